@@ -1320,6 +1320,29 @@ mxArray *mxCreateFloatMatrix3D(size_t m, size_t n, size_t p)
 	return mxCreateNumericArray(numDims, (mwSize*) dimArray, mxSINGLE_CLASS, mxREAL);		
 }
 
+/*
+    mxCreateInt16Matrix3D()
+    
+    Create a 2D or 3D matrix of 16 bit signed integers. 
+	
+    Requirements are that m>0, n>0, p>=0.  
+*/
+mxArray *mxCreateInt16Matrix3D(size_t m, size_t n, size_t p)
+{
+	int numDims;
+	mwSize dimArray[3];
+	
+	if(m==0 || n==0 ){
+		dimArray[0]=0;dimArray[1]=0;dimArray[2]=0;	//this prevents a 0x1 or 1x0 empty matrix, we want 0x0 for empty matrices. 
+	}else{
+		PsychCheckmWSizeLimits(m,n,p);
+		dimArray[0] = (mwSize) m; dimArray[1] = (mwSize) n; dimArray[2] = (mwSize) p;
+	}
+	numDims= (p==0 || p==1) ? 2 : 3;
+	
+	return mxCreateNumericArray(numDims, (mwSize*) dimArray, mxINT16_CLASS, mxREAL);		
+}
+
 /*
     mxCreateNativeBooleanMatrix3D()
     
@@ -2151,6 +2174,33 @@ psych_bool PsychAllocOutFloatMatArg(int position, PsychArgRequirementType isRequ
 
 
 
+/* 
+PsychAllocOutInt16MatArg()
+
+Like PsychAllocOutFloatMatArg() except it allocates a matrix of 16 bit signed integers,
+that is C data type short or Matlab/Octave data type int16().
+*/
+psych_bool PsychAllocOutInt16MatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, short **array)
+{
+	mxArray			**mxpp;
+	PsychError		matchError;
+	psych_bool		putOut;
+	
+	PsychSetReceivedArgDescriptor(position, TRUE, PsychArgOut);
+	PsychSetSpecifiedArgDescriptor(position, PsychArgOut, PsychArgType_int16, isRequired, m,m,n,n,p,p);
+	matchError=PsychMatchDescriptors();
+	putOut=PsychAcceptOutputArgumentDecider(isRequired, matchError);
+	if(putOut){
+		mxpp = PsychGetOutArgMxPtr(position);
+		*mxpp = mxCreateInt16Matrix3D(m,n,p);
+		*array = (short*) mxGetData(*mxpp);
+	}else
+		*array = (short*) mxMalloc(sizeof(short) * (size_t) m * (size_t) n * (size_t) maxInt(1,p));
+	return(putOut);
+}
+
+
+
 /*
     PsychCopyOutBooleanArg()
 */
@@ -2409,6 +2459,87 @@ psych_bool PsychAllocInFloatMatArg64(int position, PsychArgRequirementType isReq
 
 
 
+/*
+	PsychAllocInInt16MatArg64()
+
+	Like PsychAllocInFloatMatArg64() except it returns an array of 16 bit signed integers.
+*/
+psych_bool PsychAllocInInt16MatArg64(int position, PsychArgRequirementType isRequired, psych_int64 *m, psych_int64 *n, psych_int64 *p, short **array)
+{
+    const mxArray 	*mxPtr;
+	PsychError		matchError;
+	psych_bool		acceptArg;
+    
+    PsychSetReceivedArgDescriptor(position, TRUE, PsychArgIn);
+    PsychSetSpecifiedArgDescriptor(position, PsychArgIn, PsychArgType_int16, isRequired, 1,-1,1,-1,0,-1);
+	matchError=PsychMatchDescriptors();
+	acceptArg=PsychAcceptInputArgumentDecider(isRequired, matchError);
+	if(acceptArg){
+		mxPtr = PsychGetInArgMxPtr(position);
+		*m = (psych_int64) mxGetM(mxPtr);
+		*n = (psych_int64) mxGetNOnly(mxPtr);
+		*p = (psych_int64) mxGetP(mxPtr);
+		*array = (short*) mxGetData(mxPtr);
+	}
+	return(acceptArg);
+}
+
+
+
+/*
+	PsychAllocInUInt16MatArg64()
+
+	Like PsychAllocInFloatMatArg64() except it returns an array of 16 bit unsigned integers.
+*/
+psych_bool PsychAllocInUInt16MatArg64(int position, PsychArgRequirementType isRequired, psych_int64 *m, psych_int64 *n, psych_int64 *p, psych_uint16 **array)
+{
+    const mxArray 	*mxPtr;
+	PsychError		matchError;
+	psych_bool		acceptArg;
+    
+    PsychSetReceivedArgDescriptor(position, TRUE, PsychArgIn);
+    PsychSetSpecifiedArgDescriptor(position, PsychArgIn, PsychArgType_uint16, isRequired, 1,-1,1,-1,0,-1);
+	matchError=PsychMatchDescriptors();
+	acceptArg=PsychAcceptInputArgumentDecider(isRequired, matchError);
+	if(acceptArg){
+		mxPtr = PsychGetInArgMxPtr(position);
+		*m = (psych_int64) mxGetM(mxPtr);
+		*n = (psych_int64) mxGetNOnly(mxPtr);
+		*p = (psych_int64) mxGetP(mxPtr);
+		*array = (psych_uint16*) mxGetData(mxPtr);
+	}
+	return(acceptArg);
+}
+
+
+
+/*
+	PsychAllocInBooleanMatArg64()
+
+	Like PsychAllocInFloatMatArg64() except it returns an array of logicals.
+*/
+psych_bool PsychAllocInBooleanMatArg64(int position, PsychArgRequirementType isRequired, psych_int64 *m, psych_int64 *n, psych_int64 *p, PsychNativeBooleanType **array)
+{
+    const mxArray 	*mxPtr;
+	PsychError		matchError;
+	psych_bool		acceptArg;
+    
+    PsychSetReceivedArgDescriptor(position, TRUE, PsychArgIn);
+    PsychSetSpecifiedArgDescriptor(position, PsychArgIn, PsychArgType_boolean, isRequired, 1,-1,1,-1,0,-1);
+	matchError=PsychMatchDescriptors();
+	acceptArg=PsychAcceptInputArgumentDecider(isRequired, matchError);
+	if(acceptArg){
+		mxPtr = PsychGetInArgMxPtr(position);
+		*m = (psych_int64) mxGetM(mxPtr);
+		*n = (psych_int64) mxGetNOnly(mxPtr);
+		*p = (psych_int64) mxGetP(mxPtr);
+		*array = (PsychNativeBooleanType*) mxGetLogicals(mxPtr);
+	}
+	return(acceptArg);
+}
+
+
+
 /*
 	PsychAllocInIntegerListArg()
 	
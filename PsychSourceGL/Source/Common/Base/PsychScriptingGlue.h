@@ -70,6 +70,16 @@ psych_bool PsychAllocInIntegerListArg(int position, PsychArgRequirementType isRe
 psych_bool PsychAllocInFloatMatArg64(int position, PsychArgRequirementType isRequired, psych_int64 *m, psych_int64 *n, psych_int64 *p, float **array);
 psych_bool PsychAllocOutFloatMatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, float **array);
 
+//for 16 bit signed integers:
+psych_bool PsychAllocInInt16MatArg64(int position, PsychArgRequirementType isRequired, psych_int64 *m, psych_int64 *n, psych_int64 *p, short **array);
+psych_bool PsychAllocOutInt16MatArg(int position, PsychArgRequirementType isRequired, psych_int64 m, psych_int64 n, psych_int64 p, short **array);
+
+//for 16 bit unsigned integers:
+psych_bool PsychAllocInUInt16MatArg64(int position, PsychArgRequirementType isRequired, psych_int64 *m, psych_int64 *n, psych_int64 *p, psych_uint16 **array);
+
+//for logicals:
+psych_bool PsychAllocInBooleanMatArg64(int position, PsychArgRequirementType isRequired, psych_int64 *m, psych_int64 *n, psych_int64 *p, PsychNativeBooleanType **array);
+
 //for doubles
 psych_bool PsychCopyInDoubleArg(int position, PsychArgRequirementType isRequired, double *value);
 psych_bool PsychAllocInDoubleArg(int position, PsychArgRequirementType isRequired, double **value);
@@ -36,6 +36,19 @@
 
 #if PSYCH_SYSTEM == PSYCH_WINDOWS
 #include "pa_asio.h"
+#else
+// For memory-mapped audio buffers backed by files:
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// SSE2 vector instructions available for the mixing kernels? They are always
+// available on 64-bit x86 and optionally enabled on 32-bit x86 builds:
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PSYCH_PA_HAVE_SSE2 1
 #endif
 
 // Need to define these as they aren't defined in portaudio.h
@@ -81,6 +94,14 @@ static const char *synopsisSYNOPSIS[MAX_SYNOPSIS_STRINGS];
 // many slots whenever it needs to grow:
 #define PSYCH_AUDIO_BUFFERLIST_INCREMENT 1024
 
+// Amount of sound data in bytes to prefetch ahead of the current play position
+// of audio buffers which are backed by memory-mapped files:
+#define PSYCH_PA_PREFETCH_BYTES (4 * 1024 * 1024)
+
+// Maximum number of pending prefetch requests, and polling interval of the prefetch thread in seconds:
+#define PSYCH_PA_PREFETCH_REQUESTS 64
+#define PSYCH_PA_PREFETCH_POLLINTERVAL 0.01
+
 // PA_ANTICLAMPGAIN is premultiplied onto any sample provided by usercode, reducing
 // signal amplitude by a tiny fraction. This is a workaround for a bug in the
 // sampleformat converters in Portaudio for float -> 32 bit int and float -> 24 bit int.
@@ -95,28 +116,133 @@ static const char *synopsisSYNOPSIS[MAX_SYNOPSIS_STRINGS];
 // in the mixing/modulation stage.
 #define PA_ANTICLAMPGAIN 0.9999999
 
+// Sample formats of audio buffers created via 'CreateBuffer'. Compact integer formats
+// are converted to float on the fly during playback:
+#define PSYCH_PA_FORMAT_FLOAT32	0	// 32 bit float, premultiplied with PA_ANTICLAMPGAIN.
+#define PSYCH_PA_FORMAT_INT16	1	// 16 bit signed integer.
+#define PSYCH_PA_FORMAT_INT24	2	// 24 bit signed integer, packed into 3 bytes, little-endian.
+
 // Uncomment this define MUTEX_LOCK_TIME_STATS to enable tracing of
 // mutex lock hold times for low-level debugging and tuning:
 //#define MUTEX_LOCK_TIME_STATS 1
 
+// Full memory barrier, used for the lock-free single-producer / single-consumer handshake
+// between 'FillBuffer' on the main thread and paCallback on the audio thread in streaming
+// mode 3. Makes sure all written sound data is visible before the new writeposition is:
+#if (PSYCH_SYSTEM == PSYCH_WINDOWS) && defined(_MSC_VER)
+#define PsychPAMemoryBarrier() MemoryBarrier()
+#else
+#define PsychPAMemoryBarrier() __sync_synchronize()
+#endif
+
+// Atomic operations on ints, with full memory barrier semantics, used for handing out and
+// completing slave render jobs between the audio thread and the render worker threads:
+#if (PSYCH_SYSTEM == PSYCH_WINDOWS) && defined(_MSC_VER)
+#define PsychPAAtomicCompareAndSwap(ptr, oldval, newval) (InterlockedCompareExchange((volatile LONG*) (ptr), (newval), (oldval)) == (oldval))
+#define PsychPAAtomicIncrement(ptr) InterlockedIncrement((volatile LONG*) (ptr))
+#else
+#define PsychPAAtomicCompareAndSwap(ptr, oldval, newval) __sync_bool_compare_and_swap((ptr), (oldval), (newval))
+#define PsychPAAtomicIncrement(ptr) __sync_add_and_fetch((ptr), 1)
+#endif
+
+// Spin-wait hint to the processor, used while waiting for render worker threads. Reduces power
+// consumption and frees execution resources for a hyperthreaded sibling core running a worker:
+#ifdef PSYCH_PA_HAVE_SSE2
+#define PsychPACpuRelax() _mm_pause()
+#else
+#define PsychPACpuRelax()
+#endif
+
+// Maximum number of render worker threads per master device:
+#define PSYCH_PA_MAX_RENDER_THREADS 16
+
+// Batch size in sample frames for which render job buffers and sample rate converter buffers get reserved
+// outside of paCallback, unless a bigger batch size was already seen. Matches the largest 'buffersize'
+// accepted by 'Open':
+#define PSYCH_PA_RENDER_RESERVE_FRAMES 4096
+
+// Number of master callbacks to render serially after parallel rendering missed its deadline:
+#define PSYCH_PA_RENDER_FALLBACK_CALLBACKS 100
+
+// A schedule slot. A schedule is a ring of slots, linked via their 'next' pointers. 'AddToSchedule' is the
+// single producer and paCallback the single consumer of slots: A slot with the pending bit 2 set in 'mode'
+// belongs to the audio thread, a slot without it to the main thread, so slots are handed back and forth
+// without any locking:
 typedef struct PsychPASchedule {
-	unsigned int	mode;				// Mode of schedule slot: 0 = Invalid slot, > 0 valid slot, where different bits in the int mean something...
+	volatile unsigned int	mode;		// Mode of schedule slot: 0 = Invalid slot, > 0 valid slot, where different bits in the int mean something...
 	double			repetitions;		// Number of repetitions for the playloop defined in this slot.
 	psych_int64	loopStartFrame;		// Start of playloop in frames.
 	psych_int64	loopEndFrame;		// End of playloop in frames.
 	int bufferhandle;					// Handle of the playout buffer to use. Zero is the standard playbuffer as set by 'FillBuffer'. Negative handles
 										// may have special meaning in future implementations.
+	psych_uint64	buffergeneration;	// Generation of the referenced playout buffer at the time the slot was filled.
+	psych_bool		refheld;			// TRUE while the slot holds a reference on its playout buffer. Protected by bufferListmutex.
 	double			tWhen;				// Time in seconds, either absolute or relative spec, depending on command.
 	unsigned int	command;			// Command code: 0 = Normal playback buffer. 1 = Pause & Restart playback, 2 = Schedule end of playback, ..
+	struct PsychPASchedule* volatile next;	// Next slot in the schedule ring.
 } PsychPASchedule;
 
+// A slab of schedule slots. A schedule starts with one slab and grows by splicing further slabs into its ring:
+typedef struct PsychPAScheduleSlab {
+	struct PsychPAScheduleSlab* nextslab;	// Next slab of the same schedule, or NULL.
+	unsigned int count;						// Number of slots in this slab.
+	PsychPASchedule* slots;					// The slots, allocated in one piece with the slab header.
+} PsychPAScheduleSlab;
+
+// Number of bins of a timing histogram: Bin 0 counts durations below 1 usec, bin k counts
+// durations of at least 2^(k-1) usecs and less than 2^k usecs, the last bin counts all longer ones:
+#define PSYCH_PA_HISTOGRAM_BINS 24
+
+// Timing histogram: Only written by the audio thread, read without locking by the main thread:
+typedef struct PsychPAHistogram {
+	unsigned int	bins[PSYCH_PA_HISTOGRAM_BINS];	// Count of samples per bin.
+	unsigned int	count;				// Total count of samples.
+	double			total;				// Sum of all samples in seconds.
+	double			max;				// Maximum sample in seconds.
+} PsychPAHistogram;
+
+// Timing statistics and xrun forensics of a device, accumulated until reset via 'GetTimingStats':
+typedef struct PsychPATimingStats {
+	PsychPAHistogram	cbDuration;		// Duration of paCallback invocations, including slave processing on a master.
+	PsychPAHistogram	cbJitter;		// Deviation of callback entry intervals from the nominal duration of one buffer.
+	PsychPAHistogram	mutexWait;		// Time spent in paCallback waiting for the device mutex.
+	PsychPAHistogram	schedDuration;	// Duration of schedule processing, if a schedule is in use.
+	double			lastCbEntry;		// Entry time of the last callback, or zero if none since start.
+	double			lastXRunTime;		// Time of the last callback which reported an xrun, or zero if none.
+	unsigned int	inputUnderflows;	// Number of callbacks which reported an input underflow...
+	unsigned int	inputOverflows;		// ...an input overflow...
+	unsigned int	outputUnderflows;	// ...an output underflow...
+	unsigned int	outputOverflows;	// ...or an output overflow.
+} PsychPATimingStats;
+
+// Virtual null device stream: Defined below.
+typedef struct PsychPAVirtualStream PsychPAVirtualStream;
+
+// Disk streaming playback source: Defined below.
+typedef struct PsychPADiskStream PsychPADiskStream;
+
+// Capture to disk writer: Defined below.
+typedef struct PsychPACaptureWriter PsychPACaptureWriter;
+
+// Sample rate converter for slave devices: Defined below.
+typedef struct PsychPAResampler PsychPAResampler;
+
+// Worker thread pool for parallel rendering of slaves: Defined below.
+typedef struct PsychPARenderPool PsychPARenderPool;
+
 // Our device record:
 typedef struct PsychPADevice {
 	psych_mutex	mutex;			// Mutex lock for the PsychPADevice struct.
 	psych_condition changeSignal;	// Condition variable or event object for change signalling (see above).
 	int		 opmode;			// Mode of operation: Playback, capture or full duplex? Master, Slave or standalone?
 	int		 runMode;			// Runmode: 0 = Stop engine at end of playback, 1 = Keep engine running in hot-standby, ...
-	PaStream *stream;			// Pointer to associated portaudio stream.
+	PaStream *stream;			// Pointer to associated portaudio stream. Points to the virtualStream on virtual null devices.
+	PsychPAVirtualStream* virtualStream;	// Virtual null device stream driving this device, or NULL for real sound hardware.
+	PsychPADiskStream* diskStream;	// Disk streaming source feeding the outputbuffer, or NULL if none is attached.
+	PsychPACaptureWriter* captureWriter;	// Capture to disk writer draining the inputbuffer, or NULL if none is attached.
+	PsychPAResampler* resampler;	// Sample rate converter of a slave which plays at its own sample rate, NULL otherwise.
+	PaStreamInfo resampledinfo;	// Stream info with the own sample rate of such a slave. Its 'streaminfo' points here.
+	PsychPARenderPool* renderPool;	// Worker threads for parallel rendering of the slaves of a master, or NULL for serial rendering.
 	const PaStreamInfo* streaminfo;   // Pointer to stream info structure, provided by PortAudio.
 	PaHostApiTypeId hostAPI;	// Type of host API.
 	int		indeviceidx;		// Device index of capture device. -1 if none open.
@@ -140,13 +266,24 @@ typedef struct PsychPADevice {
 	psych_int64 outputbuffersize;	// Size of output buffer in bytes.
 	psych_int64 loopStartFrame; // Start of current playloop in frames.
 	psych_int64 loopEndFrame;  // End of current playloop in frames.
-	psych_int64 playposition;	// Current playposition in samples since start of playback for current buffer and playloop (not frames, not bytes!)
-	psych_int64 writeposition; // Current writeposition in samples since start of playback (for incremental filling).
+	volatile psych_int64 playposition;	// Current playposition in samples since start of playback for current buffer and playloop (not frames, not bytes!)
+	volatile psych_int64 writeposition; // Current writeposition in samples since start of playback (for incremental filling).
+	volatile int streamingMode;	// 0 = Classic mutex protected streaming refills. 1 = Lock-free refills: Only main thread writes writeposition, only paCallback writes playposition.
+	unsigned int underflows;	// Number of paCallback invocations which ran out of refilled sound data in lock-free streaming mode.
+	psych_int64 underflowFrames; // Total number of sample frames which had to be replaced by silence due to such underflows.
+	double	 cbLastDuration;	// Duration of last paCallback invocation in seconds, including all slave processing on a master.
+	double	 cbMaxDuration;		// Maximum duration of a paCallback invocation since start.
+	double	 cbTotalDuration;	// Accumulated duration of all timed paCallback invocations since start.
+	unsigned int cbTimedCalls;	// Number of timed paCallback invocations since start.
+	double	 schedTotalDuration;	// Accumulated duration of all schedule processing since start.
+	unsigned int schedTimedCalls;	// Number of timed schedule processing calls since start.
+	PsychPATimingStats timingStats;	// Timing histograms and xrun forensics, only written by the audio thread.
+	volatile int timingResetRequest;	// 1 = Audio thread shall reset timingStats before updating them next time.
 	psych_int64 totalplaycount; // Total running count of samples since start of playback, accumulated over all buffers and playloop(not frames, not bytes!)
 	float*	 inputbuffer;		// Pointer to float memory buffer with sound input data (captured sound data).
 	psych_int64 inputbuffersize;	// Size of input buffer in bytes.
-	psych_int64 recposition;	// Current record position in samples since start of capture.
-	psych_int64 readposition;  // Last read-out sample since start of capture.
+	volatile psych_int64 recposition;	// Current record position in samples since start of capture.
+	volatile psych_int64 readposition;  // Last read-out sample since start of capture.
 	psych_int64 outchannels;	// Number of output channels.
 	psych_int64 inchannels;	// Number of input channels.
 	unsigned int xruns;			// Number of over-/underflows of input-/output channel for this stream.
@@ -159,10 +296,16 @@ typedef struct PsychPADevice {
 								// for slight mistakes in PA's estimate.
 
 	// Audio schedule related:
-	PsychPASchedule* schedule;	// Pointer to start of array with playback schedule, or a NULL pointer if none defined.
-	volatile unsigned int schedule_size;	// Size of schedule array in slots.
+	PsychPASchedule* schedule;	// Pointer to first slot of the playback schedule, or a NULL pointer if none defined.
+	PsychPAScheduleSlab* schedule_slabs;	// List of slabs which hold the slots of the schedule.
+	volatile unsigned int schedule_size;	// Size of schedule in slots.
 	volatile unsigned int schedule_pos;		// Current position in schedule (in slots).
 	unsigned int schedule_writepos;			// Current position in schedule (in slots).
+	PsychPASchedule* volatile schedule_readslot;	// Current slot of paCallback in the schedule ring.
+	PsychPASchedule* schedule_writeslot;	// Next slot to fill by 'AddToSchedule'.
+	PsychPASchedule* schedule_writeprev;	// Slot preceding 'schedule_writeslot' in the ring, where new slabs get spliced in.
+	psych_bool schedule_growable;			// TRUE = 'AddToSchedule' grows a full schedule instead of failing.
+	psych_bool schedule_refsdropped;		// TRUE = Buffer references of pending slots were dropped while idle, 'Start' reacquires them.
 
 	// Master-Slave virtual device related:
 	int*	outputmappings;		// Mapping array of output slave channels to associated master channels for mix and merge. NULL on master devices.
@@ -182,8 +325,103 @@ typedef struct PsychPADevice {
 	// Mixer volume related:
 	float*	outChannelVolumes;	// Array of per-outputchannel volume settings on slave devices, NULL and not used on non-slave devices.
 	float	masterVolume;		// Master volume setting for all non-slave audio devices, i.e., masters and regular devices. Unused on slaves.
+
+	// Gain envelope related:
+	double	envAttack;				// Duration of fade-in after start of playback in seconds.
+	double	envRelease;				// Duration of fade-out before stop of playback in seconds.
+	double	envCrossfade;			// Duration of crossfades between successive schedule slots in seconds.
+	psych_int64 envAttackFrames;	// Fade-in duration in sample frames.
+	psych_int64 envReleaseFrames;	// Fade-out duration in sample frames.
+	psych_int64 envPlayedFrames;	// Number of frames played since start, for the fade-in.
+	psych_int64 xfadeFrames;		// Crossfade duration in sample frames.
+	float*	xfadeBuffer;			// Tail of the previous schedule slot, to mix into the start of the current slot.
+	float*	xfadeGains;				// AM gains for the tail on slave devices, snapshot before the current slot is written.
+	psych_int64 xfadeLength;		// Length of the tail in xfadeBuffer in frames.
+	psych_int64 xfadePos;			// Number of frames of the tail already mixed.
 } PsychPADevice;
 
+// One slave render job of a master callback. Each job has its own set of scratch buffers, so
+// all jobs can be rendered in parallel, independent of each other:
+typedef struct PsychPARenderJob {
+	int				slaveId;		// Slave device to render.
+	volatile int	state;			// 0 = Pending, 1 = Claimed for rendering or no work.
+	volatile int	finished;		// 1 = Rendering done, 'rendered', 'duration' and the buffers are valid.
+	psych_bool		rendered;		// Result of PsychPARenderSlave(): Slave was active and needs mixing.
+	float*			outBuffer;		// Job specific replacement for the slaveOutBuffer of the master.
+	float*			gainBuffer;		// Job specific replacement for the slaveGainBuffer of the master.
+	float*			inBuffer;		// Job specific replacement for the slaveInBuffer of the master.
+	psych_int64		capacity;		// Capacity of the buffers in sample frames.
+	double			duration;		// Duration of rendering the slave in seconds.
+} PsychPARenderJob;
+
+// Disk streaming playback: A prefetch thread reads sound data from a file, converts it to float
+// and appends it to the ring buffer of a device in lock-free streaming mode, exactly like a
+// 'FillBuffer' call with 'streamingrefill' flag 3 would do. paCallback consumes it and accounts
+// underflows as usual, and stops playback once all data of the file is played out.
+
+// Worker thread pool of a master device: On each master callback, paCallback sets up one job per
+// slave, wakes the workers and then helps rendering. Jobs are claimed via compare-and-swap on their
+// 'state', so each job is rendered exactly once, by whichever thread gets it first. Once all jobs are
+// done, paCallback mixes the results in slave order, so the mix is the same as with serial rendering:
+struct PsychPARenderPool {
+	PsychPADevice*	dev;			// Master device.
+	int				numThreads;		// Number of worker threads.
+	psych_thread	threads[PSYCH_PA_MAX_RENDER_THREADS];
+	psych_mutex		mutex;			// Mutex for 'signal'.
+	psych_condition	signal;			// Signals a new generation of jobs or shutdown to the workers.
+	volatile unsigned int generation;	// Incremented for each new set of jobs.
+	volatile int	shutdown;		// Request for workers to exit.
+	volatile int	jobCount;		// Number of jobs in the current generation.
+	volatile int	jobsDone;		// Number of completed jobs in the current generation.
+	int				slavesHandled;	// Number of slaves covered by the jobs, including modulators of slaves.
+	const float*	in;				// Captured input of the master for this generation, copied to inBuffer, or NULL.
+	float*			inBuffer;		// Copy of the captured input, as late workers may read it after paCallback returned.
+	psych_int64		inCapacity;		// Capacity of inBuffer in sample frames.
+	PaStreamCallbackTimeInfo timeInfo;	// Timing info of the master callback for this generation.
+	PaStreamCallbackFlags statusFlags;	// Status flags of the master callback for this generation.
+	double			deadline;		// Maximum duration of parallel rendering as fraction of a buffer duration.
+	int				serialCallbacks;	// Remaining number of callbacks to render serially after a missed deadline.
+	unsigned int	deadlineMisses;	// Number of missed deadlines.
+	unsigned int	parallelCallbacks;	// Number of callbacks rendered in parallel.
+	psych_int64		neededFrames;	// Biggest batch size which exceeded the capacity of the job buffers, or 0.
+	PsychPARenderJob jobs[MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE];
+};
+
+struct PsychPADiskStream {
+	PsychPADevice*	dev;				// Device record of the device which plays the stream.
+	FILE*			file;				// Sound file.
+	psych_thread	thread;				// Prefetch thread.
+	psych_bool		threadRunning;		// TRUE if the prefetch thread was started and not yet joined.
+	volatile int	stopRequest;		// 1 = Prefetch thread shall exit as soon as possible.
+	volatile int	eof;				// 1 = All sound data of the file is in the ring buffer.
+	int				format;				// Sample format of the sound data in the file.
+	psych_int64		channels;			// Number of channels in the file.
+	psych_int64		remaining;			// Number of bytes of sound data not yet read from the file.
+	psych_int64		chunkFrames;		// Maximum number of sample frames to read at once.
+	double			pollInterval;		// Sleep interval of the prefetch thread while the ring buffer is full.
+	unsigned char*	readBuffer;			// Buffer for raw sound data read from the file.
+};
+
+// Capture to disk: A writer thread drains captured sound data from the inputbuffer of a
+// device into a file, advancing the readposition like 'GetAudioData' would do. It never
+// takes the device mutex, so it can't block paCallback.
+struct PsychPACaptureWriter {
+	PsychPADevice*	dev;				// Device record of the capture device.
+	FILE*			file;				// Output file.
+	psych_thread	thread;				// Writer thread.
+	psych_bool		threadRunning;		// TRUE if the writer thread was started and not yet joined.
+	volatile int	stopRequest;		// 1 = Writer thread shall write out all remaining data, then exit.
+	int				format;				// Sample format of the sound data in the file.
+	int				isWav;				// 1 = WAV file, 0 = Raw file without header.
+	psych_int64		channels;			// Number of channels.
+	psych_int64		blockBytes;			// Size of one write in bytes, a multiple of the disk block size.
+	psych_int64		fill;				// Number of bytes pending in writeBuffer.
+	volatile psych_int64 framesWritten;	// Total number of sample frames written into the file.
+	volatile psych_int64 droppedFrames;	// Total number of sample frames lost due to capture buffer overflow or write errors.
+	double			pollInterval;		// Sleep interval of the writer thread while no data is pending.
+	unsigned char*	writeBuffer;		// Buffer for converted sound data, blockBytes in size.
+};
+
 PsychPADevice audiodevices[MAX_PSYCH_AUDIO_DEVS];
 unsigned int  audiodevicecount = 0;
 unsigned int  verbosity = 4;
@@ -192,199 +430,620 @@ psych_bool    uselocking = TRUE;		// Use Mutex locking and signalling code for t
 psych_bool    lockToCore1 = TRUE;		// Lock all engine threads to run on cpu core 1 on Windows to work around broken TSC sync on multi-cores?
 psych_bool    pulseaudio_autosuspend = TRUE;    // Should we try to suspend the Pulseaudio sound server on Linux while we're active?
 psych_bool    pulseaudio_isSuspended = FALSE;   // Is PulseAudio suspended by us?
+psych_bool    usesimd = TRUE;			// Use SSE2 vector kernels for master/slave mixing, if supported by the build?
 
 double debugdummy1, debugdummy2;
 
+// Virtual null device stream: Replaces a PortAudio stream for devices opened with deviceid -2.
+// A clock thread calls the regular processing callback at a virtual sample clock, either paced
+// in realtime or free-running as fast as possible. Output goes to memory or to a WAV file:
+struct PsychPAVirtualStream {
+	PsychPADevice*	dev;				// Device record of the device which owns the stream.
+	PaStreamInfo	info;				// Stream info, as Pa_GetStreamInfo() would return for a real stream.
+	psych_thread	thread;				// Clock thread which drives the callbacks while the stream is started.
+	psych_bool		threadRunning;		// TRUE if the clock thread was started and not yet joined.
+	volatile int	active;				// 1 = Callbacks are executing. 0 = Finished via paComplete/paAbort, or stopped.
+	volatile int	stopped;			// 1 = Stream is stopped. 0 = Stream is started.
+	volatile int	stopRequest;		// 1 = Clock thread shall exit as soon as possible.
+	psych_bool		freeRunning;		// FALSE = Pace the virtual clock in realtime. TRUE = Run as fast as possible.
+	unsigned long	framesPerBuffer;	// Size of one callback buffer in sample frames.
+	double			virtualTime;		// Virtual clock: Time of the first sample of the next callback buffer in seconds.
+	float*			outBuffer;			// Output buffer for the callback, or NULL if no playback.
+	float*			inBuffer;			// Input buffer for the callback, always silence, or NULL if no capture.
+	FILE*			wavFile;			// WAV file for output data, or NULL if output only goes to memory.
+	psych_int64		wavFrames;			// Number of sample frames written to wavFile.
+	psych_int64		callbacks;			// Total number of executed callbacks.
+};
+
+// Wrappers around the PortAudio stream functions, so virtual null devices are handled as well:
+static PaError PsychPAStartStream(PsychPADevice* dev);
+static PaError PsychPAStopStream(PsychPADevice* dev);
+static PaError PsychPAAbortStream(PsychPADevice* dev);
+static int PsychPAIsStreamActive(PsychPADevice* dev);
+static int PsychPAIsStreamStopped(PsychPADevice* dev);
+static void PsychPALockDeviceMutex(PsychPADevice* dev);
+static void PsychPAUnlockDeviceMutex(PsychPADevice* dev);
+
 psych_bool pa_initialized = FALSE;
 
 // Definition of an audio buffer:
 struct PsychPABuffer_Struct {
-	unsigned int locked;		// locked: >= 1 = Buffer in use by some active audio device. 0 = Buffer unused.
-	float*	 outputbuffer;		// Pointer to float memory buffer with sound output data.
+	void*	 outputbuffer;		// Pointer to memory buffer with sound output data in 'format'. NULL = Slot unused.
 	psych_int64 outputbuffersize;	// Size of output buffer in bytes.
 	psych_int64 outchannels;	// Number of channels.
+	int format;					// Sample format of outputbuffer, one of PSYCH_PA_FORMAT_xxx.
+	unsigned int refcount;		// Number of schedule slots which currently reference this buffer.
+	psych_uint64 generation;	// Unique id of this incarnation of the buffer. Stale references to a deleted buffer won't match it.
+	int nextfree;				// Handle of next slot in the free list if this slot is unused, -1 = End of free list.
+	void* mapbase;				// Base address of file mapping if buffer is backed by a memory-mapped file, NULL otherwise.
+	psych_int64 mapsize;		// Size of file mapping in bytes.
+	volatile psych_int64 prefetchstart;	// Start of byte range of outputbuffer for which prefetching was last requested.
+	volatile psych_int64 prefetchend;	// End of byte range of outputbuffer for which prefetching was last requested.
 };
 
 typedef struct PsychPABuffer_Struct PsychPABuffer;
 
 psych_mutex	bufferListmutex;			// Mutex lock for the audio bufferList.
-PsychPABuffer*  bufferList;				// Pointer to start of audio bufferList.
-int	bufferListCount;					// Number of slots allocated in bufferList.
+PsychPABuffer** bufferSlabs;			// Array of slabs of PSYCH_AUDIO_BUFFERLIST_INCREMENT buffer records each. Records never move once allocated.
+int	bufferSlabCount;					// Number of slabs in bufferSlabs.
+int	bufferListCount;					// Number of buffer slots allocated in all slabs.
+int	bufferFreeList;						// Handle of first free buffer slot, or -1 if no free slot is left.
+unsigned int bufferListReferences;		// Total number of references to buffers from all schedule slots.
+psych_uint64 bufferGeneration;			// Counter for assignment of unique buffer generations. Never reset.
+
+// Prefetch request for a memory-mapped buffer, queued by the audio threads and executed by the prefetch thread:
+typedef struct PsychPAPrefetchRequest {
+	PsychPABuffer*	buffer;				// Buffer record. Records never move, but may get reused for a new buffer.
+	psych_uint64	generation;			// Generation of the buffer at the time of the request.
+	psych_int64		offset;				// Byte offset into outputbuffer to prefetch from.
+} PsychPAPrefetchRequest;
+
+PsychPAPrefetchRequest prefetchRequests[PSYCH_PA_PREFETCH_REQUESTS];	// Queue of pending requests. Protected by bufferListmutex.
+int prefetchRequestCount;				// Number of pending requests in prefetchRequests.
+psych_mutex prefetchmutex;				// Keeps file mappings alive while the prefetch thread works on them. Taken before bufferListmutex.
+psych_thread prefetchThread;			// Prefetch thread, started on creation of the first memory-mapped buffer.
+psych_bool prefetchThreadRunning;		// TRUE if the prefetch thread was started and not yet joined.
+volatile int prefetchStopRequest;		// 1 = Prefetch thread shall exit.
+
+// Return size of one sample in bytes for sample 'format':
+static int PsychPABytesPerSample(int format)
+{
+	return((format == PSYCH_PA_FORMAT_INT16) ? 2 : ((format == PSYCH_PA_FORMAT_INT24) ? 3 : 4));
+}
 
-// Scan all schedules of all active and open audio devices to check if
-// given audiobuffer is referenced. Invalidate reference, if so:
-// The special handle == -1 invalidates all references except the ones to special buffer zero.
-psych_bool PsychPAInvalidateBufferReferences(int handle)
+// Map audio bufferhandle to its buffer record, or return NULL if no such slot exists.
+// Handle zero is never a valid slot, as it denotes the standard per-device playbuffer:
+static PsychPABuffer* PsychPAGetBufferRecord(int handle)
 {
-	unsigned int i, j;
-	psych_bool anylocked = FALSE;
-
-	// Scan all open audio devices:
-	for(i = 0; i < MAX_PSYCH_AUDIO_DEVS; i++) {
-		// Device open?
-		if (audiodevices[i].stream) {
-			// Schedule attached?
-			if (audiodevices[i].schedule) {
-				// Scan it and mark all references to our buffer(s) as invalid:
-				for (j = 0; j < audiodevices[i].schedule_size; j++) {
-					// Slot active and with relevant bufferhandle?
-					if ((audiodevices[i].schedule[j].bufferhandle == handle) || ((audiodevices[i].schedule[j].bufferhandle !=0) && (handle == -1)) ) {
-						// Invalidate this reference:
-						audiodevices[i].schedule[j].mode = 0;
-						audiodevices[i].schedule[j].bufferhandle = 0;
-						anylocked = TRUE;
-					}
-				}
-			}
+	if ((handle <= 0) || (handle >= bufferListCount)) return(NULL);
+	return(&(bufferSlabs[handle / PSYCH_AUDIO_BUFFERLIST_INCREMENT][handle % PSYCH_AUDIO_BUFFERLIST_INCREMENT]));
+}
+
+// Map file 'filename' read-only into memory. Returns base address of the mapping and
+// assigns its size in bytes to 'mapsize', or returns NULL on failure:
+static void* PsychPAMapFile(const char* filename, psych_int64* mapsize)
+{
+	void* base = NULL;
+
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+	HANDLE file, mapping;
+	LARGE_INTEGER size;
+
+	file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) return(NULL);
+
+	if (GetFileSizeEx(file, &size) && (size.QuadPart > 0)) {
+		mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping) {
+			// The view keeps the mapping alive, so we can close the handles right away:
+			base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping);
 		}
+		*mapsize = (psych_int64) size.QuadPart;
 	}
-	
-	return(anylocked);
+
+	CloseHandle(file);
+#else
+	struct stat st;
+	int fd;
+
+	fd = open(filename, O_RDONLY);
+	if (fd < 0) return(NULL);
+
+	if ((fstat(fd, &st) == 0) && (st.st_size > 0)) {
+		base = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if (base == MAP_FAILED) {
+			base = NULL;
+		}
+		else {
+			// We mostly play sound files front to back:
+			madvise(base, (size_t) st.st_size, MADV_SEQUENTIAL);
+			*mapsize = (psych_int64) st.st_size;
+		}
+	}
+
+	// The mapping stays valid after closing the file:
+	close(fd);
+#endif
+
+	return(base);
 }
 
-// Create a new audiobuffer for 'outchannels' audio channels and 'nrFrames' samples
-// per channel. Init header, allocate zero-filled memory, enqeue in bufferList.
-// Resize/Grow bufferList if neccessary. Return handle to buffer.
-int PsychPACreateAudioBuffer(psych_int64 outchannels, psych_int64 nrFrames)
+// Release file mapping created by PsychPAMapFile():
+static void PsychPAUnmapFile(void* base, psych_int64 mapsize)
 {
-	PsychPABuffer* tmpptr;
-	int i, handle;
-	
-	// Does a bufferList exist?
-	if ((bufferListCount <= 0) || (bufferList == NULL)) {
-		// First call. Allocate and zero-fill initial bufferList:
-		bufferList = (PsychPABuffer*) calloc(PSYCH_AUDIO_BUFFERLIST_INCREMENT, sizeof(PsychPABuffer));
-		if (NULL == bufferList) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffers when trying to create internal bufferlist!");
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+	UnmapViewOfFile(base);
+#else
+	munmap(base, (size_t) mapsize);
+#endif
+}
+
+// Request the prefetch thread to ask the operating system to asynchronously read ahead the sound
+// data of memory-mapped audiobuffer 'buffer' around byte offset 'offset' of its outputbuffer, so
+// the realtime audio thread doesn't page-fault on it later. Called from PsychPAProcessSchedule()
+// with the bufferListmutex held, so this only queues a request, and only if the play position gets
+// close to the end of the last requested range, or moves before its start, e.g., on loop wraparound.
+// This is a no-op on MS-Windows:
+static void PsychPAPrefetchMappedBuffer(PsychPABuffer* buffer, psych_int64 offset)
+{
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+	PsychPAPrefetchRequest* request;
 
-		bufferListCount = PSYCH_AUDIO_BUFFERLIST_INCREMENT;
-	} 
+	if ((offset >= buffer->prefetchstart) && (offset + PSYCH_PA_PREFETCH_BYTES / 2 <= buffer->prefetchend)) return;
 
-	// Search a free slot in bufferList: We start at slot 1, ie., we skip slot 0.
-	// This because we don't want to ever return a handle of zero, as zero denotes the
-	// special per-audiodevice playback buffer.
-	i = 1; while ((i < bufferListCount) && (NULL != bufferList[i].outputbuffer)) i++;
+	// Queue full? Then retry on the next call:
+	if (prefetchRequestCount >= PSYCH_PA_PREFETCH_REQUESTS) return;
 
-	// Success?
-	if ((i >= bufferListCount)) {
-		// Nope. Could not find free slot. Need to resize the bufferList with more capacity.
-		
-		// Need to lock bufferList lock to do this:
+	request = &prefetchRequests[prefetchRequestCount++];
+	request->buffer = buffer;
+	request->generation = buffer->generation;
+	request->offset = offset;
+
+	buffer->prefetchstart = offset;
+	buffer->prefetchend = offset + PSYCH_PA_PREFETCH_BYTES;
+#endif
+
+	return;
+}
+
+// Main function of the prefetch thread: Periodically executes all queued prefetch requests via
+// non-blocking madvise() calls. The bufferListmutex is only held while fetching the requests, never
+// during the system calls, so the audio threads are not held up by them. The prefetchmutex keeps the
+// file mappings alive meanwhile:
+static void* PsychPAPrefetchThreadMain(void* arg)
+{
+#if PSYCH_SYSTEM != PSYCH_WINDOWS
+	char* starts[PSYCH_PA_PREFETCH_REQUESTS];
+	size_t sizes[PSYCH_PA_PREFETCH_REQUESTS];
+	PsychPAPrefetchRequest* request;
+	psych_int64 start, end, pagesize;
+	int i, n;
+
+	pagesize = (psych_int64) sysconf(_SC_PAGESIZE);
+
+	while (!prefetchStopRequest) {
+		PsychLockMutex(&prefetchmutex);
+
+		// Map all requests for still existing buffers to page aligned byte ranges of their mappings:
 		PsychLockMutex(&bufferListmutex);
-		
-		// Reallocate bufferList: This may relocate the bufferList:
-		tmpptr = (PsychPABuffer*) realloc((void*) bufferList, (bufferListCount + PSYCH_AUDIO_BUFFERLIST_INCREMENT) * sizeof(PsychPABuffer) );		
+		for (i = 0, n = 0; i < prefetchRequestCount; i++) {
+			request = &prefetchRequests[i];
+			if ((NULL == request->buffer->mapbase) || (request->buffer->generation != request->generation)) continue;
+
+			start = ((char*) request->buffer->outputbuffer - (char*) request->buffer->mapbase) + request->offset;
+			start -= start % pagesize;
+			end = start + PSYCH_PA_PREFETCH_BYTES;
+			if (end > request->buffer->mapsize) end = request->buffer->mapsize;
+			if (end <= start) continue;
+
+			starts[n] = (char*) request->buffer->mapbase + start;
+			sizes[n++] = (size_t) (end - start);
+		}
+		prefetchRequestCount = 0;
+		PsychUnlockMutex(&bufferListmutex);
+
+		for (i = 0; i < n; i++) madvise(starts[i], sizes[i], MADV_WILLNEED);
+
+		PsychUnlockMutex(&prefetchmutex);
+
+		PsychYieldIntervalSeconds(PSYCH_PA_PREFETCH_POLLINTERVAL);
+	}
+#endif
+
+	return(NULL);
+}
+
+// Stop the prefetch thread, if it is running. Pending requests are discarded:
+static void PsychPAStopPrefetchThread(void)
+{
+	if (!prefetchThreadRunning) return;
+
+	prefetchStopRequest = 1;
+	PsychDeleteThread(&prefetchThread);
+	prefetchThreadRunning = FALSE;
+	prefetchStopRequest = 0;
+	prefetchRequestCount = 0;
+}
+
+// Drop the reference of schedule 'slot' to its audiobuffer, if it holds one, with the bufferListmutex
+// held. References to buffers which were deleted in the meantime are simply ignored:
+static void PsychPAReleaseBufferReference(PsychPASchedule* slot)
+{
+	PsychPABuffer* buffer;
+
+	if (!slot->refheld) return;
+	slot->refheld = FALSE;
+
+	buffer = PsychPAGetBufferRecord(slot->bufferhandle);
+	if (buffer && buffer->outputbuffer && (buffer->generation == slot->buffergeneration) && (buffer->refcount > 0)) {
+		buffer->refcount--;
+		bufferListReferences--;
+	}
+}
+
+// Take a reference of schedule 'slot' to its audiobuffer, if it doesn't hold one yet, with the
+// bufferListmutex held. Buffers which were deleted in the meantime are not referenced anymore:
+static void PsychPAAcquireBufferReference(PsychPASchedule* slot)
+{
+	PsychPABuffer* buffer;
+
+	if (slot->refheld || (slot->command > 0)) return;
+
+	buffer = PsychPAGetBufferRecord(slot->bufferhandle);
+	if (buffer && buffer->outputbuffer && (buffer->generation == slot->buffergeneration)) {
+		buffer->refcount++;
+		bufferListReferences++;
+		slot->refheld = TRUE;
+	}
+}
+
+// Take the buffer references of all pending slots of the schedule of idle device 'dev', after they
+// were dropped by PsychPAReleaseIdleScheduleReferences(). Called by 'Start':
+static void PsychPAAcquireScheduleReferences(PsychPADevice* dev)
+{
+	PsychPASchedule* slot = dev->schedule;
+	unsigned int j;
+
+	if (NULL == dev->schedule) return;
+
+	PsychLockMutex(&bufferListmutex);
+	for (j = 0; j < dev->schedule_size; j++, slot = slot->next) {
+		if (slot->mode & 2) PsychPAAcquireBufferReference(slot);
+	}
+	PsychUnlockMutex(&bufferListmutex);
+}
+
+// Drop all buffer references of the schedule of device 'dev'. Called whenever a
+// schedule gets reset or destroyed:
+static void PsychPAReleaseScheduleReferences(PsychPADevice* dev)
+{
+	PsychPASchedule* slot = dev->schedule;
+	unsigned int j;
+
+	if (NULL == dev->schedule) return;
+
+	PsychLockMutex(&bufferListmutex);
+	for (j = 0; j < dev->schedule_size; j++, slot = slot->next) PsychPAReleaseBufferReference(slot);
+	PsychUnlockMutex(&bufferListmutex);
+}
+
+// Allocate a slab of 'count' zero-filled schedule slots, already linked into a chain
+// from the first to the last slot. Returns NULL if out of memory:
+static PsychPAScheduleSlab* PsychPAAllocScheduleSlab(unsigned int count)
+{
+	PsychPAScheduleSlab* slab;
+	unsigned int j;
+
+	slab = (PsychPAScheduleSlab*) calloc(1, sizeof(PsychPAScheduleSlab) + (size_t) count * sizeof(PsychPASchedule));
+	if (NULL == slab) return(NULL);
+
+	slab->count = count;
+	slab->slots = (PsychPASchedule*) &slab[1];
+	for (j = 0; j + 1 < count; j++) slab->slots[j].next = &(slab->slots[j + 1]);
+
+	return(slab);
+}
+
+// Clear all slots of the schedule of 'dev', link them into one ring in slab order and
+// rewind read and write positions to the first slot. Only call on idle devices, after
+// dropping the buffer references of the slots via PsychPAReleaseScheduleReferences():
+static void PsychPAResetSchedule(PsychPADevice* dev)
+{
+	PsychPAScheduleSlab* slab;
+	PsychPASchedule* prev = NULL;
+	unsigned int j;
+
+	for (slab = dev->schedule_slabs; slab; slab = slab->nextslab) {
+		memset(slab->slots, 0, slab->count * sizeof(PsychPASchedule));
+		for (j = 0; j < slab->count; j++) {
+			if (prev) prev->next = &(slab->slots[j]);
+			prev = &(slab->slots[j]);
+		}
+	}
+
+	// Close the ring:
+	prev->next = dev->schedule;
+
+	dev->schedule_readslot = dev->schedule;
+	dev->schedule_writeslot = dev->schedule;
+	dev->schedule_writeprev = prev;
+	dev->schedule_pos = 0;
+	dev->schedule_writepos = 0;
+	dev->schedule_refsdropped = FALSE;
+}
+
+// Release the schedule of 'dev', if any. Only call on idle devices:
+static void PsychPADestroySchedule(PsychPADevice* dev)
+{
+	PsychPAScheduleSlab* slab;
+
+	if (NULL == dev->schedule) return;
+
+	// Drop all buffer references of the schedule, then free its slabs:
+	PsychPAReleaseScheduleReferences(dev);
+	while ((slab = dev->schedule_slabs)) {
+		dev->schedule_slabs = slab->nextslab;
+		free(slab);
+	}
+
+	dev->schedule = NULL;
+	dev->schedule_size = 0;
+	dev->schedule_refsdropped = FALSE;
+	dev->schedule_readslot = NULL;
+	dev->schedule_writeslot = NULL;
+	dev->schedule_writeprev = NULL;
+}
+
+// Grow the full schedule of 'dev' by 'count' slots. Called by 'AddToSchedule', possibly while
+// paCallback is processing the schedule: The new slots are allocated and chained up front, then
+// spliced into the ring in front of the current write slot with a single pointer store, so the
+// audio thread either still sees the old successor or the complete new chain, but never blocks.
+// Returns FALSE if out of memory:
+static psych_bool PsychPAGrowSchedule(PsychPADevice* dev, unsigned int count)
+{
+	PsychPAScheduleSlab* slab;
+	PsychPAScheduleSlab** tail;
+
+	slab = PsychPAAllocScheduleSlab(count);
+	if (NULL == slab) return(FALSE);
+
+	// Chain end points to the current write slot, then publish the chain:
+	slab->slots[count - 1].next = dev->schedule_writeslot;
+	PsychPAMemoryBarrier();
+	dev->schedule_writeprev->next = &(slab->slots[0]);
+	dev->schedule_writeslot = &(slab->slots[0]);
+
+	// Append to the slab list, which only the main thread uses:
+	for (tail = &(dev->schedule_slabs); *tail; tail = &((*tail)->nextslab));
+	*tail = slab;
+	dev->schedule_size += count;
+
+	return(TRUE);
+}
+
+// Take a free slot from the free list and return its handle. Add a new slab to the
+// bufferList if the free list is empty:
+static int PsychPAAllocBufferSlot(void)
+{
+	PsychPABuffer** tmpptr;
+	PsychPABuffer* buffer;
+	int i, handle;
+
+	// Free slot available? Otherwise we need to add a new slab of buffer slots:
+	if (bufferFreeList < 0) {
+		// Need to lock bufferList lock to do this, as the audio callback accesses bufferSlabs:
+		PsychLockMutex(&bufferListmutex);
+
+		// Reallocate slab array: This may relocate the array, but not the slabs itself:
+		tmpptr = (PsychPABuffer**) realloc((void*) bufferSlabs, (bufferSlabCount + 1) * sizeof(PsychPABuffer*));
 		if (NULL == tmpptr) {
 			// Failed! Unlock mutex:
 			PsychUnlockMutex(&bufferListmutex);
-			
+
 			// Error out. The old allocation and parameters are still valid:
 			PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffers when trying to grow internal bufferlist!");
 		}
-		
-		// Assign new pointer and size:
-		bufferList = tmpptr;
-		tmpptr = &(bufferList[i]);
+		bufferSlabs = tmpptr;
+
+		// Allocate and zero-fill new slab:
+		bufferSlabs[bufferSlabCount] = (PsychPABuffer*) calloc(PSYCH_AUDIO_BUFFERLIST_INCREMENT, sizeof(PsychPABuffer));
+		if (NULL == bufferSlabs[bufferSlabCount]) {
+			PsychUnlockMutex(&bufferListmutex);
+			PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffers when trying to grow internal bufferlist!");
+		}
+		bufferSlabCount++;
 		bufferListCount += PSYCH_AUDIO_BUFFERLIST_INCREMENT;
-		
-		// Initialize new segment of list to zero:
-		memset((void*) tmpptr, 0, PSYCH_AUDIO_BUFFERLIST_INCREMENT * sizeof(PsychPABuffer));
 
 		// Done resizing bufferlist. Unlock mutex:
 		PsychUnlockMutex(&bufferListmutex);
 
-		// Ready. 'i' now points to first free slot in new segment of extended bufferList.
+		// Enqueue all slots of the new slab in the free list, so that the lowest handle is
+		// handed out first. We skip slot 0, as we don't want to ever return a handle of zero,
+		// because zero denotes the special per-audiodevice playback buffer:
+		for (i = bufferListCount - 1; (i >= bufferListCount - PSYCH_AUDIO_BUFFERLIST_INCREMENT) && (i > 0); i--) {
+			PsychPAGetBufferRecord(i)->nextfree = bufferFreeList;
+			bufferFreeList = i;
+		}
 	}
-	
-	// Assign slotid of bufferList slot in handle:
-	handle = i;
 
-	// Invalidate all potential stale references to the new 'handle' in all schedules:
-	PsychPAInvalidateBufferReferences(handle);
+	// Dequeue first free slot:
+	handle = bufferFreeList;
+	buffer = PsychPAGetBufferRecord(handle);
+	bufferFreeList = buffer->nextfree;
+
+	// Init buffer header. A new generation invalidates all potential stale references to 'handle' in all schedules:
+	buffer->nextfree = -1;
+	buffer->refcount = 0;
+	buffer->generation = ++bufferGeneration;
+	buffer->mapbase = NULL;
+	buffer->mapsize = 0;
+	buffer->prefetchstart = 0;
+	buffer->prefetchend = 0;
+
+	return(handle);
+}
+
+// Return unused slot 'handle' to the free list:
+static void PsychPAReleaseBufferSlot(int handle)
+{
+	PsychPABuffer* buffer = PsychPAGetBufferRecord(handle);
+
+	buffer->nextfree = bufferFreeList;
+	bufferFreeList = handle;
+}
+
+// Create a new audiobuffer for 'outchannels' audio channels and 'nrFrames' samples
+// per channel in sample 'format'. Take a slot from the free list, init header,
+// allocate zero-filled memory. Return handle to buffer.
+int PsychPACreateAudioBuffer(psych_int64 outchannels, psych_int64 nrFrames, int format)
+{
+	PsychPABuffer* buffer;
+	void* outputbuffer;
+	int handle;
+
+	handle = PsychPAAllocBufferSlot();
+	buffer = PsychPAGetBufferRecord(handle);
 
 	// Allocate actual data buffer:
-	bufferList[handle].outputbuffersize = outchannels * nrFrames * sizeof(float);
-	bufferList[handle].outchannels = outchannels;
-	
-	if (NULL == ( bufferList[handle].outputbuffer = (float*) calloc(1, (size_t) bufferList[handle].outputbuffersize) )) {
-		// Out of memory: Release bufferList header and error out:
+	if (NULL == (outputbuffer = calloc(1, (size_t) (outchannels * nrFrames * PsychPABytesPerSample(format))))) {
+		PsychPAReleaseBufferSlot(handle);
 		PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating new audio buffer when trying to allocate actual buffer!");
 	}
-	
+
+	buffer->outputbuffersize = outchannels * nrFrames * PsychPABytesPerSample(format);
+	buffer->outchannels = outchannels;
+	buffer->format = format;
+	buffer->outputbuffer = outputbuffer;
+
 	// Ok, we're ready with an empty, silence filled audiobuffer. Return its handle:
 	return(handle);
 }
 
+// Create a new audiobuffer backed by the file mapping 'mapbase' of 'mapsize' bytes, as
+// created by PsychPAMapFile(). The buffer takes ownership of the mapping. The sound data
+// starts at byte offset 'dataoffset' into the mapping, has 'datasize' bytes and consists of
+// 'outchannels' channels of samples in sample 'format'. Return handle to buffer:
+int PsychPACreateMappedAudioBuffer(void* mapbase, psych_int64 mapsize, psych_int64 dataoffset, psych_int64 datasize, psych_int64 outchannels, int format)
+{
+	PsychPABuffer* buffer;
+	int handle;
+
+	handle = PsychPAAllocBufferSlot();
+	buffer = PsychPAGetBufferRecord(handle);
+	buffer->mapbase = mapbase;
+	buffer->mapsize = mapsize;
+	buffer->outputbuffersize = datasize;
+	buffer->outchannels = outchannels;
+	buffer->format = format;
+	buffer->outputbuffer = (void*) ((char*) mapbase + dataoffset);
+
+	#if PSYCH_SYSTEM != PSYCH_WINDOWS
+	// Start the prefetch thread for memory-mapped buffers, if this is the first one:
+	if (!prefetchThreadRunning) {
+		if (PsychCreateThread(&prefetchThread, NULL, PsychPAPrefetchThreadMain, NULL)) {
+			if (verbosity > 1) printf("PsychPortAudio-WARNING: Failed to start prefetch thread for memory-mapped audio buffers. Playback from them may glitch.\n");
+		}
+		else {
+			prefetchThreadRunning = TRUE;
+		}
+	}
+	#endif
+
+	// Start reading in the beginning of the sound:
+	PsychLockMutex(&bufferListmutex);
+	PsychPAPrefetchMappedBuffer(buffer, 0);
+	PsychUnlockMutex(&bufferListmutex);
+
+	return(handle);
+}
+
 // Delete all audio buffers and bufferList itself: Called during shutdown.
 void PsychPADeleteAllAudioBuffers(void)
 {
-	int i;
-	
-	if (bufferListCount > 0) {
-		
-		// Lock list:
+	int i, j;
+
+	if (bufferSlabCount > 0) {
+
+		// Lock list, and keep the prefetch thread away from the file mappings:
+		PsychLockMutex(&prefetchmutex);
 		PsychLockMutex(&bufferListmutex);
 
-		// Invalidate all referencing slots in all schedules:
-		PsychPAInvalidateBufferReferences(-1);
-		
-		// Free all audio buffers:
-		for (i = 0; i < bufferListCount; i++) {
-			if (NULL != bufferList[i].outputbuffer) free(bufferList[i].outputbuffer);
+		// Free all audio buffers and slabs. References to them in schedules go stale, as
+		// bufferGeneration is never reset, so no new buffer will ever match them:
+		for (i = 0; i < bufferSlabCount; i++) {
+			for (j = 0; j < PSYCH_AUDIO_BUFFERLIST_INCREMENT; j++) {
+				if (NULL != bufferSlabs[i][j].mapbase) {
+					PsychPAUnmapFile(bufferSlabs[i][j].mapbase, bufferSlabs[i][j].mapsize);
+				}
+				else if (NULL != bufferSlabs[i][j].outputbuffer) free(bufferSlabs[i][j].outputbuffer);
+			}
+			free(bufferSlabs[i]);
 		}
-		
-		// Release memory for bufferheader array itself:
-		free(bufferList);
-		bufferList = NULL;
+
+		// Release memory for slab array itself:
+		free(bufferSlabs);
+		bufferSlabs = NULL;
+		bufferSlabCount = 0;
 		bufferListCount = 0;
+		bufferFreeList = -1;
+		bufferListReferences = 0;
+		prefetchRequestCount = 0;
 
 		// Unlock list:
 		PsychUnlockMutex(&bufferListmutex);
+		PsychUnlockMutex(&prefetchmutex);
 	}
-	
+
 	return;
 }
 
 PsychPABuffer* PsychPAGetAudioBuffer(int handle)
 {
+	PsychPABuffer* buffer = PsychPAGetBufferRecord(handle);
+
 	// Does buffer with given handle exist?
-	if ((handle < 0) || (handle >= bufferListCount) || (bufferList[handle].outputbuffer == NULL)) {
+	if ((NULL == buffer) || (buffer->outputbuffer == NULL)) {
 		PsychErrorExitMsg(PsychError_user, "Invalid audio bufferhandle provided! The handle doesn't correspond to an existing audiobuffer.");
 	}
-	
-	return( &(bufferList[handle]) );
+
+	return(buffer);
+}
+
+// Check if audiobuffer 'handle' - or any audiobuffer if 'handle' is -1 - is
+// referenced by a pending slot in the schedule of an audio device, ie., locked
+// against deletion. paCallback drops the reference of a slot when it retires
+// the slot, so the reference counts alone tell this in constant time:
+psych_bool PsychPAIsBufferLocked(int handle)
+{
+	PsychPABuffer* buffer;
+
+	if (handle == -1) return((bufferListReferences > 0) ? TRUE : FALSE);
+
+	buffer = PsychPAGetBufferRecord(handle);
+	return((buffer && (buffer->refcount > 0)) ? TRUE : FALSE);
 }
 
-// Scan all schedules of all active and open audio devices to check which
-// audiobuffers are active and lock them:
-psych_bool PsychPAUpdateBufferReferences(void)
+// Drop the buffer references of the pending slots of all devices which are not active, so buffers
+// which are only referenced by schedules of stopped devices can be deleted. 'Start' reacquires the
+// references of those slots whose buffers still exist. Only an active device retires slots and only
+// 'Start' activates a device, so an idle device stays idle while we drop its references:
+static void PsychPAReleaseIdleScheduleReferences(void)
 {
+	PsychPADevice* dev;
 	int i;
-	unsigned int j;
-	psych_bool anylocked = FALSE;
-	
-	// First we reset all locked flags of all buffers:
-	for (i = 0; i < bufferListCount; i++) bufferList[i].locked = 0;
-	
-	// Scan all open audio devices:
-	for(i = 0; i < MAX_PSYCH_AUDIO_DEVS; i++) {
-		// Device open?
-		if (audiodevices[i].stream) {
-			// Schedule attached and device active?
-			if ((audiodevices[i].schedule) && ((audiodevices[i].state > 0) && Pa_IsStreamActive(audiodevices[i].stream))) {
-				// Active schedule. Scan it and mark all referenced buffers as locked:
-				for (j = 0; j < audiodevices[i].schedule_size; j++) {
-					// Slot active and with valid bufferhandle?
-					if ((audiodevices[i].schedule[j].mode & 2) && (audiodevices[i].schedule[j].bufferhandle > 0)) {
-						// Mark used and active audiobuffer as locked:
-						bufferList[ audiodevices[i].schedule[j].bufferhandle ].locked = 1;
-						anylocked = TRUE;
-					}
-				}
-			}
+
+	for (i = 0; i < MAX_PSYCH_AUDIO_DEVS; i++) {
+		dev = &audiodevices[i];
+		if ((NULL == dev->stream) || (NULL == dev->schedule)) continue;
+
+		PsychPALockDeviceMutex(dev);
+		if ((dev->state == 0) || !PsychPAIsStreamActive(dev)) {
+			PsychPAReleaseScheduleReferences(dev);
+			dev->schedule_refsdropped = TRUE;
 		}
+		PsychPAUnlockDeviceMutex(dev);
 	}
-	
-	return(anylocked);
 }
 
 // Delete audiobuffer 'handle' if this is possible. If it isn't possible
@@ -393,26 +1052,43 @@ int PsychPADeleteAudioBuffer(int handle, int waitmode)
 {
 	// Retrieve buffer:
 	PsychPABuffer* buffer = PsychPAGetAudioBuffer(handle);
-	
-	// Make sure all buffer locked flags are up to date:
-	PsychPAUpdateBufferReferences();
-	
-	// Buffer locked?
-	if (buffer->locked) {
+
+	// Buffer locked? Only schedules of active devices may keep it locked:
+	if (PsychPAIsBufferLocked(handle)) PsychPAReleaseIdleScheduleReferences();
+	if (PsychPAIsBufferLocked(handle)) {
 		// Yes :-( In 'waitmode' zero we fail:
 		if (waitmode == 0) return(0);
-		
-		// In waitmode 1, we retry spin-waiting until buffer available:
-		while (buffer->locked) {
+
+		// In waitmode 1, we retry spin-waiting until buffer available, ie., until all
+		// devices have played or stopped playing it:
+		while (PsychPAIsBufferLocked(handle)) {
 			PsychYieldIntervalSeconds(yieldInterval);
-			PsychPAUpdateBufferReferences();
+			PsychPAReleaseIdleScheduleReferences();
 		}
 	}
-	
-	// Delete buffer:
-	if (NULL != buffer->outputbuffer) free(buffer->outputbuffer);
-	memset(buffer, 0, sizeof(PsychPABuffer));
-	
+
+	// Delete buffer. All remaining references to it go stale. The prefetch thread must not work on its mapping meanwhile:
+	PsychLockMutex(&prefetchmutex);
+	PsychLockMutex(&bufferListmutex);
+	if (buffer->mapbase) {
+		PsychPAUnmapFile(buffer->mapbase, buffer->mapsize);
+		buffer->mapbase = NULL;
+		buffer->mapsize = 0;
+	}
+	else {
+		free(buffer->outputbuffer);
+	}
+	buffer->outputbuffer = NULL;
+	buffer->outputbuffersize = 0;
+	buffer->outchannels = 0;
+	bufferListReferences -= buffer->refcount;
+	buffer->refcount = 0;
+	PsychUnlockMutex(&bufferListmutex);
+	PsychUnlockMutex(&prefetchmutex);
+
+	// Return slot to free list:
+	PsychPAReleaseBufferSlot(handle);
+
 	// Success:
 	return(1);
 }
@@ -521,40 +1197,763 @@ void PALogger(const char* msg)
 	return;
 }
 
+// Mixing kernels for the master/slave engine. These are called from paCallback with the
+// device mutex of the master held. If the SSE2 instruction set is available at compile
+// time, the vector paths are used unless disabled at runtime via 'EngineTunables', otherwise
+// we fall back to the plain scalar loops.
 
-// Called exclusively from paCallback, with device-mutex held.
-// Check if a schedule is defined. If not, return repetition, playloop and bufferparameters
-// from the device struct, ie., old behaviour. If yes, check if an update of the schedule is
-// needed (ie., progressing to the next slot) and do so if needed. Return parameters from
-// current slot, or an abort signal if end of schedule reached.
-//
-// Return codes:
-// 0 = Valid buffer and playback parameters assigned. Proceed with audio playback as scheduled.
-// 1 = Regular end of playback or schedule reached. Finish playback.
-// 2 = Error abort, something is totally frelled.
-// 4 = Abort bufferfill operation for this host audio buffer via zerofill, but don't switch to idle mode / don't stop engine.
-//     Instead switch back to hot-standby so playback can be picked up again at a later point in time.
-//	   This is used to reschedule start of playback for a following slot at a later time.
-int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float** ret_playoutbuffer, psych_int64* ret_outsbsize, psych_int64* ret_outsboffset, double* ret_repeatCount, psych_int64* ret_playpositionlimit)
+// Fill 'n' floats at 'buf' with 'value':
+static void PsychPAFillBuffer(float* buf, psych_int64 n, float value)
 {
-	psych_int64   loopStartFrame, loopEndFrame;
-	psych_int64  outsbsize, outsboffset;
-	psych_int64  outchannels = dev->outchannels;
-	unsigned int  slotid, cmd;
-	double		  repeatCount;
-	double		  reqTime;
-	psych_int64  playpositionlimit;
-	
-	// NULL-Schedule?
-	if (dev->schedule == NULL) {
-		// Yes: Assign settings from dev-struct:
-		*ret_playoutbuffer = dev->outputbuffer;
-		outsbsize = dev->outputbuffersize / sizeof(float);
+#ifdef PSYCH_PA_HAVE_SSE2
+	if (usesimd) {
+		__m128 v = _mm_set1_ps(value);
+		for (; n >= 4; n -= 4, buf += 4) _mm_storeu_ps(buf, v);
+	}
+#endif
+	while (n-- > 0) *(buf++) = value;
+}
 
-		// Fetch boundaries of playback loop:
-		loopStartFrame = dev->loopStartFrame;
-		loopEndFrame = dev->loopEndFrame;
-		repeatCount = dev->repeatCount;
+// Check if 'mappings' maps 'channels' channels 1:1 onto a buffer with 'dstchannels' channels:
+static psych_bool PsychPAIsIdentityMapping(const int* mappings, psych_int64 channels, psych_int64 dstchannels)
+{
+	psych_int64 k;
+	if (channels != dstchannels) return(FALSE);
+	for (k = 0; k < channels; k++) if (mappings[k] != k) return(FALSE);
+	return(TRUE);
+}
+
+// Mix 'nframes' sample frames of the interleaved 'srcchannels' channel buffer 'src' into
+// the interleaved 'dstchannels' channel buffer 'dst'. Source channel k goes to target channel
+// mappings[k] and gets scaled by volumes[k] on its way. 'mixop' selects the operation:
+// 0 = Store: dst = src * vol, 1 = Mix: dst += src * vol, 2 = AM modulation: dst *= src * vol.
+static void PsychPAMixChannels(float* dst, psych_int64 dstchannels, const float* src, psych_int64 srcchannels,
+							   const int* mappings, const float* volumes, psych_int64 nframes, int mixop)
+{
+	psych_int64 j, k;
+
+	if ((nframes <= 0) || (srcchannels <= 0)) return;
+
+#ifdef PSYCH_PA_HAVE_SSE2
+	// Identity mapping of all channels? Then this is a flat elementwise operation over
+	// all samples, with the per-channel gains repeating with a period of 'p' samples. We
+	// can vectorize this if the period is compatible with the vector width of 4 floats:
+	if (usesimd && ((4 % srcchannels == 0) || (srcchannels % 4 == 0)) && PsychPAIsIdentityMapping(mappings, srcchannels, dstchannels)) {
+		float gainpattern[MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE];
+		psych_int64 n, p;
+		__m128 g, s, d;
+
+		p = (4 % srcchannels == 0) ? 4 : srcchannels;
+
+		for (k = 0; k < p; k++) gainpattern[k] = volumes[k % srcchannels];
+
+		n = nframes * srcchannels;
+		for (j = 0, k = 0; j + 4 <= n; j += 4) {
+			g = _mm_loadu_ps(&gainpattern[k]);
+			s = _mm_mul_ps(_mm_loadu_ps(&src[j]), g);
+			switch (mixop) {
+				case 0:
+					d = s;
+				break;
+				case 1:
+					d = _mm_add_ps(_mm_loadu_ps(&dst[j]), s);
+				break;
+				default:
+					d = _mm_mul_ps(_mm_loadu_ps(&dst[j]), s);
+			}
+			_mm_storeu_ps(&dst[j], d);
+			k += 4;
+			if (k >= p) k = 0;
+		}
+
+		// Scalar remainder:
+		for (; j < n; j++) {
+			switch (mixop) {
+				case 0:
+					dst[j] = src[j] * volumes[j % srcchannels];
+				break;
+				case 1:
+					dst[j] += src[j] * volumes[j % srcchannels];
+				break;
+				default:
+					dst[j] *= src[j] * volumes[j % srcchannels];
+			}
+		}
+
+		return;
+	}
+#endif
+
+	// Generic scalar path with arbitrary channel mappings. The operation switch is hoisted
+	// out of the loops, so each inner loop is a tight gather/scatter:
+	switch (mixop) {
+		case 0:
+			for (j = 0; j < nframes; j++, dst += dstchannels) {
+				for (k = 0; k < srcchannels; k++) dst[mappings[k]] = *(src++) * volumes[k];
+			}
+		break;
+		case 1:
+			for (j = 0; j < nframes; j++, dst += dstchannels) {
+				for (k = 0; k < srcchannels; k++) dst[mappings[k]] += *(src++) * volumes[k];
+			}
+		break;
+		default:
+			for (j = 0; j < nframes; j++, dst += dstchannels) {
+				for (k = 0; k < srcchannels; k++) dst[mappings[k]] *= *(src++) * volumes[k];
+			}
+	}
+
+	return;
+}
+
+// Distribute 'nframes' sample frames of the interleaved 'srcchannels' channel buffer 'src'
+// into the interleaved 'dstchannels' channel buffer 'dst', fetching target channel k from
+// source channel mappings[k], scaled by 'gain'. Used for distributing captured sound to
+// capture slaves, and for feeding the master mix to output capture slaves:
+static void PsychPAGatherChannels(float* dst, psych_int64 dstchannels, const float* src, psych_int64 srcchannels,
+								  const int* mappings, float gain, psych_int64 nframes)
+{
+	psych_int64 j, k, n;
+
+	if ((nframes <= 0) || (dstchannels <= 0)) return;
+
+	// Identity mapping? Then this is a plain scaled copy:
+	if (PsychPAIsIdentityMapping(mappings, dstchannels, srcchannels)) {
+		n = nframes * dstchannels;
+		j = 0;
+#ifdef PSYCH_PA_HAVE_SSE2
+		if (usesimd) {
+			__m128 g = _mm_set1_ps(gain);
+			for (; j + 4 <= n; j += 4) _mm_storeu_ps(&dst[j], _mm_mul_ps(_mm_loadu_ps(&src[j]), g));
+		}
+#endif
+		for (; j < n; j++) dst[j] = src[j] * gain;
+		return;
+	}
+
+	for (j = 0; j < nframes; j++, src += srcchannels) {
+		for (k = 0; k < dstchannels; k++) *(dst++) = gain * src[mappings[k]];
+	}
+
+	return;
+}
+
+// Multiply all 'channels' samples of each of the 'nframes' sample frames in the interleaved
+// buffer 'buf' with the per-frame gain gains[frame]. Used for applying gain envelopes:
+static void PsychPAApplyFrameGains(float* buf, psych_int64 channels, const float* gains, psych_int64 nframes)
+{
+	psych_int64 f = 0, k;
+
+#ifdef PSYCH_PA_HAVE_SSE2
+	if (usesimd) {
+		__m128 g;
+
+		if (channels == 1) {
+			for (; f + 4 <= nframes; f += 4, buf += 4) _mm_storeu_ps(buf, _mm_mul_ps(_mm_loadu_ps(buf), _mm_loadu_ps(&gains[f])));
+		}
+		else if (channels == 2) {
+			// Duplicate each of 4 frame gains for both channels of 8 samples:
+			for (; f + 4 <= nframes; f += 4, buf += 8) {
+				g = _mm_loadu_ps(&gains[f]);
+				_mm_storeu_ps(buf, _mm_mul_ps(_mm_loadu_ps(buf), _mm_unpacklo_ps(g, g)));
+				_mm_storeu_ps(buf + 4, _mm_mul_ps(_mm_loadu_ps(buf + 4), _mm_unpackhi_ps(g, g)));
+			}
+		}
+		else if (channels >= 4) {
+			for (; f < nframes; f++, buf += channels) {
+				g = _mm_set1_ps(gains[f]);
+				for (k = 0; k + 4 <= channels; k += 4) _mm_storeu_ps(&buf[k], _mm_mul_ps(_mm_loadu_ps(&buf[k]), g));
+				for (; k < channels; k++) buf[k] *= gains[f];
+			}
+		}
+	}
+#endif
+
+	for (; f < nframes; f++, buf += channels) {
+		for (k = 0; k < channels; k++) buf[k] *= gains[f];
+	}
+
+	return;
+}
+
+
+// Convert 'n' samples of sample 'format', starting at sample index 'srcindex' of buffer 'src',
+// into float samples scaled by 'gain' and write them to 'dst'. 'mixop' selects the operation
+// as in PsychPAMixChannels(): 0 = Store: dst = src * gain, 2 = AM modulation: dst *= src * gain.
+// Integer samples are normalized into the range -1 to +1 and get PA_ANTICLAMPGAIN applied,
+// float samples are already premultiplied with it:
+static void PsychPAConvertSamples(float* dst, const void* src, int format, psych_int64 srcindex, psych_int64 n, float gain, int mixop)
+{
+	psych_int64 k = 0;
+	float scale, v;
+
+	if (format == PSYCH_PA_FORMAT_INT16) {
+		const short* in = ((const short*) src) + srcindex;
+		scale = (float) (PA_ANTICLAMPGAIN / 32768.0) * gain;
+
+#ifdef PSYCH_PA_HAVE_SSE2
+		if (usesimd) {
+			__m128 vscale = _mm_set1_ps(scale);
+			__m128i s;
+			__m128 lo, hi;
+
+			// Sign-extend 8 samples at a time to 32 bit ints, convert to float and scale:
+			for (; k + 8 <= n; k += 8) {
+				s  = _mm_loadu_si128((const __m128i*) &in[k]);
+				lo = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16)), vscale);
+				hi = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16)), vscale);
+				if (mixop == 2) {
+					lo = _mm_mul_ps(_mm_loadu_ps(&dst[k]), lo);
+					hi = _mm_mul_ps(_mm_loadu_ps(&dst[k + 4]), hi);
+				}
+				_mm_storeu_ps(&dst[k], lo);
+				_mm_storeu_ps(&dst[k + 4], hi);
+			}
+		}
+#endif
+
+		for (; k < n; k++) {
+			v = (float) in[k] * scale;
+			if (mixop == 2) dst[k] *= v; else dst[k] = v;
+		}
+	}
+	else if (format == PSYCH_PA_FORMAT_INT24) {
+		const unsigned char* in = ((const unsigned char*) src) + 3 * srcindex;
+		scale = (float) (PA_ANTICLAMPGAIN / 8388608.0) * gain;
+
+		// Assemble each little-endian 3 byte sample in the upper 24 bits of an int, then
+		// sign-extend by an arithmetic right shift:
+		for (; k < n; k++, in += 3) {
+			v = (float) (((int) (((unsigned int) in[0] << 8) | ((unsigned int) in[1] << 16) | ((unsigned int) in[2] << 24))) >> 8) * scale;
+			if (mixop == 2) dst[k] *= v; else dst[k] = v;
+		}
+	}
+	else {
+		const float* in = ((const float*) src) + srcindex;
+
+		if (mixop == 2) {
+			for (; k < n; k++) dst[k] *= in[k] * gain;
+		}
+		else {
+			for (; k < n; k++) dst[k] = in[k] * gain;
+		}
+	}
+
+	return;
+}
+
+// Convert up to 'count' samples of a playloop in a buffer of compact sample 'format' into
+// the output buffer 'out', starting at 'playposition' and wrapping around at the end of the
+// loop of 'outsbsize' samples at 'outsboffset'. Works in contiguous runs between wraparounds,
+// so the vectorized conversion kernel can be used. Returns number of produced samples:
+static psych_int64 PsychPAConvertPlayoutSamples(float* out, psych_int64 count, const void* playoutbuffer, int format, psych_int64 outsboffset,
+												psych_int64 outsbsize, psych_int64 playposition, float gain, int mixop)
+{
+	psych_int64 done, n, idx;
+
+	for (done = 0; done < count; done += n) {
+		idx = (playposition + done) % outsbsize;
+		n = outsbsize - idx;
+		if (n > count - done) n = count - done;
+		PsychPAConvertSamples(out + done, playoutbuffer, format, outsboffset + idx, n, gain, mixop);
+	}
+
+	return((count > 0) ? count : 0);
+}
+
+// Convert 'n' samples from either 'indata' or 'indatafloat' - whichever is non-NULL - into sample
+// 'format' and store them at sample index 'dstindex' of buffer 'dst'. Input samples are expected
+// in range -1 to +1 and are clamped to the representable range of integer formats:
+static void PsychPAEncodeSamples(void* dst, int format, psych_int64 dstindex, const double* indata, const float* indatafloat, psych_int64 n)
+{
+	psych_int64 k;
+	double x, scale, vmax;
+	int v;
+
+	if (format == PSYCH_PA_FORMAT_FLOAT32) {
+		float* out = ((float*) dst) + dstindex;
+		for (k = 0; k < n; k++) out[k] = (float) (PA_ANTICLAMPGAIN * ((indata) ? indata[k] : (double) indatafloat[k]));
+		return;
+	}
+
+	scale = (format == PSYCH_PA_FORMAT_INT16) ? 32768.0 : 8388608.0;
+	vmax = scale - 1.0;
+	k = 0;
+
+#ifdef PSYCH_PA_HAVE_SSE2
+	if (usesimd && indatafloat && (format == PSYCH_PA_FORMAT_INT16)) {
+		short* out = ((short*) dst) + dstindex;
+		__m128d vscale = _mm_set1_pd(32768.0);
+		__m128d vhi = _mm_set1_pd(32767.0);
+		__m128d vlo = _mm_set1_pd(-32768.0);
+		__m128d vhalf = _mm_set1_pd(0.5);
+		__m128d vsign = _mm_set1_pd(-0.0);
+		__m128d x[4];
+		__m128i q[4];
+		__m128 v;
+		int j;
+
+		// Scale 8 samples at a time in double precision and round half away from zero, exactly like
+		// the scalar code below, then clamp, truncate to int and pack to 16 bit:
+		for (; k + 8 <= n; k += 8) {
+			v = _mm_loadu_ps(&indatafloat[k]);
+			x[0] = _mm_cvtps_pd(v);
+			x[1] = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+			v = _mm_loadu_ps(&indatafloat[k + 4]);
+			x[2] = _mm_cvtps_pd(v);
+			x[3] = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+
+			for (j = 0; j < 4; j++) {
+				x[j] = _mm_mul_pd(x[j], vscale);
+				x[j] = _mm_add_pd(x[j], _mm_or_pd(_mm_and_pd(x[j], vsign), vhalf));
+				q[j] = _mm_cvttpd_epi32(_mm_max_pd(_mm_min_pd(x[j], vhi), vlo));
+			}
+
+			// Each conversion yields two ints in the low half of its result:
+			_mm_storeu_si128((__m128i*) &out[k], _mm_packs_epi32(_mm_unpacklo_epi64(q[0], q[1]), _mm_unpacklo_epi64(q[2], q[3])));
+		}
+	}
+#endif
+
+	for (; k < n; k++) {
+		x = ((indata) ? indata[k] : (double) indatafloat[k]) * scale;
+		x = (x >= 0) ? x + 0.5 : x - 0.5;
+		if (x > vmax) x = vmax;
+		if (x < -scale) x = -scale;
+		v = (int) x;
+
+		if (format == PSYCH_PA_FORMAT_INT16) {
+			((short*) dst)[dstindex + k] = (short) v;
+		}
+		else {
+			unsigned char* out = ((unsigned char*) dst) + 3 * (dstindex + k);
+			out[0] = (unsigned char) (v & 0xff);
+			out[1] = (unsigned char) ((v >> 8) & 0xff);
+			out[2] = (unsigned char) ((v >> 16) & 0xff);
+		}
+	}
+
+	return;
+}
+
+// Convert 'n' float samples at 'src' into doubles at 'dst':
+static void PsychPAFloatToDouble(double* dst, const float* src, psych_int64 n)
+{
+	psych_int64 k = 0;
+
+#ifdef PSYCH_PA_HAVE_SSE2
+	if (usesimd) {
+		__m128 v;
+
+		for (; k + 4 <= n; k += 4) {
+			v = _mm_loadu_ps(&src[k]);
+			_mm_storeu_pd(&dst[k], _mm_cvtps_pd(v));
+			_mm_storeu_pd(&dst[k + 2], _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+		}
+	}
+#endif
+
+	for (; k < n; k++) dst[k] = (double) src[k];
+}
+
+// Convert 'n' samples of sample 'format' at 'src' into a temporary float buffer, premultiplied
+// with PA_ANTICLAMPGAIN, as expected by the data copy paths for internal audio buffers. The
+// buffer is released automatically at the end of the current subfunction call:
+static float* PsychPAConvertToTempFloat(const void* src, int format, psych_int64 n)
+{
+	float* tmp = (float*) PsychMallocTemp((size_t) n * sizeof(float));
+	PsychPAConvertSamples(tmp, src, format, 0, n, 1.0f, 0);
+	return(tmp);
+}
+
+// Polyphase windowed-sinc sample rate converter for slave devices which play at a sample rate
+// different from their master. The converter reads interleaved sound data at the source rate
+// produced by the slave and outputs it at the master rate. Input is kept as planar per-channel
+// history, so the filter inner loop is a contiguous dot product. Filter coefficients are stored
+// for PSYCH_PA_RESAMPLER_PHASES fractional positions, coefficients for positions inbetween are
+// linearly interpolated.
+#define PSYCH_PA_RESAMPLER_PHASES 256
+
+struct PsychPAResampler {
+	int				taps;				// Number of filter taps per output sample. 2 = Linear interpolation.
+	int				channels;			// Number of channels.
+	double			srcRate;			// Source sample rate of the slave.
+	psych_uint64	step;				// Input frames per output frame as 32.32 fixed point number.
+	psych_uint64	pos;				// Position of next output frame in the history as 32.32 fixed point number.
+	psych_int64		fill;				// Number of valid frames per channel in the history.
+	psych_int64		capacity;			// Capacity of the history in frames per channel.
+	float*			history;			// Planar input history: 'channels' arrays of 'capacity' floats.
+	float*			inBuffer;			// Interleaved buffer for slave output at the source rate.
+	psych_int64		inCapacity;			// Capacity of inBuffer in frames.
+	float*			coeffs;				// (PSYCH_PA_RESAMPLER_PHASES + 1) * taps filter coefficients.
+	float*			kernel;				// Interpolated filter coefficients of the current output frame.
+	double			onsetOffset;		// Offset in seconds from master buffer onset to onset of next slave input frame.
+	volatile unsigned int resetRequests;	// Number of resets requested by the main thread via PsychPARequestResamplerReset().
+	unsigned int	resetsDone;			// Number of those requests already executed by paCallback.
+};
+
+// Modified Bessel function of first kind, order zero, for the Kaiser window:
+static double PsychPABesselI0(double x)
+{
+	double sum = 1.0, term = 1.0;
+	int k;
+
+	for (k = 1; k < 50; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+		if (term < sum * 1e-12) break;
+	}
+
+	return(sum);
+}
+
+// Reset converter to silence, as at start of playback. The history is prefilled with silence,
+// so the first output frame is centered exactly on the first input frame, without delay:
+static void PsychPAResetResampler(PsychPAResampler* rs)
+{
+	rs->fill = rs->taps / 2 - 1;
+	rs->pos = 0;
+	memset(rs->history, 0, sizeof(float) * rs->capacity * rs->channels);
+}
+
+// Request a reset of the converter from the main thread. The converter is used by paCallback of the
+// master device, which doesn't hold the mutex of the slave, so the reset is executed by the next call
+// to PsychPAResamplerPrepare() on the audio thread:
+static void PsychPARequestResamplerReset(PsychPAResampler* rs)
+{
+	PsychPAMemoryBarrier();
+	rs->resetRequests++;
+}
+
+// Release converter:
+static void PsychPADestroyResampler(PsychPAResampler* rs)
+{
+	if (NULL == rs) return;
+	free(rs->history);
+	free(rs->inBuffer);
+	free(rs->coeffs);
+	free(rs->kernel);
+	free(rs);
+}
+
+// Make sure the history and input buffer of converter 'rs' are big enough for output of up to
+// 'maxFrames' frames per call. paCallback can't allocate memory, so this is called when the slave
+// is opened and whenever its master gets started. At most 8x as many input frames as output frames
+// are needed, as 'OpenSlave' limits the sample rate ratio to 8, plus the taps of the filter and the
+// fractional input frames left over from the previous call. Returns FALSE if out of memory, leaving
+// the old buffers untouched:
+static psych_bool PsychPAResamplerReserve(PsychPAResampler* rs, psych_int64 maxFrames)
+{
+	psych_int64 need;
+	float *history, *inBuffer;
+	int c;
+
+	need = (psych_int64) ceil((double) (maxFrames + 1) * ((double) rs->step / 4294967296.0)) + 2 * rs->taps;
+	if ((need <= rs->capacity) && (need <= rs->inCapacity)) return(TRUE);
+
+	history = (float*) calloc((size_t) (need * rs->channels), sizeof(float));
+	inBuffer = (float*) malloc(sizeof(float) * (size_t) (need * rs->channels));
+	if ((NULL == history) || (NULL == inBuffer)) {
+		free(history);
+		free(inBuffer);
+		return(FALSE);
+	}
+
+	if (rs->history) {
+		for (c = 0; c < rs->channels; c++) memcpy(history + c * need, rs->history + c * rs->capacity, sizeof(float) * (size_t) rs->fill);
+	}
+
+	free(rs->history);
+	free(rs->inBuffer);
+	rs->history = history;
+	rs->inBuffer = inBuffer;
+	rs->capacity = need;
+	rs->inCapacity = need;
+
+	return(TRUE);
+}
+
+// Create converter for 'channels' channels from 'srcRate' to 'dstRate', for output of up to 'maxFrames'
+// frames per call. 'quality' selects the filter: 0 = Linear interpolation, 1 = 8 taps, 2 = 32 taps,
+// 3 = 64 taps. Returns NULL if out of memory:
+static PsychPAResampler* PsychPACreateResampler(int channels, double srcRate, double dstRate, int quality, psych_int64 maxFrames)
+{
+	const int qtaps[4] = { 2, 8, 32, 64 };
+	PsychPAResampler* rs;
+	double cutoff, beta, d, x, w, sum;
+	int p, k;
+
+	rs = (PsychPAResampler*) calloc(1, sizeof(PsychPAResampler));
+	if (NULL == rs) return(NULL);
+
+	rs->taps = qtaps[quality];
+	rs->channels = channels;
+	rs->srcRate = srcRate;
+	rs->step = (psych_uint64) ((srcRate / dstRate) * 4294967296.0 + 0.5);
+	rs->coeffs = (float*) calloc((size_t) ((PSYCH_PA_RESAMPLER_PHASES + 1) * rs->taps), sizeof(float));
+	rs->kernel = (float*) calloc((size_t) rs->taps, sizeof(float));
+	if ((NULL == rs->coeffs) || (NULL == rs->kernel) || !PsychPAResamplerReserve(rs, maxFrames)) {
+		PsychPADestroyResampler(rs);
+		return(NULL);
+	}
+
+	// Lowpass cutoff relative to the source Nyquist frequency: Below the target Nyquist frequency
+	// when downsampling, to avoid aliasing. Longer filters allow for a steeper transition band:
+	cutoff = ((rs->taps >= 32) ? 0.95 : 0.85) * ((dstRate < srcRate) ? dstRate / srcRate : 1.0);
+	beta = (rs->taps >= 32) ? 8.6 : 6.0;
+
+	// Compute filter coefficients for each phase, ie., each fractional position 'f'. Tap k
+	// is at distance d = k - (taps/2 - 1) - f from the output sample position:
+	for (p = 0; p <= PSYCH_PA_RESAMPLER_PHASES; p++) {
+		sum = 0.0;
+		for (k = 0; k < rs->taps; k++) {
+			d = (double) k - (double) (rs->taps / 2 - 1) - (double) p / (double) PSYCH_PA_RESAMPLER_PHASES;
+
+			if (rs->taps == 2) {
+				// Linear interpolation: Triangle kernel.
+				w = 1.0 - fabs(d);
+			}
+			else {
+				// Kaiser windowed sinc:
+				x = d / ((double) rs->taps / 2.0);
+				w = (fabs(x) < 1.0) ? PsychPABesselI0(beta * sqrt(1.0 - x * x)) / PsychPABesselI0(beta) : 0.0;
+				w *= (d == 0.0) ? cutoff : sin(M_PI * cutoff * d) / (M_PI * d);
+			}
+
+			rs->coeffs[p * rs->taps + k] = (float) w;
+			sum += w;
+		}
+
+		// Normalize for unity gain at DC:
+		for (k = 0; k < rs->taps; k++) rs->coeffs[p * rs->taps + k] = (float) (rs->coeffs[p * rs->taps + k] / sum);
+	}
+
+	PsychPAResetResampler(rs);
+
+	return(rs);
+}
+
+// Prepare converter for output of 'nframes' frames at the destination rate and compute onsetOffset.
+// Returns number of input frames the slave needs to produce into rs->inBuffer, or -1 if the buffers
+// reserved via PsychPAResamplerReserve() are too small for this call. Called from paCallback, so it
+// must not allocate memory. The slave stays silent for this call then:
+static psych_int64 PsychPAResamplerPrepare(PsychPAResampler* rs, psych_int64 nframes)
+{
+	psych_int64 nin;
+	unsigned int resetRequests = rs->resetRequests;
+
+	// Execute pending reset requests:
+	if (resetRequests != rs->resetsDone) {
+		PsychPAResetResampler(rs);
+		rs->resetsDone = resetRequests;
+	}
+
+	nin = (psych_int64) ((rs->pos + (psych_uint64) (nframes - 1) * rs->step) >> 32) + rs->taps - rs->fill;
+	if (nin < 0) nin = 0;
+
+	if ((rs->fill + nin > rs->capacity) || (nin > rs->inCapacity)) return(-1);
+
+	// The first new input frame will go to history position 'fill'. The first output frame of
+	// this buffer is centered on history position pos + taps/2 - 1:
+	rs->onsetOffset = ((double) rs->fill - ((double) rs->pos / 4294967296.0 + (double) (rs->taps / 2 - 1))) / rs->srcRate;
+
+	return(nin);
+}
+
+// Dot product of 'n' floats:
+static float PsychPADotProduct(const float* a, const float* b, int n)
+{
+	float sum = 0.0f;
+
+#ifdef PSYCH_PA_HAVE_SSE2
+	if (usesimd && (n >= 4)) {
+		float partial[4];
+		__m128 acc = _mm_setzero_ps();
+		for (; n >= 4; n -= 4, a += 4, b += 4) acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)));
+		_mm_storeu_ps(partial, acc);
+		sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+	}
+#endif
+
+	while (n-- > 0) sum += *(a++) * *(b++);
+	return(sum);
+}
+
+// Append 'nin' interleaved frames from rs->inBuffer to the history - or silence if 'valid' is
+// FALSE - then compute 'nframes' output frames and multiply them into the interleaved buffer 'out',
+// which is prefilled with per-sample gain values, like the output buffer of a slave:
+static void PsychPAResamplerProcess(PsychPAResampler* rs, psych_int64 nin, psych_bool valid, float* out, psych_int64 nframes)
+{
+	const psych_int64 channels = rs->channels;
+	const float* c0;
+	const float* c1;
+	float t;
+	psych_int64 m, j, shift;
+	int c, k, phase;
+	psych_uint64 frac;
+
+	// Deinterleave new input into the planar history:
+	for (c = 0; c < channels; c++) {
+		float* dst = rs->history + c * rs->capacity + rs->fill;
+		if (valid) {
+			for (j = 0; j < nin; j++) dst[j] = rs->inBuffer[j * channels + c];
+		}
+		else {
+			memset(dst, 0, sizeof(float) * (size_t) nin);
+		}
+	}
+	rs->fill += nin;
+
+	for (m = 0; m < nframes; m++) {
+		// Interpolate filter coefficients for the fractional position of this output frame:
+		frac = rs->pos & 0xffffffff;
+		phase = (int) ((frac * PSYCH_PA_RESAMPLER_PHASES) >> 32);
+		t = (float) ((double) ((frac * PSYCH_PA_RESAMPLER_PHASES) & 0xffffffff) / 4294967296.0);
+		c0 = rs->coeffs + phase * rs->taps;
+		c1 = c0 + rs->taps;
+		for (k = 0; k < rs->taps; k++) rs->kernel[k] = c0[k] + t * (c1[k] - c0[k]);
+
+		// Filter each channel:
+		j = (psych_int64) (rs->pos >> 32);
+		for (c = 0; c < channels; c++) {
+			out[m * channels + c] *= PsychPADotProduct(rs->history + c * rs->capacity + j, rs->kernel, rs->taps);
+		}
+
+		rs->pos += rs->step;
+	}
+
+	// Discard history which is no longer needed:
+	shift = (psych_int64) (rs->pos >> 32);
+	if (shift > rs->fill) shift = rs->fill;
+	if (shift > 0) {
+		for (c = 0; c < channels; c++) memmove(rs->history + c * rs->capacity, rs->history + c * rs->capacity + shift, sizeof(float) * (size_t) (rs->fill - shift));
+		rs->fill -= shift;
+		rs->pos -= ((psych_uint64) shift) << 32;
+	}
+}
+
+// Called exclusively from paCallback: Apply the gain envelope of 'dev' to the 'nframes' sample
+// frames at 'out', which are the next frames to play since start of playback. 'stopFrames' is
+// the number of frames from 'out' until playback stops, or -1 if the stop is not within reach of
+// the fade-out. The fade-in ramps up linearly over the first 'envAttackFrames' after start, the
+// fade-out ramps down linearly over the last 'envReleaseFrames' before the stop, so it ends
+// exactly at the stop:
+static void PsychPAApplyEnvelope(PsychPADevice* dev, float* out, psych_int64 nframes, psych_int64 stopFrames)
+{
+	float gains[64];
+	psych_int64 f, k, m, frame;
+	double g;
+
+	// Nothing to do if the fade-in is over and the stop is not within reach of the fade-out:
+	if ((dev->envPlayedFrames >= dev->envAttackFrames) && ((stopFrames < 0) || (stopFrames - nframes >= dev->envReleaseFrames))) return;
+
+	// Compute per-frame gains in small batches, then apply them with the vector kernel:
+	for (f = 0; f < nframes; f += m) {
+		m = (nframes - f < 64) ? nframes - f : 64;
+		for (k = 0; k < m; k++) {
+			frame = f + k;
+			g = 1.0;
+			if (dev->envPlayedFrames + frame < dev->envAttackFrames) g = (double) (dev->envPlayedFrames + frame) / (double) dev->envAttackFrames;
+			if ((stopFrames >= 0) && (stopFrames - frame < dev->envReleaseFrames)) g *= (double) (stopFrames - frame) / (double) dev->envReleaseFrames;
+			gains[k] = (float) g;
+		}
+
+		PsychPAApplyFrameGains(out + f * dev->outchannels, dev->outchannels, gains, m);
+	}
+}
+
+// Called exclusively from paCallback: Mix the crossfade tail of the previous schedule slot into
+// the first 'nframes' output frames at 'out' of the slot which follows it. The new slot fades in
+// linearly while the tail fades out. On slaves the tail gets the AM gains applied which were
+// snapshot into 'xfadeGains' before the new slot was written, as the new slot got them applied:
+static void PsychPAMixCrossfadeTail(PsychPADevice* dev, float* out, psych_int64 nframes, psych_bool useGains)
+{
+	psych_int64 channels = dev->outchannels;
+	psych_int64 f, k, j;
+	const float* tail;
+	const float* gains;
+	float t;
+
+	if (nframes > dev->xfadeLength - dev->xfadePos) nframes = dev->xfadeLength - dev->xfadePos;
+
+	for (f = 0; f < nframes; f++, out += channels) {
+		j = dev->xfadePos + f;
+		t = (float) j / (float) dev->xfadeLength;
+		tail = &(dev->xfadeBuffer[j * channels]);
+		if (useGains) {
+			gains = &(dev->xfadeGains[j * channels]);
+			for (k = 0; k < channels; k++) out[k] = out[k] * t + tail[k] * gains[k] * (1.0f - t);
+		}
+		else {
+			for (k = 0; k < channels; k++) out[k] = out[k] * t + tail[k] * (1.0f - t);
+		}
+	}
+
+	dev->xfadePos += nframes;
+}
+
+// Called exclusively from paCallback: Retire the used up schedule slot 'slot' and advance to the next
+// one. The slot is handed back to 'AddToSchedule' for recycling by clearing its pending bit, unless the
+// flag 4 aka "don't auto-disable" is set. The barrier makes sure we are done reading the slot before:
+static void PsychPAAdvanceSchedule(PsychPADevice* dev, PsychPASchedule* slot)
+{
+	if (!(slot->mode & 4)) {
+		// Retire the slot: It doesn't reference its buffer anymore, so the buffer may get deleted:
+		if (slot->bufferhandle > 0) {
+			PsychLockMutex(&bufferListmutex);
+			PsychPAReleaseBufferReference(slot);
+			PsychUnlockMutex(&bufferListmutex);
+		}
+
+		PsychPAMemoryBarrier();
+		slot->mode &= ~2;
+	}
+
+	dev->schedule_readslot = slot->next;
+	dev->schedule_pos++;
+}
+
+// Called exclusively from paCallback, with device-mutex held.
+// Check if a schedule is defined. If not, return repetition, playloop and bufferparameters
+// from the device struct, ie., old behaviour. If yes, check if an update of the schedule is
+// needed (ie., progressing to the next slot) and do so if needed. Return parameters from
+// current slot, or an abort signal if end of schedule reached.
+//
+// Return codes:
+// 0 = Valid buffer and playback parameters assigned. Proceed with audio playback as scheduled.
+// 1 = Regular end of playback or schedule reached. Finish playback.
+// 2 = Error abort, something is totally frelled.
+// 4 = Abort bufferfill operation for this host audio buffer via zerofill, but don't switch to idle mode / don't stop engine.
+//     Instead switch back to hot-standby so playback can be picked up again at a later point in time.
+//	   This is used to reschedule start of playback for a following slot at a later time.
+int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, void** ret_playoutbuffer, int* ret_playoutformat, psych_int64* ret_outsbsize, psych_int64* ret_outsboffset, double* ret_repeatCount, psych_int64* ret_playpositionlimit)
+{
+	psych_int64   loopStartFrame, loopEndFrame;
+	psych_int64  outsbsize, outsboffset;
+	psych_int64  outchannels = dev->outchannels;
+	unsigned int  cmd;
+	PsychPASchedule* slot;
+	PsychPASchedule* next;
+	psych_int64  xfadeSamples = 0;
+	double		  repeatCount;
+	double		  reqTime;
+	psych_int64  playpositionlimit;
+	PsychPABuffer* buffer;
+	PsychPABuffer* mappedbuffer = NULL;
+	
+	// NULL-Schedule?
+	if (dev->schedule == NULL) {
+		// Yes: Assign settings from dev-struct:
+		*ret_playoutbuffer = dev->outputbuffer;
+		*ret_playoutformat = PSYCH_PA_FORMAT_FLOAT32;
+		outsbsize = dev->outputbuffersize / sizeof(float);
+
+		// Fetch boundaries of playback loop:
+		loopStartFrame = dev->loopStartFrame;
+		loopEndFrame = dev->loopEndFrame;
+
+		// A disk streaming source plays until the end of its file, regardless of 'repetitions':
+		repeatCount = (dev->diskStream) ? -1 : dev->repeatCount;
 
 		// Revalidate boundaries of playback loop:
 		if (loopStartFrame * outchannels >= outsbsize) loopStartFrame = (outsbsize / outchannels) - 1;
@@ -582,17 +1981,21 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 		// No: Real schedule:
 		
 		do {
-			// Find current slot (with wraparound):
-			slotid = dev->schedule_pos % dev->schedule_size;
+			// Find current slot:
+			slot = dev->schedule_readslot;
 			
 			// Current slot valid and pending?
-			if ((dev->schedule[slotid].mode & 2) == 0) {
+			if ((slot->mode & 2) == 0) {
 				// No: End of schedule reached - Signal regular abort request and that's it:
 				return(1);
 			}
+
+			// Pending slot is ours. Make sure we see its content as written by 'AddToSchedule':
+			PsychPAMemoryBarrier();
 			
 			// Current slot is valid: Assign it:
-			cmd = dev->schedule[slotid].command;
+			cmd = slot->command;
+			mappedbuffer = NULL;
 			if (cmd > 0) {
 				// Special command buffer: Doesn't contain sound, but some special
 				// control commands. Process it, then advance to next slot...
@@ -602,16 +2005,16 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 				outsbsize = 0;
 
 				// Compute absolute deadline from given tWhen timespec and type of timespec:
-				if (cmd & 4)  reqTime = dev->schedule[slotid].tWhen;						// Absolute system time specified.
+				if (cmd & 4)  reqTime = slot->tWhen;						// Absolute system time specified.
                 // Relative to last requested start time. We use last true start time as fallback if the requested start time is undefined:
-				if (cmd & 8)  reqTime = ((dev->reqStartTime > 0.0) ? dev->reqStartTime : dev->startTime) + dev->schedule[slotid].tWhen;
-				if (cmd & 16) reqTime = dev->startTime + dev->schedule[slotid].tWhen;		// Relative to last true start time.
+				if (cmd & 8)  reqTime = ((dev->reqStartTime > 0.0) ? dev->reqStartTime : dev->startTime) + slot->tWhen;
+				if (cmd & 16) reqTime = dev->startTime + slot->tWhen;		// Relative to last true start time.
 				// TODO: The following two "end time" related ones are pretty broken - Can't
 				// work the way i want it to work, as relevant information is not available at
 				// the time we'd need it, ie., at this point in execution flow...
 				// Need to think about this, or scrap the idea of end-time related timeoffsets...
-				if (cmd & 32) reqTime = dev->reqStopTime + dev->schedule[slotid].tWhen;		// Relative to last requested end time.
-				if (cmd & 64) reqTime = dev->estStopTime + dev->schedule[slotid].tWhen;		// Relative to last true end time.
+				if (cmd & 32) reqTime = dev->reqStopTime + slot->tWhen;		// Relative to last requested end time.
+				if (cmd & 64) reqTime = dev->estStopTime + slot->tWhen;		// Relative to last true end time.
 				
 				// Pause-playback-and-restart command?
 				if (cmd & 1) {
@@ -622,9 +2025,7 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 
 					// Manually invalidate this slot and advance schedule to next one:
 					*playposition = 0;
-					// Only disable if the flag 4 aka "don't auto-disable" isn't set:
-					if (!(dev->schedule[slotid].mode & 4)) dev->schedule[slotid].mode &= ~2;
-					dev->schedule_pos++;
+					PsychPAAdvanceSchedule(dev, slot);
 
 					// Return with special code 4 to reschedule:
 					return(4);
@@ -641,9 +2042,10 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 				
 				// End of command buffer processing.
 			} // Regular audio buffer: First assign outbuffer size and pointer...
-			else if (dev->schedule[slotid].bufferhandle <= 0) {
+			else if (slot->bufferhandle <= 0) {
 				// Default device playoutbuffer:
 				*ret_playoutbuffer = dev->outputbuffer;
+				*ret_playoutformat = PSYCH_PA_FORMAT_FLOAT32;
 				outsbsize = dev->outputbuffersize / sizeof(float);
 			}
 			else
@@ -653,15 +2055,18 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 				// Need to lock bufferList lock to do this:
 				PsychLockMutex(&bufferListmutex);
 
-				if (bufferList && (dev->schedule[slotid].bufferhandle < bufferListCount)) {
+				buffer = PsychPAGetBufferRecord(slot->bufferhandle);
+				if (buffer && (buffer->generation == slot->buffergeneration)) {
 					// Fetch pointer to actual audio data buffer:
-					*ret_playoutbuffer = bufferList[dev->schedule[slotid].bufferhandle].outputbuffer;
+					*ret_playoutbuffer = buffer->outputbuffer;
+					*ret_playoutformat = buffer->format;
+					if (buffer->mapbase) mappedbuffer = buffer;
 					
 					// Retrieve buffersize in samples:
-					outsbsize = bufferList[dev->schedule[slotid].bufferhandle].outputbuffersize / sizeof(float);
+					outsbsize = buffer->outputbuffersize / PsychPABytesPerSample(buffer->format);
 					
 					// Another child protection:
-					if (outchannels != bufferList[dev->schedule[slotid].bufferhandle].outchannels) {
+					if (outchannels != buffer->outchannels) {
 						*ret_playoutbuffer = NULL;
 						outsbsize = 0;
 					}
@@ -676,9 +2081,9 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 			}
 
 			// ... then loop and repeat parameters:
-			loopStartFrame = dev->schedule[slotid].loopStartFrame;
-			loopEndFrame   = dev->schedule[slotid].loopEndFrame;
-			repeatCount    = dev->schedule[slotid].repetitions;
+			loopStartFrame = slot->loopStartFrame;
+			loopEndFrame   = slot->loopEndFrame;
+			repeatCount    = slot->repetitions;
 			
 			// Revalidate boundaries of playback loop:
 			if (loopStartFrame * outchannels >= outsbsize) loopStartFrame = (outsbsize / outchannels) - 1;
@@ -695,14 +2100,36 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 			playpositionlimit = ((psych_int64) (repeatCount * outsbsize));
 			// ...and make sure it ends on integral sample frame boundaries:
 			playpositionlimit -= playpositionlimit % outchannels;
+
+			// Crossfade into a following pending sound slot? Then this slot ends 'xfadeSamples' early, and
+			// paCallback mixes its remaining samples into the start of the next slot. At most half of the
+			// slot is used for the crossfade:
+			xfadeSamples = 0;
+			if ((dev->xfadeFrames > 0) && (repeatCount != -1) && (*ret_playoutbuffer) && !(dev->opmode & kPortAudioIsMaster)) {
+				next = slot->next;
+				if ((next->mode & 2) && ((next != slot) || (slot->mode & 4))) {
+					PsychPAMemoryBarrier();
+					if (next->command == 0) {
+						xfadeSamples = dev->xfadeFrames * outchannels;
+						if (xfadeSamples > playpositionlimit / 2) xfadeSamples = (playpositionlimit / 2) - ((playpositionlimit / 2) % outchannels);
+					}
+				}
+			}
 			
 			// Check if loop and repetition constraints as well as actual audio buffer for this slot are still valid:
-			if ( !((repeatCount == -1) || (*playposition < playpositionlimit)) || (NULL == *ret_playoutbuffer) ) {
-				// Constraints violated. This slot is used up: Reset playposition and advance to next slot:
+			if ( !((repeatCount == -1) || (*playposition < playpositionlimit - xfadeSamples)) || (NULL == *ret_playoutbuffer) ) {
+				// Constraints violated. This slot is used up. Render the remainder of a crossfading slot
+				// as tail for the next slot:
+				if ((xfadeSamples > 0) && (*playposition < playpositionlimit)) {
+					PsychPAConvertPlayoutSamples(dev->xfadeBuffer, playpositionlimit - *playposition, *ret_playoutbuffer, *ret_playoutformat,
+												 outsboffset, outsbsize, *playposition, dev->masterVolume, 0);
+					dev->xfadeLength = (playpositionlimit - *playposition) / outchannels;
+					dev->xfadePos = 0;
+				}
+
+				// Reset playposition and advance to next slot:
 				*playposition = 0;
-				// Only disable if the flag 4 aka "don't auto-disable" isn't set:
-				if (!(dev->schedule[slotid].mode & 4)) dev->schedule[slotid].mode &= ~2;
-				dev->schedule_pos++;
+				PsychPAAdvanceSchedule(dev, slot);
 			}
 			else {
 				// Constraints ok, break out of do-while slot advance loop:
@@ -714,16 +2141,433 @@ int PsychPAProcessSchedule(PsychPADevice* dev, psych_int64 *playposition, float*
 	*ret_outsbsize = outsbsize;
 	*ret_outsboffset = outsboffset;
 	*ret_repeatCount = repeatCount;
-	*ret_playpositionlimit = playpositionlimit;
+	*ret_playpositionlimit = playpositionlimit - xfadeSamples;
 
 	// Safety check: If playoutbuffer is NULL at this point, then somethings screwed
 	// and we request abort of playback:
 	if (NULL == *ret_playoutbuffer) return(2);
 
+	// Buffer backed by a memory-mapped file? Make sure the sound data ahead of the current
+	// play position gets paged in by the prefetch thread before we need it. Hold the bufferList
+	// lock, so the buffer can't go away meanwhile:
+	if (mappedbuffer) {
+		PsychLockMutex(&bufferListmutex);
+		if (mappedbuffer->mapbase) PsychPAPrefetchMappedBuffer(mappedbuffer, (outsboffset + (*playposition % outsbsize)) * PsychPABytesPerSample(mappedbuffer->format));
+		PsychUnlockMutex(&bufferListmutex);
+	}
+
 	// Return 0 exit to signal a valid update:
 	return(0);
 }
 
+// Add a duration of 'secs' seconds to histogram 'h':
+static void PsychPAHistogramAdd(PsychPAHistogram* h, double secs)
+{
+	double usecs = secs * 1e6;
+	int bin = 0;
+
+	while ((usecs >= 1.0) && (bin < PSYCH_PA_HISTOGRAM_BINS - 1)) {
+		usecs *= 0.5;
+		bin++;
+	}
+
+	h->bins[bin]++;
+	h->count++;
+	h->total += secs;
+	if (secs > h->max) h->max = secs;
+}
+
+// Reset timing statistics of 'dev' if requested. Must only be called by the audio thread which
+// updates them, so the statistics have only one writer and need no locking:
+static void PsychPAHandleTimingReset(PsychPADevice* dev)
+{
+	if (dev->timingResetRequest) {
+		memset(&(dev->timingStats), 0, sizeof(PsychPATimingStats));
+		PsychPAMemoryBarrier();
+		dev->timingResetRequest = 0;
+	}
+}
+
+// Timed variant of PsychPAProcessSchedule() for use in paCallback: Accounts the time
+// spent in schedule processing, if a schedule is active on the device:
+static int PsychPAProcessScheduleTimed(PsychPADevice* dev, psych_int64 *playposition, void** ret_playoutbuffer, int* ret_playoutformat, psych_int64* ret_outsbsize, psych_int64* ret_outsboffset, double* ret_repeatCount, psych_int64* ret_playpositionlimit)
+{
+	double tStart, tEnd;
+	int rc;
+
+	if (NULL == dev->schedule) return(PsychPAProcessSchedule(dev, playposition, ret_playoutbuffer, ret_playoutformat, ret_outsbsize, ret_outsboffset, ret_repeatCount, ret_playpositionlimit));
+
+	PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+	rc = PsychPAProcessSchedule(dev, playposition, ret_playoutbuffer, ret_playoutformat, ret_outsbsize, ret_outsboffset, ret_repeatCount, ret_playpositionlimit);
+	PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+
+	dev->schedTotalDuration += tEnd - tStart;
+	dev->schedTimedCalls++;
+	PsychPAHistogramAdd(&(dev->timingStats.schedDuration), tEnd - tStart);
+
+	return(rc);
+}
+
+static int paCallback( const void *inputBuffer, void *outputBuffer,
+                             unsigned long framesPerBuffer,
+                             const PaStreamCallbackTimeInfo* timeInfo,
+                             PaStreamCallbackFlags statusFlags,
+                             void *userData );
+
+// Called from paCallback of master 'dev' with its mutex held, or from a render worker on its behalf:
+// Render one buffer of 'dev->batchsize' frames of slave 'slaveId' into 'slaveOutBuffer', using
+// 'slaveGainBuffer' for the output of an AM modulator of the slave and 'slaveInBuffer' for the
+// captured data of the master in 'in' which gets distributed to the slave. Returns FALSE if the
+// slave itself was inactive, so there is nothing to mix:
+static psych_bool PsychPARenderSlave(PsychPADevice* dev, int slaveId, const float* in, float* slaveOutBuffer, float* slaveGainBuffer, float* slaveInBuffer,
+							   const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags)
+{
+	PsychPADevice* slave = &audiodevices[slaveId];
+	PsychPADevice* modulator = NULL;
+	psych_int64 rsframes;
+
+	// Gain modulator slave for this real slave attached, valid and active?
+	// If this is the case, we need to unconditionally execute it here, regardless
+	// of what the actual 'slaveId' device is up to. Otherwise we can run into
+	// time sync issues and ugly deadlocks in the calling code:
+	if ((slave->modulatorSlave > -1) && (audiodevices[slave->modulatorSlave].stream) &&
+		(audiodevices[slave->modulatorSlave].opmode & kPortAudioIsAMModulatorForSlave) && (audiodevices[slave->modulatorSlave].state > 0)) {
+		// Yes. Execute it:
+		modulator = &audiodevices[slave->modulatorSlave];
+		modulator->slaveDirty = 0;
+
+		// Prefill buffer with neutral 1.0:
+		PsychPAFillBuffer(slaveGainBuffer, dev->batchsize * modulator->outchannels, 1.0);
+
+		// This will potentially fill the slaveGainBuffer with gain modulation values.
+		// The passed slaveInBuffer is meaningless for a modulator slave and only contains random junk...
+		paCallback( (const void*) slaveInBuffer, (void*) slaveGainBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) modulator);
+	}
+
+	// Skip actual slaves processing if its state is zero == completely inactive.
+	if (slave->state == 0) return(FALSE);
+
+	// Reset dirty flag for this slave:
+	slave->slaveDirty = 0;
+
+	// Is this a playback slave?
+	if (slave->opmode & kPortAudioPlayBack) {
+		// Prefill slaves output buffer with 1.0, a neutral gain value for playback slaves
+		// without a AM modulator attached. The same prefill is needed with AM modulator,
+		// this time to make the modulator itself happy:
+		PsychPAFillBuffer(slaveOutBuffer, dev->batchsize * slave->outchannels, 1.0);
+
+		// Is a modulator slave active and did it write any gain AM values?
+		if (modulator && modulator->slaveDirty) {
+			// Yes. Need to distribute them to proper channels in slaveOutBuffer:
+			PsychPAMixChannels(slaveOutBuffer, slave->outchannels, slaveGainBuffer, modulator->outchannels,
+							   modulator->outputmappings, modulator->outChannelVolumes, dev->batchsize, 0);
+		}
+	}	// Ok, the slaveOutBuffer for this playback slave is prefilled with valid gain modulation data to apply to the actual sound output.
+
+	// Capture enabled on slave? If so, we need to distribute our captured audio data to it:
+	if (slave->opmode & kPortAudioCapture) {
+		// Fetch each target channel of the slave from the corresponding source channel of our device:
+		PsychPAGatherChannels(slaveInBuffer, slave->inchannels, in, dev->inchannels, slave->inputmappings, 1.0, dev->batchsize);
+	}
+
+	if (slave->resampler) {
+		// Playback slave with its own sample rate: Let it produce as many sample frames at its rate as
+		// the converter needs for one buffer at our rate, then convert and multiply them into the prefilled
+		// slaveOutBuffer, applying any AM gain modulation at our rate:
+		rsframes = PsychPAResamplerPrepare(slave->resampler, dev->batchsize);
+		if (rsframes >= 0) {
+			PsychPAFillBuffer(slave->resampler->inBuffer, rsframes * slave->outchannels, 1.0);
+			if (rsframes > 0) paCallback( (const void*) slaveInBuffer, (void*) slave->resampler->inBuffer, (unsigned long) rsframes, timeInfo, statusFlags, (void*) slave);
+			PsychPAResamplerProcess(slave->resampler, rsframes, slave->slaveDirty, slaveOutBuffer, dev->batchsize);
+
+			// The converter always outputs valid sound, e.g., the decaying tail of the sound data:
+			slave->slaveDirty = 1;
+		}
+	}
+	else {
+		// Temporary input buffer is filled for slave callback: Execute it.
+		paCallback( (const void*) slaveInBuffer, (void*) slaveOutBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) slave);
+	}
+
+	return(TRUE);
+}
+
+// Called from paCallback of master 'dev' with its mutex held: Mix the output of active slave 'slaveId',
+// as rendered into 'slaveOutBuffer' by PsychPARenderSlave(), into the master's 'mixBuffer', starting
+// after the 'committedFrames' frames of silence at the head of the buffer:
+static void PsychPAMixSlave(PsychPADevice* dev, int slaveId, const float* slaveOutBuffer, float* mixBuffer, psych_int64 committedFrames)
+{
+	PsychPADevice* slave = &audiodevices[slaveId];
+
+	// Check if the paCallback actually filled anything into the slaveOutBuffer:
+	if (!(slave->opmode & kPortAudioPlayBack) || !slave->slaveDirty) return;
+
+	// Slave has written meaningful data to its output buffer. Merge & mix it, from first
+	// non-silence sample slot (after silenceframes prefix) until end of buffer:
+	slaveOutBuffer = &(slaveOutBuffer[committedFrames * slave->outchannels]);
+	mixBuffer = &(mixBuffer[committedFrames * dev->outchannels]);
+
+	// Special AM-Modulator slave?
+	if (slave->opmode & kPortAudioIsAMModulator) {
+		// Yes: This slave doesn't provide audio data for mixing, but instead
+		// a time-series of gain modulation samples for amplitude modulation.
+		// Multiply the master channels samples with the slaves "gain samples"
+		// to apply AM modulation:
+		PsychPAMixChannels(mixBuffer, dev->outchannels, slaveOutBuffer, slave->outchannels,
+						   slave->outputmappings, slave->outChannelVolumes, dev->batchsize - committedFrames, 2);
+	}
+	else {
+		// Regular mix: Mix all output channels of the slave into the proper target channels
+		// of the master by simple addition. Apply per-channel volume settings of the slave
+		// during mix:
+		PsychPAMixChannels(mixBuffer, dev->outchannels, slaveOutBuffer, slave->outchannels,
+						   slave->outputmappings, slave->outChannelVolumes, dev->batchsize - committedFrames, 1);
+	}
+}
+
+// Render all pending jobs of 'pool' which are not yet claimed by another thread. Called by the
+// worker threads, and by paCallback of the master to help out:
+static void PsychPARunRenderJobs(PsychPARenderPool* pool)
+{
+	PsychPARenderJob* job;
+	double tStart, tEnd;
+	int k, n;
+
+	n = pool->jobCount;
+	for (k = 0; k < n; k++) {
+		job = &(pool->jobs[k]);
+		if ((job->state != 0) || !PsychPAAtomicCompareAndSwap(&(job->state), 0, 1)) continue;
+
+		// Job is ours:
+		PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+		job->rendered = PsychPARenderSlave(pool->dev, job->slaveId, pool->in, job->outBuffer, job->gainBuffer, job->inBuffer, &(pool->timeInfo), pool->statusFlags);
+		PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+		job->duration = tEnd - tStart;
+		job->finished = 1;
+
+		// Publish completion, implies a memory barrier:
+		PsychPAAtomicIncrement(&(pool->jobsDone));
+	}
+}
+
+// Returns TRUE if some jobs of the last generation are still being rendered by a worker, because
+// paCallback stopped waiting for them after a missed deadline. The job buffers are still in use then:
+static psych_bool PsychPARenderJobsInFlight(PsychPARenderPool* pool)
+{
+	return((pool->jobsDone < pool->jobCount) ? TRUE : FALSE);
+}
+
+// Returns TRUE if slave 'slaveId' is still being rendered by a straggling worker of the last generation:
+static psych_bool PsychPAIsSlaveInFlight(PsychPARenderPool* pool, int slaveId)
+{
+	int k, n = pool->jobCount;
+
+	for (k = 0; k < n; k++) {
+		if ((pool->jobs[k].slaveId == slaveId) && !pool->jobs[k].finished) return(TRUE);
+	}
+
+	return(FALSE);
+}
+
+// Main function of render worker threads: Sleep until a new generation of jobs is available, then help rendering it:
+static void* PsychPARenderThreadMain(void* poolToCast)
+{
+	PsychPARenderPool* pool = (PsychPARenderPool*) poolToCast;
+	unsigned int generation = 0;
+
+	while (TRUE) {
+		PsychLockMutex(&(pool->mutex));
+		while (!pool->shutdown && (pool->generation == generation)) PsychWaitCondition(&(pool->signal), &(pool->mutex));
+		generation = pool->generation;
+		PsychUnlockMutex(&(pool->mutex));
+
+		if (pool->shutdown) break;
+
+		PsychPARunRenderJobs(pool);
+	}
+
+	return(NULL);
+}
+
+// Called from paCallback of master 'dev' with its mutex held: Set up one render job for each slave
+// which would be rendered in the serial slave loop. Returns FALSE if parallel rendering isn't worth it
+// or not possible for this callback, e.g., due to lack of memory for the job buffers:
+static psych_bool PsychPASetupRenderJobs(PsychPADevice* dev, PsychPARenderPool* pool, const float* in, const PaStreamCallbackTimeInfo* timeInfo, PaStreamCallbackFlags statusFlags)
+{
+	PsychPARenderJob* job;
+	int i, slaveId, n = 0, handled = 0;
+
+	// Stop all late workers from claiming anything until the jobs are set up:
+	pool->jobCount = 0;
+	PsychPAMemoryBarrier();
+
+	for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (handled < dev->slaveCount); i++) {
+		slaveId = dev->slaves[i];
+		if ((slaveId < 0) || (audiodevices[slaveId].opmode & kPortAudioIsOutputCapture)) continue;
+		handled++;
+
+		// Modulators of slaves are rendered as part of their parent slave:
+		if (audiodevices[slaveId].opmode & kPortAudioIsAMModulatorForSlave) continue;
+
+		job = &(pool->jobs[n]);
+		if (job->capacity < dev->batchsize) {
+			// Scratch buffers of this job too small. We must not allocate memory here, so remember the
+			// batch size for the next reservation at 'Start' and render serially until then:
+			pool->neededFrames = dev->batchsize;
+			return(FALSE);
+		}
+
+		job->slaveId = slaveId;
+		n++;
+	}
+
+	// Parallelism needs at least two jobs:
+	if (n < 2) return(FALSE);
+
+	// Workers which miss the deadline may still read the input after we returned to PortAudio, so
+	// hand them a copy of it:
+	if (in && (dev->inchannels > 0)) {
+		if (pool->inCapacity < dev->batchsize) {
+			pool->neededFrames = dev->batchsize;
+			return(FALSE);
+		}
+
+		memcpy(pool->inBuffer, in, sizeof(float) * dev->batchsize * dev->inchannels);
+		pool->in = pool->inBuffer;
+	}
+	else {
+		pool->in = NULL;
+	}
+
+	pool->timeInfo = *timeInfo;
+	pool->statusFlags = statusFlags;
+	pool->slavesHandled = handled;
+	pool->jobsDone = 0;
+	for (i = 0; i < n; i++) {
+		pool->jobs[i].finished = 0;
+		pool->jobs[i].state = 0;
+	}
+
+	// Publish the new jobs:
+	PsychPAMemoryBarrier();
+	pool->jobCount = n;
+
+	return(TRUE);
+}
+
+// Reserve scratch buffers for the first 'numJobs' render jobs of 'pool', big enough for the biggest batch
+// size seen so far, or PSYCH_PA_RENDER_RESERVE_FRAMES, whatever is bigger. Must be called with the mutex
+// of the master held, or before the pool is attached to its master, and without jobs in flight. Returns
+// FALSE if out of memory, in which case the job keeps its old buffers:
+static psych_bool PsychPAReserveRenderJobs(PsychPARenderPool* pool, int numJobs)
+{
+	PsychPADevice* dev = pool->dev;
+	PsychPARenderJob* job;
+	float *outBuffer, *gainBuffer, *inBuffer;
+	psych_int64 frames = PSYCH_PA_RENDER_RESERVE_FRAMES;
+	int i;
+
+	if (frames < dev->batchsize) frames = dev->batchsize;
+	if (frames < pool->neededFrames) frames = pool->neededFrames;
+
+	// Copy of the captured input of the master, shared by all jobs:
+	if ((dev->inchannels > 0) && (pool->inCapacity < frames)) {
+		inBuffer = (float*) malloc(sizeof(float) * frames * dev->inchannels);
+		if (NULL == inBuffer) return(FALSE);
+
+		free(pool->inBuffer);
+		pool->inBuffer = inBuffer;
+		pool->inCapacity = frames;
+	}
+
+	for (i = 0; (i < numJobs) && (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE); i++) {
+		job = &(pool->jobs[i]);
+		if (job->capacity >= frames) continue;
+
+		outBuffer = (float*) malloc(sizeof(float) * frames * dev->outchannels);
+		gainBuffer = (float*) malloc(sizeof(float) * frames * dev->outchannels);
+		inBuffer = (dev->inchannels > 0) ? (float*) malloc(sizeof(float) * frames * dev->inchannels) : NULL;
+		if ((NULL == outBuffer) || (NULL == gainBuffer) || ((dev->inchannels > 0) && (NULL == inBuffer))) {
+			free(outBuffer);
+			free(gainBuffer);
+			free(inBuffer);
+			return(FALSE);
+		}
+
+		free(job->outBuffer);
+		free(job->gainBuffer);
+		free(job->inBuffer);
+		job->outBuffer = outBuffer;
+		job->gainBuffer = gainBuffer;
+		job->inBuffer = inBuffer;
+		job->capacity = frames;
+	}
+
+	return(TRUE);
+}
+
+// Shut down and destroy render worker pool 'pool'. The pool must be detached from its master already:
+static void PsychPADestroyRenderPool(PsychPARenderPool* pool)
+{
+	int i;
+
+	PsychLockMutex(&(pool->mutex));
+	pool->shutdown = 1;
+	PsychBroadcastCondition(&(pool->signal));
+	PsychUnlockMutex(&(pool->mutex));
+
+	for (i = 0; i < pool->numThreads; i++) PsychDeleteThread(&(pool->threads[i]));
+
+	for (i = 0; i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE; i++) {
+		free(pool->jobs[i].outBuffer);
+		free(pool->jobs[i].gainBuffer);
+		free(pool->jobs[i].inBuffer);
+	}
+	free(pool->inBuffer);
+
+	PsychDestroyCondition(&(pool->signal));
+	PsychDestroyMutex(&(pool->mutex));
+	free(pool);
+}
+
+// Create a render worker pool with 'numThreads' threads for master device 'dev'. Returns NULL on failure:
+static PsychPARenderPool* PsychPACreateRenderPool(PsychPADevice* dev, int numThreads, double deadline)
+{
+	PsychPARenderPool* pool;
+	int i;
+
+	pool = (PsychPARenderPool*) calloc(1, sizeof(PsychPARenderPool));
+	if (NULL == pool) return(NULL);
+
+	pool->dev = dev;
+	pool->deadline = deadline;
+
+	// No pending work in any job:
+	for (i = 0; i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE; i++) pool->jobs[i].state = 1;
+
+	PsychInitMutex(&(pool->mutex));
+	PsychInitCondition(&(pool->signal), NULL);
+
+	for (i = 0; i < numThreads; i++) {
+		if (PsychCreateThread(&(pool->threads[i]), NULL, PsychPARenderThreadMain, (void*) pool)) break;
+		pool->numThreads++;
+
+		// Workers should run with the same realtime priority as audio processing itself:
+		if (PsychSetThreadPriority(&(pool->threads[i]), 10, 2) && (verbosity > 3)) {
+			printf("PsychPortAudio: Could not raise priority of render worker thread %i. Parallel rendering may miss its deadlines.\n", i);
+		}
+	}
+
+	// Reserve job buffers for the current slaves, as paCallback can't allocate them:
+	if ((pool->numThreads < numThreads) || !PsychPAReserveRenderJobs(pool, dev->slaveCount)) {
+		PsychPADestroyRenderPool(pool);
+		return(NULL);
+	}
+
+	return(pool);
+}
+
 /* paCallback: PortAudo I/O processing callback. 
  *
  * This callback is called by PortAudios playback/capture engine whenever
@@ -749,10 +2593,10 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
     PsychPADevice* dev = (PsychPADevice*) userData;
     float *out = (float*) outputBuffer;
     float *in = (float*) inputBuffer;
-	float *playoutbuffer;
+	void *playoutbuffer;
+	int playoutformat;
 	float *tmpBuffer, *mixBuffer;
 	float masterVolume, neutralValue;
-	psych_int64  j, k;
     psych_int64 i, silenceframes, committedFrames, max_i;
 	psych_int64 inchannels, outchannels;
 	psych_int64  playposition, outsbsize, insbsize, recposition;
@@ -760,11 +2604,16 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 	unsigned int reqstate;
 	double now, firstsampleonset, onsetDelta, offsetDelta, captureStartTime, tMonotonic;
 	double repeatCount;	
-	psych_int64 playpositionlimit;
+	double tSlaveStart, tSlaveEnd, tLockStart, tLockEnd, tDeadline;
+	unsigned int spins;
+	PsychPARenderPool* renderPool;
+	psych_bool renderedParallel;
+	psych_int64 playpositionlimit, writelimit, underflowSamples, remaining, stopFrames;
+	float *outStart, *segmentStart;
 	PaHostApiTypeId hA;
-	psych_bool	stopEngine;
+	psych_bool	stopEngine, stopClamped;
 	psych_bool  isMaster, isSlave;
-	int			slaveId, modulatorSlave, parc, numSlavesHandled;
+	int			slaveId, parc, numSlavesHandled, streamEOF;
 
 	// Device struct attached to stream? If no device struct
 	// is attached, we can't continue and tell the engine to abort
@@ -802,6 +2651,9 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 		
 		// Retrieve current system time:
 		PsychGetAdjustedPrecisionTimerSeconds(&now);
+
+		// Virtual null devices run on their own virtual clock, which defines 'now':
+		if (dev->virtualStream) now = timeInfo->currentTime;
 		
 		// FIXME: PortAudio stable sets timeInfo->currentTime == 0 --> Breakage!!!
 		// That's why we currently have our own PortAudio version.
@@ -909,6 +2761,10 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 		firstsampleonset = audiodevices[dev->pamaster].firstsampleonset;
 		captureStartTime = audiodevices[dev->pamaster].cst;
 		now = audiodevices[dev->pamaster].now;
+
+		// Slave with its own sample rate? Its sound data for this callback only starts playing
+		// after the data still pending in the sample rate converter:
+		if (dev->resampler) firstsampleonset += dev->resampler->onsetOffset;
 	}
 	
 	// Cache cooked timestamps:
@@ -916,8 +2772,13 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 	dev->cst = captureStartTime;
 	dev->now = now;
 	
-	// Acquire device lock: We'll likely hold it until exit from paCallback:
+	// Acquire device lock: We'll likely hold it until exit from paCallback. Account the time
+	// we had to wait for it:
+	PsychGetAdjustedPrecisionTimerSeconds(&tLockStart);
 	PsychPALockDeviceMutex(dev);
+	PsychGetAdjustedPrecisionTimerSeconds(&tLockEnd);
+	PsychPAHandleTimingReset(dev);
+	PsychPAHistogramAdd(&(dev->timingStats.mutexWait), tLockEnd - tLockStart);
 	
 	// Cache requested state:
 	reqstate = dev->reqstate;
@@ -932,7 +2793,16 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 	if (dev->batchsize < (psych_int64) framesPerBuffer) dev->batchsize = (psych_int64) framesPerBuffer;
 	
 	// Keep track of buffer over-/underflows:
-	if (statusFlags & (paInputOverflow | paInputUnderflow | paOutputOverflow | paOutputUnderflow)) dev->xruns++;
+	if (statusFlags & (paInputOverflow | paInputUnderflow | paOutputOverflow | paOutputUnderflow)) {
+		dev->xruns++;
+
+		// Keep forensics about type and time of the xrun:
+		if (statusFlags & paInputUnderflow) dev->timingStats.inputUnderflows++;
+		if (statusFlags & paInputOverflow) dev->timingStats.inputOverflows++;
+		if (statusFlags & paOutputUnderflow) dev->timingStats.outputUnderflows++;
+		if (statusFlags & paOutputOverflow) dev->timingStats.outputOverflows++;
+		dev->timingStats.lastXRunTime = now;
+	}
 
 	// Reset number of already committed sample frames for this buffer fill iteration to zero:
 	// This is a running count of how much of the current output buffer has been filled with
@@ -942,6 +2812,7 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 	// NULL-out pointer to buffer with sound data to play. It will get initialized later on
 	// in PsychPAProcessSchedule():
 	playoutbuffer = NULL;
+	playoutformat = PSYCH_PA_FORMAT_FLOAT32;
 
 	// Query number of output channels:
 	outchannels = (psych_int64) dev->outchannels;
@@ -1171,9 +3042,77 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 		// Have scratch buffers ready. Clear output intermix buffer:
 		memset(outputBuffer, 0, dev->batchsize * outchannels * sizeof(float));
 
-		// Iterate over all slave device callbacks: Or at least until all registered slaves are handled.
+		// Parallel rendering of slaves via render worker threads enabled and possible for this callback?
 		numSlavesHandled = 0;
-		for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (numSlavesHandled < dev->slaveCount); i++) {
+		renderedParallel = FALSE;
+		renderPool = dev->renderPool;
+		if (renderPool && (renderPool->serialCallbacks > 0)) {
+			// No. Still in serial fallback after a missed deadline:
+			renderPool->serialCallbacks--;
+			renderPool = NULL;
+		}
+
+		// Workers still busy with jobs of a previous callback which missed its deadline? Then their
+		// job buffers are still in use, so render serially, without the slaves of those jobs:
+		if (renderPool && PsychPARenderJobsInFlight(renderPool)) renderPool = NULL;
+
+		if (renderPool && PsychPASetupRenderJobs(dev, renderPool, in, timeInfo, statusFlags)) {
+			// Yes: Wake up the workers, then help them out until all jobs are done:
+			PsychGetAdjustedPrecisionTimerSeconds(&tSlaveStart);
+			PsychLockMutex(&(renderPool->mutex));
+			renderPool->generation++;
+			PsychBroadcastCondition(&(renderPool->signal));
+			PsychUnlockMutex(&(renderPool->mutex));
+
+			PsychPARunRenderJobs(renderPool);
+
+			// Wait for the workers to finish their jobs, but not beyond the deadline. Spin with a pause hint
+			// and yield the cpu every 64 spins, as workers of the same realtime priority may need this core:
+			tDeadline = tSlaveStart + renderPool->deadline * ((double) dev->batchsize / (double) dev->streaminfo->sampleRate);
+			spins = 0;
+			while (renderPool->jobsDone < renderPool->jobCount) {
+				PsychPACpuRelax();
+				if ((++spins % 64) == 0) {
+					PsychGetAdjustedPrecisionTimerSeconds(&tSlaveEnd);
+					if (tSlaveEnd > tDeadline) break;
+					PsychYieldIntervalSeconds(0);
+				}
+			}
+			PsychPAMemoryBarrier();
+			PsychGetAdjustedPrecisionTimerSeconds(&tSlaveEnd);
+
+			// Deadline missed? Then render serially for a while, as the workers don't get the cpu time they'd need:
+			renderPool->parallelCallbacks++;
+			if (tSlaveEnd > tDeadline) {
+				renderPool->deadlineMisses++;
+				renderPool->serialCallbacks = PSYCH_PA_RENDER_FALLBACK_CALLBACKS;
+			}
+
+			// Deterministic mixdown in slave order, same as serial rendering would do:
+			for (i = 0; i < renderPool->jobCount; i++) {
+				// Job still rendered by a straggling worker after a missed deadline? Its slave stays silent
+				// for this buffer, and its timing is unknown, so skip it:
+				if (!renderPool->jobs[i].finished) continue;
+				PsychPAMemoryBarrier();
+
+				slaveId = renderPool->jobs[i].slaveId;
+				if (renderPool->jobs[i].rendered) PsychPAMixSlave(dev, slaveId, renderPool->jobs[i].outBuffer, (float*) outputBuffer, committedFrames);
+
+				// Account slave processing time to the slave:
+				audiodevices[slaveId].cbLastDuration = renderPool->jobs[i].duration;
+				if (audiodevices[slaveId].cbLastDuration > audiodevices[slaveId].cbMaxDuration) audiodevices[slaveId].cbMaxDuration = audiodevices[slaveId].cbLastDuration;
+				audiodevices[slaveId].cbTotalDuration += audiodevices[slaveId].cbLastDuration;
+				audiodevices[slaveId].cbTimedCalls++;
+				PsychPAHandleTimingReset(&audiodevices[slaveId]);
+				PsychPAHistogramAdd(&(audiodevices[slaveId].timingStats.cbDuration), audiodevices[slaveId].cbLastDuration);
+			}
+
+			numSlavesHandled = renderPool->slavesHandled;
+			renderedParallel = TRUE;
+		}
+
+		// Otherwise iterate over all slave device callbacks: Or at least until all registered slaves are handled.
+		for (i = 0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (numSlavesHandled < dev->slaveCount) && !renderedParallel; i++) {
 			// Valid slave slot?
 			slaveId = dev->slaves[i];
 
@@ -1191,116 +3130,29 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 
 				// This is a "real" audio slave, not a modulator or such:
 
-				// Gain modulator slave for this real slave attached, valid and active?
-				// If this is the case, we need to unconditionally execute it here, regardless
-				// of what the actual 'slaveId' device is up to. Otherwise we can run into
-				// time sync issues and ugly deadlocks in the calling code:
-				modulatorSlave = audiodevices[slaveId].modulatorSlave;
-				if ((modulatorSlave > -1) && (audiodevices[modulatorSlave].stream) &&
-					(audiodevices[modulatorSlave].opmode & kPortAudioIsAMModulatorForSlave) && (audiodevices[modulatorSlave].state > 0)) {
-					// Yes. Execute it:
-					audiodevices[modulatorSlave].slaveDirty = 0;
-
-					// Prefill buffer with neutral 1.0:
-					tmpBuffer = dev->slaveGainBuffer;
-					for (j = 0; j < dev->batchsize * audiodevices[modulatorSlave].outchannels; j++) *(tmpBuffer++) = 1.0;
-
-					// This will potentially fill the slaveGainBuffer with gain modulation values.
-					// The passed slaveInBuffer is meaningless for a modulator slave and only contains random junk...
-					paCallback( (const void*) dev->slaveInBuffer, (void*) dev->slaveGainBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[modulatorSlave]));
-				}
-				else {
-					// No. Either no modulator slave or slave not currently active. Signal this
-					// by setting modulatorSlave to a -1 value:
-					modulatorSlave = -1;
+				// Still rendered by a straggling render worker after a missed deadline? Then it must not
+				// be touched until the worker is done, so it stays silent for this buffer:
+				if (dev->renderPool && PsychPAIsSlaveInFlight(dev->renderPool, slaveId)) {
+					numSlavesHandled++;
+					continue;
 				}
 
-				// Skip actual slaves processing if its state is zero == completely inactive.
-				if (audiodevices[slaveId].state > 0) {
-					// Slave is active, need to process it:
+				// Time the processing of this slave, including its modulator and mixing:
+				PsychGetAdjustedPrecisionTimerSeconds(&tSlaveStart);
 
-					// Reset dirty flag for this slave:
-					audiodevices[slaveId].slaveDirty = 0;
+				// Render it into our scratch buffers, then mix it:
+				if (PsychPARenderSlave(dev, slaveId, in, dev->slaveOutBuffer, dev->slaveGainBuffer, dev->slaveInBuffer, timeInfo, statusFlags))
+					PsychPAMixSlave(dev, slaveId, dev->slaveOutBuffer, (float*) outputBuffer, committedFrames);
+
+				// Account slave processing time to the slave:
+				PsychGetAdjustedPrecisionTimerSeconds(&tSlaveEnd);
+				audiodevices[slaveId].cbLastDuration = tSlaveEnd - tSlaveStart;
+				if (audiodevices[slaveId].cbLastDuration > audiodevices[slaveId].cbMaxDuration) audiodevices[slaveId].cbMaxDuration = audiodevices[slaveId].cbLastDuration;
+				audiodevices[slaveId].cbTotalDuration += audiodevices[slaveId].cbLastDuration;
+				audiodevices[slaveId].cbTimedCalls++;
+				PsychPAHandleTimingReset(&audiodevices[slaveId]);
+				PsychPAHistogramAdd(&(audiodevices[slaveId].timingStats.cbDuration), audiodevices[slaveId].cbLastDuration);
 
-					// Is this a playback slave?
-					if (audiodevices[slaveId].opmode & kPortAudioPlayBack) {
-						// Prefill slaves output buffer with 1.0, a neutral gain value for playback slaves
-						// without a AM modulator attached. The same prefill is needed with AM modulator,
-						// this time to make the modulator itself happy:
-						tmpBuffer = dev->slaveOutBuffer;
-						for (j = 0; j < dev->batchsize * audiodevices[slaveId].outchannels; j++) *(tmpBuffer++) = 1.0;
-
-						// Ok, the outbuffer is filled with a neutral 1.0 gain value. This will work
-						// even if no per-slave gain modulation is provided by a modulator slave.
-
-						// Is a modulator slave active and did it write any gain AM values?
-						if ((modulatorSlave > -1) && (audiodevices[modulatorSlave].slaveDirty)) {
-							// Yes. Need to distribute them to proper channels in slaveOutBuffer:
-							tmpBuffer = dev->slaveGainBuffer;
-							mixBuffer = dev->slaveOutBuffer;
-							for (j = 0; j < dev->batchsize; j++) {
-								// Iterate over all target channels in the slave device outputbuffer:
-								for (k = 0; k < audiodevices[modulatorSlave].outchannels; k++) {
-									// Modulate current sample in intermixbuffer via multiplication:
-									mixBuffer[(j * audiodevices[slaveId].outchannels) + audiodevices[modulatorSlave].outputmappings[k]] = *(tmpBuffer++) * audiodevices[modulatorSlave].outChannelVolumes[k];
-								}
-							}				
-						}
-					}	// Ok, the slaveOutBuffer for this playback slave is prefilled with valid gain modulation data to apply to the actual sound output.
-
-					// Capture enabled on slave? If so, we need to distribute our captured audio data to it:
-					if (audiodevices[slaveId].opmode & kPortAudioCapture) {
-						tmpBuffer = dev->slaveInBuffer;
-						// For each sampleFrame in the input buffer:
-						for (j = 0; j < dev->batchsize; j++) {
-							// Iterate over all target channels in the slave devices inputbuffer:
-							for (k = 0; k < audiodevices[slaveId].inchannels; k++) {
-								// And fetch from corrsponding source channel of our device:
-								*(tmpBuffer++) = in[(j * inchannels) + audiodevices[slaveId].inputmappings[k]];
-							}
-						}
-					}
-					
-					// Temporary input buffer is filled for slave callback: Execute it.
-					paCallback( (const void*) dev->slaveInBuffer, (void*) dev->slaveOutBuffer, (unsigned long) dev->batchsize, timeInfo, statusFlags, (void*) &(audiodevices[slaveId]));
-					
-					// Check if the paCallback actually filled anything into the dev->slaveOutBuffer:
-					if ((audiodevices[slaveId].opmode & kPortAudioPlayBack) && audiodevices[slaveId].slaveDirty) {
-						// Slave has written meaningful data to its output buffer. Merge & mix it:
-						
-						// Process from first non-silence sample slot (after silenceframes prefix) until end of buffer:
-						tmpBuffer = &(dev->slaveOutBuffer[committedFrames * audiodevices[slaveId].outchannels]);
-						mixBuffer = (float*) outputBuffer;
-						
-						// Special AM-Modulator slave?
-						if (audiodevices[slaveId].opmode & kPortAudioIsAMModulator) {
-							// Yes: This slave doesn't provide audio data for mixing, but instead
-							// a time-series of gain modulation samples for amplitude modulation.
-							// Multiply the master channels samples with the slaves "gain samples"
-							// to apply AM modulation:
-							for (j = committedFrames; j < dev->batchsize; j++) {
-								// Iterate over all target channels in the slave device outputbuffer:
-								for (k = 0; k < audiodevices[slaveId].outchannels; k++) {
-									// Modulate current sample in intermixbuffer via multiplication:
-									mixBuffer[(j * outchannels) + audiodevices[slaveId].outputmappings[k]] *= *(tmpBuffer++) * audiodevices[slaveId].outChannelVolumes[k];
-								}
-							}
-						}
-						else {
-							// Regular mix: Mix all output channels of the slave into the proper target channels
-							// of the master by simple addition. Apply per-channel volume settings of the slave
-							// during mix:
-							for (j = committedFrames; j < dev->batchsize; j++) {
-								// Iterate over all target channels in the slave device outputbuffer:
-								for (k = 0; k < audiodevices[slaveId].outchannels; k++) {
-									// Mix current sample via addition:
-									mixBuffer[(j * outchannels) + audiodevices[slaveId].outputmappings[k]] += *(tmpBuffer++) * audiodevices[slaveId].outChannelVolumes[k];
-								}
-							}
-						}
-					}
-				}
-				
 				// One more slave handled:
 				numSlavesHandled++;
 			}
@@ -1328,15 +3180,9 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 						// Our input is the mixBuffer from previous mixes:
 						mixBuffer = (float*) outputBuffer;
 						
-						// For each sampleFrame in the mixBuffer:
-						for (j = 0; j < dev->batchsize; j++) {
-							// Iterate over all target channels in the slave devices inputbuffer:
-							for (k = 0; k < audiodevices[slaveId].inchannels; k++) {
-								// And fetch from corrsponding mixBuffer channel of our device, applying the same
-								// masterVolume setting that the master output device will apply later:
-								*(tmpBuffer++) = masterVolume * mixBuffer[(j * outchannels) + audiodevices[slaveId].inputmappings[k]];
-							}
-						}
+						// Fetch from corrsponding mixBuffer channel of our device, applying the same
+						// masterVolume setting that the master output device will apply later:
+						PsychPAGatherChannels(tmpBuffer, audiodevices[slaveId].inchannels, mixBuffer, outchannels, audiodevices[slaveId].inputmappings, masterVolume, dev->batchsize);
 					}
 					
 					// Temporary input buffer is filled for slave callback: dev->slaveOutBuffer acts as the input
@@ -1398,7 +3244,9 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 			recposition++;
 		}
 		
-		// Store updated recording position in device structure:
+		// Store updated recording position in device structure. Make sure all captured data is
+		// visible to a capture writer thread before the new recposition is:
+		PsychPAMemoryBarrier();
 		dev->recposition = recposition;
 	}
 	
@@ -1421,8 +3269,10 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 
 		// Clamp to at most 10 seconds ahead, because that is more than enough even
 		// for the largest conceivable hostbuffersizes, and it prevents numeric overflow
-		// in the math below when converting to psych_int64 ints:
-		offsetDelta = (offsetDelta > 10.0) ? 10.0 : offsetDelta;
+		// in the math below when converting to psych_int64 ints. The requested stop is
+		// then beyond reach of any fade-out, as 'SetEnvelope' limits those to 10 seconds:
+		stopClamped = (offsetDelta > 10.0) ? TRUE : FALSE;
+		offsetDelta = (stopClamped) ? 10.0 : offsetDelta;
 
 		// Convert remaining time until requested stop time into sample frames until stop:
 		offsetDelta = offsetDelta * (double)(dev->streaminfo->sampleRate);
@@ -1434,6 +3284,24 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 		
 		// Count of outputted frames in this part of the code:
 		i=0;
+		outStart = out;
+
+		// Lock-free streaming refill mode? Then the main thread may append new sound data without holding
+		// our mutex, and we must not play out beyond the last sample it has published. Fetch the published
+		// writeposition once, and only afterwards read the buffer content it covers:
+		underflowSamples = 0;
+		writelimit = 0;
+		if (dev->streamingMode) {
+			// Disk streaming source which has appended all sound data of its file? Check its 'eof' flag
+			// before fetching the writeposition, so we know the writeposition is final:
+			streamEOF = (dev->diskStream) ? dev->diskStream->eof : 0;
+			PsychPAMemoryBarrier();
+			writelimit = dev->writeposition;
+			PsychPAMemoryBarrier();
+
+			// Stop playback once all sound data of the file has been played out, instead of underflowing:
+			if (streamEOF && (writelimit - playposition < max_i)) max_i = (writelimit > playposition) ? writelimit - playposition : 0;
+		}
 
 		// Stoptime already reached or abort request from master thread received? If so, stop the engine:
 		if (reqstate == 0 || reqstate == 3 || (offsetDelta <= 0) ) stopEngine = TRUE;
@@ -1442,27 +3310,79 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 		// or max_i timeout reached for end of processing, or no more valid slots available
 		// in current schedule. Assign all relevant parameters from schedule:
 		while (!stopEngine && (i < framesPerBuffer * outchannels) && (i < max_i) &&
-			   ((parc = PsychPAProcessSchedule(dev, &playposition, &playoutbuffer, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) == 0)) {
+			   ((parc = PsychPAProcessScheduleTimed(dev, &playposition, &playoutbuffer, &playoutformat, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) == 0)) {
 			// Process this slot:
+			segmentStart = out;
+
+			// Crossfade tail of a previous slot pending? Slaves need a snapshot of the AM gains in the
+			// part of the output buffer it overlaps, before we multiply sound data into it:
+			if (isSlave && (dev->xfadePos < dev->xfadeLength)) {
+				remaining = (framesPerBuffer * outchannels - i) / outchannels;
+				if (remaining > dev->xfadeLength - dev->xfadePos) remaining = dev->xfadeLength - dev->xfadePos;
+				memcpy(&(dev->xfadeGains[dev->xfadePos * outchannels]), out, (size_t) (remaining * outchannels) * sizeof(float));
+			}
 
 			if (!isMaster && !isSlave) {
 				// Non-master, non-slave device: This is a regular sound device.
 				// Copy requested number of samples for each channel into the output buffer: Take the case of
 				// "loop forever" and "loop repeatCount" times into account, as well as stop times:
-				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
-					*(out++) = playoutbuffer[outsboffset + ( playposition % outsbsize )] * masterVolume;
-					playposition++;
+				if (playoutformat != PSYCH_PA_FORMAT_FLOAT32) {
+					// Compact integer sample format: Convert to float on the fly. Only dynamic buffers
+					// can have such formats, so lock-free streaming doesn't apply:
+					remaining = ((framesPerBuffer * outchannels) < max_i) ? (framesPerBuffer * outchannels) - i : max_i - i;
+					if ((repeatCount != -1) && (playpositionlimit - playposition < remaining)) remaining = playpositionlimit - playposition;
+					remaining = PsychPAConvertPlayoutSamples(out, remaining, playoutbuffer, playoutformat, outsboffset, outsbsize, playposition, masterVolume, 0);
+					out += remaining;
+					i += remaining;
+					playposition += remaining;
+				}
+				else if (!dev->streamingMode) {
+					for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
+						*(out++) = ((float*) playoutbuffer)[outsboffset + ( playposition % outsbsize )] * masterVolume;
+						playposition++;
+					}
+				}
+				else {
+					// Lock-free streaming: Samples not yet provided by the main thread are output as silence
+					// and accounted as underflow. playposition advances regardless, so timing stays intact:
+					for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
+						if (playposition < writelimit) {
+							*(out++) = ((float*) playoutbuffer)[outsboffset + ( playposition % outsbsize )] * masterVolume;
+						}
+						else {
+							*(out++) = 0;
+							underflowSamples++;
+						}
+						playposition++;
+					}
 				}
 			}
 			else if (!isMaster) {
 				// Non-master device: This is a slave.
 				// Copy requested number of samples for each channel into the output buffer: Take the case of
 				// "loop forever" and "loop repeatCount" times into account, as well as stop times:
-				for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
-					// We multiply in order to apply possible per-channel, per-sample gain values as
-					// defined by the master - i.e., by an AM modulator that is attached to us:
-					*(out++) *= playoutbuffer[outsboffset + ( playposition % outsbsize )] * masterVolume;
-					playposition++;
+				if (playoutformat != PSYCH_PA_FORMAT_FLOAT32) {
+					// Compact integer sample format: Convert to float on the fly, multiplying as below:
+					remaining = ((framesPerBuffer * outchannels) < max_i) ? (framesPerBuffer * outchannels) - i : max_i - i;
+					if ((repeatCount != -1) && (playpositionlimit - playposition < remaining)) remaining = playpositionlimit - playposition;
+					remaining = PsychPAConvertPlayoutSamples(out, remaining, playoutbuffer, playoutformat, outsboffset, outsbsize, playposition, masterVolume, 2);
+					out += remaining;
+					i += remaining;
+					playposition += remaining;
+				}
+				else {
+					for (; (i < framesPerBuffer * outchannels) && (i < max_i) && ((repeatCount == -1) || (playposition < playpositionlimit)); i++) {
+						// We multiply in order to apply possible per-channel, per-sample gain values as
+						// defined by the master - i.e., by an AM modulator that is attached to us:
+						if (!dev->streamingMode || (playposition < writelimit)) {
+							*(out++) *= ((float*) playoutbuffer)[outsboffset + ( playposition % outsbsize )] * masterVolume;
+						}
+						else {
+							*(out++) = 0;
+							underflowSamples++;
+						}
+						playposition++;
+					}
 				}
 			}
 			else {
@@ -1474,16 +3394,39 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
 				}		
 			}
 
+			// Mix crossfade tail of the previous slot into the start of this one:
+			if (dev->xfadePos < dev->xfadeLength) PsychPAMixCrossfadeTail(dev, segmentStart, (out - segmentStart) / outchannels, isSlave);
+
 			// Store updated playposition in device structure:
 			dev->playposition = playposition;
 
 			// Abort condition?
-			if ((i >= max_i) || ((parc = PsychPAProcessSchedule(dev, &playposition, &playoutbuffer, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) > 0)) stopEngine = TRUE;
+			if ((i >= max_i) || ((parc = PsychPAProcessScheduleTimed(dev, &playposition, &playoutbuffer, &playoutformat, &outsbsize, &outsboffset, &repeatCount, &playpositionlimit)) > 0)) stopEngine = TRUE;
 		}
 
 		// Store updated playposition in device structure:
 		dev->playposition = playposition;
 
+		// Apply fade-in and fade-out gain envelope: Playback stops at max_i, unless max_i is only
+		// clamped, or at the end of the last repetition of a finite non-schedule playback, whatever
+		// comes first:
+		if ((i > 0) && ((dev->envAttackFrames > 0) || (dev->envReleaseFrames > 0))) {
+			stopFrames = (stopClamped) ? -1 : max_i / outchannels;
+			if (!dev->schedule && !dev->streamingMode && (dev->repeatCount != -1) && (playpositionlimit >= playposition) &&
+				((stopFrames < 0) || ((i + playpositionlimit - playposition) / outchannels < stopFrames))) {
+				stopFrames = (i + playpositionlimit - playposition) / outchannels;
+			}
+
+			PsychPAApplyEnvelope(dev, outStart, i / outchannels, stopFrames);
+		}
+		dev->envPlayedFrames += i / outchannels;
+
+		// Account for underflows in lock-free streaming mode:
+		if (underflowSamples > 0) {
+			dev->underflows++;
+			dev->underflowFrames += underflowSamples / outchannels;
+		}
+
 		// Update total count of emitted valid non-silence sample frames:
 		committedFrames += i / outchannels;
 
@@ -1542,6 +3485,539 @@ static int paCallback( const void *inputBuffer, void *outputBuffer,
     return(paContinue);
 }
 
+/* paTimedCallback() - The callback actually attached to PortAudio streams.
+ *
+ * Executes paCallback and measures the duration of each invocation, including
+ * all slave processing in case of a master device. Slaves are called by their
+ * master directly via paCallback and therefore not timed separately. The timing
+ * fields are only ever written by the audio thread, so no locking is needed:
+ */
+static int paTimedCallback( const void *inputBuffer, void *outputBuffer,
+							unsigned long framesPerBuffer,
+							const PaStreamCallbackTimeInfo* timeInfo,
+							PaStreamCallbackFlags statusFlags,
+							void *userData )
+{
+	PsychPADevice* dev = (PsychPADevice*) userData;
+	double tStart, tEnd;
+	int rc;
+
+	PsychGetAdjustedPrecisionTimerSeconds(&tStart);
+	rc = paCallback(inputBuffer, outputBuffer, framesPerBuffer, timeInfo, statusFlags, userData);
+	PsychGetAdjustedPrecisionTimerSeconds(&tEnd);
+
+	if (dev) {
+		dev->cbLastDuration = tEnd - tStart;
+		if (dev->cbLastDuration > dev->cbMaxDuration) dev->cbMaxDuration = dev->cbLastDuration;
+		dev->cbTotalDuration += dev->cbLastDuration;
+		dev->cbTimedCalls++;
+
+		// Update histograms of callback duration and of the deviation of the interval between
+		// callback invocations from the nominal duration of one buffer:
+		PsychPAHandleTimingReset(dev);
+		PsychPAHistogramAdd(&(dev->timingStats.cbDuration), dev->cbLastDuration);
+		if (dev->timingStats.lastCbEntry > 0) PsychPAHistogramAdd(&(dev->timingStats.cbJitter), fabs(tStart - dev->timingStats.lastCbEntry - ((double) framesPerBuffer / dev->streaminfo->sampleRate)));
+		dev->timingStats.lastCbEntry = tStart;
+	}
+
+	return(rc);
+}
+
+// Write a little-endian 16 or 32 bit value to a WAV file header:
+static void PsychPAWriteLE(FILE* fd, unsigned int value, int nbytes)
+{
+	while (nbytes-- > 0) {
+		fputc((int) (value & 0xff), fd);
+		value >>= 8;
+	}
+}
+
+// Write or rewrite the header of a WAV file with 'nrframes' sample frames of the given sample
+// 'format'. If 'headerBytes' is non-zero, pad the header with a JUNK chunk to exactly that many
+// bytes, e.g., to start the sound data at a disk block boundary. A data size which doesn't fit
+// into the 32 bit size fields is stored as 0xFFFFFFFF, meaning "sound data up to end of file":
+static void PsychPAWriteWavHeader(FILE* fd, int channels, int samplerate, psych_int64 nrframes, int format, int headerBytes)
+{
+	int bytesPerSample = PsychPABytesPerSample(format);
+	int junkBytes = (headerBytes > 52) ? headerBytes - 52 : 0;
+	psych_int64 datasize = nrframes * channels * bytesPerSample;
+	psych_int64 riffsize = datasize + 36 + ((junkBytes > 0) ? 8 + junkBytes : 0);
+
+	fwrite("RIFF", 1, 4, fd);
+	PsychPAWriteLE(fd, (riffsize > 0xFFFFFFFFLL) ? 0xFFFFFFFF : (unsigned int) riffsize, 4);
+	fwrite("WAVEfmt ", 1, 8, fd);
+	PsychPAWriteLE(fd, 16, 4);							// Size of fmt chunk.
+	PsychPAWriteLE(fd, (format == PSYCH_PA_FORMAT_FLOAT32) ? 3 : 1, 2);	// WAVE_FORMAT_IEEE_FLOAT or WAVE_FORMAT_PCM.
+	PsychPAWriteLE(fd, channels, 2);
+	PsychPAWriteLE(fd, samplerate, 4);
+	PsychPAWriteLE(fd, samplerate * channels * bytesPerSample, 4);	// Bytes per second.
+	PsychPAWriteLE(fd, channels * bytesPerSample, 2);	// Bytes per sample frame.
+	PsychPAWriteLE(fd, 8 * bytesPerSample, 2);			// Bits per sample.
+
+	if (junkBytes > 0) {
+		fwrite("JUNK", 1, 4, fd);
+		PsychPAWriteLE(fd, junkBytes, 4);
+		while (junkBytes-- > 0) fputc(0, fd);
+	}
+
+	fwrite("data", 1, 4, fd);
+	PsychPAWriteLE(fd, (datasize > 0xFFFFFFFFLL) ? 0xFFFFFFFF : (unsigned int) datasize, 4);
+}
+
+/* PsychPAVirtualStreamThreadMain() - Clock thread of a virtual null device.
+ *
+ * Executes the processing callback for one buffer after the other, advancing the
+ * virtual sample clock by one buffer duration per callback. In realtime mode, we
+ * sleep until the virtual clock catches up with the system clock, otherwise we
+ * run as fast as the engine can process the buffers. The timestamps passed to the
+ * callback are taken from the virtual clock, which is in the GetSecs() timebase.
+ */
+static void* PsychPAVirtualStreamThreadMain(void* vsToCast)
+{
+	PsychPAVirtualStream* vs = (PsychPAVirtualStream*) vsToCast;
+	PaStreamCallbackTimeInfo timeInfo;
+	double tRealStart, tVirtualStart, bufferDuration;
+	psych_int64 nbuffers = 0;
+	int rc = paContinue;
+
+	PsychGetAdjustedPrecisionTimerSeconds(&tRealStart);
+	tVirtualStart = vs->virtualTime;
+	bufferDuration = (double) vs->framesPerBuffer / vs->info.sampleRate;
+
+	while (!vs->stopRequest && (rc == paContinue)) {
+		timeInfo.currentTime = vs->virtualTime;
+		timeInfo.outputBufferDacTime = vs->virtualTime;
+		timeInfo.inputBufferAdcTime = vs->virtualTime;
+
+		rc = paTimedCallback((const void*) vs->inBuffer, (void*) vs->outBuffer, vs->framesPerBuffer, &timeInfo, 0, (void*) vs->dev);
+
+		// Store output to WAV file, if any:
+		if (vs->wavFile && vs->outBuffer) {
+			fwrite(vs->outBuffer, sizeof(float) * vs->dev->outchannels, vs->framesPerBuffer, vs->wavFile);
+			vs->wavFrames += vs->framesPerBuffer;
+		}
+
+		// Advance virtual clock. Computed from the buffer count to avoid accumulating roundoff error:
+		nbuffers++;
+		vs->callbacks++;
+		vs->virtualTime = tVirtualStart + (double) nbuffers * bufferDuration;
+
+		// Pace in realtime if requested:
+		if (!vs->freeRunning) PsychWaitUntilSeconds(tRealStart + (vs->virtualTime - tVirtualStart));
+	}
+
+	// Callback processing finished or stop requested:
+	vs->active = 0;
+	PAStreamFinishedCallback((void*) vs->dev);
+
+	return(NULL);
+}
+
+// Create a virtual null device stream for device 'dev':
+static PsychPAVirtualStream* PsychPACreateVirtualStream(PsychPADevice* dev, double samplerate, unsigned long framesPerBuffer, psych_bool freeRunning, const char* wavFilename)
+{
+	PsychPAVirtualStream* vs = (PsychPAVirtualStream*) calloc(1, sizeof(PsychPAVirtualStream));
+	if (NULL == vs) return(NULL);
+
+	vs->dev = dev;
+	vs->info.structVersion = 1;
+	vs->info.inputLatency = 0.0;
+	vs->info.outputLatency = 0.0;
+	vs->info.sampleRate = samplerate;
+	vs->stopped = 1;
+	vs->freeRunning = freeRunning;
+	vs->framesPerBuffer = framesPerBuffer;
+
+	if (dev->opmode & kPortAudioPlayBack) vs->outBuffer = (float*) calloc(framesPerBuffer * dev->outchannels, sizeof(float));
+	if (dev->opmode & kPortAudioCapture) vs->inBuffer = (float*) calloc(framesPerBuffer * dev->inchannels, sizeof(float));
+	if (((dev->opmode & kPortAudioPlayBack) && (NULL == vs->outBuffer)) || ((dev->opmode & kPortAudioCapture) && (NULL == vs->inBuffer))) {
+		free(vs->outBuffer);
+		free(vs->inBuffer);
+		free(vs);
+		return(NULL);
+	}
+
+	if (wavFilename && (dev->opmode & kPortAudioPlayBack)) {
+		vs->wavFile = fopen(wavFilename, "wb");
+		if (vs->wavFile) {
+			PsychPAWriteWavHeader(vs->wavFile, (int) dev->outchannels, (int) samplerate, 0, PSYCH_PA_FORMAT_FLOAT32, 0);
+		}
+		else if (verbosity > 1) {
+			printf("PsychPortAudio-WARNING: Could not create WAV output file %s for virtual device. Output will only go to memory.\n", wavFilename);
+		}
+	}
+
+	return(vs);
+}
+
+// Destroy a stopped virtual null device stream, finalize its WAV file, if any:
+static void PsychPADestroyVirtualStream(PsychPAVirtualStream* vs)
+{
+	if (vs->wavFile) {
+		// Rewrite header with final size:
+		fseek(vs->wavFile, 0, SEEK_SET);
+		PsychPAWriteWavHeader(vs->wavFile, (int) vs->dev->outchannels, (int) vs->info.sampleRate, vs->wavFrames, PSYCH_PA_FORMAT_FLOAT32, 0);
+		fclose(vs->wavFile);
+	}
+
+	free(vs->outBuffer);
+	free(vs->inBuffer);
+	free(vs);
+}
+
+static PaError PsychPAStartStream(PsychPADevice* dev)
+{
+	PsychPAVirtualStream* vs = dev->virtualStream;
+	double now;
+
+	if (NULL == vs) return(Pa_StartStream(dev->stream));
+
+	if (!vs->stopped) return(paStreamIsNotStopped);
+
+	// Virtual clock must never run behind the system clock at start, or we'd have to play catch-up:
+	PsychGetAdjustedPrecisionTimerSeconds(&now);
+	if (vs->virtualTime < now) vs->virtualTime = now;
+
+	vs->stopRequest = 0;
+	vs->active = 1;
+	vs->stopped = 0;
+	if (PsychCreateThread(&(vs->thread), NULL, PsychPAVirtualStreamThreadMain, (void*) vs)) {
+		vs->active = 0;
+		vs->stopped = 1;
+		return(paInternalError);
+	}
+	vs->threadRunning = TRUE;
+
+	return(paNoError);
+}
+
+static PaError PsychPAStopStream(PsychPADevice* dev)
+{
+	PsychPAVirtualStream* vs = dev->virtualStream;
+
+	if (NULL == vs) return(Pa_StopStream(dev->stream));
+
+	if (vs->stopped) return(paStreamIsStopped);
+
+	// Request thread shutdown and wait for it:
+	vs->stopRequest = 1;
+	if (vs->threadRunning) {
+		PsychDeleteThread(&(vs->thread));
+		vs->threadRunning = FALSE;
+	}
+
+	vs->active = 0;
+	vs->stopped = 1;
+
+	return(paNoError);
+}
+
+static PaError PsychPAAbortStream(PsychPADevice* dev)
+{
+	// A virtual stream has no pending hardware buffers to drop, so abort == stop:
+	if (dev->virtualStream) return(PsychPAStopStream(dev));
+	return(Pa_AbortStream(dev->stream));
+}
+
+static int PsychPAIsStreamActive(PsychPADevice* dev)
+{
+	if (dev->virtualStream) return(dev->virtualStream->active);
+	return(Pa_IsStreamActive(dev->stream));
+}
+
+static int PsychPAIsStreamStopped(PsychPADevice* dev)
+{
+	if (dev->virtualStream) return(dev->virtualStream->stopped);
+	return(Pa_IsStreamStopped(dev->stream));
+}
+
+// Parse the header of a sound file. 'base' points to the first 'size' bytes of the file,
+// which has 'filesize' bytes in total. WAV files define 'channels', 'sampleFormat' and
+// 'sampleRate' themselves, for other files - treated as raw sound files - the caller provides
+// 'channels' and 'sampleFormat' and the size of the file header 'headerBytes' to skip,
+// and 'sampleRate' is returned as NaN. On success, returns NULL and assigns the byte
+// offset 'dataoffset' and byte size 'datasize' of the sound data in the file, clamped to
+// whole sample frames. On failure, returns an error message:
+static const char* PsychPAParseSoundFileHeader(const unsigned char* base, psych_int64 size, psych_int64 filesize, psych_int64 headerBytes,
+											   int* channels, int* sampleFormat, double* sampleRate, psych_int64* dataoffset, psych_int64* datasize)
+{
+	const unsigned char* chunk;
+	psych_int64 chunksize, pos;
+	int wavformat = 0, wavbits = 0;
+
+	*sampleRate = PsychGetNanValue();
+	*dataoffset = 0;
+	*datasize = 0;
+
+	// WAV file? All multi-byte header fields are in little-endian byte order:
+	if ((size >= 12) && !memcmp(base, "RIFF", 4) && !memcmp(base + 8, "WAVE", 4)) {
+		// Walk the chunks until we have found the format and sound data chunks:
+		for (pos = 12; pos + 8 <= size; pos += 8 + chunksize + (chunksize & 1)) {
+			chunk = base + pos;
+			chunksize = (psych_int64) ((unsigned int) chunk[4] | ((unsigned int) chunk[5] << 8) | ((unsigned int) chunk[6] << 16) | ((unsigned int) chunk[7] << 24));
+
+			if (!memcmp(chunk, "fmt ", 4) && (chunksize >= 16) && (pos + 8 + 16 <= size)) {
+				wavformat = chunk[8] | (chunk[9] << 8);
+				*channels = chunk[10] | (chunk[11] << 8);
+				*sampleRate = (double) ((unsigned int) chunk[12] | ((unsigned int) chunk[13] << 8) | ((unsigned int) chunk[14] << 16) | ((unsigned int) chunk[15] << 24));
+				wavbits = chunk[22] | (chunk[23] << 8);
+
+				// WAVE_FORMAT_EXTENSIBLE: Actual format is in the first two bytes of the subformat GUID:
+				if ((wavformat == 0xFFFE) && (chunksize >= 40) && (pos + 8 + 26 <= size)) wavformat = chunk[32] | (chunk[33] << 8);
+			}
+
+			if (!memcmp(chunk, "data", 4)) {
+				// A size of 0xFFFFFFFF means the sound data extends to the end of the file:
+				*dataoffset = pos + 8;
+				*datasize = (chunksize == 0xFFFFFFFFLL) ? filesize - *dataoffset : chunksize;
+				break;
+			}
+		}
+
+		// Map WAV sample format to ours: 1 = PCM integer, 3 = IEEE float:
+		*sampleFormat = -1;
+		if ((wavformat == 1) && (wavbits == 16)) *sampleFormat = PSYCH_PA_FORMAT_INT16;
+		if ((wavformat == 1) && (wavbits == 24)) *sampleFormat = PSYCH_PA_FORMAT_INT24;
+		if ((wavformat == 3) && (wavbits == 32)) *sampleFormat = PSYCH_PA_FORMAT_FLOAT32;
+
+		if ((*dataoffset == 0) || (*sampleFormat < 0) || (*channels < 1)) {
+			if (verbosity > 1) printf("PsychPortAudio-ERROR: WAV file has %s, format %i with %i bits per sample.\n", (*dataoffset == 0) ? "no sound data" : "sound data", wavformat, wavbits);
+			return("Unsupported or invalid WAV file. Only 16 bit or 24 bit integer, or 32 bit floating point sound data is supported.");
+		}
+
+		if (*channels > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) {
+			if (verbosity > 1) printf("PsychPortAudio-ERROR: WAV file has %i channels, but at most %i channels are supported.\n", *channels, MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE);
+			return("Unsupported WAV file with too many channels.");
+		}
+	}
+	else {
+		// Raw sound file:
+		if ((*channels < 1) || (*channels > MAX_PSYCH_AUDIO_CHANNELS_PER_DEVICE) || (*sampleFormat < PSYCH_PA_FORMAT_FLOAT32) || (*sampleFormat > PSYCH_PA_FORMAT_INT24) || (headerBytes < 0)) {
+			return("Not a WAV file. For raw sound files you must provide a valid number of 'channels' and a 'sampleFormat' of 0, 1 or 2, and optionally a non-negative 'headerBytes'.");
+		}
+
+		*dataoffset = headerBytes;
+		*datasize = filesize - headerBytes;
+	}
+
+	// Clamp sound data to file size, e.g., for truncated files or files still being written, and to whole sample frames:
+	if ((*dataoffset >= filesize) || (*datasize <= 0) || (*dataoffset + *datasize > filesize)) *datasize = filesize - *dataoffset;
+	*datasize -= *datasize % ((psych_int64) *channels * PsychPABytesPerSample(*sampleFormat));
+	if (*datasize <= 0) return("Sound file doesn't contain any sound data!");
+
+	return(NULL);
+}
+
+// Seek to byte 'offset' of 'file', relative to 'whence'. Return new file position, or -1 on error:
+static psych_int64 PsychPASeekFile(FILE* file, psych_int64 offset, int whence)
+{
+#if PSYCH_SYSTEM == PSYCH_WINDOWS
+	if (_fseeki64(file, offset, whence)) return(-1);
+	return((psych_int64) _ftelli64(file));
+#else
+	if (fseeko(file, (off_t) offset, whence)) return(-1);
+	return((psych_int64) ftello(file));
+#endif
+}
+
+// Read as much sound data as fits into the ring buffer of the device, at most 'chunkFrames'
+// frames, convert and append it. Return number of appended sample frames:
+static psych_int64 PsychPADiskStreamFill(PsychPADiskStream* ds)
+{
+	PsychPADevice* dev = ds->dev;
+	psych_int64 ringsize = dev->outputbuffersize / (psych_int64) sizeof(float);
+	psych_int64 framebytes = ds->channels * PsychPABytesPerSample(ds->format);
+	psych_int64 freeframes, nbytes, got, nsamples, first, wp;
+	float gain = (ds->format == PSYCH_PA_FORMAT_FLOAT32) ? (float) PA_ANTICLAMPGAIN : 1.0f;
+
+	if (ds->eof) return(0);
+
+	// Free space in ring, keeping the same safety margin of one frame as 'FillBuffer':
+	wp = dev->writeposition;
+	freeframes = (ringsize - (wp - dev->playposition) - ds->channels) / ds->channels;
+	if (freeframes > ds->chunkFrames) freeframes = ds->chunkFrames;
+	if (freeframes <= 0) return(0);
+
+	nbytes = freeframes * framebytes;
+	if (nbytes > ds->remaining) nbytes = ds->remaining;
+
+	got = (psych_int64) fread(ds->readBuffer, 1, (size_t) nbytes, ds->file);
+	ds->remaining -= got;
+	got -= got % framebytes;
+	nsamples = (got / framebytes) * ds->channels;
+
+	// Convert into the ring, taking wraparound into account:
+	first = ringsize - (wp % ringsize);
+	if (first > nsamples) first = nsamples;
+	PsychPAConvertSamples(dev->outputbuffer + (wp % ringsize), ds->readBuffer, ds->format, 0, first, gain, 0);
+	PsychPAConvertSamples(dev->outputbuffer, ds->readBuffer, ds->format, first, nsamples - first, gain, 0);
+
+	// Make sure all sound data is visible to paCallback before the new writeposition is:
+	PsychPAMemoryBarrier();
+	dev->writeposition = wp + nsamples;
+
+	// End of file or read error? Then this was the last sound data. paCallback checks 'eof'
+	// before it reads the writeposition, so it always sees the final writeposition:
+	if ((got < nbytes) || (ds->remaining <= 0)) {
+		PsychPAMemoryBarrier();
+		ds->eof = 1;
+	}
+
+	return(nsamples / ds->channels);
+}
+
+// Main function of the prefetch thread:
+static void* PsychPADiskStreamThreadMain(void* arg)
+{
+	PsychPADiskStream* ds = (PsychPADiskStream*) arg;
+
+	while (!ds->stopRequest && !ds->eof) {
+		// Sleep a bit if the ring buffer is full:
+		if (PsychPADiskStreamFill(ds) == 0) PsychYieldIntervalSeconds(ds->pollInterval);
+	}
+
+	return(NULL);
+}
+
+// Stop prefetch thread of disk stream 'ds', close its file and release it:
+static void PsychPADestroyDiskStream(PsychPADiskStream* ds)
+{
+	if (NULL == ds) return;
+
+	if (ds->threadRunning) {
+		ds->stopRequest = 1;
+		PsychDeleteThread(&(ds->thread));
+		ds->threadRunning = FALSE;
+	}
+
+	if (ds->file) fclose(ds->file);
+	free(ds->readBuffer);
+	free(ds);
+}
+
+// Header size of WAV files written by a capture writer: Sound data starts at a disk block boundary.
+#define PSYCH_PA_CAPTURE_HEADERBYTES 4096
+
+// Write out the pending content of the writeBuffer, account frames which failed to write as dropped:
+static void PsychPACaptureWriterFlush(PsychPACaptureWriter* cw)
+{
+	psych_int64 framebytes = cw->channels * PsychPABytesPerSample(cw->format);
+	psych_int64 written;
+
+	if (cw->fill <= 0) return;
+
+	written = (psych_int64) fwrite(cw->writeBuffer, 1, (size_t) cw->fill, cw->file);
+	cw->framesWritten += written / framebytes;
+	if (written < cw->fill) {
+		cw->droppedFrames += (cw->fill - written) / framebytes;
+		if (verbosity > 1) printf("PsychPortAudio-WARNING: Write error while capturing to disk, e.g., due to a full disk. Some sound data will be lost!\n");
+	}
+
+	cw->fill = 0;
+}
+
+// Move captured sound data from the inputbuffer into the file. Return number of drained samples:
+static psych_int64 PsychPACaptureWriterDrain(PsychPACaptureWriter* cw)
+{
+	PsychPADevice* dev = cw->dev;
+	psych_int64 insbsize = dev->inputbuffersize / (psych_int64) sizeof(float);
+	psych_int64 bytesPerSample = PsychPABytesPerSample(cw->format);
+	psych_int64 recposition, readposition, safe, count, n, total = 0;
+
+	// Fetch the published recposition first, and only afterwards read the data it covers:
+	recposition = dev->recposition;
+	PsychPAMemoryBarrier();
+	readposition = dev->readposition;
+
+	// Data older than one buffer minus one callback batch may get overwritten by paCallback
+	// while we read it, so treat it as lost:
+	safe = insbsize - (psych_int64) dev->batchsize * cw->channels;
+	if (safe < cw->channels) safe = cw->channels;
+	if (recposition - readposition > safe) {
+		count = recposition - safe;
+		count += (cw->channels - (count - readposition) % cw->channels) % cw->channels;
+		cw->droppedFrames += (count - readposition) / cw->channels;
+		readposition = count;
+		if (verbosity > 1) printf("PsychPortAudio-WARNING: Overflow of audio capture buffer while capturing to disk. Some sound data will be lost!\n");
+	}
+
+	while (readposition < recposition) {
+		// Convert as much as fits into the writeBuffer, without crossing the end of the ring:
+		count = recposition - readposition;
+		n = (cw->blockBytes - cw->fill) / bytesPerSample;
+		if (count > n) count = n;
+		n = insbsize - (readposition % insbsize);
+		if (count > n) count = n;
+
+		if (cw->format == PSYCH_PA_FORMAT_FLOAT32) {
+			memcpy(cw->writeBuffer + cw->fill, dev->inputbuffer + (readposition % insbsize), (size_t) (count * sizeof(float)));
+		}
+		else {
+			PsychPAEncodeSamples(cw->writeBuffer + cw->fill, cw->format, 0, NULL, dev->inputbuffer + (readposition % insbsize), count);
+		}
+
+		cw->fill += count * bytesPerSample;
+		readposition += count;
+		total += count;
+
+		// Full block? Write it:
+		if (cw->fill >= cw->blockBytes) PsychPACaptureWriterFlush(cw);
+	}
+
+	dev->readposition = readposition;
+
+	return(total);
+}
+
+// Main function of the writer thread:
+static void* PsychPACaptureWriterThreadMain(void* arg)
+{
+	PsychPACaptureWriter* cw = (PsychPACaptureWriter*) arg;
+
+	while (!cw->stopRequest) {
+		// Sleep a bit if there isn't enough captured sound data for a full block:
+		if ((cw->dev->recposition - cw->dev->readposition) * PsychPABytesPerSample(cw->format) < cw->blockBytes - cw->fill) {
+			PsychYieldIntervalSeconds(cw->pollInterval);
+			continue;
+		}
+
+		PsychPACaptureWriterDrain(cw);
+	}
+
+	// Write out all remaining data:
+	PsychPACaptureWriterDrain(cw);
+	PsychPACaptureWriterFlush(cw);
+
+	return(NULL);
+}
+
+// Stop writer thread of capture writer 'cw' after it has written all pending data, finalize
+// and close its file and release it. Optionally return its final statistics:
+static void PsychPADestroyCaptureWriter(PsychPACaptureWriter* cw, psych_int64* framesWritten, psych_int64* droppedFrames)
+{
+	if (NULL == cw) return;
+
+	if (cw->threadRunning) {
+		cw->stopRequest = 1;
+		PsychDeleteThread(&(cw->thread));
+		cw->threadRunning = FALSE;
+	}
+
+	if (cw->file) {
+		// Rewrite WAV header with final size:
+		if (cw->isWav && (PsychPASeekFile(cw->file, 0, SEEK_SET) == 0)) {
+			PsychPAWriteWavHeader(cw->file, (int) cw->channels, (int) cw->dev->streaminfo->sampleRate, cw->framesWritten, cw->format, PSYCH_PA_CAPTURE_HEADERBYTES);
+		}
+		fclose(cw->file);
+	}
+
+	if (framesWritten) *framesWritten = cw->framesWritten;
+	if (droppedFrames) *droppedFrames = cw->droppedFrames;
+
+	free(cw->writeBuffer);
+	free(cw);
+}
+
 void PsychPACloseStream(int id)
 {
 	int pamaster, i;
@@ -1570,6 +4046,10 @@ void PsychPACloseStream(int id)
 			// for real audio devices and continue with release operations for our data structures,
 			// buffers and sync primitives.
 			
+			// A straggling render worker of the master may still render us or our parent, after the
+			// master missed its rendering deadline. Wait for it to finish:
+			while (audiodevices[pamaster].renderPool && PsychPARenderJobsInFlight(audiodevices[pamaster].renderPool)) PsychYieldIntervalSeconds(yieldInterval);
+
 			// Find our slot in the master:
 			for (i=0; (i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE) && (audiodevices[pamaster].slaves[i] != id); i++);
 
@@ -1596,10 +4076,10 @@ void PsychPACloseStream(int id)
 			// Portaudio shutdown.
 			
 			// Stop, shutdown and release audio stream:
-			Pa_StopStream(stream);
+			if (!PsychPAIsStreamStopped(&audiodevices[id])) PsychPAStopStream(&audiodevices[id]);
 			
 			// Unregister the stream finished callback:
-			Pa_SetStreamFinishedCallback(stream, NULL);
+			if (!audiodevices[id].virtualStream) Pa_SetStreamFinishedCallback(stream, NULL);
 			
 			// Our device thread, callbacks and hardware are stopped, all mutexes are unlocked,
 			// all our potential slaves are inactive as well. We can safely destroy our slaves,
@@ -1618,14 +4098,36 @@ void PsychPACloseStream(int id)
 			
 			// Destruction for both master- and regular audio devices:
 			
-			// Close and destroy the hardware portaudio stream:
-			Pa_CloseStream(stream);
+			// Close and destroy the hardware portaudio stream, or our virtual stream:
+			if (audiodevices[id].virtualStream) {
+				PsychPADestroyVirtualStream(audiodevices[id].virtualStream);
+			}
+			else {
+				Pa_CloseStream(stream);
+			}
 		}
 		
 		// Common destruct path for all types of devices:
 		
 		// Release stream reference to now dead stream:
 		audiodevices[id].stream = NULL;
+		audiodevices[id].virtualStream = NULL;
+
+		// Stop and release disk streaming source, if any:
+		PsychPADestroyDiskStream(audiodevices[id].diskStream);
+		audiodevices[id].diskStream = NULL;
+
+		// Write out remaining captured data and close capture file, if any:
+		PsychPADestroyCaptureWriter(audiodevices[id].captureWriter, NULL, NULL);
+		audiodevices[id].captureWriter = NULL;
+
+		// Release sample rate converter, if any:
+		PsychPADestroyResampler(audiodevices[id].resampler);
+		audiodevices[id].resampler = NULL;
+
+		// Stop and release render worker threads, if any:
+		if (audiodevices[id].renderPool) PsychPADestroyRenderPool(audiodevices[id].renderPool);
+		audiodevices[id].renderPool = NULL;
 		
 		// Free associated sound outputbuffer:
 		if(audiodevices[id].outputbuffer) {
@@ -1642,11 +4144,7 @@ void PsychPACloseStream(int id)
 		}
 
 		// Free associated schedule, if any:
-		if(audiodevices[id].schedule) {
-			free(audiodevices[id].schedule);
-			audiodevices[id].schedule = NULL;
-			audiodevices[id].schedule_size = 0;
-		}				
+		PsychPADestroySchedule(&audiodevices[id]);
 
 		// Free associated sound intermixbuffers:
 		if(audiodevices[id].slaveOutBuffer) {
@@ -1681,6 +4179,14 @@ void PsychPACloseStream(int id)
 			audiodevices[id].outputmappings = NULL;
 		}				
 
+		// Free crossfade tail buffer, which also holds the tail gains:
+		if (audiodevices[id].xfadeBuffer) {
+			free(audiodevices[id].xfadeBuffer);
+			audiodevices[id].xfadeBuffer = NULL;
+			audiodevices[id].xfadeGains = NULL;
+			audiodevices[id].xfadeFrames = 0;
+		}
+
 		// Free vector of outChannelVolumes:
 		if(audiodevices[id].outChannelVolumes) {
 			free(audiodevices[id].outChannelVolumes);
@@ -1712,27 +4218,33 @@ void InitializeSynopsis(void)
 	synopsis[i++] = "count = PsychPortAudio('GetOpenDeviceCount');";
 	synopsis[i++] = "devices = PsychPortAudio('GetDevices' [,devicetype] [, deviceIndex]);";
 	synopsis[i++] = "\nGeneral settings:\n";
-	synopsis[i++] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend]);";
+	synopsis[i++] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend, useSIMD] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend] [, useSIMD]);";
 	synopsis[i++] = "oldRunMode = PsychPortAudio('RunMode', pahandle [,runMode]);";
 	synopsis[i++] = "\n\nDevice setup and shutdown:\n";
-	synopsis[i++] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0]);";
-	synopsis[i++] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels]);";
+	synopsis[i++] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0][, virtualOutputFile]);";
+	synopsis[i++] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels][, freq][, resampleQuality=2]);";
+	synopsis[i++] = "[oldNumThreads, oldDeadline, deadlineMisses] = PsychPortAudio('UseRenderThreads', pamaster [, numThreads][, deadline]);";
 	synopsis[i++] = "PsychPortAudio('Close' [, pahandle]);";
 	synopsis[i++] = "oldOpMode = PsychPortAudio('SetOpMode', pahandle [, opModeOverride]);";
 	synopsis[i++] = "oldbias = PsychPortAudio('LatencyBias', pahandle [,biasSecs]);";
 	synopsis[i++] =	"[oldMasterVolume, oldChannelVolumes] = PsychPortAudio('Volume', pahandle [, masterVolume][, channelVolumes]);";
+	synopsis[i++] =	"[oldAttack, oldRelease, oldCrossfade] = PsychPortAudio('SetEnvelope', pahandle [, attackSecs][, releaseSecs][, crossfadeSecs]);";
 	synopsis[i++] = "enable = PsychPortAudio('DirectInputMonitoring', pahandle, enable [, inputChannel = -1][, outputChannel = 0][, gainLevel = 0.0][, stereoPan = 0.5]);";
 	synopsis[i++] = "[underflow, nextSampleStartIndex, nextSampleETASecs] = PsychPortAudio('FillBuffer', pahandle, bufferdata [, streamingrefill=0][, startIndex=Append]);";
-	synopsis[i++] =	"bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata);";
+	synopsis[i++] =	"bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata [, sampleFormat]);";
+	synopsis[i++] =	"[bufferhandle, sampleRate, channels, frames] = PsychPortAudio('CreateBufferFromFile', filename [, channels][, sampleFormat][, headerBytes]);";
+	synopsis[i++] =	"[sampleRate, channels, frames] = PsychPortAudio('StreamFromFile', pahandle [, filename][, lookaheadSecs=2][, channels][, sampleFormat][, headerBytes]);";
 	synopsis[i++] =	"PsychPortAudio('DeleteBuffer'[, bufferhandle] [, waitmode]);";
 	synopsis[i++] =	"PsychPortAudio('RefillBuffer', pahandle [, bufferhandle=0], bufferdata [, startIndex=0]);";
 	synopsis[i++] = "PsychPortAudio('SetLoop', pahandle[, startSample=0][, endSample=max][, UnitIsSeconds=0]);";
 	synopsis[i++] = "startTime = PsychPortAudio('Start', pahandle [, repetitions=1] [, when=0] [, waitForStart=0] [, stopTime=inf] [, resume=0]);";
 	synopsis[i++] = "startTime = PsychPortAudio('RescheduleStart', pahandle, when [, waitForStart=0] [, repetitions] [, stopTime]);";
 	synopsis[i++] = "status = PsychPortAudio('GetStatus' pahandle);";
-	synopsis[i++] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, singleType=0]);";
+	synopsis[i++] = "stats = PsychPortAudio('GetTimingStats', pahandle [, reset=0]);";
+	synopsis[i++] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, dataType=0][, bufferPtr][, bufferFrames]);";
+	synopsis[i++] = "[framesWritten, droppedFrames] = PsychPortAudio('CaptureToFile', pahandle [, filename][, sampleFormat=0][, bufferSecs=2][, rawFile=0]);";
 	synopsis[i++] = "[startTime endPositionSecs xruns estStopTime] = PsychPortAudio('Stop', pahandle [,waitForEndOfPlayback=0] [, blockUntilStopped=1] [, repetitions] [, stopTime]);";
-	synopsis[i++] =	"PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128]);";
+	synopsis[i++] =	"PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128][, growable = 0]);";
 	synopsis[i++] =	"[success, freeslots] = PsychPortAudio('AddToSchedule', pahandle [, bufferHandle=0][, repetitions=1][, startSample=0][, endSample=max][, UnitIsSeconds=0][, specialFlags=0]);";
 
 	synopsis[i++] = NULL;  //this tells PsychDisplayScreenSynopsis where to stop
@@ -1806,11 +4318,13 @@ PsychError PsychPortAudioExit(void)
 		}
 		audiodevicecount = 0;
 		
-		// Delete all audio buffers and the bufferlist itself:
+		// Stop prefetching, then delete all audio buffers and the bufferlist itself:
+		PsychPAStopPrefetchThread();
 		PsychPADeleteAllAudioBuffers();
 		
-		// Release audiobufferlist mutex lock:
+		// Release audiobufferlist and prefetch mutex locks:
 		PsychDestroyMutex(&bufferListmutex);
+		PsychDestroyMutex(&prefetchmutex);
 		
 		// Shutdown PortAudio itself:
 		err = Pa_Terminate();
@@ -1902,10 +4416,19 @@ void PsychPortAudioInitialize(void)
 		audiodevicecount=0;
 
 		// Init audio bufferList to empty and Mutex to unlocked:
+		bufferSlabs = NULL;
+		bufferSlabCount = 0;
 		bufferListCount = 0;
-		bufferList = NULL;
+		bufferFreeList = -1;
+		bufferListReferences = 0;
 		PsychInitMutex(&bufferListmutex);
 
+		// No prefetch thread yet, it is started on demand:
+		prefetchRequestCount = 0;
+		prefetchThreadRunning = FALSE;
+		prefetchStopRequest = 0;
+		PsychInitMutex(&prefetchmutex);
+
 		// On Vista systems and later, we assume everything will be fine wrt. to timing and multi-core
 		// systems, but still perform consistency checks at each call to PsychGetPrecisionTimerSeconds().
 		// Therefore we don't lock our threads to a single core by default. On pre-Vista systems, we
@@ -1920,14 +4443,19 @@ void PsychPortAudioInitialize(void)
  */
 PsychError PSYCHPORTAUDIOOpen(void) 
 {
- 	static char useString[] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0]);";
-	//															1			 2		 3					4		5			6			  7					  8					  9
+ 	static char useString[] = "pahandle = PsychPortAudio('Open' [, deviceid][, mode][, reqlatencyclass][, freq][, channels][, buffersize][, suggestedLatency][, selectchannels][, specialFlags=0][, virtualOutputFile]);";
+	//															1			 2		 3					4		5			6			  7					  8					  9					10
 	static char synopsisString[] = 
 		"Open a PortAudio audio device and initialize it. Returns a 'pahandle' device handle for the device. "
 		"All parameters are optional and have reasonable defaults. 'deviceid' Index to select amongst multiple "
 		"logical audio devices supported by PortAudio. Defaults to whatever the systems default sound device is. "
 		"Different device id's may select the same physical device, but controlled by a different low-level sound "
-		"system. E.g., Windows has about five different sound subsystems. 'mode' Mode of operation. Defaults to "
+		"system. E.g., Windows has about five different sound subsystems. A 'deviceid' of -2 opens a virtual null device "
+		"which doesn't use any sound hardware. Its processing is driven by an internal thread at a virtual sample clock, "
+		"either in realtime or as fast as possible (see 'specialFlags' 32). Its output goes to memory only, where you can "
+		"record it with an output capture slave device, or optionally into the WAV file 'virtualOutputFile'. Captured "
+		"sound is always silence. This is useful for benchmarking and for testing scripts on machines without sound "
+		"hardware. 'mode' Mode of operation. Defaults to "
 		"1 == sound playback only. Can be set to 2 == audio capture, or 3 for simultaneous capture and playback of sound. "
 		"Note however that mode 3 (full duplex) does not work reliably on all sound hardware. On some hardware this mode "
 		"may crash Matlab! There is also a special monitoring mode == 7, which only works for full duplex devices "
@@ -1982,11 +4510,16 @@ PsychError PSYCHPORTAUDIOOpen(void)
 		"audio quantization artifacts. Dithering can improve signal to noise ratio and quality of output sound, but it is more "
 		"compute intense and it could change very low-level properties of the audio signal, because what you hear is not exactly "
 		"what you specified.\n"
-		"16 = Never dither audio data, not even in normal mode.\n\n";
+		"16 = Never dither audio data, not even in normal mode.\n"
+		"32 = Run the virtual clock of a virtual null device (deviceid -2) as fast as possible, instead of in realtime.\n\n"
+		"'virtualOutputFile' Optional name of a WAV file into which all sound output of a virtual null device is written "
+		"in 32 bit floating point format. Ignored for real sound devices.\n\n";
 
 	static char seeAlsoString[] = "Close GetDeviceSettings ";	 
   	
 	int freq, buffersize, latencyclass, mode, deviceid, i, numel, specialFlags;
+	psych_bool isvirtual;
+	char* virtualOutputFile = NULL;
 	int* nrchannels;
 	int  mynrchannels[2];
 	int  m, n, p;
@@ -2018,7 +4551,7 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(9));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(10));    // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
@@ -2034,16 +4567,19 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 	
-	// Sanity check: Any hardware found?
-	if (Pa_GetDeviceCount() == 0) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system! Either your machine doesn't have audio hardware, or somethings seriously screwed.");
-	
 	// We default to generic system settings for host api specific settings:
 	outputParameters.hostApiSpecificStreamInfo = NULL;
 	inputParameters.hostApiSpecificStreamInfo  = NULL;
 
 	// Request optional deviceid:
 	PsychCopyInIntegerArg(1, kPsychArgOptional, &deviceid);
-	if (deviceid < -1) PsychErrorExitMsg(PsychError_user, "Invalid deviceid provided. Valid values are -1 to maximum number of devices.");
+	if (deviceid < -2) PsychErrorExitMsg(PsychError_user, "Invalid deviceid provided. Valid values are -2 to maximum number of devices.");
+
+	// Virtual null device requested?
+	isvirtual = (deviceid == -2) ? TRUE : FALSE;
+
+	// Sanity check: Any hardware found?
+	if (!isvirtual && (Pa_GetDeviceCount() == 0)) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system! Either your machine doesn't have audio hardware, or somethings seriously screwed.");
 
 	// Request optional mode of operation:
 	PsychCopyInIntegerArg(2, kPsychArgOptional, &mode);
@@ -2055,7 +4591,12 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	PsychCopyInIntegerArg(3, kPsychArgOptional, &latencyclass);
 	if (latencyclass < 0 || latencyclass > 4) PsychErrorExitMsg(PsychError_user, "Invalid reqlatencyclass provided. Valid values are 0 to 4.");
 
-	if (deviceid == -1) {
+	if (isvirtual) {
+		// Virtual null device: No hardware devices involved at all:
+		outputParameters.device = paNoDevice;
+		inputParameters.device  = paNoDevice;
+	}
+	else if (deviceid == -1) {
 		// Default devices requested:
 		if ((latencyclass == 0) && (PSYCH_SYSTEM != PSYCH_LINUX)) {
 			// High latency mode on non-Linux. Simply pick system default devices.
@@ -2084,8 +4625,8 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	}
 
 	// Query properties of selected device(s):
-	inputDevInfo  = Pa_GetDeviceInfo(inputParameters.device);
-	outputDevInfo = Pa_GetDeviceInfo(outputParameters.device);
+	inputDevInfo  = (isvirtual) ? NULL : Pa_GetDeviceInfo(inputParameters.device);
+	outputDevInfo = (isvirtual) ? NULL : Pa_GetDeviceInfo(outputParameters.device);
 
 	// Select one of them as "reference" info devices: It's properties are used whenever
 	// no more specialized info is available. We use the output device (if any) as reference,
@@ -2093,14 +4634,14 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	referenceDevInfo = (outputDevInfo) ? outputDevInfo : inputDevInfo;
 
 	// Sanity check: Any hardware found?
-	if (referenceDevInfo == NULL) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system - or at least not with the provided deviceid, if any!");
+	if (!isvirtual && (referenceDevInfo == NULL)) PsychErrorExitMsg(PsychError_user, "Could not find *any* audio hardware on your system - or at least not with the provided deviceid, if any!");
 
 	// Check if current set of selected/available devices is compatible with our playback mode:
-	if (((mode & kPortAudioPlayBack) || (mode & kPortAudioMonitoring)) && ((outputDevInfo == NULL) || (outputDevInfo && outputDevInfo->maxOutputChannels <= 0))) {
+	if (!isvirtual && ((mode & kPortAudioPlayBack) || (mode & kPortAudioMonitoring)) && ((outputDevInfo == NULL) || (outputDevInfo && outputDevInfo->maxOutputChannels <= 0))) {
 		PsychErrorExitMsg(PsychError_user, "Audio output requested, but there isn't any audio output device available or you provided a deviceid for something else than an output device!");
 	}
 
-	if (((mode & kPortAudioCapture) || (mode & kPortAudioMonitoring)) && ((inputDevInfo == NULL) || (inputDevInfo && inputDevInfo->maxInputChannels <= 0))) {
+	if (!isvirtual && ((mode & kPortAudioCapture) || (mode & kPortAudioMonitoring)) && ((inputDevInfo == NULL) || (inputDevInfo && inputDevInfo->maxInputChannels <= 0))) {
 		PsychErrorExitMsg(PsychError_user, "Audio input requested, but there isn't any audio input device available or you provided a deviceid for something else than an input device!");
 	}
 	
@@ -2159,7 +4700,7 @@ PsychError PSYCHPORTAUDIOOpen(void)
 		// Basic check ok. Build ASIO host specific mapping structure:
 		#if PSYCH_SYSTEM == PSYCH_WINDOWS
 			// Check for ASIO: This only works for ASIO host API...
-			if (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type == paASIO) {
+			if (!isvirtual && (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type == paASIO)) {
 				// MS-Windows and connected to an ASIO device. Good. Try to assign channel mapping:
 				if (mode & kPortAudioPlayBack) {
 					// Playback mappings:
@@ -2217,6 +4758,9 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	outputParameters.sampleFormat = paFloat32;
 	inputParameters.sampleFormat  = paFloat32;
 
+	// Virtual null devices use a fixed default buffersize of 256 sample frames:
+	if (isvirtual && (buffersize == 0)) buffersize = 256;
+
 	// Setup buffersize:
 	if (buffersize == 0) {
 		// No specific buffersize requested:
@@ -2246,7 +4790,11 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	// Setup samplerate:
 	if (freq == 0) {
 		// No specific frequency requested:
-		if (latencyclass < 3) {
+		if (isvirtual) {
+			// Virtual null device: Go for the most common modern default:
+			freq = 48000;
+		}
+		else if (latencyclass < 3) {
 			// At levels < 3, we select the device specific default.
 			freq = referenceDevInfo->defaultSampleRate;
 		}
@@ -2260,7 +4808,7 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	// Set requested latency: In class 0 we choose device recommendation for dropout-free operation, in
 	// all higher (lowlat) classes we request zero latency. PortAudio will
 	// clamp this request to something safe internally.
-	switch (Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type) {
+	switch ((isvirtual) ? paInDevelopment : Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type) {
 		case paCoreAudio:	// CoreAudio driver will automatically clamp to safe minimum. Around 0.7 msecs.
 		case paWDMKS:		// dto. for Windows kernel streaming.
 			lowlatency = 0.0;
@@ -2337,28 +4885,50 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	// specialFlags 16: Never dither audio data:
 	if (specialFlags & 16) sflags |= paDitherOff;
 
-	// Try to create & open stream:
-	err = Pa_OpenStream(
-            &stream,															/* Return stream pointer here on success. */
-            ((mode & kPortAudioCapture) ?  &inputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
-			((mode & kPortAudioPlayBack) ? &outputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
-            freq,																/* Requested sampling rate. */
-            buffersize,															/* Requested buffer size. */
-            sflags,																/* Define special stream property flags. */
-            paCallback,															/* Our processing callback. */
-            &audiodevices[audiodevicecount]);									/* Our own device info structure */
+	// Copy in optional name of WAV output file for virtual devices:
+	PsychAllocInCharArg(10, kPsychArgOptional, &virtualOutputFile);
+
+	if (isvirtual) {
+		// Virtual null device: Create our own virtual stream instead of a PortAudio stream. It
+		// gets attached to the device record after setup of the channel counts below:
+		stream = NULL;
+	}
+	else {
+		// Try to create & open stream:
+		err = Pa_OpenStream(
+	            &stream,															/* Return stream pointer here on success. */
+	            ((mode & kPortAudioCapture) ?  &inputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
+				((mode & kPortAudioPlayBack) ? &outputParameters : NULL),			/* Requested input settings, or NULL in pure playback case. */
+	            freq,																/* Requested sampling rate. */
+	            buffersize,															/* Requested buffer size. */
+	            sflags,																/* Define special stream property flags. */
+	            paTimedCallback,													/* Our processing callback. */
+	            &audiodevices[audiodevicecount]);									/* Our own device info structure */
             
-	if(err!=paNoError || stream == NULL) {
-			printf("PTB-ERROR: Failed to open audio device %i. PortAudio reports this error: %s \n", audiodevicecount, Pa_GetErrorText(err));
-			PsychErrorExitMsg(PsychError_system, "Failed to open PortAudio audio device.");
+		if(err!=paNoError || stream == NULL) {
+				printf("PTB-ERROR: Failed to open audio device %i. PortAudio reports this error: %s \n", audiodevicecount, Pa_GetErrorText(err));
+				PsychErrorExitMsg(PsychError_system, "Failed to open PortAudio audio device.");
+		}
 	}
-	
+
 	// Setup our final device structure:
 	audiodevices[audiodevicecount].opmode = mode;
 	audiodevices[audiodevicecount].runMode = 0;
-	audiodevices[audiodevicecount].stream = stream;
-	audiodevices[audiodevicecount].streaminfo = Pa_GetStreamInfo(stream);
-	audiodevices[audiodevicecount].hostAPI = Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type;
+	audiodevices[audiodevicecount].outchannels = mynrchannels[0];
+	audiodevices[audiodevicecount].inchannels = mynrchannels[1];
+	if (isvirtual) {
+		audiodevices[audiodevicecount].virtualStream = PsychPACreateVirtualStream(&audiodevices[audiodevicecount], (double) freq, (unsigned long) buffersize, (specialFlags & 32) ? TRUE : FALSE, virtualOutputFile);
+		if (NULL == audiodevices[audiodevicecount].virtualStream) PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to create virtual audio device.");
+		audiodevices[audiodevicecount].stream = (PaStream*) audiodevices[audiodevicecount].virtualStream;
+		audiodevices[audiodevicecount].streaminfo = &(audiodevices[audiodevicecount].virtualStream->info);
+		audiodevices[audiodevicecount].hostAPI = paInDevelopment;
+	}
+	else {
+		audiodevices[audiodevicecount].virtualStream = NULL;
+		audiodevices[audiodevicecount].stream = stream;
+		audiodevices[audiodevicecount].streaminfo = Pa_GetStreamInfo(stream);
+		audiodevices[audiodevicecount].hostAPI = Pa_GetHostApiInfo(referenceDevInfo->hostApi)->type;
+	}
 	audiodevices[audiodevicecount].startTime = 0.0;
 	audiodevices[audiodevicecount].reqStartTime = 0.0;
 	audiodevices[audiodevicecount].reqStopTime = DBL_MAX;
@@ -2371,13 +4941,17 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	audiodevices[audiodevicecount].outputbuffersize = 0;
 	audiodevices[audiodevicecount].inputbuffer = NULL;
 	audiodevices[audiodevicecount].inputbuffersize = 0;
-	audiodevices[audiodevicecount].outchannels = mynrchannels[0];
-	audiodevices[audiodevicecount].inchannels = mynrchannels[1];
 	audiodevices[audiodevicecount].latencyBias = 0.0;
 	audiodevices[audiodevicecount].schedule = NULL;
+	audiodevices[audiodevicecount].schedule_slabs = NULL;
 	audiodevices[audiodevicecount].schedule_size = 0;
 	audiodevices[audiodevicecount].schedule_pos = 0;
 	audiodevices[audiodevicecount].schedule_writepos = 0;
+	audiodevices[audiodevicecount].schedule_readslot = NULL;
+	audiodevices[audiodevicecount].schedule_writeslot = NULL;
+	audiodevices[audiodevicecount].schedule_writeprev = NULL;
+	audiodevices[audiodevicecount].schedule_growable = FALSE;
+	audiodevices[audiodevicecount].schedule_refsdropped = FALSE;
 	audiodevices[audiodevicecount].outdeviceidx = (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) ? outputParameters.device : -1;
 	audiodevices[audiodevicecount].indeviceidx  = (audiodevices[audiodevicecount].opmode & kPortAudioCapture)  ? inputParameters.device  : -1;
 	audiodevices[audiodevicecount].outputmappings = NULL;
@@ -2391,8 +4965,35 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	audiodevices[audiodevicecount].slaveInBuffer = NULL;
 	audiodevices[audiodevicecount].outChannelVolumes = NULL;
 	audiodevices[audiodevicecount].masterVolume = 1.0;
+	audiodevices[audiodevicecount].envAttack = 0;
+	audiodevices[audiodevicecount].envRelease = 0;
+	audiodevices[audiodevicecount].envCrossfade = 0;
+	audiodevices[audiodevicecount].envAttackFrames = 0;
+	audiodevices[audiodevicecount].envReleaseFrames = 0;
+	audiodevices[audiodevicecount].envPlayedFrames = 0;
+	audiodevices[audiodevicecount].xfadeFrames = 0;
+	audiodevices[audiodevicecount].xfadeBuffer = NULL;
+	audiodevices[audiodevicecount].xfadeGains = NULL;
+	audiodevices[audiodevicecount].xfadeLength = 0;
+	audiodevices[audiodevicecount].xfadePos = 0;
 	audiodevices[audiodevicecount].playposition = 0;
 	audiodevices[audiodevicecount].totalplaycount = 0;
+	audiodevices[audiodevicecount].writeposition = 0;
+	audiodevices[audiodevicecount].streamingMode = 0;
+	audiodevices[audiodevicecount].diskStream = NULL;
+	audiodevices[audiodevicecount].captureWriter = NULL;
+	audiodevices[audiodevicecount].resampler = NULL;
+	audiodevices[audiodevicecount].renderPool = NULL;
+	audiodevices[audiodevicecount].underflows = 0;
+	audiodevices[audiodevicecount].underflowFrames = 0;
+	audiodevices[audiodevicecount].cbLastDuration = 0;
+	audiodevices[audiodevicecount].cbMaxDuration = 0;
+	audiodevices[audiodevicecount].cbTotalDuration = 0;
+	audiodevices[audiodevicecount].cbTimedCalls = 0;
+	audiodevices[audiodevicecount].schedTotalDuration = 0;
+	audiodevices[audiodevicecount].schedTimedCalls = 0;
+	memset(&audiodevices[audiodevicecount].timingStats, 0, sizeof(PsychPATimingStats));
+	audiodevices[audiodevicecount].timingResetRequest = 0;
 		
 	// If this is a master, create a slave device list and init it to "empty":
 	if (mode & kPortAudioIsMaster) {
@@ -2424,8 +5025,8 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	// If we use locking, this will create & init the associated event variable:
 	PsychPACreateSignal(&(audiodevices[audiodevicecount]));
 	
-	// Register the stream finished callback:
-	Pa_SetStreamFinishedCallback(audiodevices[audiodevicecount].stream, PAStreamFinishedCallback);
+	// Register the stream finished callback: Virtual streams call it directly.
+	if (!isvirtual) Pa_SetStreamFinishedCallback(audiodevices[audiodevicecount].stream, PAStreamFinishedCallback);
 
 	#if PSYCH_SYSTEM == PSYCH_OSX
 		// Query low-level audio driver of the CoreAudio HAL for hardware latency:
@@ -2440,14 +5041,21 @@ PsychError PSYCHPORTAUDIOOpen(void)
 	#endif
 	
 	if (verbosity > 3) {
-		printf("PTB-INFO: New audio device with handle %i opened as PortAudio stream:\n",audiodevicecount);
+		if (isvirtual) {
+			printf("PTB-INFO: New audio device with handle %i opened as virtual null device with %s virtual clock:\n", audiodevicecount, (specialFlags & 32) ? "free-running" : "realtime");
+			printf("PTB-INFO: %i channels playback, %i channels capture, %i frames per buffer. Output goes to %s.\n", (int) audiodevices[audiodevicecount].outchannels, (int) audiodevices[audiodevicecount].inchannels,
+					buffersize, (audiodevices[audiodevicecount].virtualStream->wavFile) ? virtualOutputFile : "memory");
+		}
+		else {
+			printf("PTB-INFO: New audio device with handle %i opened as PortAudio stream:\n",audiodevicecount);
+		}
 
-		if (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack) {
+		if (!isvirtual && (audiodevices[audiodevicecount].opmode & kPortAudioPlayBack)) {
 			printf("PTB-INFO: For %i channels Playback: Audio subsystem is %s, Audio device name is ", (int) audiodevices[audiodevicecount].outchannels, Pa_GetHostApiInfo(outputDevInfo->hostApi)->name);
 			printf("%s\n", outputDevInfo->name);
 		}
 
-		if (audiodevices[audiodevicecount].opmode & kPortAudioCapture) {
+		if (!isvirtual && (audiodevices[audiodevicecount].opmode & kPortAudioCapture)) {
 			printf("PTB-INFO: For %i channels Capture: Audio subsystem is %s, Audio device name is ", (int) audiodevices[audiodevicecount].inchannels, Pa_GetHostApiInfo(inputDevInfo->hostApi)->name);
 			printf("%s\n", inputDevInfo->name);
 		}
@@ -2470,8 +5078,8 @@ PsychError PSYCHPORTAUDIOOpen(void)
  */
 PsychError PSYCHPORTAUDIOOpenSlave(void) 
 {
- 	static char useString[] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels]);";
-	//																  1			  2		  3			  4
+ 	static char useString[] = "pahandle = PsychPortAudio('OpenSlave', pamaster [, mode][, channels][, selectchannels][, freq][, resampleQuality=2]);";
+	//																  1			  2		  3			  4					5		 6
 	static char synopsisString[] = 
 		"Open a virtual slave audio device and initialize it. Returns a 'pahandle' device handle for the device.\n"
 		"Slave audio devices are almost always attached to a 'pamaster' audio device that you need to open and initialize "
@@ -2518,7 +5126,17 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
 		"matrix). Numbering of master device channels starts with one! Example: Both, playback and simultaneous "
 		"recording are requested from a master device which represents a 16 channel soundcard with all 16 channels open. "
 		"If you'd specify 'selectchannels' as [1, 6 ; 12, 14], then playback would happen to master channels one and six, "
-		"sound would be captured from master channels 12 and 14.\n\n";
+		"sound would be captured from master channels 12 and 14.\n\n"
+		"'freq' optional sampling frequency of the sound data of a pure playback slave. By default, slaves play at the "
+		"sampling frequency of their master. If you specify a different frequency, the sound data of the slave gets "
+		"converted to the frequency of the master on the fly during mixing, so you can play sound data at its original "
+		"sampling frequency without resampling it yourself. All timing of the slave, e.g., start and stop times, buffer "
+		"positions and loop points, refers to its own frequency. 'freq' must be within 1/8 and 8 times the master "
+		"frequency. Not supported for AM modulators, capture or monitoring slaves.\n\n"
+		"'resampleQuality' optional quality of the sample rate conversion if 'freq' is specified: 0 = Linear "
+		"interpolation, lowest cpu load, but audible artifacts. 1 = Windowed sinc filter with 8 taps, a good "
+		"compromise. 2 = Windowed sinc filter with 32 taps, high quality (default). 3 = Windowed sinc filter with "
+		"64 taps, highest quality and highest cpu load.\n\n";
 	
 	static char seeAlsoString[] = "Open Close GetDeviceSettings ";	 
   	
@@ -2528,12 +5146,14 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
 	int  m, n, p;
 	double* mychannelmap;
 	int modeExceptions = 0;
+	int resampleQuality = 2;
+	double freq = 0;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
 
@@ -2640,6 +5260,18 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
 	// Make sure that number of capture and playback channels is the same for fast monitoring/feedback mode:
 	if ((mode & kPortAudioMonitoring) && (mynrchannels[0] != mynrchannels[1])) PsychErrorExitMsg(PsychError_user, "Fast monitoring/feedback mode selected, but number of capture and playback channels differs! They must be the same for this mode!");
 
+	// Get optional sampling frequency of the slave and the quality of the sample rate conversion:
+	if (PsychCopyInDoubleArg(5, kPsychArgOptional, &freq) && (freq != audiodevices[pamaster].streaminfo->sampleRate)) {
+		if ((mode & (kPortAudioCapture | kPortAudioMonitoring | kPortAudioIsAMModulator)) || !(mode & kPortAudioPlayBack)) PsychErrorExitMsg(PsychError_user, "Invalid 'freq' provided: Only pure playback slaves can use a sampling frequency different from their master!");
+		if ((freq * 8 < audiodevices[pamaster].streaminfo->sampleRate) || (freq > 8 * audiodevices[pamaster].streaminfo->sampleRate)) PsychErrorExitMsg(PsychError_user, "Invalid 'freq' provided: Must be within 1/8 and 8 times the sampling frequency of the master!");
+	}
+	else {
+		freq = 0;
+	}
+
+	PsychCopyInIntegerArg(6, kPsychArgOptional, &resampleQuality);
+	if (resampleQuality < 0 || resampleQuality > 3) PsychErrorExitMsg(PsychError_user, "Invalid 'resampleQuality' provided. Valid values are 0 to 3.");
+
 	// Get optional channel map:	
 	audiodevices[audiodevicecount].outputmappings = NULL;
 	audiodevices[audiodevicecount].inputmappings = NULL;
@@ -2749,7 +5381,8 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
 	audiodevices[audiodevicecount].opmode = mode;
 	audiodevices[audiodevicecount].runMode = 1;
 	audiodevices[audiodevicecount].stream = audiodevices[pamaster].stream;
-	audiodevices[audiodevicecount].streaminfo = Pa_GetStreamInfo(audiodevices[pamaster].stream);
+	audiodevices[audiodevicecount].virtualStream = audiodevices[pamaster].virtualStream;
+	audiodevices[audiodevicecount].streaminfo = audiodevices[pamaster].streaminfo;
 	audiodevices[audiodevicecount].hostAPI = audiodevices[pamaster].hostAPI;
 	audiodevices[audiodevicecount].startTime = 0.0;
 	audiodevices[audiodevicecount].reqStartTime = 0.0;
@@ -2767,9 +5400,15 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
 	audiodevices[audiodevicecount].inchannels = mynrchannels[1];
 	audiodevices[audiodevicecount].latencyBias = 0.0;
 	audiodevices[audiodevicecount].schedule = NULL;
+	audiodevices[audiodevicecount].schedule_slabs = NULL;
 	audiodevices[audiodevicecount].schedule_size = 0;
 	audiodevices[audiodevicecount].schedule_pos = 0;
 	audiodevices[audiodevicecount].schedule_writepos = 0;
+	audiodevices[audiodevicecount].schedule_readslot = NULL;
+	audiodevices[audiodevicecount].schedule_writeslot = NULL;
+	audiodevices[audiodevicecount].schedule_writeprev = NULL;
+	audiodevices[audiodevicecount].schedule_growable = FALSE;
+	audiodevices[audiodevicecount].schedule_refsdropped = FALSE;
 	audiodevices[audiodevicecount].outdeviceidx = audiodevices[pamaster].outdeviceidx;
 	audiodevices[audiodevicecount].indeviceidx  = audiodevices[pamaster].indeviceidx;
 	audiodevices[audiodevicecount].slaveCount = 0;
@@ -2780,8 +5419,46 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
 	audiodevices[audiodevicecount].slaveGainBuffer = NULL;
 	audiodevices[audiodevicecount].slaveInBuffer = NULL;
 	audiodevices[audiodevicecount].masterVolume = 1.0;
+	audiodevices[audiodevicecount].envAttack = 0;
+	audiodevices[audiodevicecount].envRelease = 0;
+	audiodevices[audiodevicecount].envCrossfade = 0;
+	audiodevices[audiodevicecount].envAttackFrames = 0;
+	audiodevices[audiodevicecount].envReleaseFrames = 0;
+	audiodevices[audiodevicecount].envPlayedFrames = 0;
+	audiodevices[audiodevicecount].xfadeFrames = 0;
+	audiodevices[audiodevicecount].xfadeBuffer = NULL;
+	audiodevices[audiodevicecount].xfadeGains = NULL;
+	audiodevices[audiodevicecount].xfadeLength = 0;
+	audiodevices[audiodevicecount].xfadePos = 0;
 	audiodevices[audiodevicecount].playposition = 0;
 	audiodevices[audiodevicecount].totalplaycount = 0;
+	audiodevices[audiodevicecount].writeposition = 0;
+	audiodevices[audiodevicecount].streamingMode = 0;
+	audiodevices[audiodevicecount].diskStream = NULL;
+	audiodevices[audiodevicecount].captureWriter = NULL;
+	audiodevices[audiodevicecount].resampler = NULL;
+	audiodevices[audiodevicecount].renderPool = NULL;
+	audiodevices[audiodevicecount].underflows = 0;
+	audiodevices[audiodevicecount].underflowFrames = 0;
+	audiodevices[audiodevicecount].cbLastDuration = 0;
+	audiodevices[audiodevicecount].cbMaxDuration = 0;
+	audiodevices[audiodevicecount].cbTotalDuration = 0;
+	audiodevices[audiodevicecount].cbTimedCalls = 0;
+	audiodevices[audiodevicecount].schedTotalDuration = 0;
+	audiodevices[audiodevicecount].schedTimedCalls = 0;
+	memset(&audiodevices[audiodevicecount].timingStats, 0, sizeof(PsychPATimingStats));
+	audiodevices[audiodevicecount].timingResetRequest = 0;
+
+	// Own sampling frequency? Then create the sample rate converter, and a stream info with our frequency,
+	// so all timing calculations of this slave work at its frequency:
+	if (freq > 0) {
+		audiodevices[audiodevicecount].resampler = PsychPACreateResampler((int) mynrchannels[0], freq, audiodevices[pamaster].streaminfo->sampleRate, resampleQuality,
+																		   (audiodevices[pamaster].batchsize > PSYCH_PA_RENDER_RESERVE_FRAMES) ? audiodevices[pamaster].batchsize : PSYCH_PA_RENDER_RESERVE_FRAMES);
+		if (NULL == audiodevices[audiodevicecount].resampler) PsychErrorExitMsg(PsychError_outofMemory, "Memory exhausted during sample rate converter allocation.");
+		audiodevices[audiodevicecount].resampledinfo = *(audiodevices[pamaster].streaminfo);
+		audiodevices[audiodevicecount].resampledinfo.sampleRate = freq;
+		audiodevices[audiodevicecount].streaminfo = &(audiodevices[audiodevicecount].resampledinfo);
+	}
 
 	// Setup per-channel output volumes for slave: Each channel starts with a 1.0 setting, ie., max volume:
 	if (audiodevices[audiodevicecount].outchannels > 0) {
@@ -2825,6 +5502,15 @@ PsychError PSYCHPORTAUDIOOpenSlave(void)
 	audiodevices[pamaster].slaves[i] = audiodevicecount;
 	audiodevices[pamaster].slaveCount++;
 
+	// Reserve a render job buffer for us, if the master renders its slaves in parallel, as its paCallback
+	// can't allocate it. Failure is not fatal, the master just renders its slaves serially then:
+	if (audiodevices[pamaster].renderPool) {
+		while (PsychPARenderJobsInFlight(audiodevices[pamaster].renderPool)) PsychYieldIntervalSeconds(yieldInterval);
+		if (!PsychPAReserveRenderJobs(audiodevices[pamaster].renderPool, audiodevices[pamaster].slaveCount) && (verbosity > 1)) {
+			printf("PsychPortAudio-WARNING: Out of memory for render job buffers of master %i. Will render its slaves serially.\n", pamaster);
+		}
+	}
+
 	// Attach master to us:
 	audiodevices[audiodevicecount].pamaster = pamaster;
 
@@ -2919,6 +5605,7 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
 		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
 		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
+		"'bufferdata' can also be an int16() matrix with samples in range -32768 to +32767.\n"
 		"Instead of a matrix, you can also pass in the bufferhandle of an audio buffer as 'bufferdata'. This buffer "
 		"must have been created beforehand via PsychPortAudio('CreateBuffer', ...). Its content must satisfy the "
 		"same constraints as in case of passing a Matlab matrix. The content will be copied from the given buffer "
@@ -2931,6 +5618,12 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 		"is available. A 'streamingrefill' flag of 2 will always refill immediately, ie., without waiting for sufficient buffer "
 		"space to become available, even if this causes audible artifacts or some sound data to be overwritten. This is useful "
 		"for a few very special audio feedback tricks, only use if you really know what you're doing!\n"
+		"A 'streamingrefill' flag of 3 selects lock-free streaming refills: The data is appended exactly as with a flag of 1, "
+		"but without ever taking the device lock, so a slow refill can't stall the realtime audio thread. The engine will "
+		"only play out data you've already provided. If you don't refill in time, the missing samples are played as silence "
+		"and the 'Underflows' and 'UnderflowFrames' counters in PsychPortAudio('GetStatus') are incremented. This mode "
+		"is sticky until the next non-streaming 'FillBuffer' call and is not supported for devices with an active schedule "
+		"or for master devices. Use it for long-running streaming playback, e.g., of soundtracks far bigger than memory.\n"
 		"It will also fail if you try to refill more than the total buffer capacity. Default is to not do "
 		"streaming refills, i.e., the buffer is filled in one batch while playback is stopped. Such a refill will also "
 		"reset any playloop setting done via the 'SetLoop' subfunction to the full size of the refilled buffer.\n"
@@ -2954,6 +5647,7 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 	PsychPABuffer* inbuffer;
 	int inbufferhandle = 0;
 	float*  indatafloat = NULL;
+	short*  indataint16 = NULL;
 	psych_bool userfloat = FALSE;
 	psych_int64 inchannels, insamples, p;
 	size_t buffersize;
@@ -2981,6 +5675,7 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 	if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
+	if (audiodevices[pahandle].diskStream) PsychErrorExitMsg(PsychError_user, "Audio device is fed by a disk streaming source. Detach it via PsychPortAudio('StreamFromFile', pahandle) first.");
 
 	// Bufferhandle instead of input data matrix provided?
 	if (PsychCopyInIntegerArg(2, kPsychArgAnything, &inbufferhandle) && (inbufferhandle > 0)) {
@@ -2989,16 +5684,29 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 		
 		// Assign properties:
 		inchannels = inbuffer->outchannels;
-		insamples  = inbuffer->outputbuffersize / sizeof(float) / inchannels;
+		insamples = inbuffer->outputbuffersize / PsychPABytesPerSample(inbuffer->format) / inchannels;
 		p = 1;
-		indatafloat = inbuffer->outputbuffer;
+
+		// Buffers in compact sample formats get converted to float first:
+		if (inbuffer->format == PSYCH_PA_FORMAT_FLOAT32) {
+			indatafloat = (float*) inbuffer->outputbuffer;
+		}
+		else {
+			indatafloat = PsychPAConvertToTempFloat(inbuffer->outputbuffer, inbuffer->format, inchannels * insamples);
+		}
 	}
 	else {
 		// Regular double matrix with sound data from runtime:
 		if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-			// Or regular float matrix instead:
-			PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
-			userfloat = TRUE;
+			// Or int16 matrix, which we convert directly to float, as for internal buffers:
+			if (PsychAllocInInt16MatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indataint16)) {
+				indatafloat = PsychPAConvertToTempFloat(indataint16, PSYCH_PA_FORMAT_INT16, inchannels * insamples);
+			}
+			else {
+				// Or regular float matrix instead:
+				PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
+				userfloat = TRUE;
+			}
 		}
 	}
 
@@ -3046,6 +5754,9 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 		// Reset play position:
 		audiodevices[pahandle].playposition = 0;
 		
+		// Back to classic locked streaming refills until the next lock-free refill:
+		audiodevices[pahandle].streamingMode = 0;
+
 		outdata = audiodevices[pahandle].outputbuffer;
 		if (indata || userfloat) {
 			if (indata) {
@@ -3103,103 +5814,164 @@ PsychError PSYCHPORTAUDIOFillAudioBuffer(void)
 		buffersize = sizeof(float) * (psych_int64) inchannels * (psych_int64) insamples;
 		if (audiodevices[pahandle].outputbuffersize < buffersize) PsychErrorExitMsg(PsychError_user, "Total capacity of audio buffer is too small for a refill of this size! Allocate an initial buffer of at least the size of the biggest refill.");
 
-		// Need to lock b'cause of 'playposition':
-		PsychPALockDeviceMutex(&audiodevices[pahandle]);
+		// Lock-free streaming refill requested?
+		if (streamingrefill == 3) {
+			if (audiodevices[pahandle].schedule) PsychErrorExitMsg(PsychError_user, "Lock-free streaming refills (streamingrefill == 3) are not supported on devices with an active schedule.");
+			if (audiodevices[pahandle].opmode & kPortAudioIsMaster) PsychErrorExitMsg(PsychError_user, "Lock-free streaming refills (streamingrefill == 3) are not supported on master devices.");
+
+			// Single producer / single consumer ring buffer: We are the only writer of 'writeposition',
+			// paCallback is the only writer of 'playposition'. We never touch the device mutex here, so
+			// paCallback can never stall on us. Switch engine into this mode, it will only play out samples
+			// below the writeposition it sees from now on:
+			audiodevices[pahandle].streamingMode = 1;
+			PsychPAMemoryBarrier();
+
+			// Check for buffer underrun, wait for sufficient headroom in the ring otherwise:
+			while ((audiodevices[pahandle].state > 0) && (!underrun) && (((audiodevices[pahandle].outputbuffersize / (psych_int64) sizeof(float)) - (audiodevices[pahandle].writeposition - audiodevices[pahandle].playposition) - (psych_int64) inchannels) <= (inchannels * insamples))) {
+				PsychYieldIntervalSeconds(yieldInterval);
+			}
 
-		// Check for buffer underrun:
-		if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
-			underrun = 1;
-			tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
-		}
+			if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
+				underrun = 1;
+				tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
+			}
 
-		// Boundary conditions met. Can we refill immediately or do we need to wait for playback
-		// position to progress far enough? We skip this test if the streamingrefill flag is > 1:
-		while ((streamingrefill < 2) && (audiodevices[pahandle].state > 0) && (!underrun) && (((audiodevices[pahandle].outputbuffersize / (psych_int64) sizeof(float)) - (audiodevices[pahandle].writeposition - audiodevices[pahandle].playposition) - (psych_int64) inchannels) <= (inchannels * insamples))) {
-			// Sleep a bit, drop the lock throughout sleep:
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-			// TODO: We could do better here by predicting how long it will take at least until we're ready to refill,
-			// but a perfect solution would require quite a bit of effort... ...Something for a really boring afternoon.
-			PsychYieldIntervalSeconds(yieldInterval);
+			// Engine stopped while we waited for headroom?
+			if (audiodevices[pahandle].state == 0) PsychErrorExitMsg(PsychError_user, "Audiodevice no longer in playback mode (Auto stopped?!?)! Can't continue a streaming buffer refill while stopped. Check your code!");
+
+			// Copy the data into the free part of the ring, starting at writeposition. We use a local write index
+			// and only publish the new writeposition after all data is in place:
+			p = audiodevices[pahandle].writeposition;
+			outdata = audiodevices[pahandle].outputbuffer;
+			{
+				psych_int64 ringsize = audiodevices[pahandle].outputbuffersize / (psych_int64) sizeof(float);
+				psych_int64 outidx = p % ringsize;
+				psych_int64 count = inchannels * insamples;
+
+				while (count-- > 0) {
+					if (indata) {
+						outdata[outidx++] = (float) (PA_ANTICLAMPGAIN *  *(indata++));
+					}
+					else {
+						// Internal audio buffers are already premultiplied with anti-clamp gain:
+						outdata[outidx++] = (userfloat) ? (float) (PA_ANTICLAMPGAIN *  *(indatafloat++)) : *(indatafloat++);
+					}
+					if (outidx >= ringsize) outidx = 0;
+				}
+
+				// Make sure all sound data is visible to paCallback before the new writeposition is:
+				PsychPAMemoryBarrier();
+				audiodevices[pahandle].writeposition = p + inchannels * insamples;
+			}
+
+			// Timestamps for the ETA computation. These are only informational, so no atomic snapshot is needed:
+			totalplaycount = audiodevices[pahandle].totalplaycount;
+			currentTime = audiodevices[pahandle].currentTime;
+
+			if ((underrun > 0) && (verbosity > 1)) {
+				printf("PsychPortAudio-WARNING: Underrun of audio playback buffer detected during lock-free streaming refill at approximate play position %f secs [%f msecs behind]. Sound will be skipped, timing may be wrong and audible glitches may occur!\n",
+						((double) audiodevices[pahandle].playposition / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate)) , tBehind / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate) * 1000.0);
+			}
+		}
+		else {
+			// Need to lock b'cause of 'playposition':
 			PsychPALockDeviceMutex(&audiodevices[pahandle]);
 
-			// Recheck for buffer underrun:
+			// Check for buffer underrun:
 			if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
 				underrun = 1;
 				tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
 			}
-		}
 
-		// Exit with lock held...
+			// Boundary conditions met. Can we refill immediately or do we need to wait for playback
+			// position to progress far enough? We skip this test if the streamingrefill flag is > 1:
+			while ((streamingrefill < 2) && (audiodevices[pahandle].state > 0) && (!underrun) && (((audiodevices[pahandle].outputbuffersize / (psych_int64) sizeof(float)) - (audiodevices[pahandle].writeposition - audiodevices[pahandle].playposition) - (psych_int64) inchannels) <= (inchannels * insamples))) {
+				// Sleep a bit, drop the lock throughout sleep:
+				PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+				// TODO: We could do better here by predicting how long it will take at least until we're ready to refill,
+				// but a perfect solution would require quite a bit of effort... ...Something for a really boring afternoon.
+				PsychYieldIntervalSeconds(yieldInterval);
+				PsychPALockDeviceMutex(&audiodevices[pahandle]);
+
+				// Recheck for buffer underrun:
+				if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
+					underrun = 1;
+					tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
+				}
+			}
+
+			// Exit with lock held...
 		
-		// Have we left the while-loop because the engine stopped? In that case we won't
-		// be able to ever get the needed headroom and need to error-out:
-		if (audiodevices[pahandle].state == 0) {
-			// Ohoh...
-			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
-			PsychErrorExitMsg(PsychError_user, "Audiodevice no longer in playback mode (Auto stopped?!?)! Can't continue a streaming buffer refill while stopped. Check your code!");
-		}
+			// Have we left the while-loop because the engine stopped? In that case we won't
+			// be able to ever get the needed headroom and need to error-out:
+			if (audiodevices[pahandle].state == 0) {
+				// Ohoh...
+				PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
+				PsychErrorExitMsg(PsychError_user, "Audiodevice no longer in playback mode (Auto stopped?!?)! Can't continue a streaming buffer refill while stopped. Check your code!");
+			}
 		
-		// Ok, device locked and enough headroom for batch streaming refill:
+			// Ok, device locked and enough headroom for batch streaming refill:
 		
-		// Copy the data, convert it from double to float, take ringbuffer wraparound into account:
-		if (indata || userfloat) {
-			if (indata) {
-				while(buffersize > 0) {
-					// Fetch next sample and copy it to matrix:
-					audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indata++));
+			// Copy the data, convert it from double to float, take ringbuffer wraparound into account:
+			if (indata || userfloat) {
+				if (indata) {
+					while(buffersize > 0) {
+						// Fetch next sample and copy it to matrix:
+						audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indata++));
 					
-					// Update sample write counter:
-					audiodevices[pahandle].writeposition++;
+						// Update sample write counter:
+						audiodevices[pahandle].writeposition++;
 					
-					// Decrement copy counter:
-					buffersize-=sizeof(float);
+						// Decrement copy counter:
+						buffersize-=sizeof(float);
+					}
+				}
+				else {
+					while(buffersize > 0) {
+						// Fetch next sample and copy it to matrix:
+						audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
+					
+						// Update sample write counter:
+						audiodevices[pahandle].writeposition++;
+					
+						// Decrement copy counter:
+						buffersize-=sizeof(float);
+					}
 				}
 			}
 			else {
+				// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
 				while(buffersize > 0) {
 					// Fetch next sample and copy it to matrix:
-					audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-					
+					audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = *(indatafloat++);
+				
 					// Update sample write counter:
 					audiodevices[pahandle].writeposition++;
-					
+				
 					// Decrement copy counter:
 					buffersize-=sizeof(float);
-				}
+				}		
 			}
-		}
-		else {
-			// Data copy from internal audio buffer (already in float format and premultiplied with anti-clamp gain):
-			while(buffersize > 0) {
-				// Fetch next sample and copy it to matrix:
-				audiodevices[pahandle].outputbuffer[(audiodevices[pahandle].writeposition % (audiodevices[pahandle].outputbuffersize / sizeof(float)))] = *(indatafloat++);
-				
-				// Update sample write counter:
-				audiodevices[pahandle].writeposition++;
-				
-				// Decrement copy counter:
-				buffersize-=sizeof(float);
-			}		
-		}
 		
-		// Retrieve total count of played out samples from engine:
-		totalplaycount = audiodevices[pahandle].totalplaycount;
+			// Retrieve total count of played out samples from engine:
+			totalplaycount = audiodevices[pahandle].totalplaycount;
 
-		// Retrieve corresponding timestamp of last playout:
-		currentTime = audiodevices[pahandle].currentTime;
+			// Retrieve corresponding timestamp of last playout:
+			currentTime = audiodevices[pahandle].currentTime;
 		
-		// Check for buffer underrun:
-		if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
-			underrun = 1;
-			tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
-		}
+			// Check for buffer underrun:
+			if (audiodevices[pahandle].writeposition < audiodevices[pahandle].playposition) {
+				underrun = 1;
+				tBehind = (double) audiodevices[pahandle].playposition - (double) audiodevices[pahandle].writeposition;
+			}
 		
-		// Drop lock here, no longer needed:
-		PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
+			// Drop lock here, no longer needed:
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);			
 
-		if ((underrun > 0) && (verbosity > 1)) {
-			printf("PsychPortAudio-WARNING: Underrun of audio playback buffer detected during streaming refill at approximate play position %f secs [%f msecs behind]. Sound will be skipped, timing may be wrong and audible glitches may occur!\n",
-					((double) audiodevices[pahandle].playposition / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate)) , tBehind / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate) * 1000.0);
+			if ((underrun > 0) && (verbosity > 1)) {
+				printf("PsychPortAudio-WARNING: Underrun of audio playback buffer detected during streaming refill at approximate play position %f secs [%f msecs behind]. Sound will be skipped, timing may be wrong and audible glitches may occur!\n",
+						((double) audiodevices[pahandle].playposition / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate)) , tBehind / ((double) audiodevices[pahandle].outchannels * (double) audiodevices[pahandle].streaminfo->sampleRate) * 1000.0);
+			}
 		}
 	}
 
@@ -3231,6 +6003,7 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
 		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
 		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
 		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
+		"'bufferdata' can also be an int16() matrix with samples in range -32768 to +32767.\n"
 		"Instead of a matrix, you can also pass in the bufferhandle of an audio buffer as 'bufferdata'. This buffer "
 		"must have been created beforehand via PsychPortAudio('CreateBuffer', ...). Its content must satisfy the "
 		"same constraints as in case of passing a Matlab matrix. The content will be copied from the given buffer "
@@ -3256,8 +6029,11 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
 	double*	indata = NULL;
 	int inbufferhandle = 0;
 	float*  indatafloat = NULL;
+	short*  indataint16 = NULL;
 	psych_bool userfloat = FALSE;
 	float*  outdata = NULL;
+	int outformat = PSYCH_PA_FORMAT_FLOAT32;
+	size_t bps;
 	int pahandle   = -1;
 	int bufferhandle = 0;
 	psych_int64 startIndex = 0;
@@ -3291,6 +6067,9 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
 			printf("PsychPortAudio-ERROR: Audio channel count %i of audiobuffer with handle %i doesn't match channel count %i of audio device!\n", buffer->outchannels, bufferhandle, audiodevices[pahandle].outchannels);
 			PsychErrorExitMsg(PsychError_user, "Target audio buffer 'bufferHandle' has an audio channel count that doesn't match channels of audio device!");
 		}
+
+		// Buffers backed by files are mapped read-only:
+		if (buffer->mapbase) PsychErrorExitMsg(PsychError_user, "Target audio buffer 'bufferHandle' was created via 'CreateBufferFromFile' and is read-only!");
 	}
 
 	// Bufferhandle instead of input data matrix provided?
@@ -3300,16 +6079,29 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
 		
 		// Assign properties:
 		inchannels = inbuffer->outchannels;
-		insamples = inbuffer->outputbuffersize / sizeof(float) / inchannels;
+		insamples = inbuffer->outputbuffersize / PsychPABytesPerSample(inbuffer->format) / inchannels;
 		p = 1;
-		indatafloat = inbuffer->outputbuffer;
+
+		// Buffers in compact sample formats get converted to float first:
+		if (inbuffer->format == PSYCH_PA_FORMAT_FLOAT32) {
+			indatafloat = (float*) inbuffer->outputbuffer;
+		}
+		else {
+			indatafloat = PsychPAConvertToTempFloat(inbuffer->outputbuffer, inbuffer->format, inchannels * insamples);
+		}
 	}
 	else {
 		// Regular double matrix with sound data from runtime:
 		if (!PsychAllocInDoubleMatArg64(3, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-			// Or regular float matrix instead:
-			PsychAllocInFloatMatArg64(3, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
-			userfloat = TRUE;
+			// Or int16 matrix, which we convert directly to float, as for internal buffers:
+			if (PsychAllocInInt16MatArg64(3, kPsychArgAnything, &inchannels, &insamples, &p, &indataint16)) {
+				indatafloat = PsychPAConvertToTempFloat(indataint16, PSYCH_PA_FORMAT_INT16, inchannels * insamples);
+			}
+			else {
+				// Or regular float matrix instead:
+				PsychAllocInFloatMatArg64(3, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
+				userfloat = TRUE;
+			}
 		}
 	}
 	
@@ -3325,11 +6117,12 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
 	PsychCopyInIntegerArg64(4, kPsychArgOptional, &startIndex);
 	if (startIndex < 0) PsychErrorExitMsg(PsychError_user, "Invalid 'startIndex' provided. Must be greater or equal to zero.");
 
-	// Assign bufferpointer based on bufferhandle:
+	// Assign bufferpointer and sample format based on bufferhandle:
 	if (bufferhandle > 0) {
 		// Generic buffer:
-		outdata = buffer->outputbuffer;
+		outdata = (float*) buffer->outputbuffer;
 		outbuffersize = buffer->outputbuffersize;
+		outformat = buffer->format;
 	}
 	else {
 		// Standard playout buffer:
@@ -3341,20 +6134,27 @@ PsychError PSYCHPORTAUDIORefillBuffer(void)
 	if (outdata == NULL) PsychErrorExitMsg(PsychError_user, "No such buffer with given 'bufferhandle', or buffer not yet created!");
 	
 	// Compute required buffersize for copying all data from given startIndex:
-	buffersize = sizeof(float) * (size_t) inchannels * ((size_t) insamples + (size_t) startIndex);
+	bps = (size_t) PsychPABytesPerSample(outformat);
+	buffersize = bps * (size_t) inchannels * ((size_t) insamples + (size_t) startIndex);
 	
 	// Buffer of sufficient size?
 	if (buffersize > outbuffersize) {
 		// Nope, too small: Adapt 'buffersize' to allowable maximum amount:
-		if (verbosity > 1) printf("PsychPortAudio: WARNING: In 'RefillBuffer' for bufferhandle %i at startindex %i: Insufficient\nbuffersize %i for %i new audioframes starting at given startindex.\nWill truncate to maximum possible.\n", bufferhandle, (int) startIndex, (int) (outbuffersize / (sizeof(float) * inchannels)), (int) insamples);
+		if (verbosity > 1) printf("PsychPortAudio: WARNING: In 'RefillBuffer' for bufferhandle %i at startindex %i: Insufficient\nbuffersize %i for %i new audioframes starting at given startindex.\nWill truncate to maximum possible.\n", bufferhandle, (int) startIndex, (int) (outbuffersize / (bps * inchannels)), (int) insamples);
 		buffersize = outbuffersize;
-		buffersize -= sizeof(float) * (size_t) inchannels * (size_t) startIndex;
+		buffersize -= bps * (size_t) inchannels * (size_t) startIndex;
 	}
 	else {
 		// Big enough:
-		buffersize = sizeof(float) * (size_t) inchannels * (size_t) insamples;
+		buffersize = bps * (size_t) inchannels * (size_t) insamples;
 	}
 	
+	// Compact sample format of target buffer? Encode data into it and done:
+	if (outformat != PSYCH_PA_FORMAT_FLOAT32) {
+		PsychPAEncodeSamples(outdata, outformat, (psych_int64) inchannels * startIndex, indata, indatafloat, (psych_int64) (buffersize / bps));
+		return(PsychError_none);
+	}
+
 	// Map startIndex to offset in buffer:
 	outdata += (size_t) inchannels * (size_t) startIndex;
 	
@@ -3429,8 +6229,9 @@ PsychError PSYCHPORTAUDIODeleteBuffer(void)
 		rc = PsychPADeleteAudioBuffer(bufferhandle, waitmode);
 	}
 	else {
-		// No specific handle: Try to delete all buffers:
-		if (PsychPAUpdateBufferReferences()) {
+		// No specific handle: Try to delete all buffers. Only schedules of active devices may keep them locked:
+		if (PsychPAIsBufferLocked(-1)) PsychPAReleaseIdleScheduleReferences();
+		if (PsychPAIsBufferLocked(-1)) {
 			// At least one buffer locked. What do do?
 			if (waitmode == 0) {
 				// Just fail -> No op.
@@ -3438,116 +6239,545 @@ PsychError PSYCHPORTAUDIODeleteBuffer(void)
 			}
 			else {
 				// Retry until it works:
-				while (PsychPAUpdateBufferReferences()) PsychYieldIntervalSeconds(yieldInterval);
+				while (PsychPAIsBufferLocked(-1)) {
+					PsychYieldIntervalSeconds(yieldInterval);
+					PsychPAReleaseIdleScheduleReferences();
+				}
 				rc = 1;
 			}
 		}
 		else {
 			rc = 1;
 		}
-		
-		// Really delete all buffers if rc == 1:
-		if (rc == 1) PsychPADeleteAllAudioBuffers();
+		
+		// Really delete all buffers if rc == 1:
+		if (rc == 1) PsychPADeleteAllAudioBuffers();
+	}
+	
+	// Return status:
+	PsychCopyOutDoubleArg(1, FALSE, (double) rc);
+
+	// Done.
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('CreateBuffer') - Create and fill dynamic audio outputbuffer of a device with data.
+ */
+PsychError PSYCHPORTAUDIOCreateBuffer(void) 
+{
+ 	static char useString[] = "bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata [, sampleFormat]);";
+	static char synopsisString[] = 
+		"Create a new dynamic audio data playback buffer for a PortAudio audio device and fill it with initial data.\n"
+		"Return a 'bufferhandle' to the new buffer. 'pahandle' is the optional handle of the device "
+		"whose buffer is to be filled. 'bufferdata' is a matrix with audio data in double() or single() "
+		"format. Each row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
+		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
+		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
+		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
+		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n"
+		"'bufferdata' can also be an int16() matrix, with samples in range -32768 to +32767.\n"
+		"'sampleFormat' optional: Selects how the samples are stored internally. 0 = 32 bit floating point, the default "
+		"for double() or single() 'bufferdata'. 1 = 16 bit signed integer, the default for int16() 'bufferdata'. 2 = 24 bit "
+		"signed integer. The integer formats need only a half or three quarters of the memory of floating point buffers, "
+		"which is useful for large banks of preloaded stimuli. Floating point data gets clamped to the -1.0 to +1.0 range "
+		"and rounded to the integer format. Samples are converted back to floating point on the fly during playback.\n\n"
+		"You can refill the buffer anytime via the PsychPortAudio('RefillBuffer') call.\n"
+		"You can delete the buffer via the PsychPortAudio('DeleteBuffer') call, once it is not used anymore. \n"
+		"You can attach the buffer to an audio playback schedule for actual audio playback via the "
+		"PsychPortAudio('AddToSchedule') call.\n"
+		"The same buffer can be attached to and used by multiple audio devices simultaneously, or multiple "
+		"times within one or more playback schedules. ";
+
+	static char seeAlsoString[] = "Open FillBuffer GetStatus ";	 
+  	
+	PsychPABuffer* buffer;
+	psych_int64 inchannels, insamples, p;
+	double*	indata = NULL;
+	float* indatafloat = NULL;
+	short* indataint16 = NULL;
+	int pahandle   = -1;
+	int bufferhandle = 0;
+	int sampleFormat = PSYCH_PA_FORMAT_FLOAT32;
+	
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	// Get data matrix with initial buffer content:
+	if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
+		// Or int16 matrix, stored as int16 by default:
+		if (PsychAllocInInt16MatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indataint16)) {
+			sampleFormat = PSYCH_PA_FORMAT_INT16;
+		}
+		else {
+			// Or regular float matrix instead:
+			PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
+		}
+	}
+
+	// Get optional sample format for internal storage:
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &sampleFormat);
+	if ((sampleFormat < PSYCH_PA_FORMAT_FLOAT32) || (sampleFormat > PSYCH_PA_FORMAT_INT24)) PsychErrorExitMsg(PsychError_user, "Invalid 'sampleFormat' provided. Must be 0, 1 or 2!");
+	
+	// If the optional pahandle is provided...
+	if (PsychCopyInIntegerArg(1, kPsychArgOptional, &pahandle)) {
+		// ...then we use it to validate the configuration of the datamatrix for the new
+		// buffer against the requirements of that audiodevice pahandle:
+		if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
+		
+		if (inchannels != audiodevices[pahandle].outchannels) {
+			printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
+			PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
+		}
+	}
+
+	if (inchannels < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 row for creation of at least one audio channel in your audio buffer!");
+	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample for creation of your audio buffer!");
+	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
+
+	// Create buffer and assign bufferhandle:
+	bufferhandle = PsychPACreateAudioBuffer(inchannels, insamples, sampleFormat);
+	
+	// Deref bufferHandle:
+	buffer = PsychPAGetAudioBuffer(bufferhandle);
+
+	if (indataint16) {
+		if (sampleFormat == PSYCH_PA_FORMAT_INT16) {
+			// Copy the data as is:
+			memcpy(buffer->outputbuffer, indataint16, (size_t) buffer->outputbuffersize);
+		}
+		else if (sampleFormat == PSYCH_PA_FORMAT_FLOAT32) {
+			// Convert directly to float:
+			PsychPAConvertSamples((float*) buffer->outputbuffer, indataint16, PSYCH_PA_FORMAT_INT16, 0, inchannels * insamples, 1.0f, 0);
+		}
+		else {
+			// Convert to int24 via a temporary float buffer:
+			PsychPAEncodeSamples(buffer->outputbuffer, sampleFormat, 0, NULL, PsychPAConvertToTempFloat(indataint16, PSYCH_PA_FORMAT_INT16, inchannels * insamples), inchannels * insamples);
+		}
+	}
+	else {
+		// Copy the double or float data, convert it to the sample format of the buffer:
+		PsychPAEncodeSamples(buffer->outputbuffer, sampleFormat, 0, indata, indatafloat, inchannels * insamples);
+	}
+	
+	// Return bufferhandle:
+	PsychCopyOutDoubleArg(1, FALSE, (double) bufferhandle);
+
+	// Done.
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('CreateBufferFromFile') - Create dynamic audio outputbuffer backed by a memory-mapped sound file.
+ */
+PsychError PSYCHPORTAUDIOCreateBufferFromFile(void) 
+{
+ 	static char useString[] = "[bufferhandle, sampleRate, channels, frames] = PsychPortAudio('CreateBufferFromFile', filename [, channels][, sampleFormat][, headerBytes]);";
+	//							  1			   2		   3		 4														 1		   2		   3			   4
+	static char synopsisString[] = 
+		"Create a new dynamic audio data playback buffer whose sound data is read directly from the sound file 'filename'.\n"
+		"Return a 'bufferhandle' to the new buffer. The file is memory-mapped instead of read into memory, so creating "
+		"the buffer is fast regardless of the size of the file, and the file contents are only loaded by the operating "
+		"system on demand while the buffer is played back. During playback via a schedule, the driver asks the operating "
+		"system to read ahead of the current play position, so playback doesn't need to wait for the disk. The buffer "
+		"can be used like any other buffer created via 'CreateBuffer', e.g., with 'AddToSchedule' or 'FillBuffer', but "
+		"it is read-only, so 'RefillBuffer' can't modify it. Delete it via 'DeleteBuffer' to release the file.\n"
+		"Supported are WAV files with 16 bit or 24 bit integer samples, or with 32 bit floating point samples. Their "
+		"number of channels must match the channel count of the audio devices the buffer is used with, and their sample "
+		"rate should match the sample rate of those devices, as no sample rate conversion is done.\n"
+		"Files which aren't WAV files are treated as raw sound files with interleaved samples in little-endian byte "
+		"order. For them you must specify the number of 'channels' and the 'sampleFormat' of the samples: 0 = 32 bit "
+		"floating point, 1 = 16 bit signed integer, 2 = 24 bit signed integer in 3 bytes. The optional 'headerBytes' "
+		"defines the number of bytes to skip at the start of the raw file, defaults to zero.\n"
+		"Optionally returns the 'sampleRate' of the sound, or NaN for raw files, the number of 'channels', and the "
+		"number of sample 'frames' in the buffer.\n";
+
+	static char seeAlsoString[] = "CreateBuffer DeleteBuffer AddToSchedule ";	 
+
+	char* filename = NULL;
+	const char* errmsg;
+	void* mapbase;
+	psych_int64 mapsize = 0, dataoffset = 0, datasize = 0;
+	psych_int64 headerBytes = 0;
+	int channels = 0, sampleFormat = -1, bufferhandle;
+	double sampleRate;
+
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(4));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychAllocInCharArg(1, kPsychArgRequired, &filename);
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &channels);
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &sampleFormat);
+	PsychCopyInIntegerArg64(4, kPsychArgOptional, &headerBytes);
+
+	if (NULL == (mapbase = PsychPAMapFile(filename, &mapsize))) {
+		printf("PsychPortAudio-ERROR: Could not open or memory-map sound file '%s'.\n", filename);
+		PsychErrorExitMsg(PsychError_user, "Could not open or memory-map given sound file. Does it exist, is it empty or unreadable?");
+	}
+
+	// Parse file header to find format and location of the sound data:
+	if ((errmsg = PsychPAParseSoundFileHeader((const unsigned char*) mapbase, mapsize, mapsize, headerBytes, &channels, &sampleFormat, &sampleRate, &dataoffset, &datasize)) != NULL) {
+		PsychPAUnmapFile(mapbase, mapsize);
+		if (verbosity > 1) printf("PsychPortAudio-ERROR: Failed to parse sound file '%s'.\n", filename);
+		PsychErrorExitMsg(PsychError_user, errmsg);
+	}
+
+	// Create buffer from mapping. The buffer owns the mapping from now on:
+	bufferhandle = PsychPACreateMappedAudioBuffer(mapbase, mapsize, dataoffset, datasize, channels, sampleFormat);
+
+	PsychCopyOutDoubleArg(1, FALSE, (double) bufferhandle);
+	PsychCopyOutDoubleArg(2, FALSE, sampleRate);
+	PsychCopyOutDoubleArg(3, FALSE, (double) channels);
+	PsychCopyOutDoubleArg(4, FALSE, (double) (datasize / ((psych_int64) channels * PsychPABytesPerSample(sampleFormat))));
+
+	// Done.
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('StreamFromFile') - Attach or detach a disk streaming playback source to a device.
+ */
+PsychError PSYCHPORTAUDIOStreamFromFile(void) 
+{
+ 	static char useString[] = "[sampleRate, channels, frames] = PsychPortAudio('StreamFromFile', pahandle [, filename][, lookaheadSecs=2][, channels][, sampleFormat][, headerBytes]);";
+	//							  1			  2			3														  1			  2			  3					   4		   5			   6
+	static char synopsisString[] = 
+		"Attach a disk streaming source to the playback device 'pahandle', which plays the sound file 'filename'.\n"
+		"Instead of loading the whole file into memory, a background thread reads the file incrementally while "
+		"it is played back, staying up to 'lookaheadSecs' seconds ahead of the current play position. This allows "
+		"playback of sound files of arbitrary size, e.g., long soundtracks, with a small constant memory footprint and "
+		"without any need for periodic 'FillBuffer' calls from your script. The playback buffer of the device serves as "
+		"ring buffer of 'lookaheadSecs' seconds capacity, default is 2 seconds. Choose a bigger value if the file is on "
+		"a slow or busy disk or network drive.\n"
+		"The device must be stopped, opened for playback, not be a master device, and must not use a schedule. If you "
+		"want to mix a streamed file with other sounds or schedules, attach the stream to a dedicated slave device of "
+		"a master device, and play the other sounds via other slave devices. Once the stream is attached, start "
+		"playback via PsychPortAudio('Start') as usual. Playback stops automatically after the last sample of the "
+		"file has been played, regardless of the 'repetitions' setting of 'Start'. Stopping and restarting "
+		"playback continues where playback was stopped. To start over from the beginning, call 'StreamFromFile' again. "
+		"If the background thread can't keep up with playback, the missing samples are played as silence and the "
+		"'Underflows' and 'UnderflowFrames' counters in PsychPortAudio('GetStatus') are incremented. 'StreamFillLevel' "
+		"in the status reports how full the ring buffer is.\n"
+		"Calling this function without 'filename' or with an empty 'filename' stops and detaches the stream, closes the "
+		"file and returns the device to normal playback via 'FillBuffer' or schedules. Closing the device also detaches it.\n"
+		"Supported files, and the meaning of the optional 'channels', 'sampleFormat' and 'headerBytes' parameters for "
+		"raw sound files, are the same as for PsychPortAudio('CreateBufferFromFile'). The number of channels of the file "
+		"must match the number of output channels of the device, and its sample rate should match the sample rate of the "
+		"device, as no sample rate conversion is done.\n"
+		"Optionally returns the 'sampleRate' of the sound, or NaN for raw files, the number of 'channels', and the "
+		"number of sample 'frames' in the file.\n";
+
+	static char seeAlsoString[] = "CreateBufferFromFile FillBuffer Start GetStatus OpenSlave ";	 
+
+	PsychPADevice* dev;
+	PsychPADiskStream* ds;
+	char* filename = NULL;
+	const char* errmsg;
+	unsigned char* header;
+	FILE* file;
+	psych_int64 headersize, filesize, dataoffset = 0, datasize = 0, ringframes;
+	psych_int64 headerBytes = 0;
+	int pahandle = -1, channels = 0, sampleFormat = -1;
+	double lookaheadSecs = 2.0, sampleRate;
+
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(6));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(3));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	dev = &audiodevices[pahandle];
+
+	if ((dev->opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
+	if (dev->opmode & kPortAudioIsMaster) PsychErrorExitMsg(PsychError_user, "Disk streaming is not supported on master devices. Use a slave device of the master instead.");
+	if (dev->schedule) PsychErrorExitMsg(PsychError_user, "Disk streaming is not supported on devices with a schedule. Disable the schedule via 'UseSchedule' or use a separate slave device.");
+
+	// Make sure the device is idle. An idle device can't switch by itself out of idle state,
+	// so it won't touch the playback buffer and related variables while we set them up:
+	if (dev->state > 0) PsychErrorExitMsg(PsychError_user, "Tried to attach or detach a disk stream while audio device is active. Forbidden! Call 'Stop' first.");
+
+	// Detach and release any existing stream first:
+	if (dev->diskStream) {
+		ds = dev->diskStream;
+		PsychPALockDeviceMutex(dev);
+		dev->diskStream = NULL;
+		dev->streamingMode = 0;
+		PsychPAUnlockDeviceMutex(dev);
+		PsychPADestroyDiskStream(ds);
+	}
+
+	// Only detach requested? Then we are done:
+	if (!PsychAllocInCharArg(2, kPsychArgOptional, &filename) || (strlen(filename) == 0)) return(PsychError_none);
+
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &lookaheadSecs);
+	if (lookaheadSecs <= 0) PsychErrorExitMsg(PsychError_user, "Invalid 'lookaheadSecs' provided. Must be greater than zero!");
+
+	PsychCopyInIntegerArg(4, kPsychArgOptional, &channels);
+	PsychCopyInIntegerArg(5, kPsychArgOptional, &sampleFormat);
+	PsychCopyInIntegerArg64(6, kPsychArgOptional, &headerBytes);
+
+	if (NULL == (file = fopen(filename, "rb"))) {
+		printf("PsychPortAudio-ERROR: Could not open sound file '%s'.\n", filename);
+		PsychErrorExitMsg(PsychError_user, "Could not open given sound file. Does it exist, or is it unreadable?");
+	}
+
+	// Get size of file, read its first 64 KB for header parsing:
+	filesize = PsychPASeekFile(file, 0, SEEK_END);
+	headersize = (filesize > 65536) ? 65536 : filesize;
+	header = (unsigned char*) PsychMallocTemp((size_t) headersize + 1);
+	if ((filesize <= 0) || (PsychPASeekFile(file, 0, SEEK_SET) != 0) || (fread(header, 1, (size_t) headersize, file) != (size_t) headersize)) {
+		fclose(file);
+		PsychErrorExitMsg(PsychError_user, "Could not read given sound file. Is it empty?");
+	}
+
+	// Parse file header to find format and location of the sound data:
+	if ((errmsg = PsychPAParseSoundFileHeader(header, headersize, filesize, headerBytes, &channels, &sampleFormat, &sampleRate, &dataoffset, &datasize)) != NULL) {
+		fclose(file);
+		if (verbosity > 1) printf("PsychPortAudio-ERROR: Failed to parse sound file '%s'.\n", filename);
+		PsychErrorExitMsg(PsychError_user, errmsg);
+	}
+
+	if (channels != dev->outchannels) {
+		fclose(file);
+		printf("PTB-ERROR: Audio device %i has %i output channels, but sound file has non-matching number of %i channels.\n", pahandle, (int) dev->outchannels, channels);
+		PsychErrorExitMsg(PsychError_user, "Number of channels of sound file doesn't match number of output channels of selected audio device.");
+	}
+
+	// Warn about sample rate mismatch. Raw files have a NaN sampleRate, which never compares equal to itself:
+	if ((verbosity > 1) && (sampleRate == sampleRate) && (sampleRate != dev->streaminfo->sampleRate)) {
+		printf("PsychPortAudio-WARNING: Sample rate %f Hz of sound file '%s' doesn't match device sample rate of %f Hz. Sound will play at the wrong speed!\n", sampleRate, filename, dev->streaminfo->sampleRate);
+	}
+
+	if (PsychPASeekFile(file, dataoffset, SEEK_SET) != dataoffset) {
+		fclose(file);
+		PsychErrorExitMsg(PsychError_user, "Could not seek to start of sound data in sound file.");
+	}
+
+	// Create stream: The prefetch thread reads a quarter of the ring buffer at a time, so
+	// reads are big enough for efficient disk access, but start early enough:
+	ds = (PsychPADiskStream*) calloc(1, sizeof(PsychPADiskStream));
+	ringframes = (psych_int64) (lookaheadSecs * dev->streaminfo->sampleRate);
+	if (ringframes < 4096) ringframes = 4096;
+	if (ds) {
+		ds->dev = dev;
+		ds->file = file;
+		ds->format = sampleFormat;
+		ds->channels = channels;
+		ds->remaining = datasize;
+		ds->chunkFrames = ringframes / 4;
+		ds->pollInterval = lookaheadSecs / 16;
+		if (ds->pollInterval > 0.05) ds->pollInterval = 0.05;
+		if (ds->pollInterval < yieldInterval) ds->pollInterval = yieldInterval;
+		ds->readBuffer = (unsigned char*) malloc((size_t) (ds->chunkFrames * channels * PsychPABytesPerSample(sampleFormat)));
+	}
+
+	if ((NULL == ds) || (NULL == ds->readBuffer)) {
+		if (ds) free(ds);
+		fclose(file);
+		PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate disk stream.");
+	}
+
+	// Reallocate playback buffer as ring buffer of requested lookahead capacity:
+	free(dev->outputbuffer);
+	dev->outputbuffersize = (psych_int64) sizeof(float) * ringframes * channels;
+	dev->outputbuffer = (float*) malloc((size_t) dev->outputbuffersize);
+	if (NULL == dev->outputbuffer) {
+		dev->outputbuffersize = 0;
+		PsychPADestroyDiskStream(ds);
+		PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate disk stream ring buffer.");
+	}
+
+	// Setup lock-free streaming over the whole ring, starting at sample zero:
+	dev->playposition = 0;
+	dev->writeposition = 0;
+	dev->loopStartFrame = 0;
+	dev->loopEndFrame = ringframes - 1;
+	dev->streamingMode = 1;
+
+	// Prefill the ring, so playback can start immediately, then hand over to the prefetch thread:
+	while (PsychPADiskStreamFill(ds) > 0);
+
+	if (!ds->eof) {
+		if (PsychCreateThread(&(ds->thread), NULL, PsychPADiskStreamThreadMain, (void*) ds)) {
+			dev->streamingMode = 0;
+			PsychPADestroyDiskStream(ds);
+			PsychErrorExitMsg(PsychError_system, "Failed to start disk streaming prefetch thread.");
+		}
+		ds->threadRunning = TRUE;
 	}
-	
-	// Return status:
-	PsychCopyOutDoubleArg(1, FALSE, (double) rc);
+
+	PsychPALockDeviceMutex(dev);
+	dev->diskStream = ds;
+	PsychPAUnlockDeviceMutex(dev);
+
+	PsychCopyOutDoubleArg(1, FALSE, sampleRate);
+	PsychCopyOutDoubleArg(2, FALSE, (double) channels);
+	PsychCopyOutDoubleArg(3, FALSE, (double) (datasize / ((psych_int64) channels * PsychPABytesPerSample(sampleFormat))));
 
 	// Done.
 	return(PsychError_none);
 }
 
-/* PsychPortAudio('CreateBuffer') - Create and fill dynamic audio outputbuffer of a device with data.
+/* PsychPortAudio('CaptureToFile') - Attach or detach a capture to disk writer to a device.
  */
-PsychError PSYCHPORTAUDIOCreateBuffer(void) 
+PsychError PSYCHPORTAUDIOCaptureToFile(void) 
 {
- 	static char useString[] = "bufferhandle = PsychPortAudio('CreateBuffer' [, pahandle], bufferdata);";
+ 	static char useString[] = "[framesWritten, droppedFrames] = PsychPortAudio('CaptureToFile', pahandle [, filename][, sampleFormat=0][, bufferSecs=2][, rawFile=0]);";
+	//							  1				 2														  1			  2			  3				   4			   5
 	static char synopsisString[] = 
-		"Create a new dynamic audio data playback buffer for a PortAudio audio device and fill it with initial data.\n"
-		"Return a 'bufferhandle' to the new buffer. 'pahandle' is the optional handle of the device "
-		"whose buffer is to be filled. 'bufferdata' is a matrix with audio data in double() or single() "
-		"format. Each row of the matrix specifies one sound channel, each column one sample for each channel. Only floating point "
-		"values are supported. Samples need to be in range -1.0 to +1.0, with 0.0 for silence. This is "
-		"intentionally a very restricted interface. For lowest latency and best timing we want you to provide audio "
-		"data exactly at the optimal format and sample rate, so the driver can safe computation time and latency for "
-		"expensive sample rate conversion, sample format conversion, and bounds checking/clipping.\n\n"
-		"You can refill the buffer anytime via the PsychPortAudio('RefillBuffer') call.\n"
-		"You can delete the buffer via the PsychPortAudio('DeleteBuffer') call, once it is not used anymore. \n"
-		"You can attach the buffer to an audio playback schedule for actual audio playback via the "
-		"PsychPortAudio('AddToSchedule') call.\n"
-		"The same buffer can be attached to and used by multiple audio devices simultaneously, or multiple "
-		"times within one or more playback schedules. ";
+		"Record all sound data captured by the audio device 'pahandle' directly into the sound file 'filename'.\n"
+		"A background thread drains the internal capture buffer of the device into the file, so you don't need "
+		"to call 'GetAudioData' periodically, and the sound data never needs to go through Matlab or Octave. This "
+		"allows recordings of arbitrary length, e.g., multi-hour multi-channel recordings at high sample rates. The "
+		"thread writes in big blocks aligned to disk block boundaries for efficient disk access, and it never "
+		"blocks the realtime audio processing.\n"
+		"The device must be stopped and opened for audio capture, and must not be a master device. This call "
+		"(re)allocates the internal capture buffer of the device with a capacity of 'bufferSecs' seconds, default "
+		"is 2 seconds. Choose a bigger value if the disk is slow or busy. If the thread can't keep up, the oldest "
+		"data in the buffer is lost and counted in 'droppedFrames' and in the 'CaptureDroppedFrames' field of "
+		"PsychPortAudio('GetStatus').\n"
+		"Start and stop capture via PsychPortAudio('Start') and PsychPortAudio('Stop') as usual. All captured "
+		"data is appended to the file, also across multiple 'Start' and 'Stop' cycles. 'GetAudioData' can't be used "
+		"while a capture file is attached.\n"
+		"'sampleFormat' selects the sample format of the file: 0 = 32 bit floating point (default), 1 = 16 bit "
+		"signed integer, 2 = 24 bit signed integer in 3 bytes. Integer formats reduce file size and disk bandwidth.\n"
+		"By default a WAV file is written. Its header is finalized when the file is detached. For recordings of "
+		"more than 4 GB of sound data the WAV size fields are set to their maximum, meaning \"sound data up to the "
+		"end of file\", which 'CreateBufferFromFile' and 'StreamFromFile' understand. Set 'rawFile' to 1 to write a "
+		"raw file with interleaved little-endian samples without any header instead.\n"
+		"Calling this function without 'filename' or with an empty 'filename' writes out all remaining captured "
+		"data, finalizes and closes the file, and returns the device to normal operation via 'GetAudioData'. "
+		"Closing the device does the same. Returns the total number of sample frames 'framesWritten' into the "
+		"file that was detached by this call, and the number of 'droppedFrames' lost due to buffer overflows or "
+		"write errors, or zeros if no file was attached.\n";
+
+	static char seeAlsoString[] = "GetAudioData Open Start Stop GetStatus ";	 
+
+	PsychPADevice* dev;
+	PsychPACaptureWriter* cw;
+	char* filename = NULL;
+	FILE* file;
+	psych_int64 framesWritten = 0, droppedFrames = 0, framebytes, blockFrames;
+	int pahandle = -1, sampleFormat = PSYCH_PA_FORMAT_FLOAT32, rawFile = 0;
+	double bufferSecs = 2.0;
 
-	static char seeAlsoString[] = "Open FillBuffer GetStatus ";	 
-  	
-	PsychPABuffer* buffer;
-	psych_int64 inchannels, insamples, p;
-	size_t buffersize, outbuffersize;
-	double*	indata = NULL;
-	float* indatafloat = NULL;
-	float*  outdata = NULL;
-	int pahandle   = -1;
-	int bufferhandle = 0;
-	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
-	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+	PsychErrorExit(PsychCapNumInputArgs(5));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(2));	 // The maximum number of outputs
 
 	// Make sure PortAudio is online:
 	PsychPortAudioInitialize();
 
-	// Get data matrix with initial buffer content:
-	if (!PsychAllocInDoubleMatArg64(2, kPsychArgAnything, &inchannels, &insamples, &p, &indata)) {
-		// Or regular float matrix instead:
-		PsychAllocInFloatMatArg64(2, kPsychArgRequired, &inchannels, &insamples, &p, &indatafloat);
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	dev = &audiodevices[pahandle];
+
+	if ((dev->opmode & kPortAudioCapture) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio capture, so this call doesn't make sense.");
+	if (dev->opmode & kPortAudioIsMaster) PsychErrorExitMsg(PsychError_user, "Capture to disk is not supported on master devices. Use a capture slave device of the master instead.");
+
+	// Make sure the device is idle. An idle device can't switch by itself out of idle state,
+	// so it won't touch the capture buffer and related variables while we set them up:
+	if (dev->state > 0) PsychErrorExitMsg(PsychError_user, "Tried to attach or detach a capture file while audio device is active. Forbidden! Call 'Stop' first.");
+
+	// Detach existing writer first. This writes out all pending data:
+	if (dev->captureWriter) {
+		cw = dev->captureWriter;
+		dev->captureWriter = NULL;
+		PsychPADestroyCaptureWriter(cw, &framesWritten, &droppedFrames);
 	}
-	
-	// If the optional pahandle is provided...
-	if (PsychCopyInIntegerArg(1, kPsychArgOptional, &pahandle)) {
-		// ...then we use it to validate the configuration of the datamatrix for the new
-		// buffer against the requirements of that audiodevice pahandle:
-		if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
-		if ((audiodevices[pahandle].opmode & kPortAudioPlayBack) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so this call doesn't make sense.");
-		
-		if (inchannels != audiodevices[pahandle].outchannels) {
-			printf("PTB-ERROR: Audio device %i has %i output channels, but provided matrix has non-matching number of %i rows.\n", pahandle, (int) audiodevices[pahandle].outchannels, (int) inchannels);
-			PsychErrorExitMsg(PsychError_user, "Number of rows of audio data matrix doesn't match number of output channels of selected audio device.\n");
-		}
+
+	PsychCopyOutDoubleArg(1, FALSE, (double) framesWritten);
+	PsychCopyOutDoubleArg(2, FALSE, (double) droppedFrames);
+
+	// Only detach requested? Then we are done:
+	if (!PsychAllocInCharArg(2, kPsychArgOptional, &filename) || (strlen(filename) == 0)) return(PsychError_none);
+
+	PsychCopyInIntegerArg(3, kPsychArgOptional, &sampleFormat);
+	if ((sampleFormat < PSYCH_PA_FORMAT_FLOAT32) || (sampleFormat > PSYCH_PA_FORMAT_INT24)) PsychErrorExitMsg(PsychError_user, "Invalid 'sampleFormat' provided. Must be 0, 1 or 2!");
+
+	PsychCopyInDoubleArg(4, kPsychArgOptional, &bufferSecs);
+	if (bufferSecs <= 0) PsychErrorExitMsg(PsychError_user, "Invalid 'bufferSecs' provided. Must be greater than zero!");
+
+	PsychCopyInIntegerArg(5, kPsychArgOptional, &rawFile);
+	if (rawFile < 0 || rawFile > 1) PsychErrorExitMsg(PsychError_user, "'rawFile' flag must be zero or one!");
+
+	// (Re)allocate capture buffer, like 'GetAudioData' would do, and reset capture positions:
+	if (dev->readposition < dev->recposition) PsychErrorExitMsg(PsychError_user, "Tried to resize internal capture buffer without emptying it beforehand. You must drain the buffer via 'GetAudioData' first!");
+	free(dev->inputbuffer);
+	dev->inputbuffersize = sizeof(float) * ((psych_int64) (bufferSecs * dev->streaminfo->sampleRate)) * dev->inchannels;
+	dev->inputbuffer = (float*) calloc(1, (size_t) dev->inputbuffersize);
+	if (dev->inputbuffer == NULL) {
+		dev->inputbuffersize = 0;
+		PsychErrorExitMsg(PsychError_outofMemory, "Free system memory exhausted when trying to allocate audio recording buffer!");
 	}
+	dev->recposition = 0;
+	dev->readposition = 0;
 
-	if (inchannels < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 row for creation of at least one audio channel in your audio buffer!");
-	if (insamples < 1) PsychErrorExitMsg(PsychError_user, "You must provide at least 1 sample for creation of your audio buffer!");
-	if (p!=1) PsychErrorExitMsg(PsychError_user, "Audio data matrix must be a 2D matrix, but this one is not a 2D matrix!");
+	if (NULL == (file = fopen(filename, "wb"))) {
+		printf("PsychPortAudio-ERROR: Could not create capture file '%s'.\n", filename);
+		PsychErrorExitMsg(PsychError_user, "Could not create given capture file. Is the path valid and writable?");
+	}
 
-	// Create buffer and assign bufferhandle:
-	bufferhandle = PsychPACreateAudioBuffer(inchannels, insamples);
-	
-	// Deref bufferHandle:
-	buffer = PsychPAGetAudioBuffer(bufferhandle);
-	outdata = buffer->outputbuffer;
-	outbuffersize = buffer->outputbuffersize;
-	buffersize = sizeof(float) * (size_t) inchannels * (size_t) insamples;
+	// Write WAV header with a provisional size of zero, padded so the sound data starts at a disk block boundary:
+	if (!rawFile) PsychPAWriteWavHeader(file, (int) dev->inchannels, (int) dev->streaminfo->sampleRate, 0, sampleFormat, PSYCH_PA_CAPTURE_HEADERBYTES);
 
-	if (indata) {
-		// Copy the data, convert it from double to float:
-		while(buffersize > 0) {
-			*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indata++));
-			buffersize-=sizeof(float);
-		}
-	} else {
-		// Copy the float data:
-		while(buffersize > 0) {
-			*(outdata++) = (float) (PA_ANTICLAMPGAIN *  *(indatafloat++));
-			buffersize-=sizeof(float);
-		}
+	// Writes are a multiple of 4096 sample frames, therefore also a multiple of the disk block size,
+	// about 256 KB per write:
+	framebytes = (psych_int64) dev->inchannels * PsychPABytesPerSample(sampleFormat);
+	blockFrames = 4096 * ((262144 / (4096 * framebytes) > 1) ? 262144 / (4096 * framebytes) : 1);
+
+	cw = (PsychPACaptureWriter*) calloc(1, sizeof(PsychPACaptureWriter));
+	if (cw) {
+		cw->dev = dev;
+		cw->file = file;
+		cw->format = sampleFormat;
+		cw->isWav = (rawFile) ? 0 : 1;
+		cw->channels = dev->inchannels;
+		cw->blockBytes = blockFrames * framebytes;
+		cw->pollInterval = bufferSecs / 16;
+		if (cw->pollInterval > 0.05) cw->pollInterval = 0.05;
+		if (cw->pollInterval < yieldInterval) cw->pollInterval = yieldInterval;
+		cw->writeBuffer = (unsigned char*) malloc((size_t) cw->blockBytes);
 	}
-	
-	// Return bufferhandle:
-	PsychCopyOutDoubleArg(1, FALSE, (double) bufferhandle);
+
+	if ((NULL == cw) || (NULL == cw->writeBuffer)) {
+		if (cw) free(cw);
+		fclose(file);
+		PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate capture writer.");
+	}
+
+	if (PsychCreateThread(&(cw->thread), NULL, PsychPACaptureWriterThreadMain, (void*) cw)) {
+		PsychPADestroyCaptureWriter(cw, NULL, NULL);
+		PsychErrorExitMsg(PsychError_system, "Failed to start capture to disk writer thread.");
+	}
+	cw->threadRunning = TRUE;
+
+	dev->captureWriter = cw;
 
 	// Done.
 	return(PsychError_none);
@@ -3557,7 +6787,7 @@ PsychError PSYCHPORTAUDIOCreateBuffer(void)
  */
 PsychError PSYCHPORTAUDIOGetAudioData(void) 
 {
- 	static char useString[] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, singleType=0]);";
+ 	static char useString[] = "[audiodata absrecposition overflow cstarttime] = PsychPortAudio('GetAudioData', pahandle [, amountToAllocateSecs][, minimumAmountToReturnSecs][, maximumAmountToReturnSecs][, dataType=0][, bufferPtr][, bufferFrames]);";
 	static char synopsisString[] = 
 		"Retrieve captured audio data from a audio device. 'pahandle' is the handle of the device "
 		"whose data is to be retrieved. 'audiodata' is a matrix with audio data in floating point format. Each "
@@ -3582,9 +6812,19 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 		"values (but significantly lower than the 'amountToAllocateSecs' buffersize!!) then you'll always "
 		"get an 'audiodata' matrix back that is of a fixed size. This may be convenient for postprocessing "
 		"in Matlab. It may also reduce or avoid Matlab memory fragmentation...\n"
-		"'singleType' if set to 1 will return a sound data matrix of single() type instead of double() type. "
-		"By default, double() type is returned. single() type matrices only consume half as much memory as "
-		"double() type matrices, without any loss of audio precision.\n"
+		"'dataType' selects the type of the returned sound data matrix: 0 = double() type, the default. 1 = single() "
+		"type. single() type matrices only consume half as much memory as double() type matrices, without any "
+		"loss of audio precision. 2 = int16() type, with samples in range -32768 to +32767, clamped to that "
+		"range and rounded to the nearest integer. int16() type matrices only consume a quarter of the memory "
+		"of double() type matrices, at the precision of 16 bit audio. For compatibility with older scripts, "
+		"this parameter was formerly known as 'singleType'.\n"
+		"'bufferPtr' optional memory pointer to a caller provided buffer with room for 'bufferFrames' sample "
+		"frames of 'dataType' type, e.g., as returned from a memory allocation in another mex file. If provided, "
+		"the sound data is written into that buffer in the same channels x samples layout as a returned matrix, "
+		"and 'audiodata' returns the number of sample frames written instead of a matrix. At most 'bufferFrames' "
+		"sample frames are returned. This avoids the allocation of a new matrix at each call and is the cheapest "
+		"way of continuous polling for new sound data at short intervals. Passing an invalid pointer, or a "
+		"'bufferFrames' count bigger than the buffer, will crash Matlab or Octave!\n"
 		"\n"
 		"\nOptional return arguments other than 'audiodata':\n\n"
 		"'absrecposition' is the absolute position (in samples) of the first column in the returned data matrix, "
@@ -3609,10 +6849,14 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 	//int inchannels, insamples, p, maxSamples;
 	psych_int64 insamples, maxSamples;
 	size_t buffersize;
+	psych_int64 insbsize, readposition, count, n;
 	double*	indata = NULL;
 	float*  indatafloat = NULL;
+	short*	indataint16 = NULL;
+	void*	bufferPtr = NULL;
+	psych_int64 bufferFrames = 0;
 	int pahandle   = -1;
-	int singleType = 0;
+	int dataType = 0;
 	double allocsize;
 	double minSecs, maxSecs, minSamples;
 	int overrun = 0;
@@ -3621,7 +6865,7 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(5));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(7));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(4));	 // The maximum number of outputs
 
@@ -3631,6 +6875,7 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 	if ((audiodevices[pahandle].opmode & kPortAudioCapture) == 0) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio capture, so this call doesn't make sense.");
+	if (audiodevices[pahandle].captureWriter) PsychErrorExitMsg(PsychError_user, "Audio device captures to disk. Detach the capture file via PsychPortAudio('CaptureToFile', pahandle) first.");
 
 	buffersize = audiodevices[pahandle].inputbuffersize;
 	
@@ -3694,9 +6939,16 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 	maxSecs = 0;
 	PsychCopyInDoubleArg(4, kPsychArgOptional, &maxSecs);
 
-	// Get optional singleType flag:
-	PsychCopyInIntegerArg(5, kPsychArgOptional, &singleType);
-	if (singleType < 0 || singleType > 1) PsychErrorExitMsg(PsychError_user, "'singleType' flag must be zero or one!");
+	// Get optional dataType:
+	PsychCopyInIntegerArg(5, kPsychArgOptional, &dataType);
+	if (dataType < 0 || dataType > 2) PsychErrorExitMsg(PsychError_user, "'dataType' must be 0 for double, 1 for single or 2 for int16!");
+
+	// Get optional caller provided target buffer:
+	if (PsychCopyInPointerArg(6, kPsychArgOptional, &bufferPtr)) {
+		if (NULL == bufferPtr) PsychErrorExitMsg(PsychError_user, "Invalid NULL 'bufferPtr' provided!");
+		PsychCopyInIntegerArg64(7, kPsychArgRequired, &bufferFrames);
+		if (bufferFrames < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'bufferFrames' provided. Must be at least one sample frame!");
+	}
 
 	// The engine is potentially running, so we need to mutex-lock our accesses...
 	PsychPALockDeviceMutex(&audiodevices[pahandle]);
@@ -3778,7 +7030,21 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 		}
 	}
 	
-	if (singleType & 1) {
+	// Limitation to capacity of a caller provided buffer?
+	if (bufferPtr && (insamples > bufferFrames * audiodevices[pahandle].inchannels)) insamples = bufferFrames * audiodevices[pahandle].inchannels;
+
+	if (bufferPtr) {
+		// Write into caller provided buffer, return number of sample frames:
+		if (dataType == 2) indataint16 = (short*) bufferPtr;
+		else if (dataType == 1) indatafloat = (float*) bufferPtr;
+		else indata = (double*) bufferPtr;
+		PsychCopyOutDoubleArg(1, FALSE, (double) (insamples / audiodevices[pahandle].inchannels));
+	}
+	else if (dataType == 2) {
+		// Allocate output int16 matrix with matching number of channels and samples:
+		PsychAllocOutInt16MatArg(1, FALSE, audiodevices[pahandle].inchannels, insamples / audiodevices[pahandle].inchannels, 1, &indataint16);
+	}
+	else if (dataType == 1) {
 		// Allocate output float matrix with matching number of channels and samples:
 		PsychAllocOutFloatMatArg(1, FALSE, audiodevices[pahandle].inchannels, insamples / audiodevices[pahandle].inchannels, 1, &indatafloat);
 	}
@@ -3790,33 +7056,30 @@ PsychError PSYCHPORTAUDIOGetAudioData(void)
 	// Copy out absolute sample read position of first sample in buffer:
 	PsychCopyOutDoubleArg(2, FALSE, (double) (audiodevices[pahandle].readposition / audiodevices[pahandle].inchannels));
 
-	// Copy the data, convert it from float to double: Take ringbuffer wraparound into account:
-	if (indatafloat) {
-		// Copy to float/single matrix:
-		while(buffersize > 0) {
-			// Fetch next sample and copy it to matrix:
-			*(indatafloat++) = (float) audiodevices[pahandle].inputbuffer[(audiodevices[pahandle].readposition % (audiodevices[pahandle].inputbuffersize / sizeof(float)))];
-			
-			// Update sample read counter:
-			audiodevices[pahandle].readposition++;
-			
-			// Decrement copy counter:
-			buffersize-=sizeof(float);
+	// Copy the data, converting it from float to the target type: Samples are stored interleaved in the
+	// ringbuffer, which is already the layout of a channels x samples matrix, so we only need to convert
+	// the at most two contiguous runs before and after the ringbuffer wraparound:
+	insbsize = audiodevices[pahandle].inputbuffersize / sizeof(float);
+	readposition = audiodevices[pahandle].readposition;
+	for (count = 0; count < insamples; count += n) {
+		n = insbsize - (readposition % insbsize);
+		if (n > insamples - count) n = insamples - count;
+
+		if (indataint16) {
+			PsychPAEncodeSamples(indataint16 + count, PSYCH_PA_FORMAT_INT16, 0, NULL, audiodevices[pahandle].inputbuffer + (readposition % insbsize), n);
 		}
-	}
-	else {
-		// Copy to double matrix:
-		while(buffersize > 0) {
-			// Fetch next sample and copy it to matrix:
-			*(indata++) = (double) audiodevices[pahandle].inputbuffer[(audiodevices[pahandle].readposition % (audiodevices[pahandle].inputbuffersize / sizeof(float)))];
-			
-			// Update sample read counter:
-			audiodevices[pahandle].readposition++;
-			
-			// Decrement copy counter:
-			buffersize-=sizeof(float);
+		else if (indatafloat) {
+			memcpy(indatafloat + count, audiodevices[pahandle].inputbuffer + (readposition % insbsize), (size_t) n * sizeof(float));
+		}
+		else {
+			PsychPAFloatToDouble(indata + count, audiodevices[pahandle].inputbuffer + (readposition % insbsize), n);
 		}
+
+		readposition += n;
 	}
+
+	// Update sample read counter:
+	audiodevices[pahandle].readposition = readposition;
 	
 	// Copy out overrun flag:
 	PsychCopyOutDoubleArg(3, FALSE, (double) overrun);
@@ -3916,7 +7179,7 @@ PsychError PSYCHPORTAUDIORescheduleStart(void)
 	}
 
 	// Audio engine running? That is the minimum requirement for this function to work:
-	if (!Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Audio device not started. You need to call the 'Start' function first!");
+	if (!PsychPAIsStreamActive(&audiodevices[pahandle])) PsychErrorExitMsg(PsychError_user, "Audio device not started. You need to call the 'Start' function first!");
 
 	// Lock the device:
 	PsychPALockDeviceMutex(&audiodevices[pahandle]);
@@ -3952,23 +7215,50 @@ PsychError PSYCHPORTAUDIORescheduleStart(void)
 	// New stopTime provided?
 	if (stopTime >= 0) audiodevices[pahandle].reqStopTime = stopTime;
 
+	// Reacquire the buffer references of the schedule, if they were dropped while the device was idle:
+	if (audiodevices[pahandle].schedule_refsdropped) {
+		PsychPAAcquireScheduleReferences(&audiodevices[pahandle]);
+		audiodevices[pahandle].schedule_refsdropped = FALSE;
+	}
+
 	// Reset statistics:
 	audiodevices[pahandle].xruns = 0;	
 	audiodevices[pahandle].noTime = 0;
+	audiodevices[pahandle].underflows = 0;
+	audiodevices[pahandle].underflowFrames = 0;
+	audiodevices[pahandle].cbLastDuration = 0;
+	audiodevices[pahandle].cbMaxDuration = 0;
+	audiodevices[pahandle].cbTotalDuration = 0;
+	audiodevices[pahandle].cbTimedCalls = 0;
+	audiodevices[pahandle].schedTotalDuration = 0;
+	audiodevices[pahandle].schedTimedCalls = 0;
+	audiodevices[pahandle].timingStats.lastCbEntry = 0;
+	audiodevices[pahandle].envPlayedFrames = 0;
+	audiodevices[pahandle].xfadeLength = 0;
+	audiodevices[pahandle].xfadePos = 0;
 	audiodevices[pahandle].captureStartTime = 0;
 	audiodevices[pahandle].startTime = 0.0;
 	audiodevices[pahandle].estStopTime = 0;
 	audiodevices[pahandle].currentTime = 0;		
 	audiodevices[pahandle].schedule_pos = 0;
+	audiodevices[pahandle].schedule_readslot = audiodevices[pahandle].schedule;
 	
-	// Reset recorded samples counter:
-	audiodevices[pahandle].recposition = 0;
+	// Reset recorded and read samples counters, unless a capture writer drains the device. That
+	// one keeps appending to its file across restarts, so its positions must stay consistent:
+	if (!audiodevices[pahandle].captureWriter) {
+		// Reset recorded samples counter:
+		audiodevices[pahandle].recposition = 0;
+
+		// Reset read samples counter: This will discard possibly not yet fetched data.
+		audiodevices[pahandle].readposition = 0;
+	}
 
-	// Reset read samples counter: This will discard possibly not yet fetched data.
-	audiodevices[pahandle].readposition = 0;
+	// Reset play position, unless a disk streaming source feeds the device. That one
+	// always continues at its current position, as it can't rewind its ring buffer:
+	if (!audiodevices[pahandle].diskStream) audiodevices[pahandle].playposition = 0;
 
-	// Reset play position:
-	audiodevices[pahandle].playposition = 0;
+	// Start sample rate conversion from silence:
+	if (audiodevices[pahandle].resampler) PsychPARequestResamplerReset(audiodevices[pahandle].resampler);
 	
 	// Reset total count of played out samples:
 	audiodevices[pahandle].totalplaycount = 0;
@@ -3983,7 +7273,7 @@ PsychError PSYCHPORTAUDIORescheduleStart(void)
 
 	// Safety check for deadlock avoidance with waiting slaves:
 	if ((waitForStart > 0) && (audiodevices[pahandle].opmode & kPortAudioIsSlave) &&
-		(!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream) ||
+		(!PsychPAIsStreamActive(&audiodevices[pahandle]) || PsychPAIsStreamStopped(&audiodevices[pahandle]) ||
 		 audiodevices[audiodevices[pahandle].pamaster].state < 1)) {
 		// We are a slave that shall wait for start, but the master audio device hasn't even
 		// started its engine. This looks like a deadlock to avoid:
@@ -3997,7 +7287,7 @@ PsychError PSYCHPORTAUDIORescheduleStart(void)
 		// Wait for real start of device: We enter the first while() loop iteration with
 		// the device lock still held from above, so the while() loop will iterate at
 		// least once...
-		while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
+		while (audiodevices[pahandle].state == 1 && PsychPAIsStreamActive(&audiodevices[pahandle])) {
 			// Wait for a state-change before reevaluating the .state:
 			PsychPAWaitForChange(&audiodevices[pahandle]);
 		}
@@ -4067,6 +7357,7 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
 	int pahandle= -1;
 	int waitForStart = 0;
 	int resume = 0;
+	int i, slaveId;
 	double repetitions = 1;
 	double when = 0.0;
 	double stopTime = DBL_MAX;
@@ -4113,40 +7404,88 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
 	// Make sure current state is zero, aka fully stopped and engine is really stopped: Output a warning if this looks like an
 	// unintended "too early" restart: [No need to mutex-lock here, as iff these .state setting is not met,
 	// then we are good and they can't change by themselves behind our back -- paCallback() can't change .state to > 0]
-	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
+	if ((audiodevices[pahandle].state > 0) && PsychPAIsStreamActive(&audiodevices[pahandle])) {
 		if (verbosity > 1) {
 			printf("PsychPortAudio-WARNING: 'Start' method on audiodevice %i called, although playback on device not yet completely stopped.\nWill forcefully restart with possible audible artifacts or timing glitches.\nCheck your playback timing or use the 'Stop' function properly!\n", pahandle);
 		}
 	}
 
 	// Safeguard: If the stream is not stopped in runMode 0, do it now:
-	if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) {
-		if (audiodevices[pahandle].runMode == 0) Pa_StopStream(audiodevices[pahandle].stream);
+	if (!PsychPAIsStreamStopped(&audiodevices[pahandle])) {
+		if (audiodevices[pahandle].runMode == 0) PsychPAStopStream(&audiodevices[pahandle]);
 	}
 	
 	// Mutex-lock here: Needed if engine already/still running in runMode1, doesn't hurt if engine is stopped
 	PsychPALockDeviceMutex(&audiodevices[pahandle]);
 
+	// Reserve render job buffers for the biggest batch size seen so far, if the slaves are rendered in parallel:
+	if (audiodevices[pahandle].renderPool) {
+		while (PsychPARenderJobsInFlight(audiodevices[pahandle].renderPool)) PsychYieldIntervalSeconds(yieldInterval);
+		if (!PsychPAReserveRenderJobs(audiodevices[pahandle].renderPool, audiodevices[pahandle].slaveCount) && (verbosity > 1)) {
+			printf("PsychPortAudio-WARNING: Out of memory for render job buffers of master %i. Will render its slaves serially.\n", pahandle);
+		}
+	}
+
+	// Grow the sample rate converters of the slaves for the biggest batch size seen so far, as paCallback can't:
+	if ((audiodevices[pahandle].opmode & kPortAudioIsMaster) && (audiodevices[pahandle].slaves)) {
+		for (i = 0; i < MAX_PSYCH_AUDIO_SLAVES_PER_DEVICE; i++) {
+			slaveId = audiodevices[pahandle].slaves[i];
+			if ((slaveId > -1) && audiodevices[slaveId].resampler && (audiodevices[pahandle].batchsize > PSYCH_PA_RENDER_RESERVE_FRAMES) &&
+				!PsychPAResamplerReserve(audiodevices[slaveId].resampler, audiodevices[pahandle].batchsize) && (verbosity > 1)) {
+				printf("PsychPortAudio-WARNING: Out of memory for sample rate conversion of slave %i. It will stay silent.\n", slaveId);
+			}
+		}
+	}
+
+	// Reacquire the buffer references of the schedule, if they were dropped while the device was idle:
+	if (audiodevices[pahandle].schedule_refsdropped) {
+		PsychPAAcquireScheduleReferences(&audiodevices[pahandle]);
+		audiodevices[pahandle].schedule_refsdropped = FALSE;
+	}
+
 	// Reset statistics values:
 	audiodevices[pahandle].batchsize = 0;	
 	audiodevices[pahandle].xruns = 0;	
 	audiodevices[pahandle].paCalls = 0;
 	audiodevices[pahandle].noTime = 0;
+	audiodevices[pahandle].underflows = 0;
+	audiodevices[pahandle].underflowFrames = 0;
+	audiodevices[pahandle].cbLastDuration = 0;
+	audiodevices[pahandle].cbMaxDuration = 0;
+	audiodevices[pahandle].cbTotalDuration = 0;
+	audiodevices[pahandle].cbTimedCalls = 0;
+	audiodevices[pahandle].schedTotalDuration = 0;
+	audiodevices[pahandle].schedTimedCalls = 0;
+	audiodevices[pahandle].timingStats.lastCbEntry = 0;
+	audiodevices[pahandle].envPlayedFrames = 0;
+	audiodevices[pahandle].xfadeLength = 0;
+	audiodevices[pahandle].xfadePos = 0;
 	audiodevices[pahandle].captureStartTime = 0;
 	audiodevices[pahandle].startTime = 0.0;
 	audiodevices[pahandle].reqStopTime = stopTime;
 	audiodevices[pahandle].estStopTime = 0;
 	audiodevices[pahandle].currentTime = 0;		
-	if (!resume) audiodevices[pahandle].schedule_pos = 0;
+	if (!resume) {
+		audiodevices[pahandle].schedule_pos = 0;
+		audiodevices[pahandle].schedule_readslot = audiodevices[pahandle].schedule;
+	}
 	
-	// Reset recorded samples counter:
-	audiodevices[pahandle].recposition = 0;
+	// Reset recorded and read samples counters, unless a capture writer drains the device. That
+	// one keeps appending to its file across restarts, so its positions must stay consistent:
+	if (!audiodevices[pahandle].captureWriter) {
+		// Reset recorded samples counter:
+		audiodevices[pahandle].recposition = 0;
+
+		// Reset read samples counter: This will discard possibly not yet fetched data.
+		audiodevices[pahandle].readposition = 0;
+	}
 
-	// Reset read samples counter: This will discard possibly not yet fetched data.
-	audiodevices[pahandle].readposition = 0;
+	// Reset play position, unless a disk streaming source feeds the device. That one
+	// always continues at its current position, as it can't rewind its ring buffer:
+	if (!resume && !audiodevices[pahandle].diskStream) audiodevices[pahandle].playposition = 0;
 
-	// Reset play position:
-	if (!resume) audiodevices[pahandle].playposition = 0;
+	// Start sample rate conversion from silence:
+	if (!resume && audiodevices[pahandle].resampler) PsychPARequestResamplerReset(audiodevices[pahandle].resampler);
 	
 	// Reset total count of played out samples:
 	if (!resume) audiodevices[pahandle].totalplaycount = 0;
@@ -4165,7 +7504,7 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
 
 	if (!(audiodevices[pahandle].opmode & kPortAudioIsSlave)) {
 		// Engine running?
-		if (!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream)) {
+		if (!PsychPAIsStreamActive(&audiodevices[pahandle]) || PsychPAIsStreamStopped(&audiodevices[pahandle])) {
 			// Try to start stream if the engine isn't running, either because it is the very
 			// first call to 'Start' in any runMode, or because the engine got stopped in
 			// preparation for a restart in runMode zero. Need to drop the lock during
@@ -4173,10 +7512,10 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
 			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
 			
 			// Safeguard: If the stream is not stopped, do it now:
-			if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
+			if (!PsychPAIsStreamStopped(&audiodevices[pahandle])) PsychPAStopStream(&audiodevices[pahandle]);
 			
 			// Start engine:
-			if ((err=Pa_StartStream(audiodevices[pahandle].stream))!=paNoError) {
+			if ((err=PsychPAStartStream(&audiodevices[pahandle]))!=paNoError) {
 				printf("PTB-ERROR: Failed to start audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
 				PsychErrorExitMsg(PsychError_system, "Failed to start PortAudio audio device.");
 			}
@@ -4190,7 +7529,7 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
 	
 	// Safety check for deadlock avoidance with waiting slaves:
 	if ((waitForStart > 0) && (audiodevices[pahandle].opmode & kPortAudioIsSlave) &&
-		(!Pa_IsStreamActive(audiodevices[pahandle].stream) || Pa_IsStreamStopped(audiodevices[pahandle].stream) ||
+		(!PsychPAIsStreamActive(&audiodevices[pahandle]) || PsychPAIsStreamStopped(&audiodevices[pahandle]) ||
 		 audiodevices[audiodevices[pahandle].pamaster].state < 1)) {
 		// We are a slave that shall wait for start, but the master audio device hasn't even
 		// started its engine. This looks like a deadlock to avoid:
@@ -4206,7 +7545,7 @@ PsychError PSYCHPORTAUDIOStartAudioDevice(void)
 		// We need to enter the first while() loop iteration with
 		// the device lock held from above, so the while() loop will iterate at
 		// least once...
-		while (audiodevices[pahandle].state == 1 && Pa_IsStreamActive(audiodevices[pahandle].stream)) {
+		while (audiodevices[pahandle].state == 1 && PsychPAIsStreamActive(&audiodevices[pahandle])) {
 			// Wait for a state-change before reevaluating the .state:
 			PsychPAWaitForChange(&audiodevices[pahandle]);
 		}
@@ -4290,6 +7629,7 @@ PsychError PSYCHPORTAUDIOStopAudioDevice(void)
 	int blockUntilStopped = 1;
 	double stopTime = -1;
 	double repetitions = -1;
+	double fadeStopTime;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
@@ -4349,9 +7689,9 @@ PsychError PSYCHPORTAUDIOStopAudioDevice(void)
 	// allowed if we have infinite repetitions set, but a finite stopTime is defined, so
 	// the engine will eventually stop by itself. Same goes for an operative schedule which
 	// will run empty if not regularly updated:
-	if ((waitforend == 1) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0) &&
+	if ((waitforend == 1) && PsychPAIsStreamActive(&audiodevices[pahandle]) && (audiodevices[pahandle].state > 0) &&
 		(audiodevices[pahandle].opmode & kPortAudioPlayBack) && ((audiodevices[pahandle].repeatCount != -1) || (audiodevices[pahandle].schedule) || (audiodevices[pahandle].reqStopTime < DBL_MAX))) {
-		while ( ((audiodevices[pahandle].runMode == 0) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) ||
+		while ( ((audiodevices[pahandle].runMode == 0) && PsychPAIsStreamActive(&audiodevices[pahandle]) && (audiodevices[pahandle].state > 0)) ||
 				((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 0))) {
 
 			// Wait for a state-change before reevaluating:
@@ -4369,8 +7709,33 @@ PsychError PSYCHPORTAUDIOStopAudioDevice(void)
 	}
 	else {
 		// Some real immediate stop request wanted:
+		// Soft stop of active playback with a fade-out defined via 'SetEnvelope'? Then this
+		// becomes a stop at the end of the fade-out, starting with the next computed sample. The
+		// engine executes the fade sample-accurately, we just wait for it to finish if requested:
+		if ((waitforend != 2) && (audiodevices[pahandle].envReleaseFrames > 0) && (audiodevices[pahandle].state == 2) &&
+			(audiodevices[pahandle].opmode & kPortAudioPlayBack) && PsychPAIsStreamActive(&audiodevices[pahandle])) {
+			fadeStopTime = ((audiodevices[pahandle].currentTime > 0) ? audiodevices[pahandle].currentTime : audiodevices[pahandle].startTime) + audiodevices[pahandle].envRelease;
+			if (fadeStopTime < audiodevices[pahandle].reqStopTime) audiodevices[pahandle].reqStopTime = fadeStopTime;
+
+			if (blockUntilStopped > 0) {
+				while ( ((audiodevices[pahandle].runMode == 0) && PsychPAIsStreamActive(&audiodevices[pahandle]) && (audiodevices[pahandle].state > 0)) ||
+						((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 0))) {
+					// Wait for a state-change before reevaluating:
+					PsychPAWaitForChange(&audiodevices[pahandle]);
+				}
+			}
+			else {
+				// Leave it to the engine to stop at the end of the fade:
+				waitforend = 3;
+			}
+		}
+
 		// Soft stop requested (as opposed to fast stop)?
-		if (waitforend!=2) {
+		if (waitforend == 3) {
+			// Non-blocking fade-out stop: Nothing more to do here.
+			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
+		}
+		else if (waitforend!=2) {
 			// Softstop: Try to stop stream:
 			if (audiodevices[pahandle].state > 0) {
 				// Stream running. Request a stop of stream, to be honored by playback thread:
@@ -4381,7 +7746,7 @@ PsychError PSYCHPORTAUDIOStopAudioDevice(void)
 			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
 				
 			// If blockUntilStopped is non-zero, then explicitely stop as well:
-			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) && (err=Pa_StopStream(audiodevices[pahandle].stream))!=paNoError) {
+			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!PsychPAIsStreamStopped(&audiodevices[pahandle])) && (err=PsychPAStopStream(&audiodevices[pahandle]))!=paNoError) {
 				printf("PTB-ERROR: Failed to stop audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
 				PsychErrorExitMsg(PsychError_system, "Failed to stop PortAudio audio device.");
 			}
@@ -4400,7 +7765,7 @@ PsychError PSYCHPORTAUDIOStopAudioDevice(void)
 			PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
 			
 			// If blockUntilStopped is non-zero, then send abort request to hardware:
-			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) && ((err=Pa_AbortStream(audiodevices[pahandle].stream))!=paNoError)) {
+			if ((blockUntilStopped > 0) && (audiodevices[pahandle].runMode == 0) && (!PsychPAIsStreamStopped(&audiodevices[pahandle])) && ((err=PsychPAAbortStream(&audiodevices[pahandle]))!=paNoError)) {
 				printf("PTB-ERROR: Failed to abort audio device %i. PortAudio reports this error: %s \n", pahandle, Pa_GetErrorText(err));
 				PsychErrorExitMsg(PsychError_system, "Failed to fast stop (abort) PortAudio audio device.");
 			}
@@ -4415,8 +7780,8 @@ PsychError PSYCHPORTAUDIOStopAudioDevice(void)
 		PsychPALockDeviceMutex(&audiodevices[pahandle]);
 
 		// Wait for stop / idle:
-		if (Pa_IsStreamActive(audiodevices[pahandle].stream)) {
-			while ( ((audiodevices[pahandle].runMode == 0) && Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) ||
+		if (PsychPAIsStreamActive(&audiodevices[pahandle])) {
+			while ( ((audiodevices[pahandle].runMode == 0) && PsychPAIsStreamActive(&audiodevices[pahandle]) && (audiodevices[pahandle].state > 0)) ||
 					((audiodevices[pahandle].runMode == 1) && (audiodevices[pahandle].state > 0))) {
 				
 				// Wait for a state-change before reevaluating:
@@ -4521,16 +7886,34 @@ PsychError PSYCHPORTAUDIOGetStatus(void)
 		"InDeviceIndex: Is the deviceindex of the capture device, or -1 if not opened for capture.\n"
 		"RecordedSecs: Is the total amount of recorded sound data (in seconds) since start of capture.\n"
 		"ReadSecs: Is the total amount of sound data (in seconds) that has been fetched from the internal buffer. "
-		"The difference between RecordedSecs and ReadSecs is the amount of recorded sound data pending for retrieval. ";
+		"The difference between RecordedSecs and ReadSecs is the amount of recorded sound data pending for retrieval.\n"
+		"Underflows: Number of playback buffer underflows during lock-free streaming refills, ie., how often the engine "
+		"ran out of sound data because 'FillBuffer' with a 'streamingrefill' flag of 3 wasn't called in time.\n"
+		"UnderflowFrames: Total number of sample frames which were replaced by silence due to such underflows.\n"
+		"CallbackDuration: Duration in seconds of the most recent invocation of the audio processing callback, including "
+		"mixing of all attached slave devices if this is a master device. On slave devices this is the time the master "
+		"spent on processing and mixing this slave.\n"
+		"MaxCallbackDuration: Maximum duration of a callback invocation since start of playback/recording.\n"
+		"MeanCallbackDuration: Average duration of a callback invocation since start of playback/recording. "
+		"Compare these values with the duration of one audio buffer to judge how close you are to dropouts.\n"
+		"MeanScheduleDuration: Average duration of one invocation of schedule processing, if a schedule is in use.\n"
+		"VirtualCallbacks: Total number of processing callbacks executed by a virtual null device since it was opened, "
+		"zero on real sound devices.\n"
+		"StreamFillLevel: Fill level of the ring buffer in lock-free streaming mode, e.g., while fed by a disk streaming "
+		"source attached via 'StreamFromFile', as a fraction between 0.0 = empty and 1.0 = full. Values close to zero "
+		"during playback indicate that underflows are imminent. Zero if the device isn't in lock-free streaming mode.\n"
+		"CaptureDroppedFrames: Number of captured sample frames lost so far while capturing to disk via 'CaptureToFile', "
+		"because the writer thread couldn't keep up or the file couldn't be written. Zero if not capturing to disk. ";
 
 	static char seeAlsoString[] = "Open GetDeviceSettings ";	 
 	PsychGenericScriptType 	*status;
-	double currentTime;
-	psych_int64 playposition, totalplaycount;
+	double currentTime, fillLevel;
+	psych_int64 playposition, totalplaycount, ringsize;
 
 	const char *FieldNames[]={	"Active", "State", "RequestedStartTime", "StartTime", "CaptureStartTime", "RequestedStopTime", "EstimatedStopTime", "CurrentStreamTime", "ElapsedOutSamples", "PositionSecs", "RecordedSecs", "ReadSecs", "SchedulePosition",
 								"XRuns", "TotalCalls", "TimeFailed", "BufferSize", "CPULoad", "PredictedLatency", "LatencyBias", "SampleRate",
-								"OutDeviceIndex", "InDeviceIndex" };
+								"OutDeviceIndex", "InDeviceIndex", "Underflows", "UnderflowFrames", "CallbackDuration", "MaxCallbackDuration",
+								"MeanCallbackDuration", "MeanScheduleDuration", "VirtualCallbacks", "StreamFillLevel", "CaptureDroppedFrames" };
 	int pahandle = -1;
 	
 	// Setup online help: 
@@ -4547,7 +7930,7 @@ PsychError PSYCHPORTAUDIOGetStatus(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
 
-	PsychAllocOutStructArray(1, kPsychArgOptional, 1, 23, FieldNames, &status);
+	PsychAllocOutStructArray(1, kPsychArgOptional, 1, 32, FieldNames, &status);
 
 	// Ok, in a perfect world we should hold the device mutex while querying all the device state.
 	// However, we don't: This reduces lock contention at the price of a small chance that the
@@ -4579,12 +7962,141 @@ PsychError PSYCHPORTAUDIOGetStatus(void)
 	PsychSetStructArrayDoubleElement("TotalCalls", 0, audiodevices[pahandle].paCalls, status);
 	PsychSetStructArrayDoubleElement("TimeFailed", 0, audiodevices[pahandle].noTime, status);
 	PsychSetStructArrayDoubleElement("BufferSize", 0, audiodevices[pahandle].batchsize, status);
-	PsychSetStructArrayDoubleElement("CPULoad", 0, (Pa_IsStreamActive(audiodevices[pahandle].stream)) ? Pa_GetStreamCpuLoad(audiodevices[pahandle].stream) : 0.0, status);
+	PsychSetStructArrayDoubleElement("CPULoad", 0, (PsychPAIsStreamActive(&audiodevices[pahandle]) && !audiodevices[pahandle].virtualStream) ? Pa_GetStreamCpuLoad(audiodevices[pahandle].stream) : 0.0, status);
 	PsychSetStructArrayDoubleElement("PredictedLatency", 0, audiodevices[pahandle].predictedLatency, status);
 	PsychSetStructArrayDoubleElement("LatencyBias", 0, audiodevices[pahandle].latencyBias, status);
 	PsychSetStructArrayDoubleElement("SampleRate", 0, audiodevices[pahandle].streaminfo->sampleRate, status);
 	PsychSetStructArrayDoubleElement("OutDeviceIndex", 0, audiodevices[pahandle].outdeviceidx, status);
 	PsychSetStructArrayDoubleElement("InDeviceIndex", 0, audiodevices[pahandle].indeviceidx, status);
+	PsychSetStructArrayDoubleElement("Underflows", 0, audiodevices[pahandle].underflows, status);
+	PsychSetStructArrayDoubleElement("UnderflowFrames", 0, (double) audiodevices[pahandle].underflowFrames, status);
+	PsychSetStructArrayDoubleElement("CallbackDuration", 0, audiodevices[pahandle].cbLastDuration, status);
+	PsychSetStructArrayDoubleElement("MaxCallbackDuration", 0, audiodevices[pahandle].cbMaxDuration, status);
+	PsychSetStructArrayDoubleElement("MeanCallbackDuration", 0, (audiodevices[pahandle].cbTimedCalls > 0) ? audiodevices[pahandle].cbTotalDuration / (double) audiodevices[pahandle].cbTimedCalls : 0.0, status);
+	PsychSetStructArrayDoubleElement("MeanScheduleDuration", 0, (audiodevices[pahandle].schedTimedCalls > 0) ? audiodevices[pahandle].schedTotalDuration / (double) audiodevices[pahandle].schedTimedCalls : 0.0, status);
+	PsychSetStructArrayDoubleElement("VirtualCallbacks", 0, (audiodevices[pahandle].virtualStream) ? (double) audiodevices[pahandle].virtualStream->callbacks : 0.0, status);
+
+	// Fill level of lock-free streaming ring buffer. Fetch the unlocked playposition, as
+	// the locked snapshot above may be outdated by the time we fetch the writeposition:
+	fillLevel = 0.0;
+	ringsize = audiodevices[pahandle].outputbuffersize / (psych_int64) sizeof(float);
+	if (audiodevices[pahandle].streamingMode && (ringsize > 0)) {
+		playposition = audiodevices[pahandle].playposition;
+		fillLevel = (double) (audiodevices[pahandle].writeposition - playposition) / (double) ringsize;
+		if (fillLevel < 0.0) fillLevel = 0.0;
+	}
+	PsychSetStructArrayDoubleElement("StreamFillLevel", 0, fillLevel, status);
+	PsychSetStructArrayDoubleElement("CaptureDroppedFrames", 0, (audiodevices[pahandle].captureWriter) ? (double) audiodevices[pahandle].captureWriter->droppedFrames : 0.0, status);
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('GetTimingStats') - Return and optionally reset timing histograms of a device.
+ */
+PsychError PSYCHPORTAUDIOGetTimingStats(void) 
+{
+ 	static char useString[] = "stats = PsychPortAudio('GetTimingStats', pahandle [, reset=0]);";
+	//							 1										   1		   2
+	static char synopsisString[] = 
+		"Returns a struct with timing statistics of the audio processing of the device 'pahandle'.\n"
+		"The statistics are collected continuously by the realtime audio thread without any locking, "
+		"accumulated across all 'Start' and 'Stop' cycles since the device was opened or since the last reset, "
+		"and help to tune latency and buffer size settings for a given machine.\n"
+		"If the optional 'reset' flag is set to 1, all statistics are reset to zero after returning them. "
+		"If the device is active, the reset is carried out by the audio thread at its next invocation.\n"
+		"Durations are reported as histograms with logarithmically spaced bins. Bin 1 counts durations "
+		"of less than 1 microsecond, bin k counts durations from 2^(k-2) up to 2^(k-1) microseconds, and the "
+		"last bin counts all longer durations. The returned struct contains the following fields:\n"
+		"BinEdges: Row vector with the upper edge of each histogram bin, in seconds.\n"
+		"CallbackDuration: Histogram of the execution times of the audio processing callback, including mixing "
+		"of all attached slave devices on a master. On slave devices the time the master spent on the slave.\n"
+		"CallbackJitter: Histogram of the deviation of the interval between successive callback invocations from "
+		"the nominal duration of one audio buffer. Not collected on slave devices.\n"
+		"MutexWait: Histogram of the time the callback had to wait for the device lock, which is held by the "
+		"main thread during some operations.\n"
+		"ScheduleDuration: Histogram of the time spent in schedule processing, if a schedule is used.\n"
+		"For each histogram 'Name' there are also the fields 'NameCount', 'NameMean' and 'NameMax' with the total "
+		"count of samples, their mean and their maximum in seconds, e.g., 'CallbackDurationMax'.\n"
+		"NominalBufferDuration: Duration of one audio buffer in seconds, based on the 'BufferSize' reported by "
+		"'GetStatus'. Compare the CallbackDuration histogram against it.\n"
+		"InputUnderflows, InputOverflows, OutputUnderflows, OutputOverflows: Number of callback invocations "
+		"which reported the respective type of xrun.\n"
+		"LastXRunTime: GetSecs time of the last callback which reported an xrun, or zero if none happened.\n";
+
+	static char seeAlsoString[] = "GetStatus EngineTunables ";	 
+	PsychGenericScriptType 	*stats;
+	PsychGenericScriptType 	*histogram;
+	PsychPATimingStats* ts;
+	PsychPAHistogram* h[4];
+	double* bins;
+	char fieldName[64];
+	int pahandle = -1, reset = 0, i, j;
+
+	const char *FieldNames[]={	"BinEdges", "CallbackDuration", "CallbackDurationCount", "CallbackDurationMean", "CallbackDurationMax",
+								"CallbackJitter", "CallbackJitterCount", "CallbackJitterMean", "CallbackJitterMax",
+								"MutexWait", "MutexWaitCount", "MutexWaitMean", "MutexWaitMax",
+								"ScheduleDuration", "ScheduleDurationCount", "ScheduleDurationMean", "ScheduleDurationMax",
+								"NominalBufferDuration", "InputUnderflows", "InputOverflows", "OutputUnderflows", "OutputOverflows", "LastXRunTime" };
+	const char *HistogramNames[]={ "CallbackDuration", "CallbackJitter", "MutexWait", "ScheduleDuration" };
+
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(2));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(1));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &reset);
+	if (reset < 0 || reset > 1) PsychErrorExitMsg(PsychError_user, "'reset' flag must be zero or one!");
+
+	ts = &(audiodevices[pahandle].timingStats);
+	h[0] = &(ts->cbDuration);
+	h[1] = &(ts->cbJitter);
+	h[2] = &(ts->mutexWait);
+	h[3] = &(ts->schedDuration);
+
+	// The statistics are updated by the audio thread while we read them, so this is not an atomic
+	// snapshot, but each individual value is consistent, which is all we need:
+	PsychAllocOutStructArray(1, kPsychArgOptional, 1, 23, FieldNames, &stats);
+
+	PsychAllocateNativeDoubleMat(1, PSYCH_PA_HISTOGRAM_BINS, 1, &bins, &histogram);
+	for (j = 0; j < PSYCH_PA_HISTOGRAM_BINS; j++) bins[j] = (j < PSYCH_PA_HISTOGRAM_BINS - 1) ? ldexp(1e-6, j) : HUGE_VAL;
+	PsychSetStructArrayNativeElement("BinEdges", 0, histogram, stats);
+
+	for (i = 0; i < 4; i++) {
+		PsychAllocateNativeDoubleMat(1, PSYCH_PA_HISTOGRAM_BINS, 1, &bins, &histogram);
+		for (j = 0; j < PSYCH_PA_HISTOGRAM_BINS; j++) bins[j] = (double) h[i]->bins[j];
+		PsychSetStructArrayNativeElement((char*) HistogramNames[i], 0, histogram, stats);
+
+		sprintf(fieldName, "%sCount", HistogramNames[i]);
+		PsychSetStructArrayDoubleElement(fieldName, 0, (double) h[i]->count, stats);
+		sprintf(fieldName, "%sMean", HistogramNames[i]);
+		PsychSetStructArrayDoubleElement(fieldName, 0, (h[i]->count > 0) ? h[i]->total / (double) h[i]->count : 0.0, stats);
+		sprintf(fieldName, "%sMax", HistogramNames[i]);
+		PsychSetStructArrayDoubleElement(fieldName, 0, h[i]->max, stats);
+	}
+
+	PsychSetStructArrayDoubleElement("NominalBufferDuration", 0, (double) audiodevices[pahandle].batchsize / (double) audiodevices[pahandle].streaminfo->sampleRate, stats);
+	PsychSetStructArrayDoubleElement("InputUnderflows", 0, (double) ts->inputUnderflows, stats);
+	PsychSetStructArrayDoubleElement("InputOverflows", 0, (double) ts->inputOverflows, stats);
+	PsychSetStructArrayDoubleElement("OutputUnderflows", 0, (double) ts->outputUnderflows, stats);
+	PsychSetStructArrayDoubleElement("OutputOverflows", 0, (double) ts->outputOverflows, stats);
+	PsychSetStructArrayDoubleElement("LastXRunTime", 0, ts->lastXRunTime, stats);
+
+	if (reset) {
+		// The audio thread is the only writer of the statistics, so ask it to reset them at its
+		// next invocation. If the engine isn't running, no audio thread will touch the statistics,
+		// so we can reset them ourselves:
+		audiodevices[pahandle].timingResetRequest = 1;
+		if (!PsychPAIsStreamActive(&audiodevices[pahandle])) PsychPAHandleTimingReset(&audiodevices[pahandle]);
+	}
+
 	return(PsychError_none);
 }
 
@@ -4692,7 +8204,7 @@ PsychError PSYCHPORTAUDIOLatencyBias(void)
 	// Set new bias, if one was provided:
 	if (bias!=DBL_MAX) {
 		if (audiodevices[pahandle].opmode & kPortAudioIsSlave) PsychErrorExitMsg(PsychError_user, "Change of latency bias is not allowed on slave devices! Set it on associated master device.");
-		if (Pa_IsStreamActive(audiodevices[pahandle].stream) && (audiodevices[pahandle].state > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change 'biasSecs' while device is active! Forbidden!");
+		if (PsychPAIsStreamActive(&audiodevices[pahandle]) && (audiodevices[pahandle].state > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change 'biasSecs' while device is active! Forbidden!");
 		audiodevices[pahandle].latencyBias = bias;
 	}
 	
@@ -4804,6 +8316,196 @@ PsychError PSYCHPORTAUDIOVolume(void)
 	return(PsychError_none);
 }
 
+/* PsychPortAudio('SetEnvelope') - Set fade-in, fade-out and crossfade durations of a device.
+ */
+PsychError PSYCHPORTAUDIOSetEnvelope(void) 
+{
+ 	static char useString[] = "[oldAttack, oldRelease, oldCrossfade] = PsychPortAudio('SetEnvelope', pahandle [, attackSecs][, releaseSecs][, crossfadeSecs]);";
+	static char synopsisString[] = 
+		"Set the gain envelope of playback device 'pahandle' and/or return the old settings.\n"
+		"The envelope is applied by the audio engine with sample accuracy while playing, so you don't need "
+		"to bake fade-in or fade-out ramps into your sound data to avoid clicks at onset or offset of a "
+		"sound, and changing them doesn't require any new 'FillBuffer' calls. All durations are in seconds, "
+		"default to zero, which means no fade, and can be at most 10 seconds. Omitted settings stay unchanged.\n"
+		"'attackSecs' Duration of a linear fade-in after each start of playback via 'Start' or 'RescheduleStart'.\n"
+		"'releaseSecs' Duration of a linear fade-out which ends exactly at the time playback stops: This is "
+		"the 'stopTime' set in 'Start', 'RescheduleStart' or 'Stop', or the end of the last repetition of "
+		"a sound played without a schedule. A 'Stop' call which asks for a regular stop, ie., with "
+		"'waitForEndOfPlayback' set to 0, no longer stops playback immediately, but turns into a stop at the "
+		"end of a fade-out of 'releaseSecs' duration, starting with the next sample which is computed by the engine. "
+		"If 'blockUntilStopped' is 1, the 'Stop' call waits for the end of the fade-out, otherwise it returns "
+		"immediately. A fast stop with 'waitForEndOfPlayback' = 2 always stops immediately, without fade-out.\n"
+		"'crossfadeSecs' Duration of a linear crossfade between successive sound slots of a playback schedule: "
+		"Each slot which is followed by a pending sound slot in the schedule overlaps with that slot for "
+		"'crossfadeSecs', so the schedule plays that much shorter. A slot uses at most half its own duration "
+		"for crossfading, slots which repeat infinitely or are followed by command slots are not crossfaded, "
+		"and slots should be longer than the crossfade duration for clean results. Crossfades are not supported "
+		"on master devices, as they don't play sound buffers of their own.\n"
+		"On a master device, 'attackSecs' and 'releaseSecs' fade the whole mix of all attached slaves. On a slave "
+		"device, they only fade the sound of that slave.\n";
+
+	static char seeAlsoString[] = "Volume Start Stop UseSchedule AddToSchedule";	 
+	
+	PsychPADevice* dev;
+	double attack, release, crossfade, samplerate;
+	float *newBuffer = NULL, *oldBuffer = NULL;
+	psych_int64 xfadeFrames;
+	int pahandle = -1;
+
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(3));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	dev = &audiodevices[pahandle];
+	if (!(dev->opmode & kPortAudioPlayBack)) PsychErrorExitMsg(PsychError_user, "Audio device has not been opened for audio playback, so gain envelopes are not supported.");
+
+	// Return old settings:
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, dev->envAttack);
+	PsychCopyOutDoubleArg(2, kPsychArgOptional, dev->envRelease);
+	PsychCopyOutDoubleArg(3, kPsychArgOptional, dev->envCrossfade);
+
+	attack = dev->envAttack;
+	release = dev->envRelease;
+	crossfade = dev->envCrossfade;
+	PsychCopyInDoubleArg(2, kPsychArgOptional, &attack);
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &release);
+	PsychCopyInDoubleArg(4, kPsychArgOptional, &crossfade);
+	if (attack < 0 || attack > 10) PsychErrorExitMsg(PsychError_user, "Invalid 'attackSecs' provided. Must be between 0 and 10 seconds.");
+	if (release < 0 || release > 10) PsychErrorExitMsg(PsychError_user, "Invalid 'releaseSecs' provided. Must be between 0 and 10 seconds.");
+	if (crossfade < 0 || crossfade > 10) PsychErrorExitMsg(PsychError_user, "Invalid 'crossfadeSecs' provided. Must be between 0 and 10 seconds.");
+	if ((crossfade > 0) && (dev->opmode & kPortAudioIsMaster)) PsychErrorExitMsg(PsychError_user, "Crossfades are not supported on master devices. Set them on the slave devices instead.");
+
+	// Convert to sample frames at the device's own sampling rate:
+	samplerate = (double) dev->streaminfo->sampleRate;
+	xfadeFrames = (psych_int64) (crossfade * samplerate + 0.5);
+
+	// New crossfade duration needs a new tail buffer, with room for the tail and its gains. Allocate
+	// it upfront, so we only need to swap pointers while the device is locked:
+	if ((xfadeFrames != dev->xfadeFrames) && (xfadeFrames > 0)) {
+		newBuffer = (float*) calloc((size_t) (2 * xfadeFrames * dev->outchannels), sizeof(float));
+		if (NULL == newBuffer) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free memory for allocating crossfade buffer.");
+	}
+
+	// Assign with device mutex held, so we don't update in the middle of a callback:
+	PsychPALockDeviceMutex(dev);
+
+	dev->envAttack = attack;
+	dev->envRelease = release;
+	dev->envCrossfade = crossfade;
+	dev->envAttackFrames = (psych_int64) (attack * samplerate + 0.5);
+	dev->envReleaseFrames = (psych_int64) (release * samplerate + 0.5);
+
+	if (xfadeFrames != dev->xfadeFrames) {
+		oldBuffer = dev->xfadeBuffer;
+		dev->xfadeBuffer = newBuffer;
+		dev->xfadeGains = (newBuffer) ? newBuffer + xfadeFrames * dev->outchannels : NULL;
+		dev->xfadeFrames = xfadeFrames;
+		dev->xfadeLength = 0;
+		dev->xfadePos = 0;
+	}
+
+	PsychPAUnlockDeviceMutex(dev);
+
+	// Release old tail buffer outside the lock:
+	free(oldBuffer);
+
+	return(PsychError_none);
+}
+
+/* PsychPortAudio('UseRenderThreads') - Render the slaves of a master device in parallel.
+ */
+PsychError PSYCHPORTAUDIOUseRenderThreads(void) 
+{
+ 	static char useString[] = "[oldNumThreads, oldDeadline, deadlineMisses] = PsychPortAudio('UseRenderThreads', pamaster [, numThreads][, deadline]);";
+	static char synopsisString[] = 
+		"Enable or disable parallel rendering of the slave devices of master device 'pamaster' on multiple processor cores, "
+		"and/or return the old settings.\n"
+		"By default, the audio processing thread of a master device computes the sound of all its slaves one after another. "
+		"With many slaves, or slaves which are expensive to compute, e.g., due to sample rate conversion, this can exceed "
+		"the processing capacity of a single core and cause audio dropouts, although the machine still has plenty of idle "
+		"processor cores. With render threads enabled, the master starts 'numThreads' worker threads with realtime priority. "
+		"Each time the master computes a new buffer of sound, the workers and the master's own audio thread compute the "
+		"sound of the slaves in parallel, then the master mixes the results. Mixing always happens in the same order as "
+		"without render threads, so the output of the master is exactly the same, only computed faster.\n"
+		"'numThreads' Number of worker threads, between 0 and 16. 0 disables parallel rendering. A good choice is the number "
+		"of processor cores minus one, as the audio thread of the master helps out. Parallel rendering is only used if at "
+		"least two slaves need to be computed.\n"
+		"'deadline' Maximum time for parallel rendering of one buffer, as a fraction of the duration of the buffer, between "
+		"0 and 1. Defaults to 0.5. If the workers fail to finish in time, e.g., because the system doesn't give them enough "
+		"processor time, the master stops waiting for them, so slaves which are not finished in time stay silent for this "
+		"buffer. Then the master computes its slaves on its own for the next 100 buffers, before it tries parallel rendering "
+		"again. 'deadlineMisses' returns how often this happened since the render threads were enabled.\n"
+		"Changing the number of threads is best done while the master is stopped, as starting and stopping the threads takes time.\n";
+
+	static char seeAlsoString[] = "Open OpenSlave GetStatus GetTimingStats";	 
+	
+	PsychPADevice* dev;
+	PsychPARenderPool *newPool = NULL, *oldPool = NULL;
+	double deadline;
+	int numThreads;
+	int pahandle = -1;
+
+	// Setup online help: 
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
+	
+	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychRequireNumInputArgs(1)); // The required number of inputs	
+	PsychErrorExit(PsychCapNumOutputArgs(3));	 // The maximum number of outputs
+
+	// Make sure PortAudio is online:
+	PsychPortAudioInitialize();
+
+	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
+	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	dev = &audiodevices[pahandle];
+	if (!(dev->opmode & kPortAudioIsMaster)) PsychErrorExitMsg(PsychError_user, "Audio device is not a master device. Only master devices can render slaves in parallel.");
+
+	// Return old settings:
+	numThreads = (dev->renderPool) ? dev->renderPool->numThreads : 0;
+	deadline = (dev->renderPool) ? dev->renderPool->deadline : 0.5;
+	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) numThreads);
+	PsychCopyOutDoubleArg(2, kPsychArgOptional, deadline);
+	PsychCopyOutDoubleArg(3, kPsychArgOptional, (double) ((dev->renderPool) ? dev->renderPool->deadlineMisses : 0));
+
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &numThreads);
+	PsychCopyInDoubleArg(3, kPsychArgOptional, &deadline);
+	if (numThreads < 0 || numThreads > PSYCH_PA_MAX_RENDER_THREADS) PsychErrorExitMsg(PsychError_user, "Invalid 'numThreads' provided. Must be between 0 and 16.");
+	if (deadline <= 0 || deadline > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'deadline' provided. Must be greater than 0 and at most 1.");
+
+	// Only a new deadline for the same number of threads? Then simply assign it:
+	if (dev->renderPool && (numThreads == dev->renderPool->numThreads)) {
+		dev->renderPool->deadline = deadline;
+		return(PsychError_none);
+	}
+
+	// Create new pool upfront, so we only need to swap pointers while the device is locked:
+	if (numThreads > 0) {
+		newPool = PsychPACreateRenderPool(dev, numThreads, deadline);
+		if (NULL == newPool) PsychErrorExitMsg(PsychError_system, "Failed to create render worker threads or their buffers.");
+	}
+
+	// Assign with device mutex held, so we don't swap in the middle of a callback:
+	PsychPALockDeviceMutex(dev);
+	oldPool = dev->renderPool;
+	dev->renderPool = newPool;
+	PsychPAUnlockDeviceMutex(dev);
+
+	// Shut down old workers outside the lock:
+	if (oldPool) PsychPADestroyRenderPool(oldPool);
+
+	return(PsychError_none);
+}
+
 /* PsychPortAudio('GetDevices') - Enumerate all available sound devices.
  */
 PsychError PSYCHPORTAUDIOGetDevices(void) 
@@ -4968,7 +8670,7 @@ PsychError PSYCHPORTAUDIORunMode(void)
 		if (audiodevices[pahandle].opmode & kPortAudioIsSlave) PsychErrorExitMsg(PsychError_user, "Change of runmode is not allowed on slave devices!");
 
 		// Stop engine if it is running:
-		if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
+		if (!PsychPAIsStreamStopped(&audiodevices[pahandle])) PsychPAStopStream(&audiodevices[pahandle]);
 
 		// Reset state:
 		audiodevices[pahandle].state = 0;
@@ -5021,6 +8723,7 @@ PsychError PSYCHPORTAUDIOSetLoop(void)
 
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided.");
+	if (audiodevices[pahandle].diskStream) PsychErrorExitMsg(PsychError_user, "Audio device is fed by a disk streaming source, which doesn't support playback loops.");
 
 	unitIsSecs = 0;
 	PsychCopyInIntegerArg(4, kPsychArgOptional, &unitIsSecs);
@@ -5059,7 +8762,7 @@ PsychError PSYCHPORTAUDIOSetLoop(void)
  */
 PsychError PSYCHPORTAUDIOEngineTunables(void) 
 {
- 	static char useString[] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend]);";
+ 	static char useString[] = "[oldyieldInterval, oldMutexEnable, lockToCore1, audioserver_autosuspend, useSIMD] = PsychPortAudio('EngineTunables' [, yieldInterval] [, MutexEnable] [, lockToCore1] [, audioserver_autosuspend] [, useSIMD]);";
 	static char synopsisString[] = 
 		"Return, and optionally set low-level tuneable driver parameters.\n"
 		"The driver must be idle, ie., no audio device must be open, if you want to change tuneables! "
@@ -5087,20 +8790,24 @@ PsychError PSYCHPORTAUDIOEngineTunables(void)
 		"can interfere with low level audio device access and low-latency / high-precision audio timing. "
 		"For this reason it is a good idea to switch them to standby (suspend) while a PsychPortAudio "
 		"session is active. Sometimes this isn't needed or not even desireable. Therefore this option "
-		"allows to inhibit this automatic suspending of audio servers.\n";
+		"allows to inhibit this automatic suspending of audio servers.\n"
+		"'useSIMD' - Enable (1) or Disable (0) use of SSE2 vector instructions for mixing and distributing sound "
+		"between master and slave devices. Enabled by default. Only has an effect if your build of PsychPortAudio "
+		"supports SSE2, otherwise the setting is ignored and the scalar code is always used. Disabling is useful for "
+		"debugging and for comparing performance.\n";
 
 	static char seeAlsoString[] = "Open ";	 
 	
-	int mutexenable, mylockToCore1, mysuspend;
+	int mutexenable, mylockToCore1, mysuspend, myusesimd;
 	double myyieldInterval;
 
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(5));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(0)); // The required number of inputs	
-	PsychErrorExit(PsychCapNumOutputArgs(4));    // The maximum number of outputs
+	PsychErrorExit(PsychCapNumOutputArgs(5));    // The maximum number of outputs
 
 	// Make sure no settings are changed while an audio device is open:
 	if ((PsychGetNumInputArgs() > 0) && (audiodevicecount > 0)) PsychErrorExitMsg(PsychError_user, "Tried to change low-level engine parameter while at least one audio device is open! Forbidden!");
@@ -5148,6 +8855,16 @@ PsychError PSYCHPORTAUDIOEngineTunables(void)
 		if (verbosity > 3) printf("PsychPortAudio: INFO: Locking of all engine threads to cpu core 1 %s.\n", (lockToCore1) ? "enabled" : "disabled");
 	}
 
+	// Return current/old useSIMD:
+	PsychCopyOutDoubleArg(5, kPsychArgOptional, (double) ((usesimd) ? 1 : 0));
+
+	// Get optional new useSIMD:
+	if (PsychCopyInIntegerArg(5, kPsychArgOptional, &myusesimd)) {
+		if (myusesimd < 0 || myusesimd > 1) PsychErrorExitMsg(PsychError_user, "Invalid setting for 'useSIMD' provided. Valid are 0 and 1.");
+		usesimd = (myusesimd > 0) ? TRUE : FALSE;
+		if (verbosity > 3) printf("PsychPortAudio: INFO: Use of SIMD vector instructions for mixing %s.\n", (usesimd) ? "enabled" : "disabled");
+	}
+
 	return(PsychError_none);
 }
 
@@ -5155,7 +8872,7 @@ PsychError PSYCHPORTAUDIOEngineTunables(void)
  */
 PsychError PSYCHPORTAUDIOUseSchedule(void) 
 {
- 	static char useString[] = "PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128]);";
+ 	static char useString[] = "PsychPortAudio('UseSchedule', pahandle, enableSchedule [, maxSize = 128][, growable = 0]);";
 	static char synopsisString[] = 
 		"Enable or disable use of a preprogrammed schedule for audio playback on audio device 'pahandle'.\n"
 		"Schedules are similar to playlists on your favorite audio player. A schedule allows to define a sequence "
@@ -5174,6 +8891,11 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 		"so it is ready to be rewritten with new entries. You should reset and rewrite a schedule each "
 		"time after playback/processing of a schedule has finished or has been stopped.\n"
 		"A 'enableSchedule' setting of 3 will reactivate an existing schedule, ie. prepare it for a replay.\n"
+		"If the optional flag 'growable' is set to 1 when creating a schedule, then the schedule is not limited "
+		"to 'maxSize' slots: Whenever 'AddToSchedule' finds the schedule full, it doubles its size and adds the "
+		"new slot, instead of failing. This also works while playback of the schedule is running.\n"
+		"Adding slots to a schedule never blocks or delays the audio processing thread, so you can add "
+		"large numbers of slots during playback without causing audio glitches.\n"
 		"See the subfunction 'AddToSchedule' on how to populate the schedule with actual entries.\n";
 		
 	static char seeAlsoString[] = "FillBuffer Start Stop RescheduleStart AddToSchedule";
@@ -5181,13 +8903,16 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 	int pahandle = -1;
 	int enableSchedule;
 	int maxSize = 128;
-	int j;
+	int growable = -1;
+	PsychPAScheduleSlab* slab;
+	PsychPASchedule* slot;
+	unsigned int j;
 	
 	// Setup online help: 
 	PsychPushHelp(useString, synopsisString, seeAlsoString);
 	if(PsychIsGiveHelp()) {PsychGiveHelp(); return(PsychError_none); };
 	
-	PsychErrorExit(PsychCapNumInputArgs(3));     // The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(4));     // The maximum number of inputs
 	PsychErrorExit(PsychRequireNumInputArgs(2)); // The required number of inputs	
 	PsychErrorExit(PsychCapNumOutputArgs(0));	 // The maximum number of outputs
 
@@ -5200,7 +8925,7 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 	// Make sure the device is fully idle: We can check without mutex held, as a device which is
 	// already idle (state == 0) can't switch by itself out of idle state (state > 0), neither
 	// can an inactive stream start itself.
-	if ((audiodevices[pahandle].state > 0) && Pa_IsStreamActive(audiodevices[pahandle].stream)) PsychErrorExitMsg(PsychError_user, "Tried to enable/disable audio schedule while audio device is active. Forbidden! Call 'Stop' first.");
+	if ((audiodevices[pahandle].state > 0) && PsychPAIsStreamActive(&audiodevices[pahandle])) PsychErrorExitMsg(PsychError_user, "Tried to enable/disable audio schedule while audio device is active. Forbidden! Call 'Stop' first.");
 
 	// At this point the deivce is idle and will remain so during this routines execution,
 	// so it won't touch any of the schedule related variables and we can manipulate them
@@ -5209,11 +8934,18 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 	// Get required enable flag:
 	PsychCopyInIntegerArg(2, kPsychArgRequired, &enableSchedule);
 	if (enableSchedule < 0 || enableSchedule > 3)  PsychErrorExitMsg(PsychError_user, "Invalid 'enableSchedule' provided. Must be 0, 1, 2 or 3!");
+	if ((enableSchedule > 0) && audiodevices[pahandle].diskStream) PsychErrorExitMsg(PsychError_user, "Audio device is fed by a disk streaming source, which can't be combined with a schedule. Use a separate slave device for the stream.");
 
 	// Get the optional maxSize parameter:
 	PsychCopyInIntegerArg(3, kPsychArgOptional, &maxSize);
 	if (maxSize < 1) PsychErrorExitMsg(PsychError_user, "Invalid 'maxSize' provided. Must be greater than zero!");
 
+	// Get the optional growable flag. Keeps the current setting on reset or revival if omitted:
+	PsychCopyInIntegerArg(4, kPsychArgOptional, &growable);
+	if (growable > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'growable' flag provided. Must be 0 or 1!");
+	if (growable >= 0) audiodevices[pahandle].schedule_growable = (growable > 0) ? TRUE : FALSE;
+	else if (enableSchedule == 1) audiodevices[pahandle].schedule_growable = FALSE;
+
 	// Revival of existing schedule requested?
 	if (enableSchedule == 3) {
 		if (NULL == audiodevices[pahandle].schedule) {
@@ -5222,15 +8954,22 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 
 		// Reset current position in schedule to start:
 		audiodevices[pahandle].schedule_pos = 0;
+		audiodevices[pahandle].schedule_readslot = audiodevices[pahandle].schedule;
 		
-		for (j = 0; j < audiodevices[pahandle].schedule_size; j++) {
+		// Retired slots dropped their buffer references, so take them again:
+		PsychLockMutex(&bufferListmutex);
+		slot = audiodevices[pahandle].schedule;
+		for (j = 0; j < audiodevices[pahandle].schedule_size; j++, slot = slot->next) {
 			// Slot occupied?
-			if (audiodevices[pahandle].schedule[j].mode & 1) {
+			if (slot->mode & 1) {
 				// Reactivate this slot to pending:
-				audiodevices[pahandle].schedule[j].mode |= 2;
+				PsychPAAcquireBufferReference(slot);
+				slot->mode |= 2;
 			}
 		}
-		
+		PsychUnlockMutex(&bufferListmutex);
+		audiodevices[pahandle].schedule_refsdropped = FALSE;
+
 		// Done.
 		return(PsychError_none);
 	}
@@ -5239,7 +8978,7 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 	// Reset of existing schedule requested?
 	if ((enableSchedule == 2) && (audiodevices[pahandle].schedule)) {
 		// Yes: Simply set requested size to current size, this will trigger
-		// a memset() to zero below, instead of a realloc or alloc, which is
+		// a reset of all slots below, instead of a realloc or alloc, which is
 		// exactly what we want:
 		maxSize = audiodevices[pahandle].schedule_size;
 	}
@@ -5252,32 +8991,29 @@ PsychError PSYCHPORTAUDIOUseSchedule(void)
 		// Schedule already exists: Is this by any chance an enable call and
 		// the requested size of the new schedule matches the size of the current
 		// one?
-		if (enableSchedule && (audiodevices[pahandle].schedule_size == maxSize)) {
+		if (enableSchedule && (audiodevices[pahandle].schedule_size == (unsigned int) maxSize)) {
 			// Yes! Have a schedule of exactly wanted size, no need to free and
-			// realloc - We simply clear it out by zero filling:
-			memset((void*) audiodevices[pahandle].schedule, 0, (size_t) (maxSize * sizeof(PsychPASchedule)));
+			// realloc - We simply drop all buffer references and clear it out:
+			PsychPAReleaseScheduleReferences(&audiodevices[pahandle]);
+			PsychPAResetSchedule(&audiodevices[pahandle]);
 		}
 		else {
 			// No. Release old schedule...
-			free(audiodevices[pahandle].schedule);
-			audiodevices[pahandle].schedule = NULL;
-			audiodevices[pahandle].schedule_size = 0;
+			PsychPADestroySchedule(&audiodevices[pahandle]);
 		}
 	}
 
-	// Reset current position in schedule to start and size to zero in any case:
-	audiodevices[pahandle].schedule_pos = 0;
-	audiodevices[pahandle].schedule_writepos = 0;
-	
 	// Enable/Reset request?
 	if (enableSchedule && (NULL == audiodevices[pahandle].schedule)) {
 		// Enable request - Allocate proper schedule:
-		audiodevices[pahandle].schedule_size = 0;
-		audiodevices[pahandle].schedule = (PsychPASchedule*) calloc(maxSize, sizeof(PsychPASchedule));
-		if (audiodevices[pahandle].schedule == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create a schedule!");
+		slab = PsychPAAllocScheduleSlab((unsigned int) maxSize);
+		if (slab == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to create a schedule!");
 
-		// Assign new size:
+		// Assign new slots and size, link them into a ring:
+		audiodevices[pahandle].schedule_slabs = slab;
+		audiodevices[pahandle].schedule = slab->slots;
 		audiodevices[pahandle].schedule_size = maxSize;
+		PsychPAResetSchedule(&audiodevices[pahandle]);
 	}
 
 	// Done.
@@ -5298,7 +9034,10 @@ PsychError PSYCHPORTAUDIOAddToSchedule(void)
 		"Failure to add an item can happen if the schedule is full. If playback is running, you can "
 		"simply retry after some time, because eventually the playback will consume and thereby free "
 		"at least one slot in the schedule. If playback is stopped and you get this failure, you should "
-		"reallocate the schedule with a bigger size via a proper call to 'UseSchedule'.\n"
+		"reallocate the schedule with a bigger size via a proper call to 'UseSchedule'. Schedules created "
+		"with the 'growable' flag of 'UseSchedule' never fail this way, but grow to make room for the new item.\n"
+		"Adding items doesn't lock out the audio processing thread, so it is safe to add items to a running "
+		"schedule at any time without affecting audio timing.\n"
 		"Please note that after playback/processing of a schedule has finished by itself, or due to "
 		"'Stop'ping the playback via the stop function, you should clear or reactivate the schedule and rewrite "
 		"it, otherwise results at next call to 'Start' may be undefined. You can clear/reactivate a schedule "
@@ -5341,7 +9080,7 @@ PsychError PSYCHPORTAUDIOAddToSchedule(void)
 	
 	PsychPASchedule* slot;
 	PsychPABuffer* buffer;
-	int	slotid;
+	PsychPADevice* dev;
 	double startSample, endSample, sMultiplier;
 	psych_int64 maxSample;
 	int unitIsSecs;
@@ -5437,32 +9176,49 @@ PsychError PSYCHPORTAUDIOAddToSchedule(void)
 	// Copy in optional specialFlags:
 	PsychCopyInIntegerArg(7, kPsychArgOptional, &specialFlags);
 	
-	// All settings validated and ready to initialize a slot in the schedule:
+	// All settings validated and ready to initialize a slot in the schedule. We don't lock the
+	// device for this: We are the only producer of slots, paCallback the only consumer, and the
+	// pending bit of a slot tells who owns it:
+	dev = &audiodevices[pahandle];
+	slot = dev->schedule_writeslot;
 
-	// Lock device:
-	PsychPALockDeviceMutex(&audiodevices[pahandle]);
+	// Schedule full, but allowed to grow? Then double its size. Refuse to grow beyond 2^30 slots:
+	if ((slot->mode & 2) && dev->schedule_growable && (dev->schedule_size <= (1U << 29))) {
+		if (!PsychPAGrowSchedule(dev, dev->schedule_size)) PsychErrorExitMsg(PsychError_outofMemory, "Insufficient free system memory when trying to grow the schedule!");
+		slot = dev->schedule_writeslot;
+	}
 
-	// Map writepos to slotindex:
-	slotid = audiodevices[pahandle].schedule_writepos % audiodevices[pahandle].schedule_size;
-	
 	// Enough unoccupied space in schedule? Ie., is this slot free (either never used, or already consumed and ready for recycling)?
-	if ((audiodevices[pahandle].schedule[slotid].mode & 2) == 0) {
-		// Fill slot:
-		slot = (PsychPASchedule*) &(audiodevices[pahandle].schedule[slotid]);
-		slot->mode = 1 | 2 | ((specialFlags & 1) ? 4 : 0);
+	if ((slot->mode & 2) == 0) {
+		// The slot is ours now. Make sure paCallback is done with it before we touch it:
+		PsychPAMemoryBarrier();
+
 		slot->bufferhandle   = bufferHandle;
 		slot->repetitions    = (commandCode == 0) ? ((repetitions == 0) ? -1 : repetitions) : 0.0;;
 		slot->loopStartFrame = startSample;
 		slot->loopEndFrame   = endSample;
 		slot->command		 = commandCode;
+
+		// Reference the new buffer. Usually the slot dropped its reference to its old buffer already when it was retired:
+		PsychLockMutex(&bufferListmutex);
+		PsychPAReleaseBufferReference(slot);
+		slot->buffergeneration = (bufferHandle > 0) ? buffer->generation : 0;
+		PsychPAAcquireBufferReference(slot);
+		PsychUnlockMutex(&bufferListmutex);
 		slot->tWhen			 = (commandCode > 0) ? repetitions : 0.0;
 
+		// Publish the slot to paCallback only after all of its content is visible:
+		PsychPAMemoryBarrier();
+		slot->mode = 1 | 2 | ((specialFlags & 1) ? 4 : 0);
+
 		// Advance write position for next update iteration:
-		audiodevices[pahandle].schedule_writepos++;
+		dev->schedule_writeprev = slot;
+		dev->schedule_writeslot = slot->next;
+		dev->schedule_writepos++;
 		
 		// Recompute number of free slots:
-		if (audiodevices[pahandle].schedule_size >= (audiodevices[pahandle].schedule_writepos - audiodevices[pahandle].schedule_pos)) {
-			freeslots = audiodevices[pahandle].schedule_size - (audiodevices[pahandle].schedule_writepos - audiodevices[pahandle].schedule_pos);
+		if (dev->schedule_size >= (dev->schedule_writepos - dev->schedule_pos)) {
+			freeslots = dev->schedule_size - (dev->schedule_writepos - dev->schedule_pos);
 		}
 		else {
 			freeslots = 0;
@@ -5476,9 +9232,6 @@ PsychError PSYCHPORTAUDIOAddToSchedule(void)
 		freeslots = 0;
 	}
 
-	// Unlock device:
-	PsychPAUnlockDeviceMutex(&audiodevices[pahandle]);
-
 	// Return optional result code:
 	PsychCopyOutDoubleArg(1, kPsychArgOptional, (double) success);
 
@@ -5538,7 +9291,7 @@ PsychError PSYCHPORTAUDIOSetOpMode(void)
 	// Set new opMode, if one was provided:
 	if (opMode != -1) {
 		// Stop engine if it is running:
-		if (!Pa_IsStreamStopped(audiodevices[pahandle].stream)) Pa_StopStream(audiodevices[pahandle].stream);
+		if (!PsychPAIsStreamStopped(&audiodevices[pahandle])) PsychPAStopStream(&audiodevices[pahandle]);
 
 		// Reset state:
 		audiodevices[pahandle].state = 0;
@@ -5636,6 +9389,9 @@ PsychError PSYCHPORTAUDIODirectInputMonitoring(void)
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &pahandle);
 	if (pahandle < 0 || pahandle>=MAX_PSYCH_AUDIO_DEVS || audiodevices[pahandle].stream == NULL) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided. No such device with that handle open!");
 
+	// Virtual null devices have no sound hardware to query or to monitor:
+	if (audiodevices[pahandle].virtualStream) PsychErrorExitMsg(PsychError_user, "Invalid audio device handle provided. Direct input monitoring is not supported on virtual null devices!");
+
 	// Get mandatory enable flag:
 	PsychCopyInIntegerArg(2, kPsychArgRequired, &enable);
 	if (enable < 0 || enable > 1) PsychErrorExitMsg(PsychError_user, "Invalid enable flag provided. Must be zero or one for on or off!");
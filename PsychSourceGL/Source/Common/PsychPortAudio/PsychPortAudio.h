@@ -83,6 +83,11 @@ PsychError PSYCHPORTAUDIOUseSchedule(void);
 PsychError PSYCHPORTAUDIOAddToSchedule(void);
 // Create and fill dynamic audio buffer:
 PsychError PSYCHPORTAUDIOCreateBuffer(void); 
+// Create dynamic audio buffer backed by a memory-mapped sound file:
+PsychError PSYCHPORTAUDIOCreateBufferFromFile(void);
+PsychError PSYCHPORTAUDIOStreamFromFile(void);
+PsychError PSYCHPORTAUDIOCaptureToFile(void);
+PsychError PSYCHPORTAUDIOGetTimingStats(void);
 // Delete dynamic audio buffer:
 PsychError PSYCHPORTAUDIODeleteBuffer(void); 
 // Change device opMode at runtime:
@@ -91,5 +96,8 @@ PsychError PSYCHPORTAUDIOSetOpMode(void);
 PsychError PSYCHPORTAUDIODirectInputMonitoring(void);
 // Set per-device volume:
 PsychError PSYCHPORTAUDIOVolume(void);
+PsychError PSYCHPORTAUDIOSetEnvelope(void);
+// Parallel rendering of slaves:
+PsychError PSYCHPORTAUDIOUseRenderThreads(void);
 //end include once
 #endif
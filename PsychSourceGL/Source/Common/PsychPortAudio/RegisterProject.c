@@ -62,10 +62,16 @@ PsychError PsychModuleInit(void)
 	PsychErrorExit(PsychRegister("UseSchedule", &PSYCHPORTAUDIOUseSchedule));
 	PsychErrorExit(PsychRegister("AddToSchedule", &PSYCHPORTAUDIOAddToSchedule));
 	PsychErrorExit(PsychRegister("CreateBuffer", &PSYCHPORTAUDIOCreateBuffer));
+	PsychErrorExit(PsychRegister("CreateBufferFromFile", &PSYCHPORTAUDIOCreateBufferFromFile));
+	PsychErrorExit(PsychRegister("StreamFromFile", &PSYCHPORTAUDIOStreamFromFile));
+	PsychErrorExit(PsychRegister("CaptureToFile", &PSYCHPORTAUDIOCaptureToFile));
+	PsychErrorExit(PsychRegister("GetTimingStats", &PSYCHPORTAUDIOGetTimingStats));
 	PsychErrorExit(PsychRegister("DeleteBuffer", &PSYCHPORTAUDIODeleteBuffer));
 	PsychErrorExit(PsychRegister("SetOpMode", &PSYCHPORTAUDIOSetOpMode));
 	PsychErrorExit(PsychRegister("DirectInputMonitoring", &PSYCHPORTAUDIODirectInputMonitoring));
 	PsychErrorExit(PsychRegister("Volume", &PSYCHPORTAUDIOVolume));
+	PsychErrorExit(PsychRegister("SetEnvelope", &PSYCHPORTAUDIOSetEnvelope));
+	PsychErrorExit(PsychRegister("UseRenderThreads", &PSYCHPORTAUDIOUseRenderThreads));
 
 	// Setup synopsis help strings:
 	InitializeSynopsis();   //Scripting glue won't require this if the function takes no arguments.
@@ -92,28 +92,30 @@ void PsychSetGLColor(PsychColorType *color, PsychWindowRecordType *windowRecord)
 /* PsychSetupVertexColorArrays()
 
    Helper routine, called from the different batch drawing functions of Screen():
+   Setup vertex color array of 'mc' components of type 'colortype' at 'colorpointer',
+   usually as returned by PsychWriteVertexColorStream() and PsychEndVertexStream().
 */
-void PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, double* colors, unsigned char *bytecolors)
+void PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, GLenum colortype, const GLvoid* colorpointer)
 {
 	if (enable) {
 		// Enable and setup whatever's used:
 		if (windowRecord->defaultDrawShader) {
-			// Shader based unclamped path:
-			if (colors)     glTexCoordPointer(mc, GL_DOUBLE, 0, colors);
-
 			// Can't support uint8 datatype for this vertex attribute :-(
-			if (bytecolors) PsychErrorExitMsg(PsychError_user, "Sorry, this function can't accept matrices of uint8 type for colors\nif color clamping is disabled or high precision mode active.\n Use the double() operator to convert to double matrix.");
+			if (colortype == GL_UNSIGNED_BYTE) {
+				if (glBindBuffer) glBindBuffer(GL_ARRAY_BUFFER, 0);
+				PsychErrorExitMsg(PsychError_user, "Sorry, this function can't accept matrices of uint8 type for colors\nif color clamping is disabled or high precision mode active.\n Use the double() operator to convert to double matrix.");
+			}
 
+			// Shader based unclamped path:
+			glTexCoordPointer(mc, colortype, 0, colorpointer);
 			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-			glColorPointer(4, GL_DOUBLE, 0, NULL);
+			glColorPointer(4, GL_FLOAT, 0, NULL);
 		}
 		else {
 			// Standard path:
-			if (colors)     glColorPointer(mc, GL_DOUBLE, 0, colors);
-			if (bytecolors) glColorPointer(mc, GL_UNSIGNED_BYTE, 0, bytecolors);
-
+			glColorPointer(mc, colortype, 0, colorpointer);
 			glEnableClientState(GL_COLOR_ARRAY);
-			glTexCoordPointer(4, GL_DOUBLE, 0, NULL);
+			glTexCoordPointer(4, GL_FLOAT, 0, NULL);
 		}
 	}
 	else {
@@ -127,8 +129,8 @@ void PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool
 			glDisableClientState(GL_COLOR_ARRAY);
 		}
 		
-		glColorPointer(4, GL_DOUBLE, 0, NULL);
-		glTexCoordPointer(4, GL_DOUBLE, 0, NULL);
+		glColorPointer(4, GL_FLOAT, 0, NULL);
+		glTexCoordPointer(4, GL_FLOAT, 0, NULL);
 	}
 }
 
@@ -376,6 +378,28 @@ GLdouble *PsychExtractQuadVertexFromRect(double *rect, int vertexNumber, GLdoubl
 	return(vertex);
 }
 
+/* PsychAllocInDoubleOrFloatMatArg()
+ *
+ * Helper for PsychPrepareRenderBatch(): Get a required matrix argument. If the caller
+ * provided a 'fptr' and the argument is a single precision matrix, return it unconverted
+ * in *fptr and set *dptr to NULL. Otherwise return a double matrix in *dptr.
+ */
+static void PsychAllocInDoubleOrFloatMatArg(int position, int* m, int* n, int* p, double** dptr, float** fptr)
+{
+	psych_int64 m64, n64, p64;
+
+	if (fptr && (PsychGetArgType(position) == PsychArgType_single)) {
+		PsychAllocInFloatMatArg64(position, TRUE, &m64, &n64, &p64, fptr);
+		*m = (int) m64;
+		*n = (int) n64;
+		*p = (int) p64;
+		*dptr = NULL;
+	}
+	else {
+		PsychAllocInDoubleMatArg(position, TRUE, m, n, p, dptr);
+	}
+}
+
 /* PsychPrepareRenderBatch()
  *
  * Perform setup for a batch of render requests for a specific primitive. Some 2D Screen
@@ -385,8 +409,13 @@ GLdouble *PsychExtractQuadVertexFromRect(double *rect, int vertexNumber, GLdoubl
  * are provided and if its a single one or multiple ones. It sets up the rendering pipe accordingly,
  * performing required conversion steps. The actual drawing routine just needs to perform primitive
  * specific code.
+ *
+ * Callers which can handle single precision input pass non-NULL 'xyf' and/or 'sizef' pointers:
+ * If usercode provides coordinates or sizes as 'single' matrices, they are returned unconverted
+ * in *xyf or *sizef and the corresponding *xy or *size is set to NULL. Otherwise *xyf or *sizef
+ * is set to NULL and the double precision data is returned as usual.
  */
-void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size)
+void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, float** xyf, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size, float** sizef)
 {
 	PsychColorType							color;
 	int                                     m,n,p,mc,nc,pc;
@@ -399,6 +428,10 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
 	coords_pos = abs(coords_pos);
 	colors_pos = abs(colors_pos);
 	sizes_pos = abs(sizes_pos);
+
+	// No single precision input unless we find some below:
+	if (xyf) *xyf = NULL;
+	if (sizef) *sizef = NULL;
 	
 	// Get mandatory or optional xy coordinates argument
 	isArgThere = PsychIsArgPresent(PsychArgIn, coords_pos);
@@ -407,7 +440,7 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
 	}
 	
 	if (isArgThere) {
-		PsychAllocInDoubleMatArg(coords_pos, TRUE, &m, &n, &p, xy);
+		PsychAllocInDoubleOrFloatMatArg(coords_pos, &m, &n, &p, xy, xyf);
 		if(p!=1 || (m!=*coords_count && (m*n)!=*coords_count)) {
 			printf("PTB-ERROR: Coordinates must be a %i tuple or a %i rows vector.\n", *coords_count, *coords_count);
 			PsychErrorExitMsg(PsychError_user, "Invalid format for coordinate specification.");
@@ -437,7 +470,7 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
 			*size[0] = 1;
 			nrsize=1;
 		} else {
-			PsychAllocInDoubleMatArg(sizes_pos, TRUE, &m, &n, &p, size);
+			PsychAllocInDoubleOrFloatMatArg(sizes_pos, &m, &n, &p, size, sizef);
 			if(p!=1) PsychErrorExitMsg(PsychError_user, "Size must be a scalar or a vector with one column or row");
 			nrsize=m*n;
 			if (nrsize!=nrpoints && nrsize!=1 && *sizes_count!=1) PsychErrorExitMsg(PsychError_user, "Size vector must contain one size value per item.");
@@ -522,3 +555,226 @@ void PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos
 		
 	return;
 }
+
+/* Streaming of vertex data for the batch drawing functions of Screen():
+ *
+ * Each onscreen window has a vertex buffer ring, created on first use and shared with all
+ * offscreen windows and textures which use its OpenGL context. A batch drawing function
+ * calls PsychBeginVertexStream() to get host memory for its vertex data, converts its
+ * input data once into that memory, e.g., coordinates into float, then calls
+ * PsychEndVertexStream() to submit the batch and get the base pointer for gl*Pointer(),
+ * draws, and finally calls PsychReleaseVertexStream() to unbind the vertex buffer again.
+ *
+ * Batches are appended to the vertex buffer. If a batch doesn't fit into the remaining
+ * space, the vertex buffer gets orphaned, i.e., fresh storage is allocated for it, while
+ * the gpu can still read the previous batches from the old storage. Therefore we never
+ * need to wait for the gpu, and can write each batch directly into the buffer via an
+ * unsynchronized glMapBufferRange() if supported, or via glBufferSubData() otherwise.
+ * Without vertex buffer objects, the batch is passed as client vertex arrays.
+ */
+
+// Initial size of a windows vertex buffer ring in bytes. It grows if needed for big batches:
+#define PSYCH_VERTEXSTREAM_MINSIZE	(64 * 1024)
+
+// Alignment of each batch in the vertex buffer ring in bytes:
+#define PSYCH_VERTEXSTREAM_ALIGN	64
+
+typedef struct PsychVertexStreamRing {
+	GLuint			vbo;			// Vertex buffer object, or zero if vertex buffers are unsupported.
+	psych_bool		usemap;			// TRUE if batches can be written directly into 'vbo' via glMapBufferRange().
+	size_t			size;			// Size of 'vbo' storage in bytes.
+	size_t			offset;			// Offset for next batch in 'vbo'.
+	size_t			batchoffset;	// Offset of current batch in 'vbo'.
+	size_t			batchsize;		// Size of current batch in bytes.
+	void*			batchmemory;	// Host memory for current batch: Mapped 'vbo' range or temporary memory.
+	psych_bool		batchmapped;	// TRUE if 'batchmemory' is a mapped 'vbo' range.
+} PsychVertexStreamRing;
+
+/* PsychBeginVertexStream()
+ *
+ * Start a batch of 'nbytes' bytes of vertex data for 'windowRecord', whose OpenGL context must
+ * be bound. Returns host memory into which the caller must write the batch. No other OpenGL calls
+ * or error exits are allowed before the batch is submitted via PsychEndVertexStream().
+ */
+void* PsychBeginVertexStream(PsychWindowRecordType *windowRecord, size_t nbytes)
+{
+	PsychWindowRecordType* parentRecord = PsychGetParentWindow(windowRecord);
+	PsychVertexStreamRing* ring = parentRecord->vertexStreamRing;
+	size_t newsize;
+
+	if (ring == NULL) {
+		ring = (PsychVertexStreamRing*) calloc(1, sizeof(PsychVertexStreamRing));
+		if (ring == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of system memory when trying to allocate vertex buffer ring!");
+		parentRecord->vertexStreamRing = ring;
+
+		// Vertex buffer objects supported? Otherwise we pass batches as client vertex arrays:
+		if (glGenBuffers && glBindBuffer && glBufferData && glBufferSubData && (glewIsSupported("GL_VERSION_1_5") || glewIsSupported("GL_ARB_vertex_buffer_object"))) {
+			glGenBuffers(1, &(ring->vbo));
+			ring->usemap = (glMapBufferRange && glUnmapBuffer && (glewIsSupported("GL_VERSION_3_0") || glewIsSupported("GL_ARB_map_buffer_range"))) ? TRUE : FALSE;
+		}
+
+		if (PsychPrefStateGet_Verbosity() > 4) {
+			printf("PTB-INFO: Streaming vertex data of batch drawing commands %s.\n",
+				   (ring->vbo) ? ((ring->usemap) ? "via mapped vertex buffer ring" : "via vertex buffer ring") : "as client vertex arrays");
+		}
+	}
+
+	// Empty batches still get a valid range:
+	if (nbytes == 0) nbytes = PSYCH_VERTEXSTREAM_ALIGN;
+
+	ring->batchsize = nbytes;
+	ring->batchmapped = FALSE;
+
+	// No vertex buffer? Stage batch in temporary memory for use as client vertex array:
+	if (ring->vbo == 0) {
+		ring->batchmemory = PsychMallocTemp(nbytes);
+		return(ring->batchmemory);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, ring->vbo);
+
+	// Batch doesn't fit into remaining space? Orphan the buffer, growing it if needed:
+	if (ring->offset + nbytes > ring->size) {
+		if (nbytes > ring->size) {
+			newsize = (ring->size > 0) ? ring->size : PSYCH_VERTEXSTREAM_MINSIZE;
+			while (newsize < nbytes) newsize *= 2;
+			ring->size = newsize;
+		}
+
+		glBufferData(GL_ARRAY_BUFFER, ring->size, NULL, GL_STREAM_DRAW);
+		ring->offset = 0;
+	}
+
+	ring->batchoffset = ring->offset;
+	ring->offset += (nbytes + PSYCH_VERTEXSTREAM_ALIGN - 1) & ~((size_t) PSYCH_VERTEXSTREAM_ALIGN - 1);
+
+	// Write directly into vertex buffer if possible: Unsynchronized, as this range isn't used
+	// by the gpu since the last orphaning:
+	if (ring->usemap) {
+		ring->batchmemory = glMapBufferRange(GL_ARRAY_BUFFER, ring->batchoffset, nbytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+		if (ring->batchmemory) {
+			ring->batchmapped = TRUE;
+			return(ring->batchmemory);
+		}
+	}
+
+	// Stage batch in temporary memory for upload via glBufferSubData():
+	ring->batchmemory = PsychMallocTemp(nbytes);
+	return(ring->batchmemory);
+}
+
+/* PsychEndVertexStream()
+ *
+ * Submit the batch started via PsychBeginVertexStream(). Returns the base pointer of the batch
+ * to use in gl*Pointer() calls, ie., an offset into the now bound vertex buffer, or a host memory
+ * pointer for client vertex arrays. Byte offsets of the callers arrays within the batch are added
+ * to the base pointer.
+ */
+const GLubyte* PsychEndVertexStream(PsychWindowRecordType *windowRecord)
+{
+	PsychVertexStreamRing* ring = PsychGetParentWindow(windowRecord)->vertexStreamRing;
+	const GLubyte* base;
+
+	if (ring->vbo == 0) {
+		base = (const GLubyte*) ring->batchmemory;
+	}
+	else {
+		if (ring->batchmapped) {
+			// Unmap can fail if the buffer storage was lost, e.g., due to a display mode change.
+			// The batch is lost then, but later batches will be fine:
+			if (!glUnmapBuffer(GL_ARRAY_BUFFER) && (PsychPrefStateGet_Verbosity() > 1)) {
+				printf("PTB-WARNING: Vertex buffer ring of window %i got corrupted. Some batch drawing operation may be incomplete.\n", windowRecord->windowIndex);
+			}
+		}
+		else {
+			glBufferSubData(GL_ARRAY_BUFFER, ring->batchoffset, ring->batchsize, ring->batchmemory);
+		}
+
+		base = (const GLubyte*) ring->batchoffset;
+	}
+
+	ring->batchmemory = NULL;
+	ring->batchmapped = FALSE;
+
+	return(base);
+}
+
+/* PsychReleaseVertexStream()
+ *
+ * Unbind vertex buffer after drawing a batch submitted via PsychEndVertexStream(), so
+ * following client vertex array calls aren't misinterpreted as vertex buffer offsets.
+ */
+void PsychReleaseVertexStream(PsychWindowRecordType *windowRecord)
+{
+	PsychVertexStreamRing* ring = PsychGetParentWindow(windowRecord)->vertexStreamRing;
+
+	if (ring && ring->vbo) glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/* PsychDeleteVertexStreamRing()
+ *
+ * Release vertex buffer ring of onscreen window 'windowRecord' on window close.
+ */
+void PsychDeleteVertexStreamRing(PsychWindowRecordType *windowRecord)
+{
+	PsychVertexStreamRing* ring = windowRecord->vertexStreamRing;
+
+	if (ring == NULL) return;
+	windowRecord->vertexStreamRing = NULL;
+
+	// OpenGL objects are only released if the context still exists, otherwise they are already gone:
+	if (ring->vbo && windowRecord->targetSpecific.contextObject) {
+		PsychSetGLContext(windowRecord);
+		glDeleteBuffers(1, &(ring->vbo));
+	}
+
+	free(ring);
+}
+
+/* PsychGetVertexColorStreamSize()
+ *
+ * Return number of bytes needed by PsychWriteVertexColorStream() for 'count' colors
+ * with 'mc' components each. uint8 colors stay uint8 unless a draw shader for unclamped
+ * colors is active, everything else is converted to float:
+ */
+size_t PsychGetVertexColorStreamSize(PsychWindowRecordType *windowRecord, int count, int mc, unsigned char* bytecolors)
+{
+	return((size_t) count * mc * ((bytecolors && !windowRecord->defaultDrawShader) ? sizeof(GLubyte) : sizeof(GLfloat)));
+}
+
+/* PsychWriteVertexColorStream()
+ *
+ * Write 'count' colors with 'mc' components each from 'colors' or 'bytecolors' into
+ * the vertex stream memory 'dst', repeating each color 'repeat' times, e.g., for all
+ * vertices of a rectangle. Returns the data type of written colors for use with
+ * PsychSetupVertexColorArrays().
+ */
+GLenum PsychWriteVertexColorStream(PsychWindowRecordType *windowRecord, void* dst, int count, int mc, int repeat, double* colors, unsigned char* bytecolors)
+{
+	GLubyte *bdst = (GLubyte*) dst;
+	GLfloat *fdst = (GLfloat*) dst;
+	int i, j, k;
+
+	if (bytecolors && !windowRecord->defaultDrawShader) {
+		for (i = 0; i < count; i++) {
+			for (j = 0; j < repeat; j++) {
+				for (k = 0; k < mc; k++) *(bdst++) = bytecolors[i * mc + k];
+			}
+		}
+
+		return(GL_UNSIGNED_BYTE);
+	}
+
+	for (i = 0; i < count; i++) {
+		for (j = 0; j < repeat; j++) {
+			if (bytecolors) {
+				for (k = 0; k < mc; k++) *(fdst++) = (GLfloat) bytecolors[i * mc + k] / 255.0f;
+			}
+			else {
+				for (k = 0; k < mc; k++) *(fdst++) = (GLfloat) colors[i * mc + k];
+			}
+		}
+	}
+
+	return(GL_FLOAT);
+}
@@ -1150,6 +1150,7 @@ psych_bool PsychCreateFBO(PsychFBO** fbo, GLenum fboInternalFormat, psych_bool n
 	GLint bpc;
 	GLboolean isFloatBuffer;
 	char fbodiag[1024];
+	size_t samples, texelSize;
     
 	// Eat all GL errors:
 	PsychTestForGLErrors();
@@ -1167,6 +1168,8 @@ psych_bool PsychCreateFBO(PsychFBO** fbo, GLenum fboInternalFormat, psych_bool n
 		(*fbo)->width = width;
 		(*fbo)->height = height;
 		(*fbo)->multisample = multisample;
+		(*fbo)->colorSizeBytes = 0;
+		(*fbo)->zSizeBytes = 0;
 		
 		// fboInternalFormat == 0 --> Only allocate and assign, don't initialize FBO.
 		if (fboInternalFormat==0) return(TRUE);
@@ -1625,6 +1628,29 @@ psych_bool PsychCreateFBO(PsychFBO** fbo, GLenum fboInternalFormat, psych_bool n
 	// Test all GL errors:
 	PsychTestForGLErrors();
 
+	// Accounting... ...this is only a rough guesstimate. A preassigned color buffer texture is
+	// accounted for by its owner:
+	samples = ((*fbo)->multisample > 0) ? (size_t) (*fbo)->multisample : 1;
+	if (fboInternalFormat != (GLenum) 1) {
+		switch (fboInternalFormat) {
+			case GL_RGBA16:
+			case GL_RGBA_FLOAT16_APPLE:
+			case GL_RGB_FLOAT16_APPLE:
+				texelSize = 8;
+			break;
+
+			case GL_RGBA_FLOAT32_APPLE:
+			case GL_RGB_FLOAT32_APPLE:
+				texelSize = 16;
+			break;
+
+			default:
+				texelSize = 4;
+		}
+		(*fbo)->colorSizeBytes = texelSize * (size_t) width * (size_t) height * samples;
+	}
+	(*fbo)->zSizeBytes = ((*fbo)->ztexid) ? 4 * (size_t) width * (size_t) height * samples : 0;
+
 	// Well done.
 	return(TRUE);
 }
@@ -1644,6 +1670,11 @@ void PsychCreateShadowFBOForTexture(PsychWindowRecordType *textureRecord, psych_
 {
 	GLenum fboInternalFormat;
 	
+	// Textures shared with the texture cache must not be modified. Make a private copy of it in
+	// normalized orientation if it is supposed to become a rendertarget. Items of an atlas texture
+	// always need a private copy, as a FBO would cover the whole atlas:
+	if ((asRendertarget && textureRecord->textureCacheEntry) || (textureRecord->textureAtlasOffset[0] >= 0)) PsychNormalizeTextureOrientation(textureRecord);
+
 	// Do we already have a framebuffer object for this texture? All textures start off without one,
 	// because most textures are just used for drawing them, not drawing *into* them. Therefore we
 	// only create a full blown FBO on demand here.
@@ -1766,7 +1797,12 @@ void PsychNormalizeTextureOrientation(PsychWindowRecordType *sourceRecord)
 
 		// Need to query real size of underlying texture, not the logical size from sourceRecord->rect, otherwise we'd screw
 		// up for padded textures (from Quicktime movie/vidcap) where the real texture is a bit bigger than its logical size.
-		if (sourceRecord->textureOrientation > 1) {
+		// Items of an atlas texture from Screen('MakeTextures') only get a copy of their sub-rectangle of the atlas:
+		if (sourceRecord->textureAtlasOffset[0] >= 0) {
+			width = (int) PsychGetWidthFromRect(sourceRecord->rect);
+			height = (int) PsychGetHeightFromRect(sourceRecord->rect);
+		}
+		else if (sourceRecord->textureOrientation > 1) {
 			// Non-transposed textures, width and height are correct:
 			glGetTexLevelParameteriv(PsychGetTextureTarget(sourceRecord), 0, GL_TEXTURE_WIDTH, &width);
 			glGetTexLevelParameteriv(PsychGetTextureTarget(sourceRecord), 0, GL_TEXTURE_HEIGHT, &height);
@@ -1848,6 +1884,10 @@ void PsychNormalizeTextureOrientation(PsychWindowRecordType *sourceRecord)
 			// Special case: CoreVideo texture:
 			PsychFreeMovieTexture(sourceRecord);
 		}
+		else if (sourceRecord->textureCacheEntry) {
+			// Texture shared with the texture cache: Keep it, we now have our private copy:
+			PsychDetachCachedTexture(sourceRecord);
+		}
 		else {
 			// Standard case:
 			glDeleteTextures(1, &(sourceRecord->textureNumber));
@@ -49,6 +49,7 @@ void PsychDeleteAllMovieWriters(void);
 int PsychCreateNewMovieFile(char* moviefile, int width, int height, double framerate, char* movieoptions);
 int PsychFinalizeNewMovieFile(int movieHandle);
 int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_bool isUpsideDown);
+int PsychAddVideoFrameBufferToMovie(int moviehandle, const unsigned char* framepixels, int width, int height, double timestamp);
 unsigned char*	PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twidth, unsigned int* theight);
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer);
 
@@ -246,6 +246,47 @@ int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_boo
 	return((int) ret);
 }
 
+/* Add a video frame from 'framepixels', an upside-down image of 'width' x 'height' pixels in the format of the buffer
+ * returned by PsychGetVideoFrameForMoviePtr(), with a presentation 'timestamp' in seconds since start of the movie, or
+ * without timestamp if 'timestamp' is negative. Unlike PsychAddVideoFrameToMovie(), this leaves the buffer of
+ * PsychGetVideoFrameForMoviePtr() alone and doesn't use the error handler, so it can be called from a background
+ * thread, e.g., for recording of flips. Returns zero on success, non-zero on failure.
+ */
+int PsychAddVideoFrameBufferToMovie(int moviehandle, const unsigned char* framepixels, int width, int height, double timestamp)
+{
+	PsychMovieWriterRecordType* pwriterRec;
+	GstBuffer*          pushBuffer;
+	GstFlowReturn       ret;
+	unsigned char*		pixptr;
+	size_t				rowSize = (size_t) width * 4;
+	int                 y;
+
+	if (moviehandle < 0 || moviehandle >= PSYCH_MAX_MOVIEWRITERDEVICES) return(-1);
+	pwriterRec = &(moviewriterRecordBANK[moviehandle]);
+	if ((NULL == pwriterRec->ptbvideoappsrc) || (width != pwriterRec->width) || (height != pwriterRec->height)) return(-1);
+
+	pushBuffer = gst_buffer_try_new_and_alloc(rowSize * height);
+	if (NULL == pushBuffer) return(-1);
+	if (NULL == GST_BUFFER_DATA(pushBuffer)) {
+		gst_buffer_unref(pushBuffer);
+		return(-1);
+	}
+
+	// Copy rows in reverse order, to flip the image vertically:
+	pixptr = (unsigned char*) GST_BUFFER_DATA(pushBuffer);
+	for (y = 0; y < height; y++) memcpy(pixptr + (size_t) y * rowSize, framepixels + (size_t) (height - 1 - y) * rowSize, rowSize);
+
+	if (timestamp >= 0) GST_BUFFER_TIMESTAMP(pushBuffer) = (GstClockTime) (timestamp * GST_SECOND);
+
+	// Add buffer to movie:
+	g_signal_emit_by_name(pwriterRec->ptbvideoappsrc, "push-buffer", pushBuffer, &ret);
+
+	// Unref it - it is now owned and memory managed by the pipeline:
+	gst_buffer_unref(pushBuffer);
+
+	return((int) ret);
+}
+
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer)
 {
 	PsychMovieWriterRecordType* pwriterRec = PsychGetMovieWriter(moviehandle, FALSE);
@@ -731,6 +772,7 @@ void PsychExitMovieWriting(void) { return; }
 void PsychDeleteAllMovieWriters(void) { return; }
 unsigned char*	PsychGetVideoFrameForMoviePtr(int moviehandle, unsigned int* twidth, unsigned int* theight) { return(NULL); }
 int PsychAddVideoFrameToMovie(int moviehandle, int frameDurationUnits, psych_bool isUpsideDown) { return(0); }
+int PsychAddVideoFrameBufferToMovie(int moviehandle, const unsigned char* framepixels, int width, int height, double timestamp) { return(-1); }
 psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels, unsigned int nrSamples, double* buffer)
 {
     PsychErrorExitMsg(PsychError_unimplemented, "Sorry, movie writing and editing support disabled at compile-time for Linux.");
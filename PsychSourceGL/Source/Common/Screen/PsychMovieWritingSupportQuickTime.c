@@ -523,6 +523,12 @@ psych_bool PsychAddAudioBufferToMovie(int moviehandle, unsigned int nrChannels,
     return(0);
 }
 
+int PsychAddVideoFrameBufferToMovie(int moviehandle, const unsigned char* framepixels, int width, int height, double timestamp)
+{
+    // Quicktime movie writing isn't thread-safe, so recording of flips is unsupported:
+    return(-1);
+}
+
 // End of routines.
 #endif
 #endif
@@ -68,6 +68,624 @@ static GLenum  texturetarget = 0;
 // only used if texture creation failed and out-of-memory is a likely suspect.
 static size_t texmemguesstimate = 0;
 
+// Asynchronous texture creation:
+//
+// PsychBeginAsyncTexture() attaches a job to a texture record and returns a buffer for the texture data,
+// either the mapped memory of a pixel buffer object (PBO) or malloc()'ed memory. The buffer is filled
+// by a PsychAsyncTextureWorkFunc on our background worker thread, queued by PsychQueueAsyncTextureWork(),
+// or directly by the caller. PsychFinishAsyncTexture() waits for the worker - or checks if it is done -
+// and then uploads the buffer via PsychCreateTexture() on the main thread, which owns the OpenGL context.
+// Upload from a PBO is a DMA transfer by the graphics driver, so it doesn't stall the main thread.
+typedef struct PsychAsyncTextureJob {
+	struct PsychAsyncTextureJob*	next;		// Next job in work queue.
+	PsychAsyncTextureWorkFunc		workFunc;	// Function to fill 'buffer' on the worker thread, or NULL.
+	void*							workArg;	// Argument for 'workFunc'.
+	void*							buffer;		// Texture data buffer: Mapped PBO or malloc()'ed memory.
+	size_t							bufferSize;	// Size of 'buffer' in bytes.
+	GLuint							pbo;		// Pixel buffer object of 'buffer', or 0 for malloc()'ed memory.
+	psych_bool						done;		// 'buffer' is completely filled. Protected by asyncTexMutex.
+} PsychAsyncTextureJob;
+
+static psych_bool				asyncTexThreadRunning = FALSE;
+static psych_bool				asyncTexShutdown = FALSE;
+static psych_thread				asyncTexThread;
+static psych_mutex				asyncTexMutex;
+static psych_condition			asyncTexWorkCondition;	// Signalled when work is queued.
+static psych_condition			asyncTexDoneCondition;	// Signalled when a job is done.
+static PsychAsyncTextureJob*	asyncTexQueueHead = NULL;
+static PsychAsyncTextureJob*	asyncTexQueueTail = NULL;
+
+// Main function of the background worker thread: Process queued jobs in order of submission.
+static void* PsychAsyncTextureThreadMain(void* dummy)
+{
+	PsychAsyncTextureJob* job;
+
+	PsychLockMutex(&asyncTexMutex);
+	while (!asyncTexShutdown) {
+		if (asyncTexQueueHead == NULL) {
+			PsychWaitCondition(&asyncTexWorkCondition, &asyncTexMutex);
+			continue;
+		}
+
+		// Dequeue next job and process it without holding the lock:
+		job = asyncTexQueueHead;
+		asyncTexQueueHead = job->next;
+		if (asyncTexQueueHead == NULL) asyncTexQueueTail = NULL;
+		PsychUnlockMutex(&asyncTexMutex);
+
+		job->workFunc(job->workArg, job->buffer);
+
+		PsychLockMutex(&asyncTexMutex);
+		job->done = TRUE;
+		PsychBroadcastCondition(&asyncTexDoneCondition);
+	}
+	PsychUnlockMutex(&asyncTexMutex);
+
+	return(NULL);
+}
+
+// Wait for the worker thread to finish the job of texture 'win', or check if it is finished if 'wait' is FALSE:
+static psych_bool PsychWaitAsyncTexture(PsychWindowRecordType *win, psych_bool wait)
+{
+	PsychAsyncTextureJob* job = win->asyncTextureJob;
+	psych_bool done;
+
+	// Jobs never reach the worker if it isn't running, so they are done:
+	if (!asyncTexThreadRunning) return(TRUE);
+
+	PsychLockMutex(&asyncTexMutex);
+	while (wait && !job->done) PsychWaitCondition(&asyncTexDoneCondition, &asyncTexMutex);
+	done = job->done;
+	PsychUnlockMutex(&asyncTexMutex);
+
+	return(done);
+}
+
+// Detach job from texture 'win' after the worker is done with it and release the buffer:
+static void PsychDiscardAsyncTexture(PsychWindowRecordType *win)
+{
+	PsychAsyncTextureJob* job = win->asyncTextureJob;
+
+	PsychWaitAsyncTexture(win, TRUE);
+	win->asyncTextureJob = NULL;
+
+	if (job->pbo) {
+		PsychSetGLContext(win);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, job->pbo);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER_ARB);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+		glDeleteBuffers(1, &job->pbo);
+	}
+	else {
+		free(job->buffer);
+	}
+
+	free(job);
+}
+
+/* PsychBeginAsyncTexture()
+ *
+ * Start asynchronous creation of texture 'win', whose windowRecord is completely set up for PsychCreateTexture(),
+ * except for the texture data. Returns a buffer of 'bufferSize' bytes, which must be filled with the texture data,
+ * either directly or by a worker function queued via PsychQueueAsyncTextureWork(). The texture is created from the
+ * buffer by PsychFinishAsyncTexture().
+ */
+void* PsychBeginAsyncTexture(PsychWindowRecordType *win, size_t bufferSize)
+{
+	PsychAsyncTextureJob* job;
+
+	job = (PsychAsyncTextureJob*) calloc(1, sizeof(PsychAsyncTextureJob));
+	if (job == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to create texture asynchronously!");
+	job->bufferSize = bufferSize;
+	job->done = TRUE;
+
+	PsychSetGLContext(win);
+
+	// Use a PBO if supported. Not for power-of-two textures, as PsychCreateTexture() creates them empty from a
+	// NULL pointer first, and not for client storage textures, which need to keep their buffer in system RAM:
+	if (glewIsSupported("GL_ARB_pixel_buffer_object") && glGenBuffers && glMapBuffer && (PsychGetTextureTarget(win) != GL_TEXTURE_2D) &&
+		!PsychUseClientStorageTextures()) {
+		while (glGetError());
+		glGenBuffers(1, &job->pbo);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, job->pbo);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER_ARB, (GLsizeiptr) bufferSize, NULL, GL_STREAM_DRAW);
+		job->buffer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+		if ((job->buffer == NULL) || glGetError()) {
+			// PBO failed, e.g., out of memory. Fall back to system memory:
+			if (job->buffer) {
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, job->pbo);
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER_ARB);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+			}
+			glDeleteBuffers(1, &job->pbo);
+			while (glGetError());
+			job->pbo = 0;
+			job->buffer = NULL;
+		}
+	}
+
+	if (job->buffer == NULL) {
+		job->buffer = malloc(bufferSize);
+		if (job->buffer == NULL) {
+			free(job);
+			PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to create texture asynchronously!");
+		}
+	}
+
+	win->asyncTextureJob = job;
+
+	return(job->buffer);
+}
+
+/* PsychQueueAsyncTextureWork()
+ *
+ * Queue 'workFunc' for filling the buffer of asynchronous texture creation for 'win' on the background worker
+ * thread. 'workFunc' is responsible for releasing 'workArg'. If the worker thread can't be started, 'workFunc'
+ * is called immediately.
+ */
+void PsychQueueAsyncTextureWork(PsychWindowRecordType *win, PsychAsyncTextureWorkFunc workFunc, void* workArg)
+{
+	PsychAsyncTextureJob* job = win->asyncTextureJob;
+
+	// Start worker thread on first use:
+	if (!asyncTexThreadRunning) {
+		PsychInitMutex(&asyncTexMutex);
+		PsychInitCondition(&asyncTexWorkCondition, NULL);
+		PsychInitCondition(&asyncTexDoneCondition, NULL);
+		asyncTexShutdown = FALSE;
+		asyncTexQueueHead = asyncTexQueueTail = NULL;
+
+		if (PsychCreateThread(&asyncTexThread, NULL, PsychAsyncTextureThreadMain, NULL)) {
+			// Failed. Do the work synchronously instead:
+			PsychDestroyCondition(&asyncTexDoneCondition);
+			PsychDestroyCondition(&asyncTexWorkCondition);
+			PsychDestroyMutex(&asyncTexMutex);
+			if (PsychPrefStateGet_Verbosity() > 1) printf("PTB-WARNING: Failed to start worker thread for asynchronous texture creation. Creating textures synchronously.\n");
+			workFunc(workArg, job->buffer);
+			return;
+		}
+
+		asyncTexThreadRunning = TRUE;
+	}
+
+	job->workFunc = workFunc;
+	job->workArg = workArg;
+	job->next = NULL;
+
+	PsychLockMutex(&asyncTexMutex);
+	job->done = FALSE;
+	if (asyncTexQueueTail) asyncTexQueueTail->next = job; else asyncTexQueueHead = job;
+	asyncTexQueueTail = job;
+	PsychSignalCondition(&asyncTexWorkCondition);
+	PsychUnlockMutex(&asyncTexMutex);
+
+	return;
+}
+
+/* PsychFinishAsyncTexture()
+ *
+ * Finish asynchronous creation of texture 'win', if any is pending: Wait for the texture data buffer to be
+ * filled, then create the OpenGL texture from it. If 'wait' is FALSE and the buffer is not yet filled, return
+ * immediately. Returns TRUE if the texture is ready for use, FALSE otherwise.
+ */
+psych_bool PsychFinishAsyncTexture(PsychWindowRecordType *win, psych_bool wait)
+{
+	PsychAsyncTextureJob* job = win->asyncTextureJob;
+
+	if (job == NULL) return(TRUE);
+	if (!PsychWaitAsyncTexture(win, wait)) return(FALSE);
+
+	// Detach job first, so the texture counts as ready during creation:
+	win->asyncTextureJob = NULL;
+
+	if (job->pbo) {
+		// Upload from the PBO: PsychCreateTexture() passes a NULL texture data pointer, which
+		// is an offset of zero into the bound PBO:
+		PsychSetGLContext(win);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, job->pbo);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER_ARB);
+		win->textureMemory = NULL;
+		win->textureMemorySizeBytes = 0;
+	}
+	else {
+		// Upload from system memory, which PsychCreateTexture() releases after upload:
+		win->textureMemory = (GLuint*) job->buffer;
+		win->textureMemorySizeBytes = job->bufferSize;
+	}
+
+	PsychCreateTexture(win);
+
+	// The PBO is only really deleted by the driver after the upload completed:
+	if (job->pbo) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+		glDeleteBuffers(1, &job->pbo);
+	}
+
+	free(job);
+
+	return(TRUE);
+}
+
+/* PsychExitAsyncTextures()
+ *
+ * Stop the background worker thread for asynchronous texture creation, if any. Called at Screen shutdown,
+ * after all textures, and therefore all jobs, are gone.
+ */
+void PsychExitAsyncTextures(void)
+{
+	if (!asyncTexThreadRunning) return;
+
+	PsychLockMutex(&asyncTexMutex);
+	asyncTexShutdown = TRUE;
+	PsychSignalCondition(&asyncTexWorkCondition);
+	PsychUnlockMutex(&asyncTexMutex);
+
+	PsychDeleteThread(&asyncTexThread);
+	PsychDestroyCondition(&asyncTexDoneCondition);
+	PsychDestroyCondition(&asyncTexWorkCondition);
+	PsychDestroyMutex(&asyncTexMutex);
+	asyncTexThreadRunning = FALSE;
+
+	return;
+}
+
+// Texture cache:
+//
+// MakeTexture computes a PsychTextureCacheKey from a hash of the image matrix and its format and
+// asks PsychLookupCachedTexture() for an existing texture of identical content. On a hit, the
+// texture record shares the OpenGL texture object of the cache entry via PsychAttachCachedTexture(),
+// on a miss the newly created texture is handed over to the cache via PsychInsertCachedTexture().
+// Entries are reference counted by the texture records sharing them. The cache keeps entries in
+// least recently used order and evicts the oldest ones when the total size of cached textures exceeds
+// the budget set via Screen('Preference', 'TextureCacheBudget'). Evicted entries which are still in
+// use by texture records stay alive until the last of them is closed. Texture records which need a
+// private copy of the texture, e.g., for drawing into it, detach from their entry via
+// PsychDetachCachedTexture() after copying it.
+typedef struct PsychTextureCacheEntry {
+	struct PsychTextureCacheEntry*	prev;			// Next more recently used entry.
+	struct PsychTextureCacheEntry*	next;			// Next less recently used entry.
+	PsychTextureCacheKey			key;
+	PsychWindowRecordType*			parentWindow;	// Onscreen window whose OpenGL context owns the texture.
+	GLuint							textureNumber;	// Shared OpenGL texture object.
+	GLenum							texturetarget;
+	int								bpc;
+	size_t							sizeBytes;		// Estimated texture memory consumption.
+	int								refCount;		// Number of texture records sharing the texture.
+	psych_bool						cached;			// Entry is in the cache list, ie., not evicted.
+	unsigned int					accountingStamp;	// Used by PsychGetTextureMemoryUsage() to count shared textures once.
+	void*							hostMemory;		// System RAM backing store of client storage texture, or NULL.
+	size_t							hostMemorySizeBytes;
+} PsychTextureCacheEntry;
+
+static PsychTextureCacheEntry*	texCacheHead = NULL;	// Most recently used entry.
+static PsychTextureCacheEntry*	texCacheTail = NULL;	// Least recently used entry.
+static size_t					texCacheBytes = 0;
+static size_t					texCacheEntries = 0;
+static double					texCacheHits = 0;
+static double					texCacheMisses = 0;
+
+/* PsychTextureCacheHash()
+ *
+ * Compute a 64 bit hash of 'size' bytes of 'data'. This is MurmurHash64A by Austin Appleby,
+ * which processes 8 bytes per step, so it is fast enough to hash big image matrices.
+ */
+psych_uint64 PsychTextureCacheHash(const void* data, size_t size)
+{
+	const psych_uint64	m = 0xc6a4a7935bd1e995ULL;
+	const int			r = 47;
+	const unsigned char	*p = (const unsigned char*) data;
+	const unsigned char	*end = p + (size & ~((size_t) 7));
+	psych_uint64		h = 0x50545265ULL ^ ((psych_uint64) size * m);
+	psych_uint64		k;
+
+	for (; p < end; p += 8) {
+		memcpy(&k, p, sizeof(k));
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+
+	switch (size & 7) {
+		case 7: h ^= (psych_uint64) p[6] << 48;
+		case 6: h ^= (psych_uint64) p[5] << 40;
+		case 5: h ^= (psych_uint64) p[4] << 32;
+		case 4: h ^= (psych_uint64) p[3] << 24;
+		case 3: h ^= (psych_uint64) p[2] << 16;
+		case 2: h ^= (psych_uint64) p[1] << 8;
+		case 1: h ^= (psych_uint64) p[0];
+				h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+
+	return(h);
+}
+
+// Remove entry from the cache list. It is deleted as soon as it is no longer in use:
+static void PsychEvictCachedTexture(PsychTextureCacheEntry* entry)
+{
+	if (entry->prev) entry->prev->next = entry->next; else texCacheHead = entry->next;
+	if (entry->next) entry->next->prev = entry->prev; else texCacheTail = entry->prev;
+	entry->prev = entry->next = NULL;
+	entry->cached = FALSE;
+	texCacheBytes -= entry->sizeBytes;
+	texCacheEntries--;
+}
+
+// Delete OpenGL texture and entry, once it is neither cached nor in use. 'contextWin' is a window
+// with the OpenGL context of the texture. The parent window may be already gone for evicted entries.
+// If the context is gone as well, the texture died with it and only the entry is released:
+static void PsychDeleteCachedTexture(PsychTextureCacheEntry* entry, PsychWindowRecordType* contextWin)
+{
+	if (entry->cached || (entry->refCount > 0)) return;
+
+	if (contextWin->targetSpecific.contextObject) {
+		PsychSetGLContext(contextWin);
+		if (entry->hostMemory) glFinish();
+		glDeleteTextures(1, &entry->textureNumber);
+	}
+	texmemguesstimate -= (texmemguesstimate > entry->sizeBytes) ? entry->sizeBytes : texmemguesstimate;
+	free(entry->hostMemory);
+	free(entry);
+}
+
+/* PsychTrimTextureCache()
+ *
+ * Evict least recently used entries until the cache fits into its budget. Called after insertion
+ * of new entries and when the budget changes.
+ */
+void PsychTrimTextureCache(void)
+{
+	PsychTextureCacheEntry*	entry;
+	size_t					budget = (size_t) PsychPrefStateGet_TextureCacheBudget() * 1024 * 1024;
+
+	while (texCacheTail && (texCacheBytes > budget)) {
+		entry = texCacheTail;
+		PsychEvictCachedTexture(entry);
+		PsychDeleteCachedTexture(entry, entry->parentWindow);
+	}
+}
+
+/* PsychLookupCachedTexture()
+ *
+ * Find the cache entry for a texture of onscreen window 'parentWin' matching 'key'.
+ * Returns the entry and marks it as most recently used on a hit, NULL on a miss.
+ */
+PsychTextureCacheEntry* PsychLookupCachedTexture(PsychWindowRecordType *parentWin, const PsychTextureCacheKey* key)
+{
+	PsychTextureCacheEntry*	entry;
+
+	for (entry = texCacheHead; entry; entry = entry->next) {
+		if ((entry->parentWindow == parentWin) && (entry->key.hash == key->hash) && (entry->key.dataSize == key->dataSize) &&
+			(entry->key.dataType == key->dataType) && (entry->key.width == key->width) && (entry->key.height == key->height) &&
+			(entry->key.planes == key->planes) && (entry->key.precision == key->precision) && (entry->key.flags == key->flags)) break;
+	}
+
+	if (entry == NULL) {
+		texCacheMisses++;
+		return(NULL);
+	}
+
+	// Move to front of LRU list:
+	if (entry != texCacheHead) {
+		entry->prev->next = entry->next;
+		if (entry->next) entry->next->prev = entry->prev; else texCacheTail = entry->prev;
+		entry->prev = NULL;
+		entry->next = texCacheHead;
+		texCacheHead->prev = entry;
+		texCacheHead = entry;
+	}
+
+	texCacheHits++;
+	return(entry);
+}
+
+/* PsychAttachCachedTexture()
+ *
+ * Make texture record 'win' share the texture of cache 'entry' instead of creating its own one.
+ */
+void PsychAttachCachedTexture(PsychWindowRecordType *win, PsychTextureCacheEntry* entry)
+{
+	win->textureNumber = entry->textureNumber;
+	win->texturetarget = entry->texturetarget;
+	win->bpc = entry->bpc;
+	win->surfaceSizeBytes = entry->sizeBytes;
+	win->textureCacheEntry = entry;
+	entry->refCount++;
+}
+
+/* PsychCreateSharedTexture()
+ *
+ * Create an entry for the texture just created for texture record 'win', so other texture records
+ * can share it via PsychAttachCachedTexture(). 'win' becomes the first record sharing it. The entry
+ * is not cached, so the texture is deleted when the last record sharing it is closed. Used for the
+ * atlas textures of Screen('MakeTextures'). The system RAM backing store of a client storage texture
+ * is owned by the entry from now on. Returns NULL if out of memory.
+ */
+PsychTextureCacheEntry* PsychCreateSharedTexture(PsychWindowRecordType *win)
+{
+	PsychTextureCacheEntry*	entry;
+
+	entry = (PsychTextureCacheEntry*) calloc(1, sizeof(PsychTextureCacheEntry));
+	if (entry == NULL) return(NULL);
+
+	entry->parentWindow = PsychGetParentWindow(win);
+	entry->textureNumber = win->textureNumber;
+	entry->texturetarget = PsychGetTextureTarget(win);
+	entry->bpc = win->bpc;
+	entry->sizeBytes = win->surfaceSizeBytes;
+	entry->refCount = 1;
+	entry->cached = FALSE;
+	win->textureCacheEntry = entry;
+
+	if (win->textureMemory && (win->textureMemorySizeBytes > 0)) {
+		entry->hostMemory = (void*) win->textureMemory;
+		entry->hostMemorySizeBytes = win->textureMemorySizeBytes;
+		win->textureMemory = NULL;
+		win->textureMemorySizeBytes = 0;
+	}
+
+	return(entry);
+}
+
+/* PsychInsertCachedTexture()
+ *
+ * Hand the texture just created for texture record 'win' over to the cache, under 'key'.
+ * 'win' becomes the first record sharing it.
+ */
+void PsychInsertCachedTexture(PsychWindowRecordType *win, const PsychTextureCacheKey* key)
+{
+	PsychTextureCacheEntry*	entry;
+
+	// Don't cache anything bigger than the whole budget:
+	if ((win->textureNumber == 0) || (win->surfaceSizeBytes > (size_t) PsychPrefStateGet_TextureCacheBudget() * 1024 * 1024)) return;
+
+	entry = PsychCreateSharedTexture(win);
+	if (entry == NULL) return;
+
+	entry->key = *key;
+	entry->cached = TRUE;
+
+	entry->next = texCacheHead;
+	if (texCacheHead) texCacheHead->prev = entry; else texCacheTail = entry;
+	texCacheHead = entry;
+	texCacheBytes += entry->sizeBytes;
+	texCacheEntries++;
+
+	PsychTrimTextureCache();
+}
+
+// Drop reference of texture record 'win' to its cache entry:
+static void PsychReleaseCachedTexture(PsychWindowRecordType *win)
+{
+	PsychTextureCacheEntry*	entry = win->textureCacheEntry;
+
+	win->textureCacheEntry = NULL;
+	entry->refCount--;
+	PsychDeleteCachedTexture(entry, win);
+}
+
+/* PsychDetachCachedTexture()
+ *
+ * Detach texture record 'win' from its cache entry, after it got a private texture object.
+ * Called by PsychNormalizeTextureOrientation() when replacing a shared texture.
+ */
+void PsychDetachCachedTexture(PsychWindowRecordType *win)
+{
+	if (win->textureCacheEntry == NULL) return;
+	PsychReleaseCachedTexture(win);
+
+	// The private texture is the color buffer of the FBO of 'win' and is accounted for by 'win' from
+	// now on. For atlas items it is only the size of the item, not of the whole atlas:
+	if (win->fboTable[0] && (win->fboTable[0]->colorSizeBytes > 0)) win->surfaceSizeBytes = win->fboTable[0]->colorSizeBytes;
+	texmemguesstimate += win->surfaceSizeBytes;
+	win->textureAtlasOffset[0] = -1;
+	win->textureAtlasOffset[1] = 0;
+}
+
+/* PsychFlushTextureCache()
+ *
+ * Evict all entries of onscreen window 'parentWin' from the cache, or all entries if 'parentWin' is NULL.
+ * Called before an onscreen window is closed.
+ */
+void PsychFlushTextureCache(PsychWindowRecordType *parentWin)
+{
+	PsychTextureCacheEntry	*entry, *next;
+
+	for (entry = texCacheHead; entry; entry = next) {
+		next = entry->next;
+		if ((parentWin == NULL) || (entry->parentWindow == parentWin)) {
+			PsychEvictCachedTexture(entry);
+			PsychDeleteCachedTexture(entry, entry->parentWindow);
+		}
+	}
+}
+
+/* PsychGetTextureCacheStats()
+ *
+ * Return number of cache hits and misses since startup, and current number and size of cached textures.
+ */
+void PsychGetTextureCacheStats(double* hits, double* misses, double* entries, double* bytes)
+{
+	*hits = texCacheHits;
+	*misses = texCacheMisses;
+	*entries = (double) texCacheEntries;
+	*bytes = (double) texCacheBytes;
+}
+
+/* PsychUseClientStorageTextures()
+ *
+ * Returns TRUE if textures should use Apple client storage, ie., keep their system RAM copy as
+ * backing store for the texture. This is requested via the kPsychDontCacheTextures flag of
+ * Screen('Preference', 'ConserveVRAM'), unless Screen('Preference', 'ReleaseTextureHostMemory')
+ * asks to always release system RAM copies after upload.
+ */
+psych_bool PsychUseClientStorageTextures(void)
+{
+	return(((PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures) && !PsychPrefStateGet_ReleaseTextureHostMemory()) ? TRUE : FALSE);
+}
+
+/* PsychGetTextureMemoryUsage()
+ *
+ * Estimate the memory consumption of textures, offscreen windows and framebuffer objects of onscreen window
+ * 'parentWin', or of all windows if 'parentWin' is NULL: 'hostBytes' returns the system RAM held by texture
+ * records, 'gpuBytes' the graphics memory of textures and FBOs. Textures shared via the texture cache are
+ * only counted once.
+ */
+void PsychGetTextureMemoryUsage(PsychWindowRecordType *parentWin, double* hostBytes, double* gpuBytes)
+{
+	static unsigned int		stamp = 0;
+	PsychWindowRecordType	**windowRecordArray;
+	PsychWindowRecordType	*win;
+	int						numWindows, i, j, k;
+	double					host = 0, gpu = 0;
+
+	stamp++;
+	PsychCreateVolatileWindowRecordPointerList(&numWindows, &windowRecordArray);
+	for (i = 0; i < numWindows; i++) {
+		win = windowRecordArray[i];
+		if ((parentWin != NULL) && (PsychGetParentWindow(win) != parentWin)) continue;
+
+		if (win->windowType == kPsychTexture) {
+			// System RAM copy owned by texture, if any:
+			host += (double) win->textureMemorySizeBytes;
+
+			// Texture or offscreen window. Count shared textures only once:
+			if (win->textureCacheEntry) {
+				if (win->textureCacheEntry->accountingStamp != stamp) {
+					gpu += (double) win->textureCacheEntry->sizeBytes;
+					host += (double) win->textureCacheEntry->hostMemorySizeBytes;
+				}
+				win->textureCacheEntry->accountingStamp = stamp;
+			}
+			else {
+				gpu += (double) win->surfaceSizeBytes;
+			}
+		}
+
+		// Framebuffer objects, e.g., of imaging pipeline or for drawing into textures. The color
+		// buffer of a textures FBO is the texture itself. FBO's can be listed multiple times:
+		for (j = 0; j < win->fboCount; j++) {
+			if (win->fboTable[j] == NULL) continue;
+			for (k = 0; k < j; k++) if (win->fboTable[k] == win->fboTable[j]) break;
+			if (k < j) continue;
+
+			if (win->windowType != kPsychTexture) gpu += (double) win->fboTable[j]->colorSizeBytes;
+			gpu += (double) win->fboTable[j]->zSizeBytes;
+		}
+	}
+	PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
+
+	*hostBytes = host;
+	*gpuBytes = gpu;
+}
+
 void PsychDetectTextureTarget(PsychWindowRecordType *win)
 {
     // First time invocation?
@@ -141,6 +759,13 @@ void PsychInitWindowRecordTextureFields(PsychWindowRecordType *win)
 		// setting will be used for the GL_UNPACK_ALIGNMENT setting in PsychCreateTexture() and friends
 		// to optimize texture upload:
 		win->textureByteAligned=0;
+		// No asynchronous texture creation pending:
+		win->asyncTextureJob=NULL;
+		// Not sharing a texture from the texture cache:
+		win->textureCacheEntry=NULL;
+		// Not an item of a texture atlas:
+		win->textureAtlasOffset[0]=-1;
+		win->textureAtlasOffset[1]=0;
 }
 
 
@@ -263,7 +888,7 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 	// Check if user requested explicit use of clientstorage + Use of System RAM for
 	// storage of textures instead of VRAM caching in order to conserve VRAM memory on
 	// low-mem gfx-cards. Enable clientstorage, if so...
-	clientstorage = (PsychPrefStateGet_ConserveVRAM() & kPsychDontCacheTextures) ? TRUE : FALSE;
+	clientstorage = PsychUseClientStorageTextures();
 	
 	// Create a unique texture handle for this texture:
 	// If the texture already has a handle assigned then this means that we shouldn't
@@ -472,6 +1097,8 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 					glBindTexture(texturetarget, 0);
 					glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 					glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+					// Unbind pixel buffer object of asynchronous texture creation, if any:
+					if (glBindBuffer) glBindBuffer(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 					glDeleteTextures(1, &win->textureNumber);
 					win->textureNumber = 0;
 					if (!clientstorage) {
@@ -694,6 +1321,9 @@ void PsychCreateTexture(PsychWindowRecordType *win)
 */
 void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
 {
+    // Discard pending asynchronous texture creation, if any:
+    if (win->asyncTextureJob) PsychDiscardAsyncTexture(win);
+
     // Destroy OpenGL texture object for windows that have one:
     if((win->windowType==kPsychSingleBufferOnscreen || win->windowType==kPsychDoubleBufferOnscreen || win->windowType==kPsychTexture) &&
        (win->targetSpecific.contextObject)) {
@@ -714,8 +1344,14 @@ void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
         // work for some strange reason :(
         if ((win->textureMemory) && (win->textureNumber > 0)) glFinish(); // FinishObjectAPPLE(GL_TEXTURE_2D, win->textureNumber);
 
+        // Texture shared with the texture cache? Only drop our reference then. A shadow FBO for read
+        // access, if any, references the shared texture as well, so make sure it doesn't get deleted:
+        if (win->textureCacheEntry) {
+            if (win->fboTable[0] && (win->fboTable[0]->coltexid == win->textureNumber)) win->fboTable[0]->coltexid = 0;
+            PsychReleaseCachedTexture(win);
+        }
         // Perform standard OpenGL texture cleanup if needed:
-		if (&win->textureNumber != 0) {
+        else if (&win->textureNumber != 0) {
 			glDeleteTextures(1, &win->textureNumber);
 
 			// Accounting... ...this is only a rough guesstimate:
@@ -728,8 +1364,13 @@ void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
         if (PsychPrefStateGet_Verbosity() > 4) PsychTestForGLErrors();
     }
 
-    // Free system RAM backing memory buffer, if any:
-    if (win->textureMemory) free(win->textureMemory);
+    // Texture outlived the OpenGL context of its onscreen window? Its reference to the cache entry
+    // must be dropped nonetheless, or the entry leaks:
+    if (win->textureCacheEntry) PsychReleaseCachedTexture(win);
+
+    // Free system RAM backing memory buffer, if any and if it is ours. A textureMemorySizeBytes of zero
+    // means that textureMemory references memory owned by someone else, e.g., a movie or video buffer:
+    if (win->textureMemory && (win->textureMemorySizeBytes > 0)) free(win->textureMemory);
     win->textureMemory=NULL;
     win->textureMemorySizeBytes=0;
     win->textureNumber=0;
@@ -737,6 +1378,32 @@ void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win)
 }
 
 
+// Select hardware filter-mode 'filterMode' of Screen('DrawTexture') for the bound texture of 'texturetarget':
+static void PsychSetTextureFilterMode(GLenum texturetarget, int filterMode)
+{
+        switch (filterMode) {
+                case 0: // Nearest-Neighbour filtering:
+                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+                break;
+                
+                case 1: // Bilinear filtering:
+                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                break;
+
+                case 2: // Linear filtering with nearest neighbour mipmapping: Needs external support to generate mipmaps.
+                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                break;
+
+                case 3: // Linear filtering with linear mipmapping --> This is full trilinear filtering. Needs external support to generate mipmaps.
+                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                break;
+        }
+}
+
 void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordType *target, double *sourceRect, double *targetRect,
                                double rotationAngle, int filterMode, double globalAlpha)
 {
@@ -809,6 +1476,14 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
             sourceYEnd=sourceHeight - sourceRect[kPsychTop];
         }
 
+        // Items of a texture atlas from Screen('MakeTextures') are sub-rectangles of the shared atlas texture:
+        if (source->textureAtlasOffset[0] >= 0) {
+            sourceX+=source->textureAtlasOffset[0];
+            sourceXEnd+=source->textureAtlasOffset[0];
+            sourceY+=source->textureAtlasOffset[1];
+            sourceYEnd+=source->textureAtlasOffset[1];
+        }
+
         // Special case handling for GL_TEXTURE_2D textures. We need to map the
 	// absolute texture coordinates (in pixels) to the interval 0.0 - 1.0 where
 	// 1.0 == full extent of power of two texture...
@@ -862,27 +1537,7 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 	}
 	else {
         // Standard hardware texture sampling/filtering: Select filter-mode for texturing:
-        switch (filterMode) {
-                case 0: // Nearest-Neighbour filtering:
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-                break;
-                
-                case 1: // Bilinear filtering:
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                break;
-
-                case 2: // Linear filtering with nearest neighbour mipmapping: Needs external support to generate mipmaps.
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                break;
-
-                case 3: // Linear filtering with linear mipmapping --> This is full trilinear filtering. Needs external support to generate mipmaps.
-                    glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                    glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                break;
-        }
+        PsychSetTextureFilterMode(texturetarget, filterMode);
 		
 		// Optional texture lookup shader set up (in Screen('MakeTexture') or due to disabled color clamping...)
 		if (source->textureLookupShader > 0) {
@@ -1122,6 +1777,117 @@ void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordT
 	return;
 }
 
+/* PsychCanBatchBlitTexture()
+ *
+ * Returns TRUE if texture 'source' can be drawn via PsychBatchBlitTexture(). This is the case for
+ * rectangle textures in transposed Matlab or upright orientation, e.g., from Screen('MakeTexture'),
+ * Screen('MakeTextures') or offscreen windows, without any filter-, lookup- or user shaders.
+ */
+psych_bool PsychCanBatchBlitTexture(PsychWindowRecordType *source)
+{
+	return(((source->textureNumber > 0) && (source->asyncTextureJob == NULL) && (PsychGetTextureTarget(source) == GL_TEXTURE_RECTANGLE_EXT) &&
+			((source->textureOrientation == 0 && !renderswap) || source->textureOrientation == 2) && (source->targetSpecific.QuickTimeGLTexture == NULL) &&
+			(source->textureFilterShader == 0) && (source->textureLookupShader == 0)) ? TRUE : FALSE);
+}
+
+/* PsychBeginBatchBlitTextures()
+ *
+ * Begin batched drawing of many unrotated quads from the OpenGL texture of texture 'source' into
+ * window 'target' with filter-mode 'filterMode'. PsychBatchBlitTexture() then draws 'source' or any
+ * other texture sharing the same OpenGL texture, e.g., all items of an atlas texture, within one
+ * glBegin() / glEnd() pair, instead of one per texture as PsychBlitTextureToDisplay() does.
+ * PsychEndBatchBlitTextures() ends the batch. Only textures for which PsychCanBatchBlitTexture()
+ * returns TRUE are allowed. The caller must not issue other OpenGL commands than glColor() between
+ * begin and end.
+ */
+void PsychBeginBatchBlitTextures(PsychWindowRecordType *source, PsychWindowRecordType *target, int filterMode)
+{
+	GLenum texturetarget;
+
+	PsychSetDrawingTarget(target);
+	PsychDetectTextureTarget(target);
+	texturetarget = PsychGetTextureTarget(source);
+
+	glDisable(GL_TEXTURE_2D);
+	glEnable(texturetarget);
+	glBindTexture(texturetarget, source->textureNumber);
+	PsychSetTextureFilterMode(texturetarget, filterMode);
+	glTexParameteri(texturetarget, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(texturetarget, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+	PsychSetShader(target, 0);
+
+	glBegin(GL_QUADS);
+}
+
+/* PsychBatchBlitTexture()
+ *
+ * Draw 'sourceRect' of texture 'source' into 'targetRect' of the target window of the current batch,
+ * see PsychBeginBatchBlitTextures(). 'globalAlpha' has the same meaning as for PsychBlitTextureToDisplay().
+ */
+void PsychBatchBlitTexture(PsychWindowRecordType *source, double *sourceRect, double *targetRect, double globalAlpha)
+{
+	GLfloat sourceX, sourceY, sourceXEnd, sourceYEnd;
+	GLfloat offsetX = 0, offsetY = 0;
+
+	if (source->textureAtlasOffset[0] >= 0) {
+		offsetX = (GLfloat) source->textureAtlasOffset[0];
+		offsetY = (GLfloat) source->textureAtlasOffset[1];
+	}
+
+	if (globalAlpha != DBL_MAX) glColor4f(1, 1, 1, (GLfloat) globalAlpha);
+
+	if (source->textureOrientation == 2) {
+		// Upright texture:
+		sourceX = (GLfloat) sourceRect[kPsychLeft] + offsetX;
+		sourceY = (GLfloat) (PsychGetHeightFromRect(source->rect) - sourceRect[kPsychBottom]) + offsetY;
+		sourceXEnd = (GLfloat) sourceRect[kPsychRight] + offsetX;
+		sourceYEnd = (GLfloat) (PsychGetHeightFromRect(source->rect) - sourceRect[kPsychTop]) + offsetY;
+
+		glTexCoord2f(sourceX, sourceYEnd);
+		glVertex2f((GLfloat) targetRect[kPsychLeft], (GLfloat) targetRect[kPsychTop]);
+		glTexCoord2f(sourceX, sourceY);
+		glVertex2f((GLfloat) targetRect[kPsychLeft], (GLfloat) targetRect[kPsychBottom]);
+		glTexCoord2f(sourceXEnd, sourceY);
+		glVertex2f((GLfloat) targetRect[kPsychRight], (GLfloat) targetRect[kPsychBottom]);
+		glTexCoord2f(sourceXEnd, sourceYEnd);
+		glVertex2f((GLfloat) targetRect[kPsychRight], (GLfloat) targetRect[kPsychTop]);
+	}
+	else {
+		// Transposed texture from Matlab image matrix:
+		sourceX = (GLfloat) sourceRect[kPsychTop] + offsetX;
+		sourceY = (GLfloat) sourceRect[kPsychLeft] + offsetY;
+		sourceXEnd = (GLfloat) sourceRect[kPsychBottom] + offsetX;
+		sourceYEnd = (GLfloat) sourceRect[kPsychRight] + offsetY;
+
+		glTexCoord2f(sourceX, sourceY);
+		glVertex2f((GLfloat) targetRect[kPsychLeft], (GLfloat) targetRect[kPsychTop]);
+		glTexCoord2f(sourceXEnd, sourceY);
+		glVertex2f((GLfloat) targetRect[kPsychLeft], (GLfloat) targetRect[kPsychBottom]);
+		glTexCoord2f(sourceXEnd, sourceYEnd);
+		glVertex2f((GLfloat) targetRect[kPsychRight], (GLfloat) targetRect[kPsychBottom]);
+		glTexCoord2f(sourceX, sourceYEnd);
+		glVertex2f((GLfloat) targetRect[kPsychRight], (GLfloat) targetRect[kPsychTop]);
+	}
+}
+
+/* PsychEndBatchBlitTextures()
+ *
+ * End batched drawing started by PsychBeginBatchBlitTextures() for texture 'source'.
+ */
+void PsychEndBatchBlitTextures(PsychWindowRecordType *source)
+{
+	GLenum texturetarget = PsychGetTextureTarget(source);
+
+	glEnd();
+
+	// Reset filters to nearest, see PsychBlitTextureToDisplay(), and unbind:
+	glTexParameteri(texturetarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(texturetarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(texturetarget, 0);
+	glDisable(texturetarget);
+}
+
 /* PsychGetTextureTarget
  * Returns GLenum with the texture target used for all PTB operations.
  * This way, external code can bind the correct target for given hardware.
@@ -1199,6 +1965,12 @@ void PsychMapTexCoord(PsychWindowRecordType *tex, double* tx, double* ty)
         sourceY=*ty;
     }
     
+    // Items of a texture atlas from Screen('MakeTextures') are sub-rectangles of the shared atlas texture:
+    if (tex->textureAtlasOffset[0] >= 0) {
+        sourceX+=tex->textureAtlasOffset[0];
+        sourceY+=tex->textureAtlasOffset[1];
+    }
+    
     // Special case handling for GL_TEXTURE_2D textures. We need to map the
     // absolute texture coordinates (in pixels) to the interval 0.0 - 1.0 where
     // 1.0 == full extent of power of two texture...
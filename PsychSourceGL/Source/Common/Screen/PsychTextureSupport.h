@@ -31,9 +31,44 @@ void PsychCreateTexture(PsychWindowRecordType *win);
 void PsychFreeTextureForWindowRecord(PsychWindowRecordType *win);
 void PsychBlitTextureToDisplay(PsychWindowRecordType *source, PsychWindowRecordType *target, double *sourceRect, double *targetRect,
                                double rotationAngle, int filterMode, double globalAlpha);
+psych_bool PsychCanBatchBlitTexture(PsychWindowRecordType *source);
+void PsychBeginBatchBlitTextures(PsychWindowRecordType *source, PsychWindowRecordType *target, int filterMode);
+void PsychBatchBlitTexture(PsychWindowRecordType *source, double *sourceRect, double *targetRect, double globalAlpha);
+void PsychEndBatchBlitTextures(PsychWindowRecordType *source);
 GLenum PsychGetTextureTarget(PsychWindowRecordType *win);
 void PsychMapTexCoord(PsychWindowRecordType *tex, double* tx, double* ty);
 void PsychDetectTextureTarget(PsychWindowRecordType *win);
+psych_bool PsychUseClientStorageTextures(void);
+void PsychGetTextureMemoryUsage(PsychWindowRecordType *parentWin, double* hostBytes, double* gpuBytes);
+
+// Asynchronous texture creation:
+typedef void (*PsychAsyncTextureWorkFunc)(void* workArg, void* buffer);
+void* PsychBeginAsyncTexture(PsychWindowRecordType *win, size_t bufferSize);
+void PsychQueueAsyncTextureWork(PsychWindowRecordType *win, PsychAsyncTextureWorkFunc workFunc, void* workArg);
+psych_bool PsychFinishAsyncTexture(PsychWindowRecordType *win, psych_bool wait);
+void PsychExitAsyncTextures(void);
+
+// Texture cache for sharing textures of identical content:
+typedef struct PsychTextureCacheKey {
+	psych_uint64	hash;		// Hash of the image data, computed by PsychTextureCacheHash().
+	size_t			dataSize;	// Size of the image data in bytes.
+	int				dataType;	// Numeric type of the image data.
+	int				width;
+	int				height;
+	int				planes;
+	int				precision;	// Requested texture precision.
+	int				flags;		// Texture creation flags which affect the texture object.
+} PsychTextureCacheKey;
+
+psych_uint64 PsychTextureCacheHash(const void* data, size_t size);
+struct PsychTextureCacheEntry* PsychLookupCachedTexture(PsychWindowRecordType *parentWin, const PsychTextureCacheKey* key);
+void PsychAttachCachedTexture(PsychWindowRecordType *win, struct PsychTextureCacheEntry* entry);
+void PsychInsertCachedTexture(PsychWindowRecordType *win, const PsychTextureCacheKey* key);
+struct PsychTextureCacheEntry* PsychCreateSharedTexture(PsychWindowRecordType *win);
+void PsychDetachCachedTexture(PsychWindowRecordType *win);
+void PsychTrimTextureCache(void);
+void PsychFlushTextureCache(PsychWindowRecordType *parentWin);
+void PsychGetTextureCacheStats(double* hits, double* misses, double* entries, double* bytes);
 
 //end include once
 #endif
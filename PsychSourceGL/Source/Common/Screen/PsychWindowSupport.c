@@ -1379,6 +1379,16 @@ void PsychCloseWindow(PsychWindowRecordType *windowRecord)
 
                 // Free possible shadow textures:
                 PsychFreeTextureForWindowRecord(windowRecord);        
+
+                // Release textures of this window in the texture cache:
+                PsychFlushTextureCache(windowRecord);
+
+                // Release pending asynchronous 'GetImage' readbacks and stop recording of flips:
+                PsychDeleteAsyncReadbackRing(windowRecord);
+                PsychDeleteFlipRecorder(windowRecord);
+
+                // Release vertex buffer ring of batch drawing commands:
+                PsychDeleteVertexStreamRing(windowRecord);
                 
                 // Make sure that OpenGL pipeline is done & idle for this window:
                 PsychSetGLContext(windowRecord);
@@ -1430,6 +1440,7 @@ void PsychCloseWindow(PsychWindowRecordType *windowRecord)
     }
     else if(windowRecord->windowType==kPsychTexture) {
                 // Texture or Offscreen window - which is also just a form of texture.
+				PsychDeleteAsyncReadbackRing(windowRecord);
 				PsychFreeTextureForWindowRecord(windowRecord);
 
 				// Shutdown only OpenGL related parts of imaging pipeline for this windowRecord, i.e.
@@ -2314,6 +2325,9 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
 		PsychSetDrawingTarget(NULL);
 	}
 	
+	// Recording of flips into a movie active? Start readback of the final stimulus image:
+	if (windowRecord->flipRecorder) PsychFlipRecorderCaptureFrame(windowRecord);
+
     // Part 1 of workaround- /checkcode for syncing to vertical retrace:
     if (vblsyncworkaround) {
         glDrawBuffer(GL_BACK);
@@ -3202,6 +3216,9 @@ double PsychFlipWindowBuffers(PsychWindowRecordType *windowRecord, int multiflip
 	// Increment the "flips successfully completed" counter:
 	windowRecord->flipCount++;
 
+	// Timestamp frame captured for recording of flips with stimulus onset:
+	if (windowRecord->flipRecorder) PsychFlipRecorderSetOnset(windowRecord, *time_at_onset);
+
     // The remaining code will run asynchronously on the GPU again and prepares the back-buffer
     // for drawing of next stim.
     PsychPostFlipOperations(windowRecord, dont_clear);
@@ -132,6 +132,7 @@ PsychError PsychModuleInit(void)
 	PsychErrorExit(PsychRegister("WaitUntilAsyncFlipCertain" , &SCREENWaitUntilAsyncFlipCertain));
 	PsychErrorExit(PsychRegister("FillRect", &SCREENFillRect));
 	PsychErrorExit(PsychRegister("GetImage", &SCREENGetImage));
+	PsychErrorExit(PsychRegister("FetchImage", &SCREENFetchImage));
 	PsychErrorExit(PsychRegister("PutImage", &SCREENPutImage));
 	PsychErrorExit(PsychRegister("HideCursorHelper", &SCREENHideCursorHelper));
 	PsychErrorExit(PsychRegister("ShowCursorHelper", &SCREENShowCursorHelper));
@@ -159,6 +160,8 @@ PsychError PsychModuleInit(void)
 	PsychErrorExit(PsychRegister("TextColor", &SCREENTextColor));
 	PsychErrorExit(PsychRegister("Preference", &SCREENPreference));
 	PsychErrorExit(PsychRegister("MakeTexture", &SCREENMakeTexture));
+	PsychErrorExit(PsychRegister("TextureReady", &SCREENTextureReady));
+	PsychErrorExit(PsychRegister("MakeTextures", &SCREENMakeTextures));
 	PsychErrorExit(PsychRegister("DrawTexture", &SCREENDrawTexture));
 	PsychErrorExit(PsychRegister("FrameRect", &SCREENFrameRect));
 	PsychErrorExit(PsychRegister("DrawLine", &SCREENDrawLine));
@@ -221,6 +224,7 @@ PsychError PsychModuleInit(void)
 	PsychErrorExit(PsychRegister("CreateMovie", &SCREENCreateMovie));
 	PsychErrorExit(PsychRegister("FinalizeMovie", &SCREENFinalizeMovie));
 	PsychErrorExit(PsychRegister("AddFrameToMovie", &SCREENGetImage));
+	PsychErrorExit(PsychRegister("RecordFlips", &SCREENRecordFlips));
 	PsychErrorExit(PsychRegister("AddAudioBufferToMovie", &SCREENAddAudioBufferToMovie));
     
 	PsychSetModuleAuthorByInitials("awi");
@@ -61,6 +61,9 @@ void ScreenCloseAllWindows(void)
 	// Check for stale texture ressources:
 	PsychRessourceCheckAndReminder(TRUE);	
 	
+    // Stop recording of flips into movies before shutdown of movie writing:
+	PsychStopFlipRecorders(-1);
+
     // Shutdown Quicktime subsystems if active:
 	PsychExitMovieWriting();
     PsychExitMovies();
@@ -276,6 +276,9 @@ PsychError SCREENCopyWindow(void)
 				PsychErrorExitMsg(PsychError_user, "Size mismatch of sourceRect and targetRect. Matching size is required for Onscreen to Offscreen copies. Sorry.");
 		}
 		
+		// Textures shared via the texture cache or an atlas texture need a private copy before modification:
+		if (targetWin->textureCacheEntry) PsychNormalizeTextureOrientation(targetWin);
+
 		// Update selected textures content:
 		// Looks weird but we need the framebuffer of sourceWin:
 		PsychSetDrawingTarget(sourceWin);
@@ -63,7 +63,8 @@ static char synopsisString[] =
 "relative to \"center\" (default center is [0 0]).  "
 "\"size\" is the width of each dot in pixels (default is 1). "
 "Instead of a common size for all dots you can also provide a "
-"vector which defines a different dot size for each dot.  "
+"vector which defines a different dot size for each dot. On GLSL capable hardware "
+"such dots are drawn just as fast as dots of a common size.  "
 "\"color\" is the the clut index (scalar or [r g b a] vector) "
 "that you want to poke into each dot pixel (default is black).  "
 "Instead of a single \"color\" you can also provide a 3 or 4 row vector,"
@@ -72,9 +73,53 @@ static char synopsisString[] =
 "0 (default) squares, 1 circles (with anti-aliasing), 2 circles (with high-quality "
 "anti-aliasing, if supported by your hardware). "
 "If you use dot_type = 1 you'll also need to set a proper blending mode with the "
-"Screen('BlendFunction') command!";  
+"Screen('BlendFunction') command!\n"
+"\"xy\" and \"size\" can also be passed as single precision matrices, e.g., single(xy). "
+"This saves memory and conversion overhead for very large numbers of dots, and is "
+"sufficient precision for all practical display sizes.";  
 static char seeAlsoString[] = "BlendFunction";	 
 
+// Vertex shader for drawing dots with per-dot sizes: Passes each dots size from
+// the 'dotSize' vertex attribute into gl_PointSize, otherwise fixed function:
+static char pointSizeVertexShaderSrc[] =
+"/* Point size vertex shader for Screen('DrawDots'): Emulates fixed function */ \n"
+"/* pipeline, but assigns a per-vertex point size from attribute dotSize:   */ \n"
+"\n"
+"attribute float dotSize;\n"
+"\n"
+"void main()\n"
+"{\n"
+"    gl_FrontColor  = gl_Color;\n"
+"    gl_PointSize   = dotSize;\n"
+"    gl_Position    = ftransform();\n"
+"}\n\0";
+
+/* PsychGetPointSizeDrawShader()
+ *
+ * Return the point size shader for drawing dots with individual sizes into 'windowRecord',
+ * or zero if unsupported. The shader is created on first use and then shared with all
+ * windows of the same parent onscreen window.
+ */
+static GLuint PsychGetPointSizeDrawShader(PsychWindowRecordType *windowRecord)
+{
+	PsychWindowRecordType *parentRecord = PsychGetParentWindow(windowRecord);
+
+	if (parentRecord->pointSizeDrawShader == 0) {
+		// Not yet tried: Only vertex shaders are needed, fixed function does the rest:
+		parentRecord->pointSizeDrawShader = -1;
+		if (glewIsSupported("GL_ARB_shader_objects") && glewIsSupported("GL_ARB_vertex_shader")) {
+			parentRecord->pointSizeDrawShader = (GLint) PsychCreateGLSLProgram(NULL, pointSizeVertexShaderSrc, NULL);
+			if (parentRecord->pointSizeDrawShader == 0) parentRecord->pointSizeDrawShader = -1;
+		}
+
+		if ((parentRecord->pointSizeDrawShader == -1) && (PsychPrefStateGet_Verbosity() > 3)) {
+			printf("PTB-INFO: Screen('DrawDots'): Point size shader unsupported. Dots of different size will be drawn slowly, one by one.\n");
+		}
+	}
+
+	return((parentRecord->pointSizeDrawShader > 0) ? (GLuint) parentRecord->pointSizeDrawShader : 0);
+}
+
 PsychError SCREENDrawDots(void)  
 {
 	PsychWindowRecordType                   *windowRecord;
@@ -82,9 +127,16 @@ PsychError SCREENDrawDots(void)
 	int                                     i, nrpoints, nrsize;
 	psych_bool                                 isArgThere, usecolorvector, isdoublecolors, isuint8colors;
 	double									*xy, *size, *center, *dot_type, *colors;
+	float									*xyf, *sizef;
 	unsigned char                           *bytecolors;
 	GLfloat									pointsizerange[2];
-	double									convfactor;
+	GLfloat									minsize, maxsize;
+	GLuint									pointSizeShader;
+	GLint									dotSizeAttrib;
+	GLubyte									*vertexdata;
+	const GLubyte							*vertexbase;
+	size_t									xybytes, sizebytes, colorbytes;
+	GLenum									colortype = GL_FLOAT;
     
 	// All sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
@@ -103,7 +155,7 @@ PsychError SCREENDrawDots(void)
 	colors = NULL;
 	bytecolors = NULL;
 
-	PsychPrepareRenderBatch(windowRecord, 2, &nrpoints, &xy, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size);
+	PsychPrepareRenderBatch(windowRecord, 2, &nrpoints, &xy, &xyf, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size, &sizef);
 	isdoublecolors = (colors) ? TRUE:FALSE;
 	isuint8colors  = (bytecolors) ? TRUE:FALSE;
 	usecolorvector = (nc>1) ? TRUE:FALSE;
@@ -153,15 +205,27 @@ PsychError SCREENDrawDots(void)
 		glGetFloatv(GL_ALIASED_POINT_SIZE_RANGE, (GLfloat*) &pointsizerange);
 	}
 	
-	// Set size of a single dot:
-	if (size[0] > pointsizerange[1] || size[0] < pointsizerange[0]) {
+	// Convert double precision sizes once into single precision:
+	if (sizef == NULL) {
+		sizef = (float*) PsychMallocTemp(nrsize * sizeof(float));
+		for (i = 0; i < nrsize; i++) sizef[i] = (float) size[i];
+	}
+
+	// Check if all requested sizes are supported:
+	minsize = maxsize = sizef[0];
+	for (i = 1; i < nrsize; i++) {
+		if (sizef[i] < minsize) minsize = sizef[i];
+		if (sizef[i] > maxsize) maxsize = sizef[i];
+	}
+
+	if (maxsize > pointsizerange[1] || minsize < pointsizerange[0]) {
 		printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
-			   size[0], pointsizerange[0], pointsizerange[1]);
+			   (maxsize > pointsizerange[1]) ? maxsize : minsize, pointsizerange[0], pointsizerange[1]);
 		PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
 	}
 	
 	// Setup initial common point size for all points:
-	glPointSize(size[0]);
+	glPointSize(sizef[0]);
 	
 	// Setup modelview matrix to perform translation by 'center':
 	glMatrixMode(GL_MODELVIEW);
@@ -172,20 +236,43 @@ PsychError SCREENDrawDots(void)
 	// Apply a global translation of (center(x,y)) pixels to all following points:
 	glTranslated(center[0], center[1], 0);
 	
-	// Render the array of 2D-Points - Efficient version:
-	// This command sequence allows fast processing of whole arrays
-	// of vertices (or points, in this case). It saves the call overhead
-	// associated with the original implementation below and is potentially
-	// optimized in specific OpenGL implementations.
-	
+	// Different size for each dot provided? Then use our point size vertex shader if possible,
+	// which takes the size of each dot from a per-vertex attribute, so all dots get drawn with
+	// one single render-call as well. Only possible if no default draw shader, e.g., for unclamped
+	// high precision colors, needs to be bound:
+	pointSizeShader = 0;
+	dotSizeAttrib = -1;
+	if (nrsize > 1) {
+		pointSizeShader = (windowRecord->defaultDrawShader == 0) ? PsychGetPointSizeDrawShader(windowRecord) : 0;
+		dotSizeAttrib = (pointSizeShader) ? glGetAttribLocation(pointSizeShader, "dotSize") : -1;
+	}
+
+	// Stream all 2D-Points, and sizes and colors if needed, into the windows vertex buffer
+	// ring, converted once into single precision or uint8, so the gpu can fetch them with
+	// one single render-call. Layout: All xy, then all sizes, then all colors:
+	xybytes    = 2 * nrpoints * sizeof(float);
+	sizebytes  = (dotSizeAttrib >= 0) ? nrpoints * sizeof(float) : 0;
+	colorbytes = (usecolorvector) ? PsychGetVertexColorStreamSize(windowRecord, nc, mc, bytecolors) : 0;
+
+	vertexdata = (GLubyte*) PsychBeginVertexStream(windowRecord, xybytes + sizebytes + colorbytes);
+	if (xyf) {
+		memcpy(vertexdata, xyf, xybytes);
+	}
+	else {
+		for (i = 0; i < 2 * nrpoints; i++) ((float*) vertexdata)[i] = (float) xy[i];
+	}
+	if (sizebytes) memcpy(vertexdata + xybytes, sizef, sizebytes);
+	if (colorbytes) colortype = PsychWriteVertexColorStream(windowRecord, vertexdata + xybytes + sizebytes, nc, mc, 1, colors, bytecolors);
+	vertexbase = PsychEndVertexStream(windowRecord);
+
 	// Pass a pointer to the start of the point-coordinate array:
-	glVertexPointer(2, GL_DOUBLE, 0, &xy[0]);
+	glVertexPointer(2, GL_FLOAT, 0, vertexbase);
 	
 	// Enable fast rendering of arrays:
 	glEnableClientState(GL_VERTEX_ARRAY);
 	
 	if (usecolorvector) {
-		PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+		PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colortype, vertexbase + xybytes + sizebytes);
 	}
 	
 	// Render all n points, starting at point 0, render them as POINTS:
@@ -195,30 +282,40 @@ PsychError SCREENDrawDots(void)
 		glDrawArrays(GL_POINTS, 0, nrpoints);
 	}
 	else {
-		// Different size for each dot provided: We have to do One GL - call per dot.
-		// This is *pretty inefficient* and should be reimplemented in the future via
-		// Point-Sprite extensions, cleverly used display lists or via vertex-shaders...
-		// For now we do it the stupid way:
-		for (i=0; i<nrpoints; i++) {
-			if (size[i] > pointsizerange[1] || size[i] < pointsizerange[0]) {
-				printf("PTB-ERROR: You requested a point size of %f units, which is not in the range (%f to %f) supported by your graphics hardware.\n",
-					   size[i], pointsizerange[0], pointsizerange[1]);
-				PsychErrorExitMsg(PsychError_user, "Unsupported point size requested in Screen('DrawDots').");
+		if (dotSizeAttrib >= 0) {
+			// Different size for each dot provided: Draw via point size shader:
+			PsychSetShader(windowRecord, (int) pointSizeShader);
+			glEnable(GL_VERTEX_PROGRAM_POINT_SIZE);
+			glVertexAttribPointer(dotSizeAttrib, 1, GL_FLOAT, GL_FALSE, 0, vertexbase + xybytes);
+			glEnableVertexAttribArray(dotSizeAttrib);
+
+			glDrawArrays(GL_POINTS, 0, nrpoints);
+
+			glDisableVertexAttribArray(dotSizeAttrib);
+			glDisable(GL_VERTEX_PROGRAM_POINT_SIZE);
+			PsychSetShader(windowRecord, -1);
+		}
+		else {
+			// No shader support: We have to do One GL - call per dot.
+			// This is *pretty inefficient*, but our only option:
+			for (i=0; i<nrpoints; i++) {
+				// Setup point size for this point:
+				glPointSize(sizef[i]);
+				
+				// Render point:
+				glDrawArrays(GL_POINTS, i, 1);
 			}
-			
-			// Setup point size for this point:
-			glPointSize(size[i]);
-			
-			// Render point:
-			glDrawArrays(GL_POINTS, i, 1);
 		}
 	}
 	
 	// Disable fast rendering of arrays:
 	glDisableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_DOUBLE, 0, NULL);
+	glVertexPointer(2, GL_FLOAT, 0, NULL);
 	
-	if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+	if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, GL_FLOAT, NULL);
+
+	// Done with this batch of vertex data:
+	PsychReleaseVertexStream(windowRecord);
 	
 	// Restore old matrix from backup copy, undoing the global translation:
 	glPopMatrix();
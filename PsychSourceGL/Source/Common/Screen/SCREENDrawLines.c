@@ -72,7 +72,8 @@ static char synopsisString[] =
 "line segment, PTB will generate a smooth transition of colors along the line via linear interpolation. "
 "The default color is white if colors is omitted. \"smooth\" is a flag that determines whether lines "
 "should be smoothed: 0 (default) no smoothing, 1 smoothing (with anti-aliasing). If you use smoothing, "
-"you'll also need to set a proper blending mode with Screen('BlendFunction').";
+"you'll also need to set a proper blending mode with Screen('BlendFunction'). \"xy\" can also "
+"be passed as a single precision matrix, e.g., single(xy), to save conversion overhead.";
   
 static char seeAlsoString[] = "BlendFunction";	 
 
@@ -83,9 +84,12 @@ PsychError SCREENDrawLines(void)
 	int							nrsize, nrcolors, nrvertices, mc, nc, pc, i;
 	psych_bool                     isArgThere, usecolorvector, isdoublecolors, isuint8colors;
 	double						*xy, *size, *center, *dot_type, *colors;
+	float						*xyf;
 	unsigned char               *bytecolors;
-	float						linesizerange[2];
-	double						convfactor;
+	GLubyte						*vertexdata;
+	const GLubyte				*vertexbase;
+	size_t						xybytes, colorbytes;
+	GLenum						colortype = GL_FLOAT;
 
 	//all sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
@@ -105,7 +109,7 @@ PsychError SCREENDrawLines(void)
 	colors = NULL;
 	bytecolors = NULL;
 
-	PsychPrepareRenderBatch(windowRecord, 2, &nrvertices, &xy, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size);
+	PsychPrepareRenderBatch(windowRecord, 2, &nrvertices, &xy, &xyf, 4, &nc, &mc, &colors, &bytecolors, 3, &nrsize, &size, NULL);
 	isdoublecolors = (colors) ? TRUE:FALSE;
 	isuint8colors  = (bytecolors) ? TRUE:FALSE;
 	usecolorvector = (nc>1) ? TRUE:FALSE;
@@ -151,17 +155,27 @@ PsychError SCREENDrawLines(void)
 	// Apply a global translation of (center(x,y)) pixels to all following lines:
 	glTranslated(center[0], center[1],0);
 	
-	// Render the array of 2D-Lines - Efficient version:
-	// This command sequence allows fast processing of whole arrays
-	// of vertices (or lines, in this case). It saves the call overhead
-	// associated with the original implementation below and is potentially
-	// optimized in specific OpenGL implementations.
-	
+	// Render the array of 2D-Lines - Efficient version: Stream all vertices and colors
+	// into the windows vertex buffer ring, converted once into single precision or uint8,
+	// and draw them with one render-call. Layout: All xy, then all colors:
+	xybytes    = 2 * nrvertices * sizeof(float);
+	colorbytes = (usecolorvector) ? PsychGetVertexColorStreamSize(windowRecord, nc, mc, bytecolors) : 0;
+
+	vertexdata = (GLubyte*) PsychBeginVertexStream(windowRecord, xybytes + colorbytes);
+	if (xyf) {
+		memcpy(vertexdata, xyf, xybytes);
+	}
+	else {
+		for (i = 0; i < 2 * nrvertices; i++) ((float*) vertexdata)[i] = (float) xy[i];
+	}
+	if (colorbytes) colortype = PsychWriteVertexColorStream(windowRecord, vertexdata + xybytes, nc, mc, 1, colors, bytecolors);
+	vertexbase = PsychEndVertexStream(windowRecord);
+
 	// Pass a pointer to the start of the arrays:
-	glVertexPointer(2, GL_DOUBLE, 0, &xy[0]);
+	glVertexPointer(2, GL_FLOAT, 0, vertexbase);
 	
 	if (usecolorvector) {
-		PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colors, bytecolors);
+		PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colortype, vertexbase + xybytes);
 	}
 
 	// Enable fast rendering of arrays:
@@ -183,9 +197,12 @@ PsychError SCREENDrawLines(void)
 	
 	// Disable fast rendering of arrays:
 	glDisableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_DOUBLE, 0, NULL);
+	glVertexPointer(2, GL_FLOAT, 0, NULL);
+
+	if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, GL_FLOAT, NULL);
 
-	if (usecolorvector) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, NULL, NULL);
+	// Done with this batch of vertex data:
+	PsychReleaseVertexStream(windowRecord);
 	
 	// Restore old matrix from backup copy, undoing the global translation:
 	glPopMatrix();
@@ -68,7 +68,10 @@ static char synopsisString[] =
 	"rotated textures, where the drawn 'dstRect' texture rectangle is always upright, but texels are retrieved at rotated positions, "
 	"as if the 'srcRect' rectangle would be rotated. If you set a value of kPsychDontDoRotation then the rotation angle will not be "
 	"used to rotate the texture. Instead it will be passed to a bount texture shader (if any), which is free to interpret the "
-	"'rotationAngle' parameters is it wants - e.g., to implement custom texture rotation."
+	"'rotationAngle' parameters is it wants - e.g., to implement custom texture rotation. "
+	"Drawing of a texture whose asynchronous creation via Screen('MakeTexture') isn't finished yet waits for it to finish. "
+	"If you set a value of kPsychSkipNotReadyTexture, such a texture is skipped instead, i.e., not drawn at all. "
+	"Screen('TextureReady') allows to check if a texture is ready."
 	"\n\n"
 	"'auxParameters' optional argument: If this is set as a vector with at least 4 components, and a multiple of four components, "
 	"then these values are passed to a shader (if any is bound) as 'auxParameter0....n'. The current implementation supports at "
@@ -92,6 +95,7 @@ static char synopsisString[] =
 	double*							auxParameters;
 	int								numAuxParams, numAuxComponents, m, n, p;
 	int specialFlags = 0;
+	double texid;
 
     //all subfunctions should have these two lines.  
     PsychPushHelp(useString, synopsisString, seeAlsoString);
@@ -103,8 +107,19 @@ static char synopsisString[] =
     PsychErrorExit(PsychRequireNumInputArgs(2)); 	
     PsychErrorExit(PsychCapNumOutputArgs(0)); 
 	
+	// Assign optional special flags:
+    PsychCopyInIntegerArg(10, kPsychArgOptional, &specialFlags);
+
     //Read in arguments
     PsychAllocInWindowRecordArg(1, kPsychArgRequired, &target);
+
+	// Skip texture if its asynchronous creation isn't finished and skipping is requested. Otherwise
+	// PsychAllocInWindowRecordArg() waits for it:
+	if ((specialFlags & kPsychSkipNotReadyTexture) && PsychCopyInDoubleArg(2, kPsychArgRequired, &texid) && IsWindowIndex((PsychWindowIndexType) texid) &&
+		(FindWindowRecord((PsychWindowIndexType) texid, &source) == PsychError_none) && !PsychFinishAsyncTexture(source, FALSE)) {
+		return(PsychError_none);
+	}
+
     PsychAllocInWindowRecordArg(2, kPsychArgRequired, &source);
     if(source->windowType!=kPsychTexture) {
       PsychErrorExitMsg(PsychError_user, "The first argument supplied was a window pointer, not a texture pointer");
@@ -157,9 +172,6 @@ static char synopsisString[] =
 	textureShader = -1;
     PsychCopyInIntegerArg(9, kPsychArgOptional, &textureShader);
 
-	// Assign any other optional special flags:
-    PsychCopyInIntegerArg(10, kPsychArgOptional, &specialFlags);
-	
 	// Set rotation mode flag for texture matrix rotation if secialFlags is set accordingly:
 	if (specialFlags & kPsychUseTextureMatrixForRotation) source->specialflags|=kPsychUseTextureMatrixForRotation;
 	// Set rotation mode flag for no fixed function pipeline rotation if secialFlags is set accordingly:
@@ -224,7 +236,7 @@ PsychError SCREENDrawTextures(void)
 	"b) n textures drawn to n different locations: Same as a) but provide a n component vector of 'texturePointers' one for "
 	"each texture to be drawn to one of n locations at n angles.\n";
 
-	PsychWindowRecordType			*source, *target;
+	PsychWindowRecordType			*source, *target, *batchSource;
 	PsychRectType					sourceRect, targetRect, tempRect;
 	PsychColorType	color;
 	GLdouble						dVals[4]; 
@@ -258,6 +270,19 @@ PsychError SCREENDrawTextures(void)
 	// This is the number of texture handles:
 	numTexs = m * n;
 
+	// Assign optional special flags:
+    PsychCopyInIntegerArg(10, kPsychArgOptional, &specialFlags);
+
+	// Finish asynchronous creation of all textures before drawing. Textures which aren't ready yet
+	// are left pending for skipping in the blitting loop, if skipping is requested:
+	for (i = 0; i < numTexs; i++) {
+		if (IsWindowIndex((PsychWindowIndexType) texids[i]) && (FindWindowRecord((PsychWindowIndexType) texids[i], &source) == PsychError_none) &&
+			!PsychFinishAsyncTexture(source, (specialFlags & kPsychSkipNotReadyTexture) ? FALSE : TRUE)) {
+			// Only texture is not ready: Nothing to draw.
+			if (numTexs == 1) return(PsychError_none);
+		}
+	}
+
 	// Only one texture?
 	if (numTexs == 1) {
 		// Yes. Allocate it in the conventional way:
@@ -276,7 +301,7 @@ PsychError SCREENDrawTextures(void)
 	
 	// The negative position -4 means: dstRects coords are expected at position 4, but they are optional.
 	// NULL means - don't want a size's vector.
-	PsychPrepareRenderBatch(target, -4, &numdstRects, &dstRects, 8, &nc, &mc, &colors, &bytecolors, 5, &nrsize, &penSizes);
+	PsychPrepareRenderBatch(target, -4, &numdstRects, &dstRects, NULL, 8, &nc, &mc, &colors, &bytecolors, 5, &nrsize, &penSizes, NULL);
 
 	// At this point, target is set up as target window, i.e. its GL-Context is active, it is set as drawing target,
 	// alpha blending is set up according to Screen('BlendFunction'), and the drawing color is set if it is a singular one.
@@ -407,11 +432,31 @@ PsychError SCREENDrawTextures(void)
 	textureShader = -1;
     PsychCopyInIntegerArg(9, kPsychArgOptional, &textureShader);
 
-	// Assign any other optional special flags:
-    PsychCopyInIntegerArg(10, kPsychArgOptional, &specialFlags);
-
 	// Ok, everything consistent so far.
-	
+
+	// Batched drawing: If all textures share one OpenGL texture, e.g., items of one atlas texture from
+	// Screen('MakeTextures') or one texture drawn many times, and neither rotation nor per-item filterModes,
+	// shaders or auxParameters are requested, then all textures are drawn within one glBegin() / glEnd():
+	batchSource = NULL;
+	if ((numRef > 1) && (textureShader == -1) && (numFilterModes <= 1) && (numAuxParams == 0) && (filterMode >= 0) && (filterMode <= 3)) {
+		for (i = 0; i < numAngles; i++) if (rotationAngles[i] != 0.0) break;
+		j = (i < numAngles) ? 0 : numTexs;
+
+		for (i = 0; i < j; i++) {
+			if (numTexs > 1) {
+				if (!IsWindowIndex((PsychWindowIndexType) texids[i]) || (FindWindowRecord((PsychWindowIndexType) texids[i], &source) != PsychError_none) ||
+					(source->windowType != kPsychTexture)) break;
+				if (source->asyncTextureJob) continue;
+			}
+
+			if (!PsychCanBatchBlitTexture(source) || (batchSource && (source->textureNumber != batchSource->textureNumber))) break;
+			batchSource = source;
+		}
+
+		if (i < numTexs) batchSource = NULL;
+		if (batchSource) PsychBeginBatchBlitTextures(batchSource, target, (int) filterMode);
+	}
+
 	// Texture blitting loop:
 	for (i=0; i < numRef; i++) {
 		// Draw i'th texture:
@@ -432,6 +477,9 @@ PsychError SCREENDrawTextures(void)
 				PsychErrorExitMsg(PsychError_user, "The second argument supplied was not a texture handle!");
 			}
 
+			// Skip textures whose asynchronous creation isn't finished yet:
+			if (source->asyncTextureJob) continue;
+
 			// Ok, we have our texture record in source:
 		}
 		
@@ -542,8 +590,11 @@ PsychError SCREENDrawTextures(void)
 		if (specialFlags & kPsychUseTextureMatrixForRotation) source->specialflags|=kPsychUseTextureMatrixForRotation;
 		if (specialFlags & kPsychDontDoRotation) source->specialflags|=kPsychDontDoRotation;
 
-		// Perform blit operation for i'th texture, either with or without an override texture shader applied:
-		if (textureShader > -1) {
+		// Perform blit operation for i'th texture, either batched, or with or without an override texture shader applied:
+		if (batchSource) {
+			PsychBatchBlitTexture(source, sourceRect, targetRect, globalAlpha);
+		}
+		else if (textureShader > -1) {
 			backupShader = source->textureFilterShader;
 			source->textureFilterShader = -1 * textureShader;
 			PsychBlitTextureToDisplay(source, target, sourceRect, targetRect, rotationAngle, filterMode, globalAlpha);	
@@ -559,6 +610,8 @@ PsychError SCREENDrawTextures(void)
 		// Next one...
 	}
 
+	if (batchSource) PsychEndBatchBlitTextures(batchSource);
+
 	target->auxShaderParams = NULL;
 	target->auxShaderParamsCount = 0;
 
@@ -120,7 +120,7 @@ PsychError SCREENFillOval(void)
 	
 	// The negative position -3 means: xy coords are expected at position 3, but they are optional.
 	// NULL means - don't want a size's vector.
-	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, 2, &nc, &mc, &colors, &bytecolors, 0, &nrsize, NULL);
+	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, NULL, 2, &nc, &mc, &colors, &bytecolors, 0, &nrsize, NULL, NULL);
 
 	// Only up to one rect provided?
 	if (numRects <= 1) {
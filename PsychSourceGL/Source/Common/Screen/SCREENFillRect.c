@@ -61,6 +61,10 @@ PsychError SCREENFillRect(void)
     double							*xy, *colors;
 	unsigned char					*bytecolors;
 	int								numRects, i, nc, mc, nrsize;
+	GLfloat							*vertices;
+	const GLubyte					*vertexbase;
+	size_t							xybytes, colorbytes;
+	GLenum							colortype = GL_FLOAT;
 
 	//all sub functions should have these two lines
 	PsychPushHelp(useString, synopsisString,seeAlsoString);
@@ -80,7 +84,7 @@ PsychError SCREENFillRect(void)
 	bytecolors = NULL;
 	// The negative position -3 means: xy coords are expected at position 3, but they are optional.
 	// NULL means - don't want a size's vector.
-	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, 2, &nc, &mc, &colors, &bytecolors, 0, &nrsize, NULL);
+	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, NULL, 2, &nc, &mc, &colors, &bytecolors, 0, &nrsize, NULL, NULL);
 	isScreenRect=FALSE;
 	
 	// Only up to one rect provided?
@@ -150,17 +154,39 @@ PsychError SCREENFillRect(void)
 	  } else {
 	    // Partial fill: Draw provided rects:
 		if (numRects>1) {
-			// Multiple rects provided: Draw the whole batch:
+			// Multiple rects provided: Stream the whole batch as quads into the windows vertex buffer
+			// ring, converted once into single precision, and draw it with one render-call. Per rect
+			// colors are replicated for all four vertices of a quad. Layout: All xy, then all colors:
+			xybytes    = numRects * 8 * sizeof(GLfloat);
+			colorbytes = (nc > 1) ? PsychGetVertexColorStreamSize(windowRecord, numRects * 4, mc, bytecolors) : 0;
+
+			vertices = (GLfloat*) PsychBeginVertexStream(windowRecord, xybytes + colorbytes);
 			for (i=0; i<numRects; i++) {
-				// Per rect color provided?
-				if (nc>1) {
-					// Yes. Set color for this specific rect:
-					PsychSetArrayColor(windowRecord, i, mc, colors, bytecolors);
-				}
-				
-				// Submit rect for drawing:
-				if (!IsPsychRectEmpty(rect)) PsychGLRect(&(xy[i*4]));
+				// Same vertex order as glRectd(): Top-left, top-right, bottom-right, bottom-left:
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychLeft];
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychTop];
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychRight];
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychTop];
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychRight];
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychBottom];
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychLeft];
+				*(vertices++) = (GLfloat) xy[i*4 + kPsychBottom];
 			}
+			if (colorbytes) colortype = PsychWriteVertexColorStream(windowRecord, vertices, numRects, mc, 4, colors, bytecolors);
+			vertexbase = PsychEndVertexStream(windowRecord);
+
+			glVertexPointer(2, GL_FLOAT, 0, vertexbase);
+			glEnableClientState(GL_VERTEX_ARRAY);
+			if (nc > 1) PsychSetupVertexColorArrays(windowRecord, TRUE, mc, colortype, vertexbase + xybytes);
+
+			glDrawArrays(GL_QUADS, 0, numRects * 4);
+
+			glDisableClientState(GL_VERTEX_ARRAY);
+			glVertexPointer(2, GL_FLOAT, 0, NULL);
+			if (nc > 1) PsychSetupVertexColorArrays(windowRecord, FALSE, 0, GL_FLOAT, NULL);
+
+			// Done with this batch of vertex data:
+			PsychReleaseVertexStream(windowRecord);
 		}
 		else {
 			// Single partial screen rect provided: Draw it.
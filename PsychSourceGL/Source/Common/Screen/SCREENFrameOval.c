@@ -107,7 +107,7 @@ PsychError SCREENFrameOval(void)
 	
 	// The negative position -3 means: xy coords are expected at position 3, but they are optional.
 	// NULL means - don't want a size's vector.
-	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, 2, &nc, &mc, &colors, &bytecolors, 4, &nrsize, &penSizes);
+	PsychPrepareRenderBatch(windowRecord, -3, &numRects, &xy, NULL, 2, &nc, &mc, &colors, &bytecolors, 4, &nrsize, &penSizes, NULL);
 
 	// Only up to one rect provided?
 	if (numRects <= 1) {
@@ -17,9 +17,6 @@
 
 	TO DO:
     
-		We could probably speed this up by using a single call to glReadPixels instead of three.  It doesn't matter what we pack the result into,
-		since we have to iterate over and copy out from the memory which glReadPixels fills so to rearrange correclty into the return matrix. None
-		of the glReadPixels modes will fill the return matrix in the same format that MATLAB wants.  
 */
 
 
@@ -27,8 +24,8 @@
 #include "Screen.h"
 
 // If you change the useString then also change the corresponding synopsis string in ScreenSynopsis.c
-static char useString[] =  "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3])";
-//                                                        1           2       3				4				   5
+static char useString[] =  "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3] [,async=0])";
+//                                                        1           2       3				4				   5				6
 
 static char synopsisString[] =
 "Slowly copy an image from a window or texture to Matlab/Octave, by default returning a uint8 array. "
@@ -57,10 +54,19 @@ static char synopsisString[] =
 "data will be returned in the normalized range 0.0 to 1.0 instead of 0 - 255. Floating "
 "point readback is only beneficial when reading back floating point precision textures, "
 "offscreen windows or the framebuffer when the imaging pipeline is active and HDR mode "
-"is selected (ie. more than 8bpc framebuffer).\n"
+"is selected (ie. more than 8bpc framebuffer). Set the flag to 2 to get a single precision "
+"matrix instead, which needs only half the memory and time of a double precision matrix. "
+"Readback of floating point framebuffers into the default uint8 matrix is done by the "
+"graphics hardware in one step, without any intermediate floating point copy.\n"
 "\"nrchannels\" Number of color channels to return. By default, 3 channels (RGB) are "
 "returned. Specify 1 for Red/Luminance only, 2 for Red+Green or Luminance+Alpha, 3 for "
-"RGB and 4 for RGBA.\n\n";
+"RGB and 4 for RGBA.\n"
+"\"async\" If set to 1, only start an asynchronous readback of the image and return a "
+"ticket for it instead of the image. The readback is performed by the graphics hardware in "
+"the background, without stalling the graphics pipeline, so it is suitable for recording "
+"every stimulus image of a fast presentation loop. Fetch the image later via "
+"Screen('FetchImage'), typically after the following Screen('Flip'). See "
+"Screen('FetchImage?') for details.\n\n";
 
 static char useString2[] = "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1])";
 //                                                    1           2       3				4			  5
@@ -97,8 +103,437 @@ static char synopsisString2[] =
 "Images are always stored as four channel RGBA frames.\n\n"
 "See Screen('CreateMovie?') for help on movie creation.\n";
 
-static char seeAlsoString[] = "PutImage CopyWindow CreateMovie FinalizeMovie";
+static char seeAlsoString[] = "PutImage CopyWindow CreateMovie FinalizeMovie FetchImage";
+
+// Conversion of glReadPixels() output into Matlab/Octave image matrices:
+//
+// glReadPixels() returns rows of interleaved pixels, bottom row first, whereas Matlab/Octave wants one
+// column-major array per color plane, top row first. The conversion transposes, flips and deinterleaves
+// in one go. It is done in tiles of pixels, so reading and writing stays within the cache, with SSE2
+// 16 x 16 byte transposes for uint8 results where available. Big images are split into stripes of
+// columns which get converted in parallel by multiple threads, as selected by
+// Screen('Preference', 'MakeTextureThreads'). Setting 0 selects the scalar reference code.
+
+// SSE2 vector instructions are always available on 64-bit x86 and optionally enabled on 32-bit x86 builds:
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PSYCH_GETIMAGE_HAVE_SSE2 1
+#endif
+
+// Maximum number of conversion threads, minimum number of pixels per thread, and tile size of scalar code:
+#define PSYCH_GETIMAGE_MAXTHREADS 16
+#define PSYCH_GETIMAGE_MINSTRIPEPIXELS (128 * 1024)
+#define PSYCH_GETIMAGE_TILE 32
+
+// Data types of returned image matrices:
+#define kPsychGetImageUInt8		0
+#define kPsychGetImageDouble	1
+#define kPsychGetImageSingle	2
+
+typedef struct PsychGetImageJob {
+	const void*		src;			// glReadPixels() output: GLubyte for uint8 results, GLfloat otherwise.
+	int				srcComponents;	// Number of components per pixel in 'src'.
+	int				chanofs[4];		// Offset of the component for each returned plane within a pixel.
+	void*			dst;			// Returned image matrix.
+	int				dstType;		// One of kPsychGetImageXXX.
+	int				nrchannels;		// Number of returned planes.
+	size_t			width;			// Width of image in pixels.
+	size_t			height;			// Height of image in pixels.
+	psych_bool		usesimd;		// Use SSE2 kernels and tiling.
+	size_t			start;			// First column to convert.
+	size_t			end;			// One past last column to convert.
+	psych_bool		threaded;		// Stripe is converted by 'thread', instead of the calling thread.
+	psych_thread	thread;			// Thread converting this stripe.
+} PsychGetImageJob;
+
+// Scalar conversion of columns ix0 to ix1 - 1 and rows iy0 to iy1 - 1 of the image:
+static void PsychGetImageConvertTile(const PsychGetImageJob* job, size_t ix0, size_t ix1, size_t iy0, size_t iy1)
+{
+	size_t ix, iy, si, di;
+	size_t planeSize = job->width * job->height;
+	size_t nc = (size_t) job->srcComponents;
+	int k;
+
+	for (k = 0; k < job->nrchannels; k++) {
+		for (ix = ix0; ix < ix1; ix++) {
+			si = (ix + (job->height - 1 - iy0) * job->width) * nc + (size_t) job->chanofs[k];
+			di = (size_t) k * planeSize + ix * job->height + iy0;
+			switch (job->dstType) {
+				case kPsychGetImageUInt8:
+					for (iy = iy0; iy < iy1; iy++, si -= job->width * nc) ((ubyte*) job->dst)[di++] = ((const GLubyte*) job->src)[si];
+				break;
+
+				case kPsychGetImageDouble:
+					for (iy = iy0; iy < iy1; iy++, si -= job->width * nc) ((double*) job->dst)[di++] = (double) ((const GLfloat*) job->src)[si];
+				break;
+
+				case kPsychGetImageSingle:
+					for (iy = iy0; iy < iy1; iy++, si -= job->width * nc) ((float*) job->dst)[di++] = ((const GLfloat*) job->src)[si];
+				break;
+			}
+		}
+	}
+}
+
+#ifdef PSYCH_GETIMAGE_HAVE_SSE2
+// Transpose the 16 x 16 bytes in r[0] to r[15] in place:
+static void PsychGetImageTranspose16x16(__m128i* r)
+{
+	__m128i t[16];
+	int i, pass;
+
+	for (pass = 0; pass < 4; pass++) {
+		for (i = 0; i < 8; i++) {
+			t[2 * i]     = _mm_unpacklo_epi8(r[i], r[i + 8]);
+			t[2 * i + 1] = _mm_unpackhi_epi8(r[i], r[i + 8]);
+		}
+		for (i = 0; i < 16; i++) r[i] = t[i];
+	}
+}
+
+// Extract the byte at offset 'ofs' of each of the 16 4-byte pixels in v[0] to v[3]:
+static __m128i PsychGetImageExtractChannel(const __m128i* v, int ofs)
+{
+	const __m128i	mask = _mm_set1_epi32(0xff);
+	const __m128i	shift = _mm_cvtsi32_si128(8 * ofs);
+	__m128i			lo, hi;
+
+	lo = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(v[0], shift), mask), _mm_and_si128(_mm_srl_epi32(v[1], shift), mask));
+	hi = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(v[2], shift), mask), _mm_and_si128(_mm_srl_epi32(v[3], shift), mask));
+	return(_mm_packus_epi16(lo, hi));
+}
+
+// SSE2 conversion of the 16 x 16 pixel tile at column ix0 and row iy0 for uint8 results:
+static void PsychGetImageConvertTileSIMD(const PsychGetImageJob* job, size_t ix0, size_t iy0)
+{
+	__m128i			planes[4][16];
+	__m128i			v[4];
+	const GLubyte*	row;
+	ubyte*			out;
+	size_t			planeSize = job->width * job->height;
+	int				i, k;
+
+	// Row i of the tile is image row iy0 + i, which is row height - 1 - (iy0 + i) of the readback:
+	for (i = 0; i < 16; i++) {
+		row = ((const GLubyte*) job->src) + ((job->height - 1 - (iy0 + (size_t) i)) * job->width + ix0) * (size_t) job->srcComponents;
+		if (job->srcComponents == 1) {
+			planes[0][i] = _mm_loadu_si128((const __m128i*) row);
+		}
+		else {
+			v[0] = _mm_loadu_si128((const __m128i*) row);
+			v[1] = _mm_loadu_si128((const __m128i*) (row + 16));
+			v[2] = _mm_loadu_si128((const __m128i*) (row + 32));
+			v[3] = _mm_loadu_si128((const __m128i*) (row + 48));
+			for (k = 0; k < job->nrchannels; k++) planes[k][i] = PsychGetImageExtractChannel(v, job->chanofs[k]);
+		}
+	}
+
+	// Transposed, each vector is 16 rows of one column of the tile:
+	for (k = 0; k < job->nrchannels; k++) {
+		PsychGetImageTranspose16x16(planes[k]);
+		out = ((ubyte*) job->dst) + (size_t) k * planeSize + ix0 * job->height + iy0;
+		for (i = 0; i < 16; i++) _mm_storeu_si128((__m128i*) (out + (size_t) i * job->height), planes[k][i]);
+	}
+}
+#endif
+
+// Convert the stripe of columns assigned to 'job':
+static void PsychGetImageConvertStripe(const PsychGetImageJob* job)
+{
+	size_t ix0, ix1, iy0, iy1;
+
+	// Scalar reference code, one pass over the whole stripe:
+	if (!job->usesimd) {
+		PsychGetImageConvertTile(job, job->start, job->end, 0, job->height);
+		return;
+	}
+
+	for (ix0 = job->start; ix0 < job->end; ix0 = ix1) {
+		ix1 = (ix0 + PSYCH_GETIMAGE_TILE < job->end) ? ix0 + PSYCH_GETIMAGE_TILE : job->end;
+		for (iy0 = 0; iy0 < job->height; iy0 = iy1) {
+			iy1 = (iy0 + PSYCH_GETIMAGE_TILE < job->height) ? iy0 + PSYCH_GETIMAGE_TILE : job->height;
+
+#ifdef PSYCH_GETIMAGE_HAVE_SSE2
+			// Full 16 x 16 sub-tiles of uint8 results are done by the SSE2 code:
+			if ((job->dstType == kPsychGetImageUInt8) && (job->srcComponents == 1 || job->srcComponents == 4) &&
+				(ix1 - ix0 == PSYCH_GETIMAGE_TILE) && (iy1 - iy0 == PSYCH_GETIMAGE_TILE)) {
+				PsychGetImageConvertTileSIMD(job, ix0, iy0);
+				PsychGetImageConvertTileSIMD(job, ix0 + 16, iy0);
+				PsychGetImageConvertTileSIMD(job, ix0, iy0 + 16);
+				PsychGetImageConvertTileSIMD(job, ix0 + 16, iy0 + 16);
+				continue;
+			}
+#endif
+			PsychGetImageConvertTile(job, ix0, ix1, iy0, iy1);
+		}
+	}
+}
+
+// Main function of conversion threads:
+static void* PsychGetImageConvertThreadMain(void* jobToCast)
+{
+	PsychGetImageConvertStripe((const PsychGetImageJob*) jobToCast);
+	return(NULL);
+}
+
+// Convert glReadPixels() output 'src' of a 'width' x 'height' image with 'srcComponents' components per
+// pixel into the 'nrchannels' planes of image matrix 'dst'. Plane k is taken from component chanofs[k]:
+static void PsychGetImageConvert(const void* src, int srcComponents, const int* chanofs, void* dst, int dstType, int nrchannels, size_t width, size_t height)
+{
+	PsychGetImageJob jobs[PSYCH_GETIMAGE_MAXTHREADS];
+	int i, k, numThreads;
+	size_t stripe;
+
+	numThreads = PsychPrefStateGet_MakeTextureThreads();
+
+	// Enough pixels to make threading worth the overhead?
+	if (numThreads > PSYCH_GETIMAGE_MAXTHREADS) numThreads = PSYCH_GETIMAGE_MAXTHREADS;
+	if ((size_t) numThreads > (width * height) / PSYCH_GETIMAGE_MINSTRIPEPIXELS) numThreads = (int) ((width * height) / PSYCH_GETIMAGE_MINSTRIPEPIXELS);
+	if (numThreads < 1) numThreads = 1;
+
+	// Stripes start at multiples of the tile size:
+	stripe = ((width / numThreads) + PSYCH_GETIMAGE_TILE - 1) & ~((size_t) PSYCH_GETIMAGE_TILE - 1);
+
+	for (i = 0; i < numThreads; i++) {
+		jobs[i].src = src;
+		jobs[i].srcComponents = srcComponents;
+		for (k = 0; k < 4; k++) jobs[i].chanofs[k] = (k < nrchannels) ? chanofs[k] : 0;
+		jobs[i].dst = dst;
+		jobs[i].dstType = dstType;
+		jobs[i].nrchannels = nrchannels;
+		jobs[i].width = width;
+		jobs[i].height = height;
+		jobs[i].usesimd = (PsychPrefStateGet_MakeTextureThreads() > 0) ? TRUE : FALSE;
+		jobs[i].threaded = FALSE;
+		jobs[i].start = (size_t) i * stripe;
+		jobs[i].end = (i == numThreads - 1) ? width : (size_t) (i + 1) * stripe;
+		if (jobs[i].end > width) jobs[i].end = width;
+		if (jobs[i].start > jobs[i].end) jobs[i].start = jobs[i].end;
+	}
+
+	// Start threads for all stripes but the first, which we convert ourselves. If thread creation
+	// fails, we convert the stripe ourselves as well:
+	for (i = 1; i < numThreads; i++) {
+		if (PsychCreateThread(&(jobs[i].thread), NULL, PsychGetImageConvertThreadMain, (void*) &jobs[i])) {
+			PsychGetImageConvertStripe(&jobs[i]);
+		}
+		else {
+			jobs[i].threaded = TRUE;
+		}
+	}
+
+	PsychGetImageConvertStripe(&jobs[0]);
+
+	// Wait for all threads to finish:
+	for (i = 1; i < numThreads; i++) {
+		if (jobs[i].threaded) PsychDeleteThread(&(jobs[i].thread));
+	}
+
+	return;
+}
 	
+// Asynchronous readback via Screen('GetImage', ..., async=1) and Screen('FetchImage'):
+//
+// Each window has a ring of pixel buffer objects (PBOs), created at first async 'GetImage'. A readback is
+// enqueued by a glReadPixels() into the next free PBO, which returns immediately, as the copy is done by the
+// graphics hardware in the background, and is identified by a ticket. A fence sync object behind the
+// glReadPixels() tells when the copy is complete. 'FetchImage' maps the PBO and converts its content into an
+// image matrix, which doesn't stall if the copy is complete. If the ring is full, the oldest unfetched
+// readback is dropped to make room for the new one.
+//
+// Without PBO support, readbacks go synchronously into system memory. Without fence support, completion
+// is unknown until 'FetchImage' maps the PBO, so 'FetchImage' always waits.
+#define PSYCH_MAX_ASYNCREADBACKS 64
+
+typedef struct PsychAsyncReadbackSlot {
+	unsigned int	ticket;			// Ticket of the pending readback, or 0 if the slot is free.
+	GLuint			pbo;			// Pixel buffer object, or 0 if PBOs are unsupported.
+	void*			hostBuffer;		// System memory buffer if PBOs are unsupported, or NULL.
+	size_t			bufferSize;		// Size of 'pbo' or 'hostBuffer' in bytes.
+	GLsync			fence;			// Fence behind the readback, or NULL.
+	psych_bool		completed;		// Readback is known to be complete.
+	int				width;			// Size of the readback in pixels.
+	int				height;
+	int				nrchannels;		// Requested number of channels.
+	int				floatprecision;	// Requested return type: 0 = uint8, 1 = double, 2 = single.
+	int				srcComponents;	// Number of components per pixel in the buffer.
+	double			enqueueTime;	// Time of enqueue.
+	double			completionTime;	// Time at which completion was detected.
+} PsychAsyncReadbackSlot;
+
+typedef struct PsychAsyncReadbackRing {
+	int						numSlots;		// Number of used slots.
+	int						nextSlot;		// Slot for next enqueue.
+	unsigned int			nextTicket;		// Ticket for next enqueue.
+	double					enqueued;		// Statistics: Number of enqueued readbacks,
+	double					fetched;		// fetched readbacks,
+	double					dropped;		// and dropped readbacks, ie., overwritten before fetch.
+	double					latencySum;		// Sum and maximum of latencies from enqueue to completion
+	double					latencyMax;		// of fetched readbacks.
+	psych_bool				warnedDrop;		// Warning about dropped readbacks was printed.
+	PsychAsyncReadbackSlot	slots[PSYCH_MAX_ASYNCREADBACKS];
+} PsychAsyncReadbackRing;
+
+// Free 'slot' for reuse, keeping its buffer:
+static void PsychReleaseAsyncReadbackSlot(PsychAsyncReadbackSlot* slot)
+{
+	if (slot->fence) glDeleteSync(slot->fence);
+	slot->fence = NULL;
+	slot->ticket = 0;
+	slot->completed = FALSE;
+}
+
+// Update completion status of all pending readbacks of 'ring', without waiting:
+static void PsychPollAsyncReadbacks(PsychAsyncReadbackRing* ring)
+{
+	PsychAsyncReadbackSlot* slot;
+	double now;
+	GLenum rc;
+	int i;
+
+	PsychGetAdjustedPrecisionTimerSeconds(&now);
+
+	for (i = 0; i < ring->numSlots; i++) {
+		slot = &(ring->slots[i]);
+		if ((slot->ticket == 0) || slot->completed || (slot->fence == NULL)) continue;
+
+		rc = glClientWaitSync(slot->fence, 0, 0);
+		if ((rc == GL_ALREADY_SIGNALED) || (rc == GL_CONDITION_SATISFIED)) {
+			slot->completed = TRUE;
+			slot->completionTime = now;
+		}
+	}
+}
+
+/* PsychDeleteAsyncReadbackRing()
+ *
+ * Release the ring of asynchronous 'GetImage' readbacks of 'windowRecord', if any, including all pending
+ * readbacks. Called at window close time.
+ */
+void PsychDeleteAsyncReadbackRing(PsychWindowRecordType *windowRecord)
+{
+	PsychAsyncReadbackRing* ring = windowRecord->asyncReadbackRing;
+	int i;
+
+	if (ring == NULL) return;
+	windowRecord->asyncReadbackRing = NULL;
+
+	// OpenGL objects are only released if the context still exists, otherwise they are already gone:
+	if (windowRecord->targetSpecific.contextObject) PsychSetGLContext(windowRecord);
+
+	for (i = 0; i < PSYCH_MAX_ASYNCREADBACKS; i++) {
+		if (windowRecord->targetSpecific.contextObject) {
+			if (ring->slots[i].fence) glDeleteSync(ring->slots[i].fence);
+			if (ring->slots[i].pbo) glDeleteBuffers(1, &(ring->slots[i].pbo));
+		}
+		free(ring->slots[i].hostBuffer);
+	}
+
+	free(ring);
+}
+
+// Enqueue asynchronous readback of the given region of the current read buffer of 'windowRecord'. Returns its ticket:
+static unsigned int PsychEnqueueAsyncReadback(PsychWindowRecordType *windowRecord, int x, int y, int width, int height, int floatprecision, int nrchannels)
+{
+	PsychAsyncReadbackRing* ring = windowRecord->asyncReadbackRing;
+	PsychAsyncReadbackSlot* slot;
+	GLenum format, type;
+	size_t bufferSize;
+	int i, numSlots;
+
+	// (Re-)Create ring on first use, or if the number of buffers was changed and no readbacks are pending:
+	numSlots = PsychPrefStateGet_AsyncReadbackBuffers();
+	if (ring && (ring->numSlots != numSlots)) {
+		for (i = 0; i < ring->numSlots; i++) if (ring->slots[i].ticket) break;
+		if (i == ring->numSlots) {
+			PsychDeleteAsyncReadbackRing(windowRecord);
+			ring = NULL;
+		}
+	}
+
+	if (ring == NULL) {
+		ring = (PsychAsyncReadbackRing*) calloc(1, sizeof(PsychAsyncReadbackRing));
+		if (ring == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to setup asynchronous 'GetImage'!");
+		ring->numSlots = numSlots;
+		ring->nextTicket = 1;
+		windowRecord->asyncReadbackRing = ring;
+	}
+
+	PsychPollAsyncReadbacks(ring);
+
+	// Slots are used round-robin, so the next slot holds the oldest readback if the ring is full. Drop it:
+	slot = &(ring->slots[ring->nextSlot]);
+	if (slot->ticket) {
+		if (!ring->warnedDrop && (PsychPrefStateGet_Verbosity() > 1)) {
+			printf("PTB-WARNING: Screen('GetImage'): Ring of %i asynchronous readbacks is full. Dropping oldest unfetched readback with ticket %i.\n", ring->numSlots, slot->ticket);
+			printf("PTB-WARNING: Fetch results via Screen('FetchImage') in time, or increase Screen('Preference', 'AsyncReadbackBuffers'). This warning is only shown once.\n");
+			ring->warnedDrop = TRUE;
+		}
+		PsychReleaseAsyncReadbackSlot(slot);
+		ring->dropped++;
+	}
+
+	// Same readback formats as synchronous 'GetImage':
+	if (floatprecision == 0) {
+		slot->srcComponents = (nrchannels == 1) ? 1 : 4;
+		format = (nrchannels == 1) ? GL_RED : GL_BGRA;
+		type = GL_UNSIGNED_BYTE;
+		bufferSize = (size_t) slot->srcComponents * (size_t) width * (size_t) height;
+	}
+	else {
+		slot->srcComponents = nrchannels;
+		format = (nrchannels == 1) ? GL_RED : ((nrchannels == 2) ? GL_LUMINANCE_ALPHA : ((nrchannels == 3) ? GL_RGB : GL_RGBA));
+		type = GL_FLOAT;
+		bufferSize = (size_t) nrchannels * sizeof(GLfloat) * (size_t) width * (size_t) height;
+	}
+
+	slot->width = width;
+	slot->height = height;
+	slot->nrchannels = nrchannels;
+	slot->floatprecision = floatprecision;
+	slot->completed = FALSE;
+	PsychGetAdjustedPrecisionTimerSeconds(&(slot->enqueueTime));
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+	if (glewIsSupported("GL_ARB_pixel_buffer_object") && glGenBuffers && glMapBuffer) {
+		// Readback into PBO, which returns without waiting for completion:
+		if (slot->pbo == 0) glGenBuffers(1, &(slot->pbo));
+		glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, slot->pbo);
+		if (slot->bufferSize != bufferSize) {
+			glBufferData(GL_PIXEL_PACK_BUFFER_ARB, (GLsizeiptr) bufferSize, NULL, GL_STREAM_READ);
+			slot->bufferSize = bufferSize;
+		}
+		glReadPixels(x, y, width, height, format, type, NULL);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+		if (glewIsSupported("GL_ARB_sync") && glFenceSync) {
+			slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+
+		// Make sure the readback gets started:
+		glFlush();
+	}
+	else {
+		// Synchronous fallback into system memory:
+		if (slot->bufferSize != bufferSize) {
+			free(slot->hostBuffer);
+			slot->hostBuffer = malloc(bufferSize);
+			slot->bufferSize = (slot->hostBuffer) ? bufferSize : 0;
+			if (slot->hostBuffer == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to enqueue asynchronous 'GetImage'!");
+		}
+		glReadPixels(x, y, width, height, format, type, slot->hostBuffer);
+		slot->completed = TRUE;
+		PsychGetAdjustedPrecisionTimerSeconds(&(slot->completionTime));
+	}
+
+	slot->ticket = ring->nextTicket++;
+	ring->nextSlot = (ring->nextSlot + 1) % ring->numSlots;
+	ring->enqueued++;
+
+	return(slot->ticket);
+}
+
 // This also works as 'AddFrameToMovie', as almost all code is shared with 'GetImage'.
 // Only difference is where the fetched pixeldata is sent: To the movie encoder or to
 // a matlab/octave matrix.
@@ -106,15 +541,19 @@ PsychError SCREENGetImage(void)
 {
 	PsychRectType   windowRect, sampleRect;
 	int 			nrchannels, invertedY;
-	size_t			ix, iy, sampleRectWidth, sampleRectHeight, redReturnIndex, greenReturnIndex, blueReturnIndex, alphaReturnIndex, planeSize;
+	size_t			sampleRectWidth, sampleRectHeight;
 	int				viewid;
-	ubyte 			*returnArrayBase, *redPlane, *greenPlane, *bluePlane, *alphaPlane;
-	float 			*dredPlane;
+	ubyte 			*returnArrayBase, *readPixels;
+	float 			*dredPlane, *returnArrayBaseFloat;
 	double 			*returnArrayBaseDouble;
 	PsychWindowRecordType	*windowRecord;
 	GLboolean		isDoubleBuffer, isStereo;
 	char*           buffername = NULL;
-	psych_bool		floatprecision = FALSE;
+	psych_bool		floatflag;
+	int				floatprecision = 0;
+	int				async = 0;
+	static const int	bgraOffsets[4] = { 2, 1, 0, 3 };
+	static const int	rgbaOffsets[4] = { 0, 1, 2, 3 };
 	GLenum			whichBuffer = 0; 
 	int				frameduration = 1;
 	int				moviehandle = 0;
@@ -134,7 +573,7 @@ PsychError SCREENGetImage(void)
 	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
 	
 	//cap the numbers of inputs and outputs
-	PsychErrorExit(PsychCapNumInputArgs(5));   //The maximum number of inputs
+	PsychErrorExit(PsychCapNumInputArgs(6));   //The maximum number of inputs
 	PsychErrorExit(PsychCapNumOutputArgs(1));  //The maximum number of outputs
 	
 	// Get windowRecord for this window:
@@ -292,9 +731,17 @@ PsychError SCREENGetImage(void)
 	if (!isAddMovieFrame) {
 		// Regular fetch:
 
-		// Get optional floatprecision flag: We return data with float-precision if
-		// this flag is set. By default we return uint8 data:
-		PsychCopyInFlagArg(4, FALSE, &floatprecision);
+		// Get optional floatprecision flag: We return data with double-precision if
+		// this flag is 1 or true, single-precision if it is 2. By default we return uint8 data:
+		if (PsychGetArgType(4) == PsychArgType_boolean) {
+			floatflag = FALSE;
+			PsychCopyInFlagArg(4, FALSE, &floatflag);
+			floatprecision = (floatflag) ? 1 : 0;
+		}
+		else {
+			PsychCopyInIntegerArg(4, FALSE, &floatprecision);
+		}
+		if (floatprecision < 0 || floatprecision > 2) PsychErrorExitMsg(PsychError_user, "Invalid 'floatprecision' flag provided. Must be 0, 1 or 2!");
 		
 		// Get the optional number of channels flag: By default we return 3 channels,
 		// the Red, Green, and blue color channel:
@@ -302,76 +749,54 @@ PsychError SCREENGetImage(void)
 		PsychCopyInIntegerArg(5, FALSE, &nrchannels);
 		if (nrchannels < 1 || nrchannels > 4) PsychErrorExitMsg(PsychError_user, "Number of requested channels 'nrchannels' must be between 1 and 4!");
 		
-		if (!floatprecision) {
-			// Readback of standard 8bpc uint8 pixels:  
-			PsychAllocOutUnsignedByteMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBase);
-			redPlane  = (ubyte*) PsychMallocTemp((size_t) nrchannels * sampleRectWidth * sampleRectHeight);
-			planeSize = sampleRectWidth * sampleRectHeight;
-			greenPlane= redPlane + planeSize;
-			bluePlane = redPlane + 2 * planeSize;
-			alphaPlane= redPlane + 3 * planeSize; 
+		// Get the optional async flag:
+		PsychCopyInIntegerArg(6, FALSE, &async);
+		if (async < 0 || async > 1) PsychErrorExitMsg(PsychError_user, "Invalid 'async' flag provided. Must be 0 or 1!");
 
-			glPixelStorei(GL_PACK_ALIGNMENT,1);
-			invertedY = windowRect[kPsychBottom] - sampleRect[kPsychBottom];
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		invertedY = windowRect[kPsychBottom] - sampleRect[kPsychBottom];
 
-			glReadPixels(sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_UNSIGNED_BYTE, redPlane); 
-			if (nrchannels>1) glReadPixels(sampleRect[kPsychLeft],invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_GREEN, GL_UNSIGNED_BYTE, greenPlane);
-			if (nrchannels>2) glReadPixels(sampleRect[kPsychLeft],invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_BLUE, GL_UNSIGNED_BYTE, bluePlane);
-			if (nrchannels>3) glReadPixels(sampleRect[kPsychLeft],invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_ALPHA, GL_UNSIGNED_BYTE, alphaPlane);
-			
-			//in one pass transpose and flip what we read with glReadPixels before returning.  
-			//-glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
-			//-the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.     
-			for(ix=0; ix < sampleRectWidth; ix++){
-				for(iy=0; iy < sampleRectHeight; iy++){
-					// Compute write-indices for returned data:
-					redReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth, nrchannels, iy, ix, 0);
-					greenReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 1);
-					blueReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 2);
-					alphaReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 3);
-					
-					// Always return RED/LUMINANCE channel:
-					returnArrayBase[redReturnIndex] = redPlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];  
-					// Other channels on demand:
-					if (nrchannels>1) returnArrayBase[greenReturnIndex] = greenPlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];
-					if (nrchannels>2) returnArrayBase[blueReturnIndex]  = bluePlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];
-					if (nrchannels>3) returnArrayBase[alphaReturnIndex] = alphaPlane[ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth];
-				}
-			}		
+		if (async) {
+			// Asynchronous readback: Only enqueue it and return its ticket.
+			PsychCopyOutDoubleArg(1, FALSE, (double) PsychEnqueueAsyncReadback(windowRecord, (int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, floatprecision, nrchannels));
 		}
 		else {
-			// Readback of standard 32bpc float pixels into a double matrix:  
-			PsychAllocOutDoubleMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBaseDouble);
-			dredPlane = (float*) PsychMallocTemp((size_t) nrchannels * sizeof(float) * sampleRectWidth * sampleRectHeight);
-			planeSize = sampleRectWidth * sampleRectHeight * sizeof(float);
-
-			glPixelStorei(GL_PACK_ALIGNMENT, 1);
-			invertedY=windowRect[kPsychBottom]-sampleRect[kPsychBottom];
-
-			if (nrchannels==1) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_FLOAT, dredPlane); 
-			if (nrchannels==2) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_LUMINANCE_ALPHA, GL_FLOAT, dredPlane);
-			if (nrchannels==3) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGB, GL_FLOAT, dredPlane);
-			if (nrchannels==4) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGBA, GL_FLOAT, dredPlane);
-			
-			//in one pass transpose and flip what we read with glReadPixels before returning.  
-			//-glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
-			//-the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.     
-			for(ix=0; ix < sampleRectWidth; ix++){
-				for(iy=0; iy < sampleRectHeight; iy++){
-					// Compute write-indices for returned data:
-					redReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth, nrchannels, iy, ix, 0);
-					greenReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 1);
-					blueReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 2);
-					alphaReturnIndex=PsychIndexElementFrom3DArray(sampleRectHeight, sampleRectWidth,  nrchannels, iy, ix, 3);
-					
-					// Always return RED/LUMINANCE channel:
-					returnArrayBaseDouble[redReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 0];  
-					// Other channels on demand:
-					if (nrchannels>1) returnArrayBaseDouble[greenReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 1];
-					if (nrchannels>2) returnArrayBaseDouble[blueReturnIndex]  = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 2];
-					if (nrchannels>3) returnArrayBaseDouble[alphaReturnIndex] = dredPlane[(ix + ((sampleRectHeight-1) - iy ) * sampleRectWidth) * (size_t) nrchannels + 3];
+			// All channels are read with one glReadPixels call, then transposed, flipped and deinterleaved in one pass:
+			// -glReadPixels insists on filling up memory in sequence by reading the screen row-wise whearas Matlab reads up memory into columns.
+			// -the Psychtoolbox screen as setup by gluOrtho puts 0,0 at the top left of the window but glReadPixels always believes that it's at the bottom left.
+			if (floatprecision == 0) {
+				// Readback of standard 8bpc uint8 pixels: Single channel readback is done as GL_RED,
+				// everything else as GL_BGRA, the native framebuffer format of most hardware:
+				PsychAllocOutUnsignedByteMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBase);
+				if (nrchannels == 1) {
+					readPixels = (ubyte*) PsychMallocTemp(sampleRectWidth * sampleRectHeight);
+					glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_UNSIGNED_BYTE, readPixels);
+					PsychGetImageConvert(readPixels, 1, rgbaOffsets, returnArrayBase, kPsychGetImageUInt8, nrchannels, sampleRectWidth, sampleRectHeight);
+				}
+				else {
+					readPixels = (ubyte*) PsychMallocTemp(4 * sampleRectWidth * sampleRectHeight);
+					glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_BGRA, GL_UNSIGNED_BYTE, readPixels);
+					PsychGetImageConvert(readPixels, 4, bgraOffsets, returnArrayBase, kPsychGetImageUInt8, nrchannels, sampleRectWidth, sampleRectHeight);
 				}
-			}		
+			}
+			else {
+				// Readback of standard 32bpc float pixels into a double or single precision matrix:
+				dredPlane = (float*) PsychMallocTemp((size_t) nrchannels * sizeof(float) * sampleRectWidth * sampleRectHeight);
+
+				if (nrchannels==1) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RED, GL_FLOAT, dredPlane); 
+				if (nrchannels==2) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_LUMINANCE_ALPHA, GL_FLOAT, dredPlane);
+				if (nrchannels==3) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGB, GL_FLOAT, dredPlane);
+				if (nrchannels==4) glReadPixels((int) sampleRect[kPsychLeft], invertedY, (int) sampleRectWidth, (int) sampleRectHeight, GL_RGBA, GL_FLOAT, dredPlane);
+
+				if (floatprecision == 1) {
+					PsychAllocOutDoubleMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBaseDouble);
+					PsychGetImageConvert(dredPlane, nrchannels, rgbaOffsets, returnArrayBaseDouble, kPsychGetImageDouble, nrchannels, sampleRectWidth, sampleRectHeight);
+				}
+				else {
+					PsychAllocOutFloatMatArg(1, TRUE, (int) sampleRectHeight, (int) sampleRectWidth, (int) nrchannels, &returnArrayBaseFloat);
+					PsychGetImageConvert(dredPlane, nrchannels, rgbaOffsets, returnArrayBaseFloat, kPsychGetImageSingle, nrchannels, sampleRectWidth, sampleRectHeight);
+				}
+			}
 		}
 	}
 	
@@ -412,3 +837,616 @@ PsychError SCREENGetImage(void)
 
 	return(PsychError_none);
 }
+
+PsychError SCREENFetchImage(void)
+{
+	static char useString[] = "[imageArray, info] = Screen('FetchImage', windowPtr [, ticket=0] [, waitForCompletion=0]);";
+	//                                                      1            2            3
+	static char synopsisString[] =
+	"Fetch the image of an asynchronous readback started by Screen('GetImage', ..., async=1).\n\n"
+	"\"windowPtr\" is the handle of the window or texture which was passed to 'GetImage'.\n"
+	"\"ticket\" is the ticket returned by 'GetImage' for the readback. The default of zero "
+	"fetches the oldest pending readback. A ticket of -1 only returns \"info\" with statistics.\n"
+	"\"waitForCompletion\" If set to 1, wait for the readback to complete. By default, the "
+	"readback is only fetched if it is already complete, so 'FetchImage' never stalls the "
+	"graphics pipeline. Typically this is the case one video refresh cycle after the "
+	"'GetImage', ie., after the following Screen('Flip'). If the readback isn't complete, "
+	"an empty \"imageArray\" is returned and the readback stays pending.\n"
+	"Readbacks are done into a ring of pixel buffer objects of a size selected via "
+	"Screen('Preference', 'AsyncReadbackBuffers'). If the ring is full, the oldest unfetched "
+	"readback is dropped to make room for a new one. Readbacks which are fetched, or were dropped, "
+	"can't be fetched again. If your graphics hardware doesn't support fence sync objects, "
+	"completion of a readback can't be checked without waiting for it, so 'FetchImage' always "
+	"waits. Without support for pixel buffer objects, 'GetImage' reads back synchronously.\n\n"
+	"\"imageArray\" is the image, with the type and number of channels requested in 'GetImage'.\n"
+	"\"info\" is a struct with information about the readback and statistics of all readbacks "
+	"of the window:\n"
+	"info.Ticket is the ticket of the fetched readback, or zero if none was pending.\n"
+	"info.Completed is 1 if the readback is complete and \"imageArray\" is returned, 0 otherwise.\n"
+	"info.EnqueueTime is the GetSecs time of the 'GetImage' call.\n"
+	"info.CompletionTime is the GetSecs time at which completion was detected. Completion is only "
+	"checked by calls to 'GetImage' and 'FetchImage', so the real completion may be earlier.\n"
+	"info.Latency is CompletionTime - EnqueueTime.\n"
+	"info.Pending is the number of pending readbacks, after this fetch.\n"
+	"info.RingSize is the number of pixel buffer objects in the ring.\n"
+	"info.Enqueued, info.Fetched and info.Dropped are the total number of enqueued, fetched "
+	"and dropped readbacks.\n"
+	"info.MeanLatency and info.MaxLatency are the mean and maximum latency of all fetched readbacks.\n";
+	static char seeAlsoString[] = "GetImage";
+
+	const char *FieldNames[] = { "Ticket", "Completed", "EnqueueTime", "CompletionTime", "Latency", "Pending", "RingSize",
+								 "Enqueued", "Fetched", "Dropped", "MeanLatency", "MaxLatency" };
+	const int fieldCount = 12;
+	PsychGenericScriptType	*s;
+	PsychWindowRecordType	*windowRecord;
+	PsychAsyncReadbackRing	*ring;
+	PsychAsyncReadbackSlot	*slot = NULL;
+	double					ticket = 0;
+	int						waitForCompletion = 0;
+	int						i, pending;
+	double					latency;
+	GLenum					rc;
+	const void				*pixels;
+	ubyte					*returnArrayBase;
+	float					*returnArrayBaseFloat;
+	double					*returnArrayBaseDouble;
+	static const int		bgraOffsets[4] = { 2, 1, 0, 3 };
+	static const int		rgbaOffsets[4] = { 0, 1, 2, 3 };
+
+	// All sub functions should have these two lines
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
+
+	PsychErrorExit(PsychCapNumInputArgs(3));
+	PsychErrorExit(PsychCapNumOutputArgs(2));
+
+	PsychAllocInWindowRecordArg(1, TRUE, &windowRecord);
+	PsychCopyInDoubleArg(2, FALSE, &ticket);
+	PsychCopyInIntegerArg(3, FALSE, &waitForCompletion);
+	ring = windowRecord->asyncReadbackRing;
+
+	if (ring) {
+		PsychSetGLContext(windowRecord);
+		PsychPollAsyncReadbacks(ring);
+
+		// Find slot of requested ticket, or of oldest pending readback:
+		if (ticket >= 0) {
+			for (i = 0; i < ring->numSlots; i++) {
+				if ((ring->slots[i].ticket == 0) || ((ticket > 0) && ((double) ring->slots[i].ticket != ticket))) continue;
+				if ((slot == NULL) || (ring->slots[i].ticket < slot->ticket)) slot = &(ring->slots[i]);
+			}
+
+			if ((slot == NULL) && (ticket > 0)) PsychErrorExitMsg(PsychError_user, "Invalid 'ticket' provided. Unknown, already fetched or dropped readback!");
+		}
+	}
+	else if (ticket > 0) {
+		PsychErrorExitMsg(PsychError_user, "Invalid 'ticket' provided. No asynchronous 'GetImage' readbacks for this window!");
+	}
+
+	// Wait for completion if requested, or if completion can't be checked:
+	if (slot && !slot->completed && (waitForCompletion || (slot->fence == NULL))) {
+		if (slot->fence) {
+			do {
+				rc = glClientWaitSync(slot->fence, GL_SYNC_FLUSH_COMMANDS_BIT, (GLuint64) 1000000000);
+			} while (rc == GL_TIMEOUT_EXPIRED);
+			if (rc == GL_WAIT_FAILED) PsychErrorExitMsg(PsychError_system, "Waiting for completion of asynchronous readback failed!");
+		}
+		slot->completed = TRUE;
+		PsychGetAdjustedPrecisionTimerSeconds(&(slot->completionTime));
+	}
+
+	if (slot && slot->completed) {
+		// Map buffer and convert its content, just as synchronous 'GetImage' does:
+		if (slot->pbo) {
+			glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, slot->pbo);
+			pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY);
+			if (pixels == NULL) {
+				glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+				PsychErrorExitMsg(PsychError_system, "Failed to map pixel buffer of asynchronous readback!");
+			}
+		}
+		else {
+			pixels = slot->hostBuffer;
+		}
+
+		if (slot->floatprecision == 0) {
+			PsychAllocOutUnsignedByteMatArg(1, FALSE, slot->height, slot->width, slot->nrchannels, &returnArrayBase);
+			PsychGetImageConvert(pixels, slot->srcComponents, (slot->nrchannels == 1) ? rgbaOffsets : bgraOffsets, returnArrayBase, kPsychGetImageUInt8, slot->nrchannels, (size_t) slot->width, (size_t) slot->height);
+		}
+		else if (slot->floatprecision == 1) {
+			PsychAllocOutDoubleMatArg(1, FALSE, slot->height, slot->width, slot->nrchannels, &returnArrayBaseDouble);
+			PsychGetImageConvert(pixels, slot->srcComponents, rgbaOffsets, returnArrayBaseDouble, kPsychGetImageDouble, slot->nrchannels, (size_t) slot->width, (size_t) slot->height);
+		}
+		else {
+			PsychAllocOutFloatMatArg(1, FALSE, slot->height, slot->width, slot->nrchannels, &returnArrayBaseFloat);
+			PsychGetImageConvert(pixels, slot->srcComponents, rgbaOffsets, returnArrayBaseFloat, kPsychGetImageSingle, slot->nrchannels, (size_t) slot->width, (size_t) slot->height);
+		}
+
+		if (slot->pbo) {
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER_ARB);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+		}
+
+		latency = slot->completionTime - slot->enqueueTime;
+		ring->fetched++;
+		ring->latencySum += latency;
+		if (latency > ring->latencyMax) ring->latencyMax = latency;
+	}
+	else {
+		// Nothing fetched: Return empty matrix.
+		PsychAllocOutDoubleMatArg(1, FALSE, 0, 0, 0, &returnArrayBaseDouble);
+	}
+
+	// Return info struct:
+	PsychAllocOutStructArray(2, FALSE, 1, fieldCount, FieldNames, &s);
+	PsychSetStructArrayDoubleElement("Ticket", 0, (slot) ? (double) slot->ticket : 0, s);
+	PsychSetStructArrayDoubleElement("Completed", 0, (slot && slot->completed) ? 1 : 0, s);
+	PsychSetStructArrayDoubleElement("EnqueueTime", 0, (slot) ? slot->enqueueTime : 0, s);
+	PsychSetStructArrayDoubleElement("CompletionTime", 0, (slot && slot->completed) ? slot->completionTime : 0, s);
+	PsychSetStructArrayDoubleElement("Latency", 0, (slot && slot->completed) ? slot->completionTime - slot->enqueueTime : 0, s);
+
+	// The slot of a fetched readback is free for reuse:
+	if (slot && slot->completed) PsychReleaseAsyncReadbackSlot(slot);
+
+	pending = 0;
+	if (ring) for (i = 0; i < ring->numSlots; i++) if (ring->slots[i].ticket) pending++;
+	PsychSetStructArrayDoubleElement("Pending", 0, (double) pending, s);
+	PsychSetStructArrayDoubleElement("RingSize", 0, (ring) ? (double) ring->numSlots : 0, s);
+	PsychSetStructArrayDoubleElement("Enqueued", 0, (ring) ? ring->enqueued : 0, s);
+	PsychSetStructArrayDoubleElement("Fetched", 0, (ring) ? ring->fetched : 0, s);
+	PsychSetStructArrayDoubleElement("Dropped", 0, (ring) ? ring->dropped : 0, s);
+	PsychSetStructArrayDoubleElement("MeanLatency", 0, (ring && (ring->fetched > 0)) ? ring->latencySum / ring->fetched : 0, s);
+	PsychSetStructArrayDoubleElement("MaxLatency", 0, (ring) ? ring->latencyMax : 0, s);
+
+	return(PsychError_none);
+}
+
+// Flip-synchronous recording of an onscreen window into a movie via Screen('RecordFlips'):
+//
+// At each flip of a recording window, the final stimulus image in the backbuffer is read back asynchronously
+// into a free pixel buffer object (PBO) of a small ring, right before the bufferswap. The readback is stamped
+// with the stimulus onset time of its flip after the swap. At subsequent flips, completed readbacks are mapped
+// and queued, in order, for a background encoder thread, which copies them into the movie writer. After the
+// encoder is done with a frame, its PBO is unmapped and reused at the next flip. Flips never wait for readbacks
+// or the encoder: If no PBO is free, the frame is dropped and counted. Without fences, completion of a readback
+// can't be polled, so it is only mapped kPsychRecorderNoSyncDelay flips later, when it is almost certainly done.
+#define kPsychRecorderNoSyncDelay	2	// Number of flips to defer mapping of a readback if fences are unsupported.
+
+#define kPsychRecorderSlotFree		0	// PBO is free for a new readback.
+#define kPsychRecorderSlotReading	1	// Readback into PBO is pending.
+#define kPsychRecorderSlotQueued	2	// PBO is mapped and queued for, or being processed by, the encoder.
+#define kPsychRecorderSlotEncoded	3	// Encoder is done, PBO needs unmap.
+
+typedef struct PsychFlipRecorderSlot {
+	int								state;		// One of kPsychRecorderSlotXXX. Protected by recorder mutex.
+	GLuint							pbo;		// Pixel buffer object.
+	GLsync							fence;		// Fence behind the readback, or NULL.
+	unsigned int					sequence;	// Sequence number of the readback, for encoding in order.
+	unsigned int					flip;		// Flip count at the time of the readback.
+	double							onset;		// Stimulus onset time of the flip, or -1 if not yet known.
+	double							timestamp;	// Onset in seconds since the first recorded flip.
+	const unsigned char*			pixels;		// Mapped PBO while queued.
+	struct PsychFlipRecorderSlot*	next;		// Next slot in encoder queue.
+} PsychFlipRecorderSlot;
+
+typedef struct PsychFlipRecorder {
+	int						moviehandle;	// Movie to record into.
+	int						x, y;			// Bottom-left corner of readback rect in OpenGL coordinates.
+	int						width, height;	// Size of movie frames.
+	int						numSlots;		// Number of PBOs.
+	int						lastSlot;		// Slot of readback waiting for onset timestamp of its flip, or -1.
+	psych_bool				haveSync;		// Fences are supported, so completion of readbacks can be polled.
+	unsigned int			nextSequence;	// Sequence number for next readback.
+	unsigned int			nextQueued;		// Sequence number of next readback to queue for the encoder.
+	unsigned int			flips;			// Number of flips since start of recording, including dropped ones.
+	double					t0;				// Onset time of the first recorded flip, or -1.
+	psych_thread			thread;			// Encoder thread.
+	psych_mutex				mutex;
+	psych_condition			condition;		// Signalled when a frame is queued, or on shutdown.
+	psych_bool				shutdown;		// Encoder thread should exit once the queue is empty.
+	PsychFlipRecorderSlot*	queueHead;		// Encoder queue.
+	PsychFlipRecorderSlot*	queueTail;
+	int						queueDepth;		// Statistics: Current and maximum length of encoder queue,
+	int						maxQueueDepth;
+	double					captured;		// number of captured flips,
+	double					encoded;		// number of frames added to the movie,
+	double					dropped;		// number of flips dropped due to lack of free PBOs,
+	double					failed;			// and number of frames which failed to map or to add to the movie.
+	PsychFlipRecorderSlot	slots[PSYCH_MAX_ASYNCREADBACKS];
+} PsychFlipRecorder;
+
+// Main function of the encoder thread: Add queued frames to the movie in order of submission.
+static void* PsychFlipRecorderThreadMain(void* recorderToCast)
+{
+	PsychFlipRecorder*		recorder = (PsychFlipRecorder*) recorderToCast;
+	PsychFlipRecorderSlot*	slot;
+	int						rc;
+
+	PsychLockMutex(&recorder->mutex);
+	while (!recorder->shutdown || recorder->queueHead) {
+		if (recorder->queueHead == NULL) {
+			PsychWaitCondition(&recorder->condition, &recorder->mutex);
+			continue;
+		}
+
+		// Dequeue next frame and add it to the movie without holding the lock:
+		slot = recorder->queueHead;
+		recorder->queueHead = slot->next;
+		if (recorder->queueHead == NULL) recorder->queueTail = NULL;
+		PsychUnlockMutex(&recorder->mutex);
+
+		rc = PsychAddVideoFrameBufferToMovie(recorder->moviehandle, slot->pixels, recorder->width, recorder->height, slot->timestamp);
+
+		PsychLockMutex(&recorder->mutex);
+		if (rc == 0) recorder->encoded++; else recorder->failed++;
+		recorder->queueDepth--;
+		slot->state = kPsychRecorderSlotEncoded;
+	}
+	PsychUnlockMutex(&recorder->mutex);
+
+	return(NULL);
+}
+
+// Queue completed readbacks for the encoder, in order. Waits for completion if 'wait' is TRUE:
+static void PsychFlipRecorderQueueFrames(PsychFlipRecorder* recorder, psych_bool wait)
+{
+	PsychFlipRecorderSlot* slot;
+	GLenum rc;
+	int i;
+
+	while (TRUE) {
+		// Find readback with next sequence number, if any:
+		for (i = 0; i < recorder->numSlots; i++) {
+			if ((recorder->slots[i].state == kPsychRecorderSlotReading) && (recorder->slots[i].sequence == recorder->nextQueued)) break;
+		}
+		if (i == recorder->numSlots) return;
+		slot = &(recorder->slots[i]);
+
+		// Onset timestamp not yet known? Only possible for the frame of the last flip, until its onset gets set:
+		if (slot->onset < 0) {
+			if (!wait) return;
+			PsychGetAdjustedPrecisionTimerSeconds(&(slot->onset));
+		}
+
+		// Check for completion. Without fences, mapping waits for completion, so defer it by a few flips:
+		if (!recorder->haveSync && !wait && (recorder->flips - slot->flip < kPsychRecorderNoSyncDelay)) return;
+		if (slot->fence) {
+			rc = glClientWaitSync(slot->fence, (wait) ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, (wait) ? GL_TIMEOUT_IGNORED : 0);
+			if ((rc != GL_ALREADY_SIGNALED) && (rc != GL_CONDITION_SATISFIED) && (rc != GL_WAIT_FAILED)) return;
+			glDeleteSync(slot->fence);
+			slot->fence = NULL;
+		}
+
+		recorder->nextQueued++;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, slot->pbo);
+		slot->pixels = (const unsigned char*) glMapBuffer(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+		PsychLockMutex(&recorder->mutex);
+		if (slot->pixels == NULL) {
+			recorder->failed++;
+			slot->state = kPsychRecorderSlotFree;
+		}
+		else {
+			if (recorder->t0 < 0) recorder->t0 = slot->onset;
+			slot->timestamp = slot->onset - recorder->t0;
+			slot->state = kPsychRecorderSlotQueued;
+			slot->next = NULL;
+			if (recorder->queueTail) recorder->queueTail->next = slot; else recorder->queueHead = slot;
+			recorder->queueTail = slot;
+			recorder->queueDepth++;
+			if (recorder->queueDepth > recorder->maxQueueDepth) recorder->maxQueueDepth = recorder->queueDepth;
+			PsychSignalCondition(&recorder->condition);
+		}
+		PsychUnlockMutex(&recorder->mutex);
+	}
+}
+
+// Unmap PBOs of frames which the encoder is done with:
+static void PsychFlipRecorderReleaseFrames(PsychFlipRecorder* recorder)
+{
+	psych_bool encoded;
+	int i;
+
+	for (i = 0; i < recorder->numSlots; i++) {
+		PsychLockMutex(&recorder->mutex);
+		encoded = (recorder->slots[i].state == kPsychRecorderSlotEncoded) ? TRUE : FALSE;
+		PsychUnlockMutex(&recorder->mutex);
+		if (!encoded) continue;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, recorder->slots[i].pbo);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER_ARB);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+		recorder->slots[i].pixels = NULL;
+		recorder->slots[i].state = kPsychRecorderSlotFree;
+	}
+}
+
+/* PsychFlipRecorderCaptureFrame()
+ *
+ * Called by PsychFlipWindowBuffers() for onscreen window 'windowRecord' right before the bufferswap, with the
+ * final stimulus image in the system backbuffer. Starts asynchronous readback of the image if the window is
+ * recording, and hands completed readbacks of previous flips to the encoder thread.
+ */
+void PsychFlipRecorderCaptureFrame(PsychWindowRecordType *windowRecord)
+{
+	PsychFlipRecorder*		recorder = windowRecord->flipRecorder;
+	PsychFlipRecorderSlot*	slot;
+	int						i;
+
+	if (recorder == NULL) return;
+	recorder->flips++;
+
+	// Previous flip aborted before its onset timestamp was set? Stamp its frame with the current time,
+	// so it doesn't block the encoder queue forever:
+	if ((recorder->lastSlot >= 0) && (recorder->slots[recorder->lastSlot].onset < 0)) {
+		PsychGetAdjustedPrecisionTimerSeconds(&(recorder->slots[recorder->lastSlot].onset));
+	}
+	recorder->lastSlot = -1;
+
+	PsychFlipRecorderReleaseFrames(recorder);
+	PsychFlipRecorderQueueFrames(recorder, FALSE);
+
+	// Find a free PBO, or drop this frame:
+	for (i = 0; i < recorder->numSlots; i++) if (recorder->slots[i].state == kPsychRecorderSlotFree) break;
+	if (i == recorder->numSlots) {
+		recorder->dropped++;
+		return;
+	}
+	slot = &(recorder->slots[i]);
+
+	glReadBuffer(GL_BACK);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, slot->pbo);
+	glReadPixels(recorder->x, recorder->y, recorder->width, recorder->height, GL_BGRA, GL_UNSIGNED_INT_8_8_8_8, NULL);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+	if (recorder->haveSync) slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	slot->state = kPsychRecorderSlotReading;
+	slot->sequence = recorder->nextSequence++;
+	slot->flip = recorder->flips;
+	slot->onset = -1;
+	recorder->lastSlot = i;
+	recorder->captured++;
+
+	return;
+}
+
+/* PsychFlipRecorderSetOnset()
+ *
+ * Called by PsychFlipWindowBuffers() after the bufferswap, to stamp the frame captured by
+ * PsychFlipRecorderCaptureFrame() with the stimulus onset time 'onset' of the flip. 'onset'
+ * is zero if no timestamp is available, in which case the current time is used.
+ */
+void PsychFlipRecorderSetOnset(PsychWindowRecordType *windowRecord, double onset)
+{
+	PsychFlipRecorder* recorder = windowRecord->flipRecorder;
+
+	if ((recorder == NULL) || (recorder->lastSlot < 0)) return;
+	if (onset <= 0) PsychGetAdjustedPrecisionTimerSeconds(&onset);
+	recorder->slots[recorder->lastSlot].onset = onset;
+	recorder->lastSlot = -1;
+
+	return;
+}
+
+/* PsychDeleteFlipRecorder()
+ *
+ * Stop recording of flips of 'windowRecord', if any: Add all pending frames to the movie, then stop
+ * the encoder thread and release all resources. Called by Screen('RecordFlips'), before finalizing
+ * the movie, and at window close time.
+ */
+void PsychDeleteFlipRecorder(PsychWindowRecordType *windowRecord)
+{
+	PsychFlipRecorder* recorder = windowRecord->flipRecorder;
+	int i;
+
+	if (recorder == NULL) return;
+
+	PsychSetGLContext(windowRecord);
+
+	// Drain all pending readbacks into the encoder queue, then wait for the encoder to finish:
+	PsychFlipRecorderQueueFrames(recorder, TRUE);
+
+	PsychLockMutex(&recorder->mutex);
+	recorder->shutdown = TRUE;
+	PsychSignalCondition(&recorder->condition);
+	PsychUnlockMutex(&recorder->mutex);
+	PsychDeleteThread(&recorder->thread);
+
+	PsychFlipRecorderReleaseFrames(recorder);
+
+	for (i = 0; i < recorder->numSlots; i++) {
+		if (recorder->slots[i].fence) glDeleteSync(recorder->slots[i].fence);
+		glDeleteBuffers(1, &(recorder->slots[i].pbo));
+	}
+
+	PsychDestroyCondition(&recorder->condition);
+	PsychDestroyMutex(&recorder->mutex);
+
+	if (PsychPrefStateGet_Verbosity() > 3) {
+		printf("PTB-INFO: Recording of flips of window %i into moviehandle %i stopped: %i flips captured, %i frames encoded, %i flips dropped, %i frames failed.\n",
+			   windowRecord->windowIndex, recorder->moviehandle, (int) recorder->captured, (int) recorder->encoded, (int) recorder->dropped, (int) recorder->failed);
+	}
+
+	windowRecord->flipRecorder = NULL;
+	free(recorder);
+
+	return;
+}
+
+/* PsychStopFlipRecorders()
+ *
+ * Stop all recordings of flips into movie 'moviehandle', or all recordings if 'moviehandle' is -1.
+ * Called before movie writers are finalized.
+ */
+void PsychStopFlipRecorders(int moviehandle)
+{
+	PsychWindowRecordType	**windowRecordArray;
+	int						i, numWindows;
+
+	PsychCreateVolatileWindowRecordPointerList(&numWindows, &windowRecordArray);
+	for (i = 0; i < numWindows; i++) {
+		if (PsychIsOnscreenWindow(windowRecordArray[i]) && windowRecordArray[i]->flipRecorder &&
+			((moviehandle == -1) || (windowRecordArray[i]->flipRecorder->moviehandle == moviehandle))) {
+			PsychDeleteFlipRecorder(windowRecordArray[i]);
+		}
+	}
+	PsychDestroyVolatileWindowRecordPointerList(windowRecordArray);
+
+	return;
+}
+
+// Start recording of flips of onscreen window 'windowRecord' into movie 'moviehandle', with 'rect' defining the top-left corner:
+static void PsychCreateFlipRecorder(PsychWindowRecordType *windowRecord, int moviehandle, PsychRectType rect)
+{
+	PsychFlipRecorder*	recorder;
+	PsychRectType		windowRect;
+	unsigned int		twidth, theight;
+	int					i;
+
+	// This also checks that no asynchronous flip is pending on the window:
+	PsychSetGLContext(windowRecord);
+
+	if (!glewIsSupported("GL_ARB_pixel_buffer_object") || !glGenBuffers || !glMapBuffer) {
+		PsychErrorExitMsg(PsychError_unimplemented, "Sorry, recording of flips requires support for pixel buffer objects, which your graphics hardware lacks.");
+	}
+
+	if (PsychGetVideoFrameForMoviePtr(moviehandle, &twidth, &theight) == NULL) {
+		PsychErrorExitMsg(PsychError_user, "Invalid 'moviePtr' provided. Doesn't correspond to a movie open for recording!");
+	}
+
+	recorder = (PsychFlipRecorder*) calloc(1, sizeof(PsychFlipRecorder));
+	if (recorder == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to start recording of flips!");
+
+	// Frames have the fixed size of the movie, with the top-left corner of 'rect':
+	PsychGetRectFromWindowRecord(windowRect, windowRecord);
+	recorder->moviehandle = moviehandle;
+	recorder->width = (int) twidth;
+	recorder->height = (int) theight;
+	recorder->x = (int) rect[kPsychLeft];
+	recorder->y = (int) (windowRect[kPsychBottom] - rect[kPsychTop]) - recorder->height;
+	recorder->numSlots = (PsychPrefStateGet_AsyncReadbackBuffers() < 2) ? 2 : PsychPrefStateGet_AsyncReadbackBuffers();
+	recorder->lastSlot = -1;
+	recorder->haveSync = (glewIsSupported("GL_ARB_sync") && glFenceSync) ? TRUE : FALSE;
+	recorder->t0 = -1;
+
+	for (i = 0; i < recorder->numSlots; i++) {
+		glGenBuffers(1, &(recorder->slots[i].pbo));
+		glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, recorder->slots[i].pbo);
+		glBufferData(GL_PIXEL_PACK_BUFFER_ARB, (GLsizeiptr) recorder->width * recorder->height * 4, NULL, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+	PsychInitMutex(&recorder->mutex);
+	PsychInitCondition(&recorder->condition, NULL);
+	if (PsychCreateThread(&recorder->thread, NULL, PsychFlipRecorderThreadMain, (void*) recorder)) {
+		PsychDestroyCondition(&recorder->condition);
+		PsychDestroyMutex(&recorder->mutex);
+		for (i = 0; i < recorder->numSlots; i++) glDeleteBuffers(1, &(recorder->slots[i].pbo));
+		free(recorder);
+		PsychErrorExitMsg(PsychError_system, "Failed to start encoder thread for recording of flips!");
+	}
+
+	windowRecord->flipRecorder = recorder;
+
+	return;
+}
+
+PsychError SCREENRecordFlips(void)
+{
+	static char useString[] = "stats = Screen('RecordFlips', windowPtr [, moviePtr] [, rect]);";
+	//                                                       1            2           3
+	static char synopsisString[] =
+	"Record the stimulus image of each flip of an onscreen window into a movie.\n\n"
+	"This is a much more efficient alternative to calling Screen('AddFrameToMovie') after each "
+	"Screen('Flip'): At each flip, the final stimulus image is read back asynchronously by the "
+	"graphics hardware, and added to the movie by a background thread one or two flips later. "
+	"Neither the flip, nor your script, wait for readback or encoding. Each frame is timestamped "
+	"with the stimulus onset time of its flip, relative to the first recorded flip, so if the "
+	"movie was created with a frame rate matching the video refresh rate, missed flips show up "
+	"as repeated frames in the movie.\n\n"
+	"\"windowPtr\" is the handle of the onscreen window to record.\n"
+	"\"moviePtr\" is the handle of a movie created via Screen('CreateMovie') to start recording "
+	"into. A moviePtr of -1 stops recording, after all pending frames are added to the movie. "
+	"Recording also stops automatically at Screen('FinalizeMovie') of the movie, or when the "
+	"window is closed. If moviePtr is omitted, only \"stats\" are returned.\n"
+	"\"rect\" Only the top-left corner is honored, just as for 'AddFrameToMovie'. The size of "
+	"recorded frames is the fixed size of movie frames as specified in Screen('CreateMovie'). "
+	"Defaults to the top-left corner of the window.\n\n"
+	"Readbacks are done into a ring of pixel buffer objects, of the size selected via "
+	"Screen('Preference', 'AsyncReadbackBuffers'). If all are busy with pending readbacks or "
+	"encoding, e.g., because encoding is too slow, the flip is not recorded and counted as "
+	"dropped. If the graphics driver doesn't support fences (GL_ARB_sync), readbacks are added "
+	"to the movie two flips later than usual, and a flip may stall if the graphics hardware "
+	"has still not finished a readback by then, e.g., with a deep queue of pending rendering. "
+	"Don't use Screen('AddFrameToMovie') on a movie while recording into it.\n"
+	"Recording requires GStreamer based movie writing and support for pixel buffer objects.\n\n"
+	"\"stats\" is a struct with statistics of the recording, before any stop of recording:\n"
+	"stats.Recording is 1 if the window is recording, 0 otherwise.\n"
+	"stats.MoviePtr is the handle of the movie being recorded into, or -1.\n"
+	"stats.Captured is the number of flips captured.\n"
+	"stats.Encoded is the number of frames added to the movie.\n"
+	"stats.Dropped is the number of flips not recorded due to lack of free buffers.\n"
+	"stats.Failed is the number of captured frames which could not be added to the movie.\n"
+	"stats.QueueDepth is the number of frames waiting for the encoder thread.\n"
+	"stats.MaxQueueDepth is the maximum of QueueDepth since start of recording.\n"
+	"stats.RingSize is the number of pixel buffer objects used.\n";
+	static char seeAlsoString[] = "CreateMovie FinalizeMovie AddFrameToMovie GetImage";
+
+	const char *FieldNames[] = { "Recording", "MoviePtr", "Captured", "Encoded", "Dropped", "Failed", "QueueDepth", "MaxQueueDepth", "RingSize" };
+	const int fieldCount = 9;
+	PsychGenericScriptType	*s;
+	PsychWindowRecordType	*windowRecord;
+	PsychFlipRecorder		*recorder;
+	PsychRectType			rect;
+	int						moviehandle;
+	psych_bool				doSet;
+
+	// All sub functions should have these two lines
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
+
+	PsychErrorExit(PsychCapNumInputArgs(3));
+	PsychErrorExit(PsychCapNumOutputArgs(1));
+
+	PsychAllocInWindowRecordArg(1, TRUE, &windowRecord);
+	if (!PsychIsOnscreenWindow(windowRecord)) PsychErrorExitMsg(PsychError_user, "Recording of flips is only possible for onscreen windows!");
+
+	doSet = PsychCopyInIntegerArg(2, FALSE, &moviehandle);
+	if (doSet && (moviehandle < -1)) PsychErrorExitMsg(PsychError_user, "Invalid 'moviePtr' provided. Must be -1 to stop, or the handle of a movie!");
+
+	// Return stats of current recording, if any:
+	recorder = windowRecord->flipRecorder;
+	PsychAllocOutStructArray(1, FALSE, 1, fieldCount, FieldNames, &s);
+	if (recorder) PsychLockMutex(&recorder->mutex);
+	PsychSetStructArrayDoubleElement("Recording", 0, (recorder) ? 1 : 0, s);
+	PsychSetStructArrayDoubleElement("MoviePtr", 0, (recorder) ? (double) recorder->moviehandle : -1, s);
+	PsychSetStructArrayDoubleElement("Captured", 0, (recorder) ? recorder->captured : 0, s);
+	PsychSetStructArrayDoubleElement("Encoded", 0, (recorder) ? recorder->encoded : 0, s);
+	PsychSetStructArrayDoubleElement("Dropped", 0, (recorder) ? recorder->dropped : 0, s);
+	PsychSetStructArrayDoubleElement("Failed", 0, (recorder) ? recorder->failed : 0, s);
+	PsychSetStructArrayDoubleElement("QueueDepth", 0, (recorder) ? (double) recorder->queueDepth : 0, s);
+	PsychSetStructArrayDoubleElement("MaxQueueDepth", 0, (recorder) ? (double) recorder->maxQueueDepth : 0, s);
+	PsychSetStructArrayDoubleElement("RingSize", 0, (recorder) ? (double) recorder->numSlots : 0, s);
+	if (recorder) PsychUnlockMutex(&recorder->mutex);
+
+	if (!doSet) return(PsychError_none);
+
+	// Stop current recording, if any:
+	PsychDeleteFlipRecorder(windowRecord);
+
+	// Start new recording?
+	if (moviehandle >= 0) {
+		#ifndef PTB_USE_GSTREAMER
+		PsychErrorExitMsg(PsychError_unimplemented, "Sorry, recording of flips is only supported with GStreamer based movie writing.");
+		#endif
+
+		PsychGetRectFromWindowRecord(rect, windowRecord);
+		PsychCopyInRectArg(3, FALSE, rect);
+		PsychCreateFlipRecorder(windowRecord, moviehandle, rect);
+	}
+
+	return(PsychError_none);
+}
@@ -187,6 +187,14 @@ static char synopsisString[] =
 	"VBLStartLine, VBLEndline: Start/Endline of vertical blanking interval. The VBLEndline value is not available/valid on all GPU's.\n"
 	"SwapGroup: Swap group id of the swap group to which this window is assigned. Zero for none.\n"
 	"SwapBarrier: Swap barrier id of the swap barrier to which this windows swap group is assigned. Zero for none.\n"
+	"TextureCacheHits, TextureCacheMisses: Number of Screen('MakeTexture') calls which did or did not find a texture of "
+	"identical content in the texture cache, since startup of Screen.\n"
+	"TextureCacheEntries, TextureCacheMB: Number and size of the textures in the texture cache, see "
+	"Screen('Preference', 'TextureCacheBudget').\n"
+	"TextureHostMemoryMB, TextureGPUMemoryMB: Estimated system memory and graphics memory in Megabytes consumed by the "
+	"textures, offscreen windows and framebuffer objects of the window. System memory is only consumed by textures which "
+	"keep a copy of their image, see Screen('Preference', 'ReleaseTextureHostMemory').\n"
+	"AllTextureHostMemoryMB, AllTextureGPUMemoryMB: The same estimates for all open windows.\n"
 	"\n"
 	"The following settings are derived from a builtin detection heuristic, which works on most common GPU's:\n\n"
 	"GPUCoreId: Symbolic name string that roughly describes the name of the GPU core of the graphics card. This string is arbitrarily\n"
@@ -212,9 +220,11 @@ PsychError SCREENGetWindowInfo(void)
 							   "VBLTimePostFlip", "OSSwapTimestamp", "GPULastFrameRenderTime", "StereoMode", "ImagingMode", "MultiSampling", "MissedDeadlines", "FlipCount", "StereoDrawBuffer",
 							   "GuesstimatedMemoryUsageMB", "VBLStartline", "VBLEndline", "VideoRefreshFromBeamposition", "GLVendor", "GLRenderer", "GLVersion", "GPUCoreId", 
 							   "GLSupportsFBOUpToBpc", "GLSupportsBlendingUpToBpc", "GLSupportsTexturesUpToBpc", "GLSupportsFilteringUpToBpc", "GLSupportsPrecisionColors",
-							   "GLSupportsFP32Shading", "BitsPerColorComponent", "IsFullscreen", "SpecialFlags", "SwapGroup", "SwapBarrier" };
+							   "GLSupportsFP32Shading", "BitsPerColorComponent", "IsFullscreen", "SpecialFlags", "SwapGroup", "SwapBarrier",
+							   "TextureCacheHits", "TextureCacheMisses", "TextureCacheEntries", "TextureCacheMB",
+							   "TextureHostMemoryMB", "TextureGPUMemoryMB", "AllTextureHostMemoryMB", "AllTextureGPUMemoryMB" };
 							   
-	const int  fieldCount = 35;
+	const int  fieldCount = 43;
 	PsychGenericScriptType	*s;
 
     PsychWindowRecordType *windowRecord;
@@ -224,6 +234,8 @@ PsychError SCREENGetWindowInfo(void)
 	CGDirectDisplayID displayId;
 	psych_uint64 postflip_vblcount;
 	double vbl_startline;
+	double cacheHits, cacheMisses, cacheEntries, cacheBytes;
+	double hostBytes, gpuBytes;
 	long scw, sch;
 	psych_bool onscreen;
     
@@ -449,6 +461,21 @@ PsychError SCREENGetWindowInfo(void)
 		// Swap group assignment and swap barrier assignment, if any:
 		PsychSetStructArrayDoubleElement("SwapGroup", 0, windowRecord->swapGroup, s);
 		PsychSetStructArrayDoubleElement("SwapBarrier", 0, windowRecord->swapBarrier, s);
+
+		// Statistics of the texture cache:
+		PsychGetTextureCacheStats(&cacheHits, &cacheMisses, &cacheEntries, &cacheBytes);
+		PsychSetStructArrayDoubleElement("TextureCacheHits", 0, cacheHits, s);
+		PsychSetStructArrayDoubleElement("TextureCacheMisses", 0, cacheMisses, s);
+		PsychSetStructArrayDoubleElement("TextureCacheEntries", 0, cacheEntries, s);
+		PsychSetStructArrayDoubleElement("TextureCacheMB", 0, cacheBytes / 1024 / 1024, s);
+
+		// Memory consumption of textures, offscreen windows and FBO's of this window, and of all windows:
+		PsychGetTextureMemoryUsage(PsychGetParentWindow(windowRecord), &hostBytes, &gpuBytes);
+		PsychSetStructArrayDoubleElement("TextureHostMemoryMB", 0, hostBytes / 1024 / 1024, s);
+		PsychSetStructArrayDoubleElement("TextureGPUMemoryMB", 0, gpuBytes / 1024 / 1024, s);
+		PsychGetTextureMemoryUsage(NULL, &hostBytes, &gpuBytes);
+		PsychSetStructArrayDoubleElement("AllTextureHostMemoryMB", 0, hostBytes / 1024 / 1024, s);
+		PsychSetStructArrayDoubleElement("AllTextureGPUMemoryMB", 0, gpuBytes / 1024 / 1024, s);
 	
         // Which basic GPU architecture is this?
 		PsychSetStructArrayStringElement("GPUCoreId", 0, windowRecord->gpuCoreId, s);
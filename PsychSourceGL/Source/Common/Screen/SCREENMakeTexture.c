@@ -21,9 +21,10 @@
 
 	DESCRIPTION:
 
-		Conversion code for creating OpenGL textures from Matlab/Octave image matrices. Handles uint8 and
-		double matrices as input. Converts into 8bpc textures by default, but also supports half_float and
-		float 16 bpc, 32 bpc floating point textures on modern hardware.
+		Conversion code for creating OpenGL textures from Matlab/Octave image matrices. Handles uint8, double,
+		single, uint16 and logical matrices as input. Converts into 8bpc textures by default, but also supports
+		half_float and float 16 bpc, 32 bpc floating point textures on modern hardware, and 16 bpc integer
+		textures for uint16 input.
 		
 	TO DO:
 
@@ -46,6 +47,18 @@ static char synopsisString[] =
 	"the texture is created as an OpenGL power-of-two texture of type GL_TEXTURE_2D. Otherwise Psychtoolbox will try to "
 	"pick the most optimal format for fast drawing and low memory consumption. Power-of-two textures are especially useful "
 	"for animation of drifting gratings (see the demos) and for simple use with the OpenGL 3D graphics functions.\n"
+	"If 'specialFlags' has the flag 4 set, the texture is created asynchronously: MakeTexture returns the texture handle "
+	"immediately after copying the imageMatrix, conversion into texture format happens on a background thread and upload "
+	"to the graphics card happens via pixel buffer objects at first use of the texture, or when Screen('TextureReady') finds it "
+	"ready. This allows to create the textures for the next trial while the current trial is running. Use of the texture "
+	"waits for its creation to finish, except for Screen('DrawTexture') and Screen('DrawTextures') with the "
+	"kPsychSkipNotReadyTexture flag, which skip drawing of textures which are not yet ready.\n"
+	"If the texture cache is enabled via Screen('Preference', 'TextureCacheBudget', budgetMB), MakeTexture returns a new "
+	"texture handle which shares the texture of a previous MakeTexture call with an identical imageMatrix and identical "
+	"creation parameters, instead of converting and uploading the imageMatrix again. The cache keeps the least recently "
+	"used textures up to 'budgetMB' megabytes of texture memory, even after their handles got closed. Shared textures "
+	"get a private copy when drawn into. Only textures with the default 'textureOrientation' of zero are shared. "
+	"Screen('GetWindowInfo') reports the number of cache hits and misses.\n"
 	"If 'specialFlags' is set to 2 then PTB will try to use its own high quality texture filtering algorithm for drawing "
 	"of bilinearly filtered textures instead of the hardwares built-in method. This only works on modern hardware with "
 	"fragment shader support and is slower than using the hardwares built in filtering, but it may provide higher precision "
@@ -77,9 +90,691 @@ static char synopsisString[] =
 	"for some formula to compute the real image during drawing. E.g., instead of defining a gabor patch as image or other standard "
 	"stimulus, one could define it as a mathematical formula to be evaluated at draw-time. The Screen('SetOpenGLTexture') command "
 	"allows you to create purely virtual textures which only consist of such a shader and some virtual size, but don't have any "
-	"real data matrix associated with it -- all content is generated on the fly.\n";
+	"real data matrix associated with it -- all content is generated on the fly.\n"
+	"The 'imageMatrix' can be of type uint8 or double, as returned by imread() or computed in Matlab, but also of "
+	"type single, uint16 or logical: single matrices can be used instead of double matrices, e.g., for floating point "
+	"textures at half the memory cost of doubles. uint16 matrices create 16 bpc integer textures, with values from 0 to "
+	"65535 mapping to the same intensity range as 0 to 255 for uint8 matrices. 'floatprecision' must be zero for uint16 "
+	"matrices. logical matrices, e.g., masks, create 8 bpc textures with true mapped to 255 and false to 0. "
+	"Single plane uint8, uint16 and single (with 'floatprecision' 2) matrices are uploaded directly from the matrix, "
+	"without any intermediate conversion.\n";
 
-static char seeAlsoString[] = "DrawTexture TransformTexture BlendFunction";
+static char seeAlsoString[] = "DrawTexture TransformTexture BlendFunction MakeTextures";
+
+// Conversion of planar Matlab/Octave image matrices into interleaved texture buffers:
+//
+// Each image plane (L, LA, RGB, RGBA) is stored as a separate column-major array, whereas OpenGL
+// wants all components of a pixel next to each other. As both sides are in column-major order,
+// pixel ix of the texture buffer is made of element ix of each plane. 8 bpc RGBA textures are
+// stored as BGRA on little-endian machines and ARGB on big-endian machines, float and 16 bpc
+// integer textures get their components in plane order.
+//
+// The vectorized SSE2 kernels produce the same result as the scalar reference code, including
+// the (GLubyte) cast semantics for out of range double values. Big images can be split into
+// stripes which get converted in parallel by multiple threads.
+
+// SSE2 vector instructions are always available on 64-bit x86 and optionally enabled on 32-bit x86 builds:
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define PSYCH_MAKETEXTURE_HAVE_SSE2 1
+#endif
+
+// Maximum number of conversion threads and minimum number of pixels per thread:
+#define PSYCH_MAKETEXTURE_MAXTHREADS 16
+#define PSYCH_MAKETEXTURE_MINSTRIPEPIXELS (128 * 1024)
+
+// Data types of input image matrices:
+#define kPsychTexSrcUInt8		0
+#define kPsychTexSrcDouble		1
+#define kPsychTexSrcSingle		2
+#define kPsychTexSrcUInt16		3
+#define kPsychTexSrcLogical		4
+
+typedef struct PsychTexConvertJob {
+	const void*		src;			// First plane of input image matrix.
+	int				srcType;		// Data type of input planes, one of kPsychTexSrcXXX.
+	int				numPlanes;		// Number of input planes and texture components per pixel.
+	size_t			iters;			// Number of pixels per plane.
+	void*			dst;			// Texture buffer: GLfloat if usefloatformat, GLushort for uint16 input, GLubyte otherwise.
+	int				usefloatformat;	// 0 = 8 bpc, 1 = 16 bpc float, 2 = 32 bpc float.
+	psych_bool		bigendian;		// Machine is big-endian.
+	psych_bool		usesimd;		// Use SSE2 kernels if available.
+	size_t			start;			// First pixel to convert.
+	size_t			end;			// One past last pixel to convert.
+	psych_bool		threaded;		// Stripe is converted by 'thread', instead of the calling thread.
+	psych_thread	thread;			// Thread converting this stripe.
+} PsychTexConvertJob;
+
+// This is a special workaround for bugs in FLOAT16 texture creation on Mac OS/X 10.4.x and 10.5.x.
+// The OpenGL fails to properly flush very small values (< 1e-9) to zero when creating a FLOAT16
+// type texture. Instead it seems to initialize with trash data, corrupting the texture.
+// Therefore, if FLOAT16 texture creation is requested, we loop over the whole converted buffer and
+// set all values with magnitude smaller than 1e-9 to zero. Better safe than sorry...
+static void PsychTexFlushTinyFloats(GLfloat* f, const GLfloat* end)
+{
+	for (; f < end; f++) if (fabs((double) *f) < 1e-9) { *f = 0.0; }
+}
+
+// Scalar conversion of pixels 'start' to 'end' - 1 for single, uint16 and logical input. Component k
+// of each pixel is taken from the plane at offset planeofs[k]:
+static void PsychTexConvertRangeGeneric(const PsychTexConvertJob* job, size_t start, size_t end)
+{
+	size_t ix, iters = job->iters, planeofs[4];
+	int k, np = job->numPlanes;
+
+	for (k = 0; k < np; k++) planeofs[k] = (size_t) k * iters;
+
+	// 8 bpc RGBA textures are BGRA on little-endian and ARGB on big-endian machines:
+	if ((np == 4) && !job->usefloatformat && (job->srcType != kPsychTexSrcUInt16)) {
+		planeofs[0] = (job->bigendian) ? 3 * iters : 2 * iters;
+		planeofs[1] = (job->bigendian) ? 0 : iters;
+		planeofs[2] = (job->bigendian) ? iters : 0;
+		planeofs[3] = (job->bigendian) ? 2 * iters : 3 * iters;
+	}
+
+	switch (job->srcType) {
+		case kPsychTexSrcSingle:
+			if (job->usefloatformat) {
+				const float* rp = ((const float*) job->src) + start;
+				GLfloat* out = ((GLfloat*) job->dst) + start * np;
+
+				for (ix = start; ix < end; ix++, rp++) {
+					for (k = 0; k < np; k++) *(out++) = (GLfloat) rp[planeofs[k]];
+				}
+
+				if (job->usefloatformat == 1) PsychTexFlushTinyFloats(((GLfloat*) job->dst) + start * np, out);
+			}
+			else {
+				const float* rp = ((const float*) job->src) + start;
+				GLubyte* out = ((GLubyte*) job->dst) + start * np;
+
+				for (ix = start; ix < end; ix++, rp++) {
+					for (k = 0; k < np; k++) *(out++) = (GLubyte) rp[planeofs[k]];
+				}
+			}
+		break;
+
+		case kPsychTexSrcUInt16:
+			if (np == 1) {
+				memcpy(((GLushort*) job->dst) + start, ((const psych_uint16*) job->src) + start, (end - start) * sizeof(GLushort));
+			}
+			else {
+				const psych_uint16* rp = ((const psych_uint16*) job->src) + start;
+				GLushort* out = ((GLushort*) job->dst) + start * np;
+
+				for (ix = start; ix < end; ix++, rp++) {
+					for (k = 0; k < np; k++) *(out++) = (GLushort) rp[planeofs[k]];
+				}
+			}
+		break;
+
+		case kPsychTexSrcLogical:
+			{
+				const PsychNativeBooleanType* rp = ((const PsychNativeBooleanType*) job->src) + start;
+				GLubyte* out = ((GLubyte*) job->dst) + start * np;
+
+				for (ix = start; ix < end; ix++, rp++) {
+					for (k = 0; k < np; k++) *(out++) = (rp[planeofs[k]]) ? 255 : 0;
+				}
+			}
+		break;
+	}
+
+	return;
+}
+
+// Scalar reference conversion of pixels 'start' to 'end' - 1:
+static void PsychTexConvertRangeScalar(const PsychTexConvertJob* job, size_t start, size_t end)
+{
+	size_t ix, iters = job->iters;
+	int np = job->numPlanes;
+
+	if ((job->srcType != kPsychTexSrcDouble) && (job->srcType != kPsychTexSrcUInt8)) {
+		PsychTexConvertRangeGeneric(job, start, end);
+		return;
+	}
+
+	if (job->usefloatformat) {
+		const double* rp = ((const double*) job->src) + start;
+		GLfloat* out = ((GLfloat*) job->dst) + start * np;
+
+		switch (np) {
+			case 1:
+				for (ix = start; ix < end; ix++, rp++) {
+					*(out++) = (GLfloat) rp[0];
+				}
+			break;
+			case 2:
+				for (ix = start; ix < end; ix++, rp++) {
+					*(out++) = (GLfloat) rp[0];
+					*(out++) = (GLfloat) rp[iters];
+				}
+			break;
+			case 3:
+				for (ix = start; ix < end; ix++, rp++) {
+					*(out++) = (GLfloat) rp[0];
+					*(out++) = (GLfloat) rp[iters];
+					*(out++) = (GLfloat) rp[2 * iters];
+				}
+			break;
+			case 4:
+				for (ix = start; ix < end; ix++, rp++) {
+					*(out++) = (GLfloat) rp[0];
+					*(out++) = (GLfloat) rp[iters];
+					*(out++) = (GLfloat) rp[2 * iters];
+					*(out++) = (GLfloat) rp[3 * iters];
+				}
+			break;
+		}
+
+		// FLOAT16 workaround, see PsychTexFlushTinyFloats():
+		if (job->usefloatformat == 1) PsychTexFlushTinyFloats(((GLfloat*) job->dst) + start * np, out);
+
+		return;
+	}
+
+	if (job->srcType == kPsychTexSrcDouble) {
+		const double* rp = ((const double*) job->src) + start;
+		GLubyte* out = ((GLubyte*) job->dst) + start * np;
+
+		switch (np) {
+			case 1:
+				for (ix = start; ix < end; ix++, rp++) {
+					*(out++) = (GLubyte) rp[0];
+				}
+			break;
+			case 2:
+				for (ix = start; ix < end; ix++, rp++) {
+					*(out++) = (GLubyte) rp[0];
+					*(out++) = (GLubyte) rp[iters];
+				}
+			break;
+			case 3:
+				for (ix = start; ix < end; ix++, rp++) {
+					*(out++) = (GLubyte) rp[0];
+					*(out++) = (GLubyte) rp[iters];
+					*(out++) = (GLubyte) rp[2 * iters];
+				}
+			break;
+			case 4:
+				if (job->bigendian) {
+					// Code for big-endian machines like PowerPC:
+					for (ix = start; ix < end; ix++, rp++) {
+						*(out++) = (GLubyte) rp[3 * iters];
+						*(out++) = (GLubyte) rp[0];
+						*(out++) = (GLubyte) rp[iters];
+						*(out++) = (GLubyte) rp[2 * iters];
+					}
+				}
+				else {
+					// Code for little-endian machines like Intel Pentium:
+					for (ix = start; ix < end; ix++, rp++) {
+						*(out++) = (GLubyte) rp[2 * iters];
+						*(out++) = (GLubyte) rp[iters];
+						*(out++) = (GLubyte) rp[0];
+						*(out++) = (GLubyte) rp[3 * iters];
+					}
+				}
+			break;
+		}
+	}
+	else {
+		const GLubyte* rpb = ((const GLubyte*) job->src) + start;
+		GLubyte* out = ((GLubyte*) job->dst) + start * np;
+
+		switch (np) {
+			case 1:
+				memcpy(out, rpb, end - start);
+			break;
+			case 2:
+				for (ix = start; ix < end; ix++, rpb++) {
+					*(out++) = rpb[0];
+					*(out++) = rpb[iters];
+				}
+			break;
+			case 3:
+				for (ix = start; ix < end; ix++, rpb++) {
+					*(out++) = rpb[0];
+					*(out++) = rpb[iters];
+					*(out++) = rpb[2 * iters];
+				}
+			break;
+			case 4:
+				if (job->bigendian) {
+					// Code for big-endian machines like PowerPC:
+					for (ix = start; ix < end; ix++, rpb++) {
+						*(out++) = rpb[3 * iters];
+						*(out++) = rpb[0];
+						*(out++) = rpb[iters];
+						*(out++) = rpb[2 * iters];
+					}
+				}
+				else {
+					// Code for little-endian machines like Intel Pentium:
+					for (ix = start; ix < end; ix++, rpb++) {
+						*(out++) = rpb[2 * iters];
+						*(out++) = rpb[iters];
+						*(out++) = rpb[0];
+						*(out++) = rpb[3 * iters];
+					}
+				}
+			break;
+		}
+	}
+
+	return;
+}
+
+#ifdef PSYCH_MAKETEXTURE_HAVE_SSE2
+// Load 4 doubles and convert them to floats:
+static __m128 PsychTexLoad4DoublesAsFloats(const double* p)
+{
+	return(_mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(p)), _mm_cvtpd_ps(_mm_loadu_pd(p + 2))));
+}
+
+// Load 4 pixels of a double or single plane as floats:
+static __m128 PsychTexLoad4AsFloats(const PsychTexConvertJob* job, size_t ix)
+{
+	if (job->srcType == kPsychTexSrcSingle) return(_mm_loadu_ps(((const float*) job->src) + ix));
+	return(PsychTexLoad4DoublesAsFloats(((const double*) job->src) + ix));
+}
+
+// Load 4 doubles and convert them to the low bytes of 4 ints, like a (GLubyte) cast:
+static __m128i PsychTexLoad4DoublesAsBytes(const double* p)
+{
+	return(_mm_and_si128(_mm_unpacklo_epi64(_mm_cvttpd_epi32(_mm_loadu_pd(p)), _mm_cvttpd_epi32(_mm_loadu_pd(p + 2))), _mm_set1_epi32(0xff)));
+}
+
+// Store 4 packed 24 bit pixels from the low bytes of the 4 ints in 'v' to 'out'. Each 4 byte store
+// overwrites the first byte of the following pixel, so this must not be used for the last pixel:
+static void PsychTexStore4RGBPixels(GLubyte* out, __m128i v)
+{
+	unsigned int px[4];
+
+	_mm_storeu_si128((__m128i*) px, v);
+	memcpy(out, &px[0], 4);
+	memcpy(out + 3, &px[1], 4);
+	memcpy(out + 6, &px[2], 4);
+	memcpy(out + 9, &px[3], 4);
+}
+
+// SSE2 conversion of as many pixels as possible, starting at 'start'. Returns the first pixel
+// which still needs conversion by the scalar code. Kernels which write beyond the current pixel
+// always leave at least one pixel for the scalar code, so they never touch other stripes:
+static size_t PsychTexConvertRangeSIMD(const PsychTexConvertJob* job, size_t start, size_t end)
+{
+	size_t ix = start, iters = job->iters;
+	int np = job->numPlanes;
+
+	// Our kernels are for little-endian machines only, as are all SSE2 capable machines:
+	if (job->bigendian) return(start);
+
+	// Float textures from double or single input:
+	if (job->usefloatformat) {
+		GLfloat* out = ((GLfloat*) job->dst) + start * np;
+		GLfloat* f = out;
+		__m128 r, g, b, a, v, mask;
+
+		switch (np) {
+			case 1:
+				for (; ix + 4 <= end; ix += 4, out += 4) {
+					_mm_storeu_ps(out, PsychTexLoad4AsFloats(job, ix));
+				}
+			break;
+			case 2:
+				for (; ix + 4 <= end; ix += 4, out += 8) {
+					r = PsychTexLoad4AsFloats(job, ix);
+					a = PsychTexLoad4AsFloats(job, ix + iters);
+					_mm_storeu_ps(out, _mm_unpacklo_ps(r, a));
+					_mm_storeu_ps(out + 4, _mm_unpackhi_ps(r, a));
+				}
+			break;
+			case 3:
+				for (; ix + 4 < end; ix += 4, out += 12) {
+					r = PsychTexLoad4AsFloats(job, ix);
+					g = PsychTexLoad4AsFloats(job, ix + iters);
+					b = PsychTexLoad4AsFloats(job, ix + 2 * iters);
+					a = _mm_setzero_ps();
+					_MM_TRANSPOSE4_PS(r, g, b, a);
+					// Overlapping stores, each 4th component gets overwritten by the next pixel:
+					_mm_storeu_ps(out, r);
+					_mm_storeu_ps(out + 3, g);
+					_mm_storeu_ps(out + 6, b);
+					_mm_storeu_ps(out + 9, a);
+				}
+			break;
+			case 4:
+				for (; ix + 4 <= end; ix += 4, out += 16) {
+					r = PsychTexLoad4AsFloats(job, ix);
+					g = PsychTexLoad4AsFloats(job, ix + iters);
+					b = PsychTexLoad4AsFloats(job, ix + 2 * iters);
+					a = PsychTexLoad4AsFloats(job, ix + 3 * iters);
+					_MM_TRANSPOSE4_PS(r, g, b, a);
+					_mm_storeu_ps(out, r);
+					_mm_storeu_ps(out + 4, g);
+					_mm_storeu_ps(out + 8, b);
+					_mm_storeu_ps(out + 12, a);
+				}
+			break;
+		}
+
+		// FLOAT16 workaround, see scalar code: Flush values with magnitude smaller than 1e-9 to zero.
+		// 'out' is the end of the vectorized part, 'f' its start:
+		if (job->usefloatformat == 1) {
+			for (; f + 4 <= out; f += 4) {
+				v = _mm_loadu_ps(f);
+				mask = _mm_cmplt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), v), _mm_set1_ps(1e-9f));
+				_mm_storeu_ps(f, _mm_andnot_ps(mask, v));
+			}
+		}
+
+		return(ix);
+	}
+
+	if (job->srcType == kPsychTexSrcDouble) {
+		const double* rp = ((const double*) job->src);
+		GLubyte* out = ((GLubyte*) job->dst) + start * np;
+		__m128i r0, r1, r2, r3, a0;
+
+		switch (np) {
+			case 1:
+				for (; ix + 16 <= end; ix += 16, out += 16) {
+					r0 = _mm_packs_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix]), PsychTexLoad4DoublesAsBytes(&rp[ix + 4]));
+					r1 = _mm_packs_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix + 8]), PsychTexLoad4DoublesAsBytes(&rp[ix + 12]));
+					_mm_storeu_si128((__m128i*) out, _mm_packus_epi16(r0, r1));
+				}
+			break;
+			case 2:
+				for (; ix + 8 <= end; ix += 8, out += 16) {
+					// Assemble 16 bit LA pixels in ints, pack them to unsigned shorts. The offset
+					// by 0x8000 maps them into the range of the signed saturating pack:
+					r0 = _mm_or_si128(PsychTexLoad4DoublesAsBytes(&rp[ix]), _mm_slli_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix + iters]), 8));
+					r1 = _mm_or_si128(PsychTexLoad4DoublesAsBytes(&rp[ix + 4]), _mm_slli_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix + 4 + iters]), 8));
+					a0 = _mm_packs_epi32(_mm_sub_epi32(r0, _mm_set1_epi32(0x8000)), _mm_sub_epi32(r1, _mm_set1_epi32(0x8000)));
+					_mm_storeu_si128((__m128i*) out, _mm_xor_si128(a0, _mm_set1_epi16((short) 0x8000)));
+				}
+			break;
+			case 3:
+				for (; ix + 4 < end; ix += 4, out += 12) {
+					r0 = PsychTexLoad4DoublesAsBytes(&rp[ix]);
+					r1 = _mm_slli_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix + iters]), 8);
+					r2 = _mm_slli_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix + 2 * iters]), 16);
+					PsychTexStore4RGBPixels(out, _mm_or_si128(_mm_or_si128(r0, r1), r2));
+				}
+			break;
+			case 4:
+				// BGRA:
+				for (; ix + 4 <= end; ix += 4, out += 16) {
+					r0 = _mm_slli_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix]), 16);
+					r1 = _mm_slli_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix + iters]), 8);
+					r2 = PsychTexLoad4DoublesAsBytes(&rp[ix + 2 * iters]);
+					r3 = _mm_slli_epi32(PsychTexLoad4DoublesAsBytes(&rp[ix + 3 * iters]), 24);
+					_mm_storeu_si128((__m128i*) out, _mm_or_si128(_mm_or_si128(r0, r1), _mm_or_si128(r2, r3)));
+				}
+			break;
+		}
+
+		return(ix);
+	}
+
+	if (job->srcType == kPsychTexSrcUInt8) {
+		const GLubyte* rpb = ((const GLubyte*) job->src);
+		GLubyte* out = ((GLubyte*) job->dst) + start * np;
+		__m128i r, g, b, a, lo, hi, ra, zero = _mm_setzero_si128();
+
+		switch (np) {
+			case 1:
+				// Plain copy, done by the scalar code via memcpy():
+			break;
+			case 2:
+				for (; ix + 16 <= end; ix += 16, out += 32) {
+					r = _mm_loadu_si128((const __m128i*) &rpb[ix]);
+					a = _mm_loadu_si128((const __m128i*) &rpb[ix + iters]);
+					_mm_storeu_si128((__m128i*) out, _mm_unpacklo_epi8(r, a));
+					_mm_storeu_si128((__m128i*) (out + 16), _mm_unpackhi_epi8(r, a));
+				}
+			break;
+			case 3:
+				for (; ix + 16 < end; ix += 16, out += 48) {
+					r = _mm_loadu_si128((const __m128i*) &rpb[ix]);
+					g = _mm_loadu_si128((const __m128i*) &rpb[ix + iters]);
+					b = _mm_loadu_si128((const __m128i*) &rpb[ix + 2 * iters]);
+					// RGB0 pixels, as 16 bit pairs RG and B0, then interleaved to 32 bit:
+					lo = _mm_unpacklo_epi8(r, g);
+					hi = _mm_unpackhi_epi8(r, g);
+					ra = _mm_unpacklo_epi8(b, zero);
+					PsychTexStore4RGBPixels(out,      _mm_unpacklo_epi16(lo, ra));
+					PsychTexStore4RGBPixels(out + 12, _mm_unpackhi_epi16(lo, ra));
+					ra = _mm_unpackhi_epi8(b, zero);
+					PsychTexStore4RGBPixels(out + 24, _mm_unpacklo_epi16(hi, ra));
+					PsychTexStore4RGBPixels(out + 36, _mm_unpackhi_epi16(hi, ra));
+				}
+			break;
+			case 4:
+				// BGRA: Interleave to 16 bit pairs BG and RA, then to 32 bit:
+				for (; ix + 16 <= end; ix += 16, out += 64) {
+					r = _mm_loadu_si128((const __m128i*) &rpb[ix]);
+					g = _mm_loadu_si128((const __m128i*) &rpb[ix + iters]);
+					b = _mm_loadu_si128((const __m128i*) &rpb[ix + 2 * iters]);
+					a = _mm_loadu_si128((const __m128i*) &rpb[ix + 3 * iters]);
+					lo = _mm_unpacklo_epi8(b, g);
+					ra = _mm_unpacklo_epi8(r, a);
+					_mm_storeu_si128((__m128i*) out, _mm_unpacklo_epi16(lo, ra));
+					_mm_storeu_si128((__m128i*) (out + 16), _mm_unpackhi_epi16(lo, ra));
+					hi = _mm_unpackhi_epi8(b, g);
+					ra = _mm_unpackhi_epi8(r, a);
+					_mm_storeu_si128((__m128i*) (out + 32), _mm_unpacklo_epi16(hi, ra));
+					_mm_storeu_si128((__m128i*) (out + 48), _mm_unpackhi_epi16(hi, ra));
+				}
+			break;
+		}
+
+		return(ix);
+	}
+
+	if (job->srcType == kPsychTexSrcUInt16) {
+		const psych_uint16* rps = ((const psych_uint16*) job->src);
+		GLushort* out = ((GLushort*) job->dst) + start * np;
+		__m128i r, g, b, a, rg, ba;
+
+		switch (np) {
+			case 2:
+				for (; ix + 8 <= end; ix += 8, out += 16) {
+					r = _mm_loadu_si128((const __m128i*) &rps[ix]);
+					a = _mm_loadu_si128((const __m128i*) &rps[ix + iters]);
+					_mm_storeu_si128((__m128i*) out, _mm_unpacklo_epi16(r, a));
+					_mm_storeu_si128((__m128i*) (out + 8), _mm_unpackhi_epi16(r, a));
+				}
+			break;
+			case 4:
+				// RGBA: Interleave to 32 bit pairs RG and BA, then to 64 bit:
+				for (; ix + 8 <= end; ix += 8, out += 32) {
+					r = _mm_loadu_si128((const __m128i*) &rps[ix]);
+					g = _mm_loadu_si128((const __m128i*) &rps[ix + iters]);
+					b = _mm_loadu_si128((const __m128i*) &rps[ix + 2 * iters]);
+					a = _mm_loadu_si128((const __m128i*) &rps[ix + 3 * iters]);
+					rg = _mm_unpacklo_epi16(r, g);
+					ba = _mm_unpacklo_epi16(b, a);
+					_mm_storeu_si128((__m128i*) out, _mm_unpacklo_epi32(rg, ba));
+					_mm_storeu_si128((__m128i*) (out + 8), _mm_unpackhi_epi32(rg, ba));
+					rg = _mm_unpackhi_epi16(r, g);
+					ba = _mm_unpackhi_epi16(b, a);
+					_mm_storeu_si128((__m128i*) (out + 16), _mm_unpacklo_epi32(rg, ba));
+					_mm_storeu_si128((__m128i*) (out + 24), _mm_unpackhi_epi32(rg, ba));
+				}
+			break;
+			default:
+				// Plain copy for one plane, scalar code for three planes.
+			break;
+		}
+
+		return(ix);
+	}
+
+	// No kernels for 8 bpc textures from single or logical input:
+	return(start);
+}
+#endif
+
+// Convert the stripe of pixels assigned to 'job':
+static void PsychTexConvertStripe(const PsychTexConvertJob* job)
+{
+	size_t start = job->start;
+
+#ifdef PSYCH_MAKETEXTURE_HAVE_SSE2
+	if (job->usesimd) start = PsychTexConvertRangeSIMD(job, start, job->end);
+#endif
+
+	PsychTexConvertRangeScalar(job, start, job->end);
+}
+
+// Main function of conversion threads:
+static void* PsychTexConvertThreadMain(void* jobToCast)
+{
+	PsychTexConvertStripe((const PsychTexConvertJob*) jobToCast);
+	return(NULL);
+}
+
+// Convert the 'numPlanes' planes of 'iters' pixels each of image matrix 'src' into interleaved texture
+// buffer 'dst', as selected by Screen('Preference', 'MakeTextureThreads'):
+static void PsychTexConvertPlanarImage(const void* src, int srcType, int numPlanes, size_t iters, void* dst, int usefloatformat, psych_bool bigendian)
+{
+	PsychTexConvertJob jobs[PSYCH_MAKETEXTURE_MAXTHREADS];
+	int i, numThreads;
+	psych_bool usesimd;
+	size_t stripe;
+
+	// Setting 0 selects the scalar reference code, e.g., for benchmarking:
+	numThreads = PsychPrefStateGet_MakeTextureThreads();
+	usesimd = (numThreads > 0) ? TRUE : FALSE;
+
+	// Enough pixels to make threading worth the overhead?
+	if (numThreads > PSYCH_MAKETEXTURE_MAXTHREADS) numThreads = PSYCH_MAKETEXTURE_MAXTHREADS;
+	if ((size_t) numThreads > iters / PSYCH_MAKETEXTURE_MINSTRIPEPIXELS) numThreads = (int) (iters / PSYCH_MAKETEXTURE_MINSTRIPEPIXELS);
+	if (numThreads < 1) numThreads = 1;
+
+	// Stripes start at multiples of 16 pixels, so the vectorized kernels can process them completely:
+	stripe = ((iters / numThreads) + 15) & ~((size_t) 15);
+
+	for (i = 0; i < numThreads; i++) {
+		jobs[i].src = src;
+		jobs[i].srcType = srcType;
+		jobs[i].numPlanes = numPlanes;
+		jobs[i].iters = iters;
+		jobs[i].dst = dst;
+		jobs[i].usefloatformat = usefloatformat;
+		jobs[i].bigendian = bigendian;
+		jobs[i].usesimd = usesimd;
+		jobs[i].threaded = FALSE;
+		jobs[i].start = (size_t) i * stripe;
+		jobs[i].end = (i == numThreads - 1) ? iters : (size_t) (i + 1) * stripe;
+		if (jobs[i].end > iters) jobs[i].end = iters;
+		if (jobs[i].start > jobs[i].end) jobs[i].start = jobs[i].end;
+	}
+
+	// Start threads for all stripes but the first, which we convert ourselves. If thread creation
+	// fails, we convert the stripe ourselves as well:
+	for (i = 1; i < numThreads; i++) {
+		if (PsychCreateThread(&(jobs[i].thread), NULL, PsychTexConvertThreadMain, (void*) &jobs[i])) {
+			PsychTexConvertStripe(&jobs[i]);
+		}
+		else {
+			jobs[i].threaded = TRUE;
+		}
+	}
+
+	PsychTexConvertStripe(&jobs[0]);
+
+	// Wait for all threads to finish:
+	for (i = 1; i < numThreads; i++) {
+		if (jobs[i].threaded) PsychDeleteThread(&(jobs[i].thread));
+	}
+
+	return;
+}
+
+// Assign depth and OpenGL texture format of 'textureRecord' for a texture data buffer converted by
+// PsychTexConvertPlanarImage() from 'numMatrixPlanes' image planes at precision 'usefloatformat':
+static void PsychTexAssignFormat(PsychWindowRecordType *textureRecord, int numMatrixPlanes, int usefloatformat, psych_bool isImageMatrixUInt16)
+{
+	if (usefloatformat) {
+		// HDR 16 bpc or 32 bpc textures: Our input buffer is always of GL_FLOAT precision:
+		textureRecord->textureexternaltype = GL_FLOAT;
+		
+		if(numMatrixPlanes==1) {
+			textureRecord->depth=(usefloatformat==1) ? 16 : 32;
+			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_FLOAT16_APPLE : GL_LUMINANCE_FLOAT32_APPLE; 
+			textureRecord->textureexternalformat = GL_LUMINANCE;
+		}
+
+		if(numMatrixPlanes==2) {
+			textureRecord->depth=(usefloatformat==1) ? 32 : 64;
+			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_ALPHA_FLOAT16_APPLE : GL_LUMINANCE_ALPHA_FLOAT32_APPLE; 
+			textureRecord->textureexternalformat = GL_LUMINANCE_ALPHA;
+		}
+		
+		if(numMatrixPlanes==3) {
+			textureRecord->depth=(usefloatformat==1) ? 48 : 96;
+			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGB_FLOAT16_APPLE : GL_RGB_FLOAT32_APPLE; 
+			textureRecord->textureexternalformat = GL_RGB;
+		}
+		
+		if(numMatrixPlanes==4) {
+			textureRecord->depth=(usefloatformat==1) ? 64 : 128;
+			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGBA_FLOAT16_APPLE : GL_RGBA_FLOAT32_APPLE; 
+			textureRecord->textureexternalformat = GL_RGBA;
+		}
+	}
+	else if (isImageMatrixUInt16) {
+		// 16 bpc integer textures: Our input buffer is always of GL_UNSIGNED_SHORT precision:
+		textureRecord->textureexternaltype = GL_UNSIGNED_SHORT;
+		textureRecord->depth = 16 * numMatrixPlanes;
+
+		if(numMatrixPlanes==1) {
+			textureRecord->textureinternalformat = GL_LUMINANCE16;
+			textureRecord->textureexternalformat = GL_LUMINANCE;
+		}
+
+		if(numMatrixPlanes==2) {
+			textureRecord->textureinternalformat = GL_LUMINANCE16_ALPHA16;
+			textureRecord->textureexternalformat = GL_LUMINANCE_ALPHA;
+		}
+
+		if(numMatrixPlanes==3) {
+			textureRecord->textureinternalformat = GL_RGB16;
+			textureRecord->textureexternalformat = GL_RGB;
+		}
+
+		if(numMatrixPlanes==4) {
+			textureRecord->textureinternalformat = GL_RGBA16;
+			textureRecord->textureexternalformat = GL_RGBA;
+		}
+	}
+	else {
+		// Standard LDR texture 8 bpc: 8 bits per plane.
+		textureRecord->depth = 8 * numMatrixPlanes;
+	}
+}
+
+// Conversion job of asynchronous texture creation: 'src' is a private copy of the image matrix.
+typedef struct PsychTexAsyncConvertArg {
+	void*			src;
+	int				srcType;
+	int				numPlanes;
+	size_t			iters;
+	int				usefloatformat;
+	psych_bool		bigendian;
+} PsychTexAsyncConvertArg;
+
+// Worker function for PsychQueueAsyncTextureWork(): Convert image into texture data buffer 'buffer':
+static void PsychTexAsyncConvert(void* workArg, void* buffer)
+{
+	PsychTexAsyncConvertArg* arg = (PsychTexAsyncConvertArg*) workArg;
+
+	PsychTexConvertPlanarImage(arg->src, arg->srcType, arg->numPlanes, arg->iters, buffer, arg->usefloatformat, arg->bigendian);
+	free(arg->src);
+	free(arg);
+}
 	 
 PsychError SCREENMakeTexture(void) 
 {
@@ -87,15 +782,24 @@ PsychError SCREENMakeTexture(void)
     PsychWindowRecordType				*textureRecord;
     PsychWindowRecordType				*windowRecord;
     PsychRectType						rect;
-    psych_bool							isImageMatrixBytes, isImageMatrixDoubles;
-    int									numMatrixPlanes, xSize, ySize;
+    psych_bool							isImageMatrixBytes, isImageMatrixDoubles, isImageMatrixSingles, isImageMatrixUInt16, isImageMatrixLogical;
+    psych_bool							directupload, directcopy, asynccreate;
+    int									numMatrixPlanes, xSize, ySize, srcType;
+    size_t								srcElementSize, dstElementSize;
+    void								*asyncBuffer;
+    PsychTexAsyncConvertArg				*asyncArg;
+    psych_bool							usecache;
+    PsychTextureCacheKey				cacheKey;
+    struct PsychTextureCacheEntry		*cacheEntry;
+    psych_int64							m64, n64, p64;
     unsigned char						*byteMatrix;
     double								*doubleMatrix;
+    float								*singleMatrix;
+    psych_uint16						*uint16Matrix;
+    PsychNativeBooleanType				*logicalMatrix;
+    const void							*srcMatrix;
     GLuint								*texturePointer;
-    GLubyte								*texturePointer_b;
-	GLfloat								*texturePointer_f;
-    double								*rp, *gp, *bp, *ap;
-    GLubyte								*rpb, *gpb, *bpb, *apb;
+    GLubyte								*rpb;
     int									usepoweroftwo, usefloatformat, assume_texorientation, textureShader;
     double								optimized_orientation;
     psych_bool							bigendian;
@@ -136,13 +840,30 @@ PsychError SCREENMakeTexture(void)
     //get the argument and sanity check it.
     isImageMatrixBytes=PsychAllocInUnsignedByteMatArg(2, kPsychArgAnything, &ySize, &xSize, &numMatrixPlanes, &byteMatrix);
     isImageMatrixDoubles=PsychAllocInDoubleMatArg(2, kPsychArgAnything, &ySize, &xSize, &numMatrixPlanes, &doubleMatrix);
+    isImageMatrixSingles=PsychAllocInFloatMatArg64(2, kPsychArgAnything, &m64, &n64, &p64, &singleMatrix);
+    isImageMatrixUInt16=PsychAllocInUInt16MatArg64(2, kPsychArgAnything, &m64, &n64, &p64, &uint16Matrix);
+    isImageMatrixLogical=PsychAllocInBooleanMatArg64(2, kPsychArgAnything, &m64, &n64, &p64, &logicalMatrix);
+    if (isImageMatrixSingles || isImageMatrixUInt16 || isImageMatrixLogical) {
+        if (m64 >= INT_MAX || n64 >= INT_MAX)
+            PsychErrorExitMsg(PsychError_inputMatrixIllegalDimensionSize, "Specified image matrix exceeds maximum width or height of 2^31 - 1 pixels");
+        ySize = (int) m64;
+        xSize = (int) n64;
+        numMatrixPlanes = (int) p64;
+    }
     if(numMatrixPlanes > 4)
         PsychErrorExitMsg(PsychError_inputMatrixIllegalDimensionSize, "Specified image matrix exceeds maximum depth of 4 layers");
     if(ySize<1 || xSize <1)
         PsychErrorExitMsg(PsychError_inputMatrixIllegalDimensionSize, "Specified image matrix must be at least 1 x 1 pixels in size");
-    if(! (isImageMatrixBytes || isImageMatrixDoubles))
+    if(! (isImageMatrixBytes || isImageMatrixDoubles || isImageMatrixSingles || isImageMatrixUInt16 || isImageMatrixLogical))
         PsychErrorExitMsg(PsychError_user, "Illegal argument type");  //not  likely. 
 
+    // Numeric type of the image matrix, for the conversion routines:
+    if (isImageMatrixDoubles) { srcType = kPsychTexSrcDouble; srcMatrix = (const void*) doubleMatrix; srcElementSize = sizeof(double); }
+    else if (isImageMatrixSingles) { srcType = kPsychTexSrcSingle; srcMatrix = (const void*) singleMatrix; srcElementSize = sizeof(float); }
+    else if (isImageMatrixUInt16) { srcType = kPsychTexSrcUInt16; srcMatrix = (const void*) uint16Matrix; srcElementSize = sizeof(psych_uint16); }
+    else if (isImageMatrixLogical) { srcType = kPsychTexSrcLogical; srcMatrix = (const void*) logicalMatrix; srcElementSize = sizeof(PsychNativeBooleanType); }
+    else { srcType = kPsychTexSrcUInt8; srcMatrix = (const void*) byteMatrix; srcElementSize = sizeof(unsigned char); }
+
 	// Is this a special image matrix which is already pre-transposed to fit our optimal format?
 	if (assume_texorientation == 2) {
 		// Yes. Swap xSize and ySize to take this into account:
@@ -169,6 +890,9 @@ PsychError SCREENMakeTexture(void)
     usepoweroftwo=0;
     PsychCopyInIntegerArg(4, FALSE, &usepoweroftwo);
 
+    // Flag 4 requests asynchronous texture creation:
+    asynccreate = (usepoweroftwo & 4) ? TRUE : FALSE;
+
     // Check if size constraints are fullfilled for power-of-two mode:
     if (usepoweroftwo & 1) {
 		for(ix = 1; ix < (size_t) xSize; ix*=2);
@@ -187,11 +911,62 @@ PsychError SCREENMakeTexture(void)
 	usefloatformat = 0;
     PsychCopyInIntegerArg(5, FALSE, &usefloatformat);
 	if (usefloatformat<0 || usefloatformat>2) PsychErrorExitMsg(PsychError_user, "Invalid value for 'floatprecision' parameter provided! Valid values are 0 for 8bpc int, 1 for 16bpc float or 2 for 32bpc float.");
-	if (usefloatformat && !isImageMatrixDoubles) {
-		// Floating point texture requested. We only support this if our input is a double matrix, not
-		// for uint8 matrices - converting them to float precision would be just a waste of ressources
-		// without any benefit for precision.
-		PsychErrorExitMsg(PsychError_user, "Creation of a floating point precision texture requested, but uint8 matrix provided! Only double matrices are acceptable for this mode.");
+	if (usefloatformat && !(isImageMatrixDoubles || isImageMatrixSingles)) {
+		// Floating point texture requested. We only support this if our input is a double or single matrix, not
+		// for uint8, uint16 or logical matrices - converting them to float precision would be just a waste of
+		// ressources without any benefit for precision. uint16 matrices get 16 bpc integer textures instead.
+		PsychErrorExitMsg(PsychError_user, "Creation of a floating point precision texture requested, but uint8, uint16 or logical matrix provided! Only double or single matrices are acceptable for this mode.");
+	}
+
+	// Texture cache enabled via Screen('Preference', 'TextureCacheBudget')? Then look for an existing texture with
+	// identical content and format to share, instead of converting and uploading the matrix again. Only textures
+	// in standard orientation are shared, as the other orientations get modified or relabeled after creation:
+	cacheEntry = NULL;
+	usecache = ((PsychPrefStateGet_TextureCacheBudget() > 0) && (assume_texorientation == 0) && !PsychUseClientStorageTextures()) ? TRUE : FALSE;
+	if (usecache) {
+		cacheKey.dataSize = srcElementSize * (size_t) numMatrixPlanes * (size_t) xSize * (size_t) ySize;
+		cacheKey.hash = PsychTextureCacheHash(srcMatrix, cacheKey.dataSize);
+		cacheKey.dataType = srcType;
+		cacheKey.width = xSize;
+		cacheKey.height = ySize;
+		cacheKey.planes = numMatrixPlanes;
+		cacheKey.precision = usefloatformat;
+		cacheKey.flags = usepoweroftwo & 3;
+		cacheEntry = PsychLookupCachedTexture(windowRecord, &cacheKey);
+
+		// A shared texture is ready for use, no need for asynchronous creation:
+		if (cacheEntry) asynccreate = FALSE;
+	}
+
+	// Can the image matrix be used directly as texture buffer? This is the case for single plane matrices whose
+	// data type matches the texture format. FLOAT16 textures need the workaround in PsychTexFlushTinyFloats() and
+	// client storage textures would keep referencing the matrix after we return, so these always get a copy, as
+	// do asynchronously created textures, which are uploaded after we return:
+	directcopy = ((numMatrixPlanes == 1) && (isImageMatrixBytes || isImageMatrixUInt16 || (isImageMatrixSingles && (usefloatformat == 2)))) ? TRUE : FALSE;
+	directupload = (directcopy && !asynccreate && !PsychUseClientStorageTextures()) ? TRUE : FALSE;
+
+	// Element size of the texture data buffer:
+	dstElementSize = (usefloatformat) ? sizeof(GLfloat) : ((isImageMatrixUInt16) ? sizeof(GLushort) : sizeof(GLubyte));
+	iters = (size_t) xSize * (size_t) ySize;
+
+	// Asynchronous creation needs a private copy of the image matrix for conversion on the worker thread, as
+	// the matrix may be gone after we return. Matrices which need no conversion get copied into the texture
+	// data buffer instead, further below:
+	asyncArg = NULL;
+	if (asynccreate && !directcopy) {
+		asyncArg = (PsychTexAsyncConvertArg*) malloc(sizeof(PsychTexAsyncConvertArg));
+		if (asyncArg) asyncArg->src = malloc(srcElementSize * (size_t) numMatrixPlanes * iters);
+		if ((asyncArg == NULL) || (asyncArg->src == NULL)) {
+			free(asyncArg);
+			PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to create texture asynchronously!");
+		}
+
+		memcpy(asyncArg->src, srcMatrix, srcElementSize * (size_t) numMatrixPlanes * iters);
+		asyncArg->srcType = srcType;
+		asyncArg->numPlanes = numMatrixPlanes;
+		asyncArg->iters = iters;
+		asyncArg->usefloatformat = usefloatformat;
+		asyncArg->bigendian = bigendian;
 	}
 
     //Create a texture record.  Really just a window record adapted for textures.  
@@ -205,10 +980,23 @@ PsychError SCREENMakeTexture(void)
     
     //Allocate the texture memory and copy the MATLAB matrix into the texture memory.
     // MK: We only allocate the amount really needed for given format, aka numMatrixPlanes - Bytes per pixel.
-	if (usefloatformat) {
+    // Asynchronously created textures get their memory from PsychBeginAsyncTexture() further below,
+    // shared textures from the texture cache don't need any.
+	if (asynccreate || cacheEntry) {
+		textureRecord->textureMemorySizeBytes = 0;
+	}
+	else if (directupload) {
+		// Setting memsize to zero prevents unwanted free() of the matrix in PsychCreateTexture():
+		textureRecord->textureMemorySizeBytes = 0;
+	}
+	else if (usefloatformat) {
 		// Allocate a double for each color component and pixel:
 		textureRecord->textureMemorySizeBytes = sizeof(double) * (size_t) numMatrixPlanes * (size_t) xSize * (size_t) ySize;		
 	}
+	else if (isImageMatrixUInt16) {
+		// Allocate one unsigned short per color component and pixel:
+		textureRecord->textureMemorySizeBytes = sizeof(GLushort) * (size_t) numMatrixPlanes * (size_t) xSize * (size_t) ySize;
+	}
     else {
 		// Allocate one byte per color component and pixel:
 		textureRecord->textureMemorySizeBytes = (size_t) numMatrixPlanes * (size_t) xSize * (size_t) ySize;
@@ -216,7 +1004,7 @@ PsychError SCREENMakeTexture(void)
 	// MK: Allocate memory page-aligned... -> Helps Apple texture range extensions et al.
     if(PsychPrefStateGet_DebugMakeTexture()) 	//MARK #2
         StoreNowTime();
-    textureRecord->textureMemory=malloc(textureRecord->textureMemorySizeBytes);
+    if (!asynccreate && !cacheEntry) textureRecord->textureMemory = (directupload) ? (GLuint*) srcMatrix : malloc(textureRecord->textureMemorySizeBytes);
     if(PsychPrefStateGet_DebugMakeTexture()) 	//MARK #3
         StoreNowTime();	
     texturePointer=textureRecord->textureMemory;
@@ -229,216 +1017,10 @@ PsychError SCREENMakeTexture(void)
 
 	// Now the conversion routines that convert Matlab/Octave matrices into memory
 	// buffers suitable for OpenGL:
-	if (usefloatformat) {
-		// Conversion routines for HDR 16 bpc or 32 bpc textures -- Slow path.
-		// Our input is always double matrices...
-		iters = (size_t) xSize * (size_t) ySize;
+	if (!directupload && !asynccreate && !cacheEntry) PsychTexConvertPlanarImage(srcMatrix, srcType, numMatrixPlanes, iters, (void*) texturePointer, usefloatformat, bigendian);
 
-		// Our input buffer is always of GL_FLOAT precision:
-		textureRecord->textureexternaltype = GL_FLOAT;
-		texturePointer_f=(GLfloat*) texturePointer;
-		
-		if(numMatrixPlanes==1) {
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(doubleMatrix++);  
-			}
-			textureRecord->depth=(usefloatformat==1) ? 16 : 32;
-
-			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_FLOAT16_APPLE : GL_LUMINANCE_FLOAT32_APPLE; 
-			textureRecord->textureexternalformat = GL_LUMINANCE;
-		}
-
-		if(numMatrixPlanes==2) {
-			rp=(double*) ((size_t) doubleMatrix);
-			ap=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(rp++);  
-				*(texturePointer_f++)= (GLfloat) *(ap++);  
-			}
-			textureRecord->depth=(usefloatformat==1) ? 32 : 64;
-			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_LUMINANCE_ALPHA_FLOAT16_APPLE : GL_LUMINANCE_ALPHA_FLOAT32_APPLE; 
-			textureRecord->textureexternalformat = GL_LUMINANCE_ALPHA;
-		}
-		
-		if(numMatrixPlanes==3) {
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(rp++);  
-				*(texturePointer_f++)= (GLfloat) *(gp++);  
-				*(texturePointer_f++)= (GLfloat) *(bp++);  
-			}
-			textureRecord->depth=(usefloatformat==1) ? 48 : 96;
-			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGB_FLOAT16_APPLE : GL_RGB_FLOAT32_APPLE; 
-			textureRecord->textureexternalformat = GL_RGB;
-		}
-		
-		if(numMatrixPlanes==4) {
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-			ap=(double*) ((size_t) bp + (size_t) iters * sizeof(double));
-
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_f++)= (GLfloat) *(rp++);  
-				*(texturePointer_f++)= (GLfloat) *(gp++);  
-				*(texturePointer_f++)= (GLfloat) *(bp++);  
-				*(texturePointer_f++)= (GLfloat) *(ap++);  
-			}			
-			textureRecord->depth=(usefloatformat==1) ? 64 : 128;
-			textureRecord->textureinternalformat = (usefloatformat==1) ? GL_RGBA_FLOAT16_APPLE : GL_RGBA_FLOAT32_APPLE; 
-			textureRecord->textureexternalformat = GL_RGBA;
-		}
-
-		// This is a special workaround for bugs in FLOAT16 texture creation on Mac OS/X 10.4.x and 10.5.x.
-		// The OpenGL fails to properly flush very small values (< 1e-9) to zero when creating a FLOAT16
-		// type texture. Instead it seems to initialize with trash data, corrupting the texture.
-		// Therefore, if FLOAT16 texture creation is requested, we loop over the whole input buffer and
-		// set all values with magnitude smaller than 1e-9 to zero. Better safe than sorry...
-		if(usefloatformat==1) {
-			texturePointer_f=(GLfloat*) texturePointer;
-			iters = iters * (size_t) numMatrixPlanes;
-			for(ix=0; ix<iters; ix++, texturePointer_f++) if(fabs((double) *texturePointer_f) < 1e-9) { *texturePointer_f = 0.0; }
-		}
-		
-		// End of HDR conversion code...
-	}
-    else {
-		// Standard LDR texture 8 bpc conversion routines -- Fast path.
-		iters = (size_t) xSize * (size_t) ySize;
-
-		// Improved implementation: Takes 13 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==1){
-			texturePointer_b=(GLubyte*) texturePointer;
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= (GLubyte) *(doubleMatrix++);  
-			}
-			textureRecord->depth=8;
-		}
-		
-		// Improved version: Takes 3 ms on a 800x800 texture...
-		// NB: Implementing memcpy manually by a for-loop takes 10 ms! This is a huge difference.
-		// -> That's because memcpy on MacOS-X is implemented with hand-coded, highly tuned Assembler code for PowerPC.
-		// -> It's always wise to use system-routines if available, instead of coding it by yourself!
-		if(isImageMatrixBytes && numMatrixPlanes==1){
-			memcpy((void*) texturePointer, (void*) byteMatrix, iters);
-			textureRecord->depth=8;
-		}
-		
-		// New version: Takes 33 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==2){
-			texturePointer_b=(GLubyte*) texturePointer;
-			rp=(double*) ((size_t) doubleMatrix);
-			ap=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= (GLubyte) *(rp++);  
-				*(texturePointer_b++)= (GLubyte) *(ap++);  
-			}
-			textureRecord->depth=16;
-		}
-		
-		// New version: Takes 20 ms on a 800x800 texture...
-		if(isImageMatrixBytes && numMatrixPlanes==2){
-			texturePointer_b=(GLubyte*) texturePointer;
-			rpb=(GLubyte*) ((size_t) byteMatrix);
-			apb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= *(rpb++);  
-				*(texturePointer_b++)= *(apb++);  
-			}
-			textureRecord->depth=16;
-		}
-		
-		// Improved version: Takes 43 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==3){
-			texturePointer_b=(GLubyte*) texturePointer;
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= (GLubyte) *(rp++);  
-				*(texturePointer_b++)= (GLubyte) *(gp++);  
-				*(texturePointer_b++)= (GLubyte) *(bp++);  
-			}
-			textureRecord->depth=24;
-		}
-		
-		// Improved version: Takes 25 ms on a 800x800 texture...
-		if(isImageMatrixBytes && numMatrixPlanes==3){
-			texturePointer_b=(GLubyte*) texturePointer;			
-			rpb=(GLubyte*) ((size_t) byteMatrix);
-			gpb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-			bpb=(GLubyte*) ((size_t) gpb + (size_t) iters);
-			for(ix=0;ix<iters;ix++){
-				*(texturePointer_b++)= *(rpb++);  
-				*(texturePointer_b++)= *(gpb++);  
-				*(texturePointer_b++)= *(bpb++);  
-			}
-			textureRecord->depth=24;
-		}
-		
-		// Improved version: Takes 55 ms on a 800x800 texture...
-		if(isImageMatrixDoubles && numMatrixPlanes==4){
-			texturePointer_b=(GLubyte*) texturePointer;			
-			rp=(double*) ((size_t) doubleMatrix);
-			gp=(double*) ((size_t) rp + (size_t) iters * sizeof(double));
-			bp=(double*) ((size_t) gp + (size_t) iters * sizeof(double));
-			ap=(double*) ((size_t) bp + (size_t) iters * sizeof(double));
-			if (bigendian) {
-				// Code for big-endian machines like PowerPC:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= (GLubyte) *(ap++);  
-					*(texturePointer_b++)= (GLubyte) *(rp++);  
-					*(texturePointer_b++)= (GLubyte) *(gp++);  
-					*(texturePointer_b++)= (GLubyte) *(bp++);  
-				}
-			}
-			else {
-				// Code for little-endian machines like Intel Pentium:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= (GLubyte) *(bp++);  
-					*(texturePointer_b++)= (GLubyte) *(gp++);  
-					*(texturePointer_b++)= (GLubyte) *(rp++);  
-					*(texturePointer_b++)= (GLubyte) *(ap++);  
-				}
-			}
-			
-			textureRecord->depth=32;
-		}
-		
-		// Improved version: Takes 33 ms on a 800x800 texture...
-		if(isImageMatrixBytes && numMatrixPlanes==4){
-			texturePointer_b=(GLubyte*) texturePointer;			
-			rpb=(GLubyte*) ((size_t) byteMatrix);
-			gpb=(GLubyte*) ((size_t) rpb + (size_t) iters);
-			bpb=(GLubyte*) ((size_t) gpb + (size_t) iters);
-			apb=(GLubyte*) ((size_t) bpb + (size_t) iters);
-			if (bigendian) {
-				// Code for big-endian machines like PowerPC:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= *(apb++);  
-					*(texturePointer_b++)= *(rpb++);  
-					*(texturePointer_b++)= *(gpb++);  
-					*(texturePointer_b++)= *(bpb++);  
-				}
-			}
-			else {
-				// Code for little-endian machines like Intel Pentium:
-				for(ix=0;ix<iters;ix++){
-					*(texturePointer_b++)= *(bpb++);  
-					*(texturePointer_b++)= *(gpb++);  
-					*(texturePointer_b++)= *(rpb++);  
-					*(texturePointer_b++)= *(apb++);  
-				}
-			}
-			
-			textureRecord->depth=32;
-		}
-	} // End of 8 bpc texture conversion code (fast-path for LDR textures)
-    
+	PsychTexAssignFormat(textureRecord, numMatrixPlanes, usefloatformat, isImageMatrixUInt16);
+	
     // The memory buffer now contains our texture data in a format ready to submit to OpenGL.
     
 	// Assign parent window and copy its inheritable properties:
@@ -450,8 +1032,29 @@ PsychError SCREENMakeTexture(void)
 	// This is our best guess about the number of image channels:
 	textureRecord->nrchannels = numMatrixPlanes;
 
-    // Let's create and bind a new texture object and fill it with our new texture data.
-    PsychCreateTexture(textureRecord);
+    if (cacheEntry) {
+        // Share the texture from the texture cache:
+        PsychAttachCachedTexture(textureRecord, cacheEntry);
+    }
+    else if (asynccreate) {
+        // Asynchronous creation: Fill the texture data buffer with the matrix if it needs no conversion,
+        // otherwise queue the conversion on the worker thread. PsychFinishAsyncTexture() creates the
+        // texture object later:
+        asyncBuffer = PsychBeginAsyncTexture(textureRecord, dstElementSize * (size_t) numMatrixPlanes * iters);
+        if (asyncArg) {
+            PsychQueueAsyncTextureWork(textureRecord, PsychTexAsyncConvert, (void*) asyncArg);
+        }
+        else {
+            memcpy(asyncBuffer, srcMatrix, dstElementSize * iters);
+        }
+    }
+    else {
+        // Let's create and bind a new texture object and fill it with our new texture data.
+        PsychCreateTexture(textureRecord);
+
+        // Hand it over to the texture cache for sharing with future MakeTexture calls:
+        if (usecache) PsychInsertCachedTexture(textureRecord, &cacheKey);
+    }
     
 	// Assign GLSL filter-/lookup-shaders if needed:
 	PsychAssignHighPrecisionTextureShaders(textureRecord, windowRecord, usefloatformat, (usepoweroftwo & 2) ? 1 : 0);
@@ -475,6 +1078,7 @@ PsychError SCREENMakeTexture(void)
 		// that format. We require this standard orientation for simplified shader design.
 
 		PsychSetShader(windowRecord, 0);
+		PsychFinishAsyncTexture(textureRecord, TRUE);
 		PsychNormalizeTextureOrientation(textureRecord);
 	}
 	
@@ -492,3 +1096,272 @@ PsychError SCREENMakeTexture(void)
     
     return(PsychError_none);
 }
+
+
+PsychError SCREENTextureReady(void)
+{
+	// If you change useString then also change the corresponding synopsis string in ScreenSynopsis.c
+	static char useString[] = "isReady = Screen('TextureReady', textureIndices [, waitForReady=0]);";
+	//                         1                                 1                 2
+	static char synopsisString[] = 
+		"Check if textures created asynchronously via Screen('MakeTexture') with 'specialFlags' 4 are ready for use.\n"
+		"'textureIndices' is a single texture handle or a vector of texture handles. 'isReady' returns a vector with "
+		"1 for each texture which is ready, 0 for each texture which is still being created. Textures which weren't "
+		"created asynchronously are always ready.\n"
+		"If 'waitForReady' is set to 1, wait until all given textures are ready.\n"
+		"Textures whose conversion is finished get uploaded to the graphics card by this function, so calling it "
+		"regularly, e.g., once per frame in the animation loop, keeps preloading of stimuli going in the background.\n";
+	static char seeAlsoString[] = "MakeTexture DrawTexture DrawTextures";
+
+	PsychWindowRecordType	*textureRecord;
+	int						m, n, p, i, waitForReady;
+	double					*texids, *isReady;
+
+	//all subfunctions should have these two lines.  
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
+
+	PsychErrorExit(PsychCapNumInputArgs(2));
+	PsychErrorExit(PsychRequireNumInputArgs(1));
+	PsychErrorExit(PsychCapNumOutputArgs(1));
+
+	PsychAllocInDoubleMatArg(1, kPsychArgRequired, &m, &n, &p, &texids);
+	if ((p > 1) || (m > 1 && n > 1)) PsychErrorExitMsg(PsychError_user, "The first argument must be a single texture handle or a vector of texture handles.");
+
+	waitForReady = 0;
+	PsychCopyInIntegerArg(2, kPsychArgOptional, &waitForReady);
+
+	PsychAllocOutDoubleMatArg(1, kPsychArgOptional, 1, m * n, 0, &isReady);
+
+	for (i = 0; i < m * n; i++) {
+		// Don't use PsychAllocInWindowRecordArg(): It would wait for textures to become ready.
+		if (!IsWindowIndex((PsychWindowIndexType) texids[i]) || (FindWindowRecord((PsychWindowIndexType) texids[i], &textureRecord) != PsychError_none) ||
+			(textureRecord->windowType != kPsychTexture)) {
+			printf("PTB-ERROR: Entry %i of texture handle vector is not a valid texture handle!\n", i + 1);
+			PsychErrorExitMsg(PsychError_user, "Invalid texture handle provided to Screen('TextureReady').");
+		}
+
+		isReady[i] = (PsychFinishAsyncTexture(textureRecord, (waitForReady > 0) ? TRUE : FALSE)) ? 1 : 0;
+	}
+
+	return(PsychError_none);
+}
+
+
+PsychError SCREENMakeTextures(void)
+{
+	// If you change useString then also change the corresponding synopsis string in ScreenSynopsis.c
+	static char useString[] = "[textureIndices, atlasRects] = Screen('MakeTextures', WindowIndex, imageStack [, numPlanes=1] [, specialFlags=0] [, floatprecision=0] [, textureShader=0]);";
+	//                          1               2                                     1            2             3               4                  5                    6
+	static char synopsisString[] = 
+		"Create textures for a stack of equally sized images in one go, packed into one shared OpenGL atlas texture.\n"
+		"'imageStack' is a height x width x (numPlanes * n) matrix with n images of 'numPlanes' image planes each, ie., "
+		"all planes of the first image, followed by all planes of the second image, and so on. A height x width x n stack "
+		"of luminance images can be passed as is, a height x width x numPlanes x n stack of color images as "
+		"reshape(stack, height, width, []), which has the same layout in memory.\n"
+		"'numPlanes' can be 1 for luminance, 2 for luminance + alpha, 3 for RGB and 4 for RGBA images. Supported matrix types "
+		"and the meaning of 'floatprecision' and 'textureShader' are the same as for Screen('MakeTexture'). 'specialFlags' 2 "
+		"has the same meaning as well, power-of-two textures and asynchronous creation are not supported.\n"
+		"Returns a vector 'textureIndices' with one texture handle for each image. The handles can be used like any handle "
+		"from Screen('MakeTexture') and get closed individually via Screen('Close'). The atlas texture is released after "
+		"all of them are closed.\n"
+		"All images get converted and uploaded to the graphics card at once, which is much faster than creating many small "
+		"textures one by one. Screen('DrawTextures') draws any number of images of one atlas in one batch, as long as no "
+		"rotation, no per-item 'filterModes' and no shaders are requested.\n"
+		"The optional 'atlasRects' returns a 4 row by n column matrix with the [left top right bottom] rectangle of each image "
+		"within the atlas texture in texels, e.g., for your own OpenGL code in combination with Screen('GetOpenGLTexture'). "
+		"The atlas stores images transposed, like all textures from Screen('MakeTexture'), so the width of each rectangle is "
+		"the height of its image. Each image is surrounded by a one texel border which replicates its edge texels, so bilinear "
+		"filtering doesn't blend in neighbouring images, but mipmapped filtering can.\n"
+		"Drawing into one of the textures, or using it for image processing, gives it a private copy of its image first.\n";
+	static char seeAlsoString[] = "MakeTexture DrawTextures Close";
+
+	PsychWindowRecordType				*windowRecord, *textureRecord;
+	struct PsychTextureCacheEntry		*atlasEntry;
+	PsychRectType						rect;
+	psych_bool							isImageMatrixBytes, isImageMatrixDoubles, isImageMatrixSingles, isImageMatrixUInt16, isImageMatrixLogical;
+	psych_bool							bigendian;
+	int									numStackPlanes, numMatrixPlanes, numItems, xSize, ySize, srcType;
+	int									specialFlags, usefloatformat, textureShader;
+	int									cols, rows, cellWidth, cellHeight, i, c;
+	GLint								maxSize;
+	size_t								ix, iters, srcElementSize, dstElementSize, texelSize, rowStride, atlasBytes;
+	psych_int64							m64, n64, p64;
+	unsigned char						*byteMatrix;
+	double								*doubleMatrix;
+	float								*singleMatrix;
+	psych_uint16						*uint16Matrix;
+	PsychNativeBooleanType				*logicalMatrix;
+	const unsigned char					*srcMatrix;
+	unsigned char						*atlasBuffer, *itemBuffer, *cell, *dst;
+	double								*texids, *atlasRects;
+	GLubyte								*rpb;
+
+	// Detect endianity (byte-order) of machine:
+	ix=255;
+	rpb=(GLubyte*) &ix;
+	bigendian = ( *rpb == 255 ) ? FALSE : TRUE;
+	ix = 0; rpb = NULL;
+
+	//all subfunctions should have these two lines.  
+	PsychPushHelp(useString, synopsisString, seeAlsoString);
+	if(PsychIsGiveHelp()){PsychGiveHelp();return(PsychError_none);};
+
+	PsychErrorExit(PsychCapNumInputArgs(6));
+	PsychErrorExit(PsychRequireNumInputArgs(2));
+	PsychErrorExit(PsychCapNumOutputArgs(2));
+
+	PsychAllocInWindowRecordArg(kPsychUseDefaultArgPosition, TRUE, &windowRecord);
+	if((windowRecord->windowType!=kPsychDoubleBufferOnscreen) && (windowRecord->windowType!=kPsychSingleBufferOnscreen))
+		PsychErrorExitMsg(PsychError_user, "MakeTextures called on something else than a onscreen window");
+
+	// Get the image stack, same as in Screen('MakeTexture'):
+	isImageMatrixBytes=PsychAllocInUnsignedByteMatArg(2, kPsychArgAnything, &ySize, &xSize, &numStackPlanes, &byteMatrix);
+	isImageMatrixDoubles=PsychAllocInDoubleMatArg(2, kPsychArgAnything, &ySize, &xSize, &numStackPlanes, &doubleMatrix);
+	isImageMatrixSingles=PsychAllocInFloatMatArg64(2, kPsychArgAnything, &m64, &n64, &p64, &singleMatrix);
+	isImageMatrixUInt16=PsychAllocInUInt16MatArg64(2, kPsychArgAnything, &m64, &n64, &p64, &uint16Matrix);
+	isImageMatrixLogical=PsychAllocInBooleanMatArg64(2, kPsychArgAnything, &m64, &n64, &p64, &logicalMatrix);
+	if (isImageMatrixSingles || isImageMatrixUInt16 || isImageMatrixLogical) {
+		if (m64 >= INT_MAX || n64 >= INT_MAX || p64 >= INT_MAX)
+			PsychErrorExitMsg(PsychError_inputMatrixIllegalDimensionSize, "Specified image stack exceeds maximum size of 2^31 - 1 elements in some dimension");
+		ySize = (int) m64;
+		xSize = (int) n64;
+		numStackPlanes = (int) p64;
+	}
+	if(ySize<1 || xSize <1)
+		PsychErrorExitMsg(PsychError_inputMatrixIllegalDimensionSize, "Specified image stack must be at least 1 x 1 pixels in size");
+	if(! (isImageMatrixBytes || isImageMatrixDoubles || isImageMatrixSingles || isImageMatrixUInt16 || isImageMatrixLogical))
+		PsychErrorExitMsg(PsychError_user, "Illegal argument type");  //not  likely. 
+
+	if (isImageMatrixDoubles) { srcType = kPsychTexSrcDouble; srcMatrix = (const unsigned char*) doubleMatrix; srcElementSize = sizeof(double); }
+	else if (isImageMatrixSingles) { srcType = kPsychTexSrcSingle; srcMatrix = (const unsigned char*) singleMatrix; srcElementSize = sizeof(float); }
+	else if (isImageMatrixUInt16) { srcType = kPsychTexSrcUInt16; srcMatrix = (const unsigned char*) uint16Matrix; srcElementSize = sizeof(psych_uint16); }
+	else if (isImageMatrixLogical) { srcType = kPsychTexSrcLogical; srcMatrix = (const unsigned char*) logicalMatrix; srcElementSize = sizeof(PsychNativeBooleanType); }
+	else { srcType = kPsychTexSrcUInt8; srcMatrix = (const unsigned char*) byteMatrix; srcElementSize = sizeof(unsigned char); }
+
+	// Number of image planes per image:
+	numMatrixPlanes = 1;
+	PsychCopyInIntegerArg(3, FALSE, &numMatrixPlanes);
+	if (numMatrixPlanes < 1 || numMatrixPlanes > 4) PsychErrorExitMsg(PsychError_user, "Invalid 'numPlanes' provided! Valid values are 1 to 4.");
+	if (numStackPlanes % numMatrixPlanes) PsychErrorExitMsg(PsychError_inputMatrixIllegalDimensionSize, "Depth of image stack is not a multiple of 'numPlanes'!");
+	numItems = numStackPlanes / numMatrixPlanes;
+
+	specialFlags = 0;
+	PsychCopyInIntegerArg(4, FALSE, &specialFlags);
+	if (specialFlags & (1 | 4)) PsychErrorExitMsg(PsychError_user, "Power-of-two textures ('specialFlags' 1) and asynchronous creation ('specialFlags' 4) are not supported by Screen('MakeTextures')!");
+
+	usefloatformat = 0;
+	PsychCopyInIntegerArg(5, FALSE, &usefloatformat);
+	if (usefloatformat<0 || usefloatformat>2) PsychErrorExitMsg(PsychError_user, "Invalid value for 'floatprecision' parameter provided! Valid values are 0 for 8bpc int, 1 for 16bpc float or 2 for 32bpc float.");
+	if (usefloatformat && !(isImageMatrixDoubles || isImageMatrixSingles)) {
+		PsychErrorExitMsg(PsychError_user, "Creation of a floating point precision texture requested, but uint8, uint16 or logical matrix provided! Only double or single matrices are acceptable for this mode.");
+	}
+
+	textureShader = 0;
+	PsychCopyInIntegerArg(6, FALSE, &textureShader);
+
+	// Atlas items are addressed by texel offsets, which needs rectangle textures:
+	PsychSetGLContext(windowRecord);
+	PsychDetectTextureTarget(windowRecord);
+	if (PsychGetTextureTarget(windowRecord) != GL_TEXTURE_RECTANGLE_EXT) PsychErrorExitMsg(PsychError_user, "Screen('MakeTextures') needs support for rectangle textures, but your graphics hardware doesn't have it!");
+	maxSize = 0;
+	glGetIntegerv(GL_MAX_RECTANGLE_TEXTURE_SIZE_ARB, &maxSize);
+
+	// Layout of the atlas: Images are stored transposed, so each cell is (height + 2) texels wide and (width + 2)
+	// texels high, including the border. Cells are arranged in a grid which is about square, within the limits
+	// of the hardware:
+	cellWidth = ySize + 2;
+	cellHeight = xSize + 2;
+	cols = (int) ceil(sqrt((double) numItems * (double) cellHeight / (double) cellWidth));
+	if (cols > numItems) cols = numItems;
+	if (cols > maxSize / cellWidth) cols = maxSize / cellWidth;
+	if (cols < 1) cols = 1;
+	rows = (numItems + cols - 1) / cols;
+	cols = (numItems + rows - 1) / rows;
+	if (cols * cellWidth > maxSize || rows * cellHeight > maxSize) {
+		printf("PTB-ERROR: Atlas texture of %i x %i texels for %i images would exceed the maximum size of %i x %i texels supported by your graphics hardware.\n", cols * cellWidth, rows * cellHeight, numItems, maxSize, maxSize);
+		PsychErrorExitMsg(PsychError_user, "Image stack too big for one atlas texture. Split it into multiple stacks.");
+	}
+
+	// Element size of the texture data buffer:
+	dstElementSize = (usefloatformat) ? sizeof(GLfloat) : ((isImageMatrixUInt16) ? sizeof(GLushort) : sizeof(GLubyte));
+	texelSize = dstElementSize * (size_t) numMatrixPlanes;
+	iters = (size_t) xSize * (size_t) ySize;
+	rowStride = (size_t) cols * (size_t) cellWidth * texelSize;
+	atlasBytes = rowStride * (size_t) rows * (size_t) cellHeight;
+
+	// Unused cells are zero aka black:
+	atlasBuffer = (unsigned char*) calloc(1, atlasBytes);
+	itemBuffer = (unsigned char*) malloc(texelSize * iters);
+	if ((atlasBuffer == NULL) || (itemBuffer == NULL)) {
+		free(atlasBuffer);
+		free(itemBuffer);
+		PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to create atlas texture!");
+	}
+
+	// Convert each image into its cell and replicate its edge texels into the border of the cell:
+	for (i = 0; i < numItems; i++) {
+		PsychTexConvertPlanarImage((const void*) (srcMatrix + (size_t) i * (size_t) numMatrixPlanes * iters * srcElementSize), srcType, numMatrixPlanes, iters, (void*) itemBuffer, usefloatformat, bigendian);
+
+		cell = atlasBuffer + (size_t) (i / cols) * (size_t) cellHeight * rowStride + (size_t) (i % cols) * (size_t) cellWidth * texelSize;
+		for (c = 0; c < xSize; c++) {
+			dst = cell + (size_t) (c + 1) * rowStride;
+			memcpy(dst + texelSize, itemBuffer + (size_t) c * (size_t) ySize * texelSize, (size_t) ySize * texelSize);
+			memcpy(dst, dst + texelSize, texelSize);
+			memcpy(dst + (size_t) (ySize + 1) * texelSize, dst + (size_t) ySize * texelSize, texelSize);
+		}
+		memcpy(cell, cell + rowStride, (size_t) cellWidth * texelSize);
+		memcpy(cell + (size_t) (xSize + 1) * rowStride, cell + (size_t) xSize * rowStride, (size_t) cellWidth * texelSize);
+	}
+	free(itemBuffer);
+
+	PsychAllocOutDoubleMatArg(1, FALSE, 1, numItems, 0, &texids);
+	PsychAllocOutDoubleMatArg(2, FALSE, 4, numItems, 0, &atlasRects);
+
+	// The texture record of the first image creates the atlas texture, with a rect of the transposed size of
+	// the atlas, as PsychCreateTexture() expects for texture orientation zero. All others share it:
+	atlasEntry = NULL;
+	for (i = 0; i < numItems; i++) {
+		PsychCreateWindowRecord(&textureRecord);
+		textureRecord->windowType=kPsychTexture;
+		textureRecord->screenNumber=windowRecord->screenNumber;
+		textureRecord->depth=32;
+		PsychTexAssignFormat(textureRecord, numMatrixPlanes, usefloatformat, isImageMatrixUInt16);
+		PsychAssignParentWindow(textureRecord, windowRecord);
+		textureRecord->textureOrientation = 0;
+		textureRecord->nrchannels = numMatrixPlanes;
+
+		if (atlasEntry == NULL) {
+			PsychMakeRect(rect, 0, 0, rows * cellHeight, cols * cellWidth);
+			PsychCopyRect(textureRecord->rect, rect);
+			textureRecord->textureMemory = (GLuint*) atlasBuffer;
+			textureRecord->textureMemorySizeBytes = atlasBytes;
+			PsychCreateTexture(textureRecord);
+
+			atlasEntry = PsychCreateSharedTexture(textureRecord);
+			if (atlasEntry == NULL) PsychErrorExitMsg(PsychError_outofMemory, "Out of memory while trying to create atlas texture!");
+		}
+		else {
+			PsychAttachCachedTexture(textureRecord, atlasEntry);
+		}
+
+		PsychMakeRect(rect, 0, 0, xSize, ySize);
+		PsychCopyRect(textureRecord->rect, rect);
+		textureRecord->textureAtlasOffset[0] = (i % cols) * cellWidth + 1;
+		textureRecord->textureAtlasOffset[1] = (i / cols) * cellHeight + 1;
+
+		// Assign GLSL filter-/lookup-shaders if needed, and the optional user specified shader:
+		PsychAssignHighPrecisionTextureShaders(textureRecord, windowRecord, usefloatformat, (specialFlags & 2) ? 1 : 0);
+		if (textureShader!=0) textureRecord->textureFilterShader = -1 * textureShader;
+
+		PsychSetWindowRecordValid(textureRecord);
+		texids[i] = (double) textureRecord->windowIndex;
+
+		atlasRects[i * 4 + 0] = textureRecord->textureAtlasOffset[0];
+		atlasRects[i * 4 + 1] = textureRecord->textureAtlasOffset[1];
+		atlasRects[i * 4 + 2] = textureRecord->textureAtlasOffset[0] + ySize;
+		atlasRects[i * 4 + 3] = textureRecord->textureAtlasOffset[1] + xSize;
+	}
+
+	return(PsychError_none);
+}
@@ -259,6 +259,9 @@ PsychError SCREENFinalizeMovie(void)
 	// Get the moviehandle:
 	PsychCopyInIntegerArg(1, kPsychArgRequired, &moviehandle);
 	
+	// Stop recording of flips into the movie, if any:
+	PsychStopFlipRecorders(moviehandle);
+
 	// Finalize the movie:
 	if (!PsychFinalizeNewMovieFile(moviehandle)) {
 		printf("See http://developer.apple.com/documentation/QuickTime/APIREF/ErrorCodes.htm#//apple_ref/doc/constant_group/Error_Codes.\n\n");
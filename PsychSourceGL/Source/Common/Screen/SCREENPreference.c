@@ -104,6 +104,10 @@ static char synopsisString[] =
 	"\nmexFunctionName = Screen('Preference', 'PsychTableCreator');"
 	"\nproc = Screen('Preference', 'Process', signature);"
 	"\nproc = Screen('Preference', 'DebugMakeTexture', enableDebugging);"
+	"\noldNumThreads = Screen('Preference', 'MakeTextureThreads', [numThreads=1 (SIMD conversion), 0 = Scalar reference conversion, n > 1 = Use n threads for big images in MakeTexture and GetImage]);"
+	"\noldBudgetMB = Screen('Preference', 'TextureCacheBudget', [budgetMB=0 (Disabled), n > 0 = Share textures of identical content created by MakeTexture, up to n MB of textures]);"
+	"\noldEnableFlag = Screen('Preference', 'ReleaseTextureHostMemory', [enableFlag=0 (Keep system RAM copy for client storage textures), 1 = Always release system RAM copy after upload]);"
+	"\noldNumBuffers = Screen('Preference', 'AsyncReadbackBuffers', [numBuffers=4 (Number of pending asynchronous GetImage readbacks per window, 1 to 64)]);"
 	"\noldEnableFlag = Screen('Preference', 'TextAlphaBlending', [enableFlag]);"
 	"\noldSize = Screen('Preference', 'DefaultFontSize', [fontSize]);"
 	"\noldStyleFlag = Screen('Preference', 'DefaultFontStyle', [styleFlag]);"
@@ -319,6 +323,43 @@ PsychError SCREENPreference(void)
 				PsychPrefStateSet_DebugMakeTexture(tempFlag);
 			}
 			preferenceNameArgumentValid=TRUE;
+		}else 
+			if(PsychMatch(preferenceName, "MakeTextureThreads")){
+			PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_MakeTextureThreads());
+			if(numInputArgs==2){
+				PsychCopyInIntegerArg(2, kPsychArgRequired, &tempInt);
+				if (tempInt < 0 || tempInt > 16) PsychErrorExitMsg(PsychError_user, "Invalid number of threads provided. Valid range is 0 to 16!");
+				PsychPrefStateSet_MakeTextureThreads(tempInt);
+			}
+			preferenceNameArgumentValid=TRUE;
+		}else 
+			if(PsychMatch(preferenceName, "TextureCacheBudget")){
+			PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_TextureCacheBudget());
+			if(numInputArgs==2){
+				PsychCopyInIntegerArg(2, kPsychArgRequired, &tempInt);
+				if (tempInt < 0) PsychErrorExitMsg(PsychError_user, "Invalid texture cache budget provided. Must be zero or a positive number of megabytes!");
+				PsychPrefStateSet_TextureCacheBudget(tempInt);
+				// Evict textures which don't fit into the new budget:
+				PsychTrimTextureCache();
+			}
+			preferenceNameArgumentValid=TRUE;
+		}else 
+			if(PsychMatch(preferenceName, "ReleaseTextureHostMemory")){
+			PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_ReleaseTextureHostMemory());
+			if(numInputArgs==2){
+				PsychCopyInFlagArg(2, kPsychArgRequired, &tempFlag);
+				PsychPrefStateSet_ReleaseTextureHostMemory(tempFlag);
+			}
+			preferenceNameArgumentValid=TRUE;
+		}else 
+			if(PsychMatch(preferenceName, "AsyncReadbackBuffers")){
+			PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_AsyncReadbackBuffers());
+			if(numInputArgs==2){
+				PsychCopyInIntegerArg(2, kPsychArgRequired, &tempInt);
+				if (tempInt < 1 || tempInt > 64) PsychErrorExitMsg(PsychError_user, "Invalid number of readback buffers provided. Valid range is 1 to 64!");
+				PsychPrefStateSet_AsyncReadbackBuffers(tempInt);
+			}
+			preferenceNameArgumentValid=TRUE;
 		}else 
 			if(PsychMatch(preferenceName, "SkipSyncTests")){
 			PsychCopyOutDoubleArg(1, kPsychArgOptional, PsychPrefStateGet_SkipSyncTests());
@@ -108,7 +108,7 @@ void ScreenCloseAllWindows();           //SCREENCloseAll.c
 int		PsychConvertColorToDoubleVector(PsychColorType *color, PsychWindowRecordType *windowRecord, GLdouble *valueArray);
 // int		PsychConvertColorAndColorSizeToDoubleVector(PsychColorType *color, int colorSize, GLdouble *valueArray);
 void		PsychSetGLColor(PsychColorType *color, PsychWindowRecordType *windowRecord);
-void		PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, double* colors, unsigned char *bytecolors);
+void		PsychSetupVertexColorArrays(PsychWindowRecordType *windowRecord, psych_bool enable, int mc, GLenum colortype, const GLvoid* colorpointer);
 void		PsychSetArrayColor(PsychWindowRecordType *windowRecord, int i, int mc, double* colors, unsigned char *bytecolors);
 void		PsychGLClear(PsychWindowRecordType *windowRecord);
 void		PsychGLRect(PsychRectType psychRect);
@@ -116,12 +116,25 @@ char		*PsychGetGLErrorNameString(GLenum errorConstant);
 #define		PsychTestForGLErrors()		PsychTestForGLErrorsC(__LINE__, __func__, __FILE__) 
 void		PsychTestForGLErrorsC(int lineNum, const char *funcName, const char *fileName);
 GLdouble	*PsychExtractQuadVertexFromRect(double *rect, int vertexNumber, GLdouble *vertex);
-void		PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size);
+void		PsychPrepareRenderBatch(PsychWindowRecordType *windowRecord, int coords_pos, int* coords_count, double** xy, float** xyf, int colors_pos, int* colors_count, int* colorcomponent_count, double** colors, unsigned char** bytecolors, int sizes_pos, int* sizes_count, double** size, float** sizef);
+void*		PsychBeginVertexStream(PsychWindowRecordType *windowRecord, size_t nbytes);
+const GLubyte* PsychEndVertexStream(PsychWindowRecordType *windowRecord);
+void		PsychReleaseVertexStream(PsychWindowRecordType *windowRecord);
+void		PsychDeleteVertexStreamRing(PsychWindowRecordType *windowRecord);
+size_t		PsychGetVertexColorStreamSize(PsychWindowRecordType *windowRecord, int count, int mc, unsigned char* bytecolors);
+GLenum		PsychWriteVertexColorStream(PsychWindowRecordType *windowRecord, void* dst, int count, int mc, int repeat, double* colors, unsigned char* bytecolors);
 
 // Helper routines for vertically compressed stereo displays: Defined in SCREENSelectStereoDrawBuffer.c
 int PsychSwitchCompressedStereoDrawBuffer(PsychWindowRecordType *windowRecord, int newbuffer);
 void PsychComposeCompressedStereoBuffer(PsychWindowRecordType *windowRecord);
 
+// Helper routines for asynchronous readback and recording of flips: Defined in SCREENGetImage.c
+void PsychDeleteAsyncReadbackRing(PsychWindowRecordType *windowRecord);
+void PsychFlipRecorderCaptureFrame(PsychWindowRecordType *windowRecord);
+void PsychFlipRecorderSetOnset(PsychWindowRecordType *windowRecord, double onset);
+void PsychDeleteFlipRecorder(PsychWindowRecordType *windowRecord);
+void PsychStopFlipRecorders(int moviehandle);
+
 // Helper routines for text renderers:
 void		PsychCleanupTextRenderer(PsychWindowRecordType* windowRecord);
 psych_bool	PsychLoadTextRendererPlugin(PsychWindowRecordType* windowRecord);
@@ -149,6 +162,7 @@ PsychError 	SCREENCopyWindow(void);
 PsychError 	SCREENFlip(void);					
 PsychError 	SCREENFillRect(void);					
 PsychError	SCREENGetImage(void);					
+PsychError	SCREENFetchImage(void);
 PsychError 	SCREENPutImage(void);					
 PsychError 	SCREENHideCursorHelper(void);					
 PsychError 	SCREENShowCursorHelper(void);					
@@ -175,6 +189,8 @@ PsychError      SCREENTextColor(void);
 PsychError      SCREENPreference(void);					
 PsychError      SCREENDrawTexture(void);			
 PsychError      SCREENMakeTexture(void);			
+PsychError      SCREENTextureReady(void);
+PsychError      SCREENMakeTextures(void);
 PsychError      SCREENFrameRect(void);
 PsychError      SCREENDrawLine(void);
 PsychError      SCREENFillPoly(void);
@@ -235,6 +251,7 @@ PsychError		SCREENResolutions(void);
 PsychError		SCREENWaitUntilAsyncFlipCertain(void);
 PsychError		SCREENCreateMovie(void);
 PsychError		SCREENFinalizeMovie(void);
+PsychError		SCREENRecordFlips(void);
 PsychError      SCREENAddAudioBufferToMovie(void);
 //PsychError SCREENSetGLSynchronous(void);		//SCREENSetGLSynchronous.c
 
@@ -70,6 +70,9 @@ psych_bool PsychAllocInWindowRecordArg(int position, psych_bool required, PsychW
             return(FALSE);
 	windowIndex = (PsychWindowIndexType)arg;
 	PsychErrorExit(FindWindowRecord(windowIndex, winRec));
+
+	// Asynchronously created textures become usable once their creation is finished:
+	if ((*winRec)->asyncTextureJob) PsychFinishAsyncTexture(*winRec, TRUE);
         return(TRUE);
 }
 
@@ -44,6 +44,9 @@ PsychError ScreenExitFunction(void)
 	ScreenCloseAllWindows();
 	CloseWindowBank();
 
+	// Stop worker thread for asynchronous texture creation, if any:
+	PsychExitAsyncTextures();
+
 	#if PSYCH_SYSTEM == PSYCH_LINUX
 	// Linux specific hack. Close display connection(s) to X-Server(s). This is a bit unclean.
 	last_dpy = NULL;
@@ -80,6 +80,10 @@ static int								textRenderer;					// 0=Default OS specific (fast one), 1=OS sp
 static int                              screenSkipSyncTests;			// 0=Do full synctests, abort on failure, 1=Reduced tests, continue with warning, 2=Skip'em
 //Debug preference state
 static psych_bool						TimeMakeTextureFlag;
+static int								makeTextureThreads;			// 0 = Scalar reference conversion, 1 = SIMD conversion, n > 1 = SIMD conversion on n threads.
+static int								textureCacheBudget;			// Maximum size of texture cache in MB. 0 = Texture cache disabled.
+static psych_bool						releaseTextureHostMemory;	// TRUE = Always release system RAM copy of textures after upload, even for client storage.
+static int								asyncReadbackBuffers;		// Number of pixel buffer objects per window for asynchronous 'GetImage'.
 static int								screenVisualDebugLevel;
 static int                              screenConserveVRAM;
 // If EmulateOldPTB is set to true, then try to behave like the old OS-9 PTB:
@@ -132,6 +136,10 @@ void PrepareScreenPreferences(void)
 	textRenderer=PTB_DEFAULT_TEXTRENDERER;
 	screenSkipSyncTests=0;
 	TimeMakeTextureFlag=FALSE;
+	makeTextureThreads=1;
+	textureCacheBudget=0;
+	releaseTextureHostMemory=FALSE;
+	asyncReadbackBuffers=4;
 	screenVisualDebugLevel=4;
 	screenConserveVRAM=0;
 	EmulateOldPTB=FALSE;
@@ -465,6 +473,46 @@ void PsychPrefStateSet_DebugMakeTexture(psych_bool setFlag)
 	TimeMakeTextureFlag=setFlag;
 }
 
+int PsychPrefStateGet_MakeTextureThreads(void)
+{
+	return(makeTextureThreads);
+}
+
+void PsychPrefStateSet_MakeTextureThreads(int numThreads)
+{
+	makeTextureThreads=numThreads;
+}
+
+int PsychPrefStateGet_TextureCacheBudget(void)
+{
+	return(textureCacheBudget);
+}
+
+void PsychPrefStateSet_TextureCacheBudget(int budgetMB)
+{
+	textureCacheBudget=budgetMB;
+}
+
+psych_bool PsychPrefStateGet_ReleaseTextureHostMemory(void)
+{
+	return(releaseTextureHostMemory);
+}
+
+void PsychPrefStateSet_ReleaseTextureHostMemory(psych_bool setFlag)
+{
+	releaseTextureHostMemory=setFlag;
+}
+
+int PsychPrefStateGet_AsyncReadbackBuffers(void)
+{
+	return(asyncReadbackBuffers);
+}
+
+void PsychPrefStateSet_AsyncReadbackBuffers(int numBuffers)
+{
+	asyncReadbackBuffers=numBuffers;
+}
+
 psych_bool PsychPrefStateGet_SuppressAllWarnings(void)
 {
 	return(suppressAllWarnings);
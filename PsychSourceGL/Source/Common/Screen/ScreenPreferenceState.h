@@ -83,6 +83,22 @@ void PsychPrefStateSet_3DGfx(int level);
 psych_bool PsychPrefStateGet_DebugMakeTexture(void);
 void PsychPrefStateSet_DebugMakeTexture(psych_bool setFlag);
 
+// Number of threads for image matrix conversion in MakeTexture:
+int PsychPrefStateGet_MakeTextureThreads(void);
+void PsychPrefStateSet_MakeTextureThreads(int numThreads);
+
+// Maximum size of texture cache for MakeTexture in MB:
+int PsychPrefStateGet_TextureCacheBudget(void);
+void PsychPrefStateSet_TextureCacheBudget(int budgetMB);
+
+// Always release system RAM copies of textures after upload:
+psych_bool PsychPrefStateGet_ReleaseTextureHostMemory(void);
+void PsychPrefStateSet_ReleaseTextureHostMemory(psych_bool setFlag);
+
+// Number of pixel buffer objects per window for asynchronous GetImage:
+int PsychPrefStateGet_AsyncReadbackBuffers(void);
+void PsychPrefStateSet_AsyncReadbackBuffers(int numBuffers);
+
 // Master switch for debug output:
 psych_bool PsychPrefStateGet_SuppressAllWarnings(void);
 void PsychPrefStateSet_SuppressAllWarnings(psych_bool setFlag);
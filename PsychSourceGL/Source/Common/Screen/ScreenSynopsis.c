@@ -80,6 +80,8 @@ void InitializeSynopsis()
 	synopsis[i++] = "[windowPtr,rect]=Screen('OpenWindow',windowPtrOrScreenNumber [,color] [,rect] [,pixelSize] [,numberOfBuffers] [,stereomode] [,multisample][,imagingmode]);";	
 	synopsis[i++] = "[windowPtr,rect]=Screen('OpenOffscreenWindow',windowPtrOrScreenNumber [,color] [,rect] [,pixelSize] [,specialFlags] [,multiSample]);";
 	synopsis[i++] = "textureIndex=Screen('MakeTexture', WindowIndex, imageMatrix [, optimizeForDrawAngle=0] [, specialFlags=0] [, floatprecision=0] [, textureOrientation=0] [, textureShader=0]);";	
+	synopsis[i++] = "isReady = Screen('TextureReady', textureIndices [, waitForReady=0]);";
+	synopsis[i++] = "[textureIndices, atlasRects] = Screen('MakeTextures', WindowIndex, imageStack [, numPlanes=1] [, specialFlags=0] [, floatprecision=0] [, textureShader=0]);";
 	synopsis[i++] = "Screen('Close', [windowOrTextureIndex or list of textureIndices/offscreenWindowIndices]);";
 	synopsis[i++] = "Screen('CloseAll');";
 	
@@ -126,7 +128,8 @@ void InitializeSynopsis()
 
 	// Copy an image, slowly, between matrices and windows
 	synopsis[i++] = "\n% Copy an image, slowly, between matrices and windows :";
-	synopsis[i++] = "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3])";
+	synopsis[i++] = "imageArray=Screen('GetImage', windowPtr [,rect] [,bufferName] [,floatprecision=0] [,nrchannels=3] [,async=0])";
+	synopsis[i++] = "[imageArray, info] = Screen('FetchImage', windowPtr [, ticket=0] [, waitForCompletion=0]);";
 	synopsis[i++] = "Screen('PutImage', windowPtr, imageArray [,rect]);";
 	
 	// Synchronize with the window's screen (on-screen only):
@@ -206,6 +209,7 @@ void InitializeSynopsis()
  	synopsis[i++] =  "moviePtr = Screen('CreateMovie', windowPtr, movieFile [, width][, height][, frameRate=30][, movieOptions]);";
 	synopsis[i++] =  "Screen('FinalizeMovie', moviePtr);";
  	synopsis[i++] =  "Screen('AddFrameToMovie', windowPtr [,rect] [,bufferName] [,moviePtr=0] [,frameduration=1]);";
+	synopsis[i++] =  "stats = Screen('RecordFlips', windowPtr [, moviePtr] [, rect]);";
  	synopsis[i++] =  "Screen('AddAudioBufferToMovie', moviePtr, audioBuffer);";
 
 	// Video capture support:
@@ -301,10 +301,16 @@ void PsychCreateWindowRecord(PsychWindowRecordType **winRec)
 	
 	// NULL out flipinfo struct:
 	(*winRec)->flipInfo = NULL;
+
+	// No asynchronous readbacks or recording of flips yet:
+	(*winRec)->asyncReadbackRing = NULL;
+	(*winRec)->flipRecorder = NULL;
+	(*winRec)->vertexStreamRing = NULL;
 	
 	// Init our shader handles to zero -- Off by default:
 	(*winRec)->unclampedDrawShader = 0;
 	(*winRec)->defaultDrawShader = 0;
+	(*winRec)->pointSizeDrawShader = 0;
 
 	// Set surface addresses to zero:
 	(*winRec)->gpu_preflip_Surfaces[0] = 0;
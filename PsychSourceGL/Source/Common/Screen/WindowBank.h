@@ -116,6 +116,7 @@ TO DO:
 											// rotated drawing of textures via texture matrix, not via modelview matrix. To be set as flag in 'DrawTexture(s)'
 #define kPsychDontDoRotation			  2	// Setting for 'specialflags' field of windowRecords that describe textures. If set, drawtexture routine should implement
 											// rotated drawing of textures via shader, not via matrices, ie., just pass rotation angle to shader. To be set as flag in 'DrawTexture(s)'
+#define kPsychSkipNotReadyTexture		  4	// Flag for 'DrawTexture(s)': Skip drawing of asynchronously created textures which are not yet ready, instead of waiting for them.
 #define kPsychHalfHeightWindow		   8192 // This flag is also used as 'specialflag' for onscreen windows. Ask for windows with half-height, e.g., for interleaved stereo...
 #define kPsychNative10bpcFBActive	   1024 // Setting for 'specialflags' field of windowRecords: Means that this windowRecord is attached to a native 10bpc system framebuffer
 											// and needs some special handling it init, shutdown and during operation.
@@ -155,6 +156,8 @@ typedef struct PsychFBO {
 	int						width;		// Width of FBO.
 	int						height;		// Height of FBO.
 	int						multisample; // Multisampling level of FBO: 0 == No multisampling. > 0 means Multisampled.
+	size_t					colorSizeBytes;	// Estimated memory consumption of color buffer, if created by PsychCreateFBO(). Zero otherwise.
+	size_t					zSizeBytes;		// Estimated memory consumption of depth and stencil buffers, if any.
 } PsychFBO;
 
 // Typedefs for WindowRecord in WindowBank.h
@@ -266,6 +269,12 @@ typedef struct _PsychWindowRecordType_{
 		GLint				textureFilterShader;	// Optional GLSL program handle for a shader to apply during PsychBlitTextureToDisplay().
 		GLint				textureLookupShader;	// Optional GLSL handle for nearest neighbour texture drawing shader.
 		GLint				textureByteAligned;		// 0 = No knowledge about byte alignment of texture data. > 1, texture rows are x byte aligned.
+		struct PsychAsyncTextureJob*	asyncTextureJob;	// Pending asynchronous texture creation, or NULL. See PsychBeginAsyncTexture().
+		struct PsychTextureCacheEntry*	textureCacheEntry;	// Texture cache entry which owns the shared 'textureNumber', or NULL. See PsychAttachCachedTexture().
+		int				textureAtlasOffset[2];	// (x,y) texel offset of texture within an atlas texture from Screen('MakeTextures'). x is -1 if not an atlas item.
+		struct PsychAsyncReadbackRing*	asyncReadbackRing;	// Ring of pending asynchronous 'GetImage' readbacks, or NULL. See PsychEnqueueAsyncReadback().
+		struct PsychFlipRecorder*		flipRecorder;		// Recording of flips into a movie, or NULL. See PsychFlipRecorderCaptureFrame().
+		struct PsychVertexStreamRing*	vertexStreamRing;	// Vertex buffer ring for batch drawing commands of onscreen windows, or NULL. See PsychBeginVertexStream().
 	//line stipple attributes, for windows not textures.
 	GLushort				stipplePattern;
 	GLint					stippleFactor;
@@ -318,6 +327,7 @@ typedef struct _PsychWindowRecordType_{
 	double					colorRange;								// Maximum allowable color component value. See SCREENColorRange.c for explanation.
 	GLuint					unclampedDrawShader;					// Handle of GLSL shader object for drawing of non-texture stims without vertex color clamping. Zero by default.
 	GLuint					defaultDrawShader;						// Default GLSL shader object for drawing of non-texture stims. Zero by default.
+	GLint					pointSizeDrawShader;					// GLSL shader for 'DrawDots' with per-dot sizes. Zero = Not yet created, -1 = Unsupported.
 	double					currentColor[4];						// Current unclamped but colorrange remapped RGBA drawcolor for whatever drawop, as spec'd by PsychSetGLColor().
 	double					clearColor[4];							// Window clear color (as GL double vector) to use in PsychGLClear();
 	int						imagingMode;							// Master mode switch for imaging and callback hook pipeline.
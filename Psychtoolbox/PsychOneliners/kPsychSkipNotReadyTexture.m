@@ -0,0 +1,15 @@
+function rc = kPsychSkipNotReadyTexture
+% kPsychSkipNotReadyTexture
+%
+% Returns a constant to be passed as part of the 'specialFlags' parameter
+% of the Screen('DrawTexture') and Screen('DrawTextures') command.
+%
+% If this flag is set, the texture drawing functions will skip drawing of
+% textures which were created asynchronously by Screen('MakeTexture') with
+% 'specialFlags' 4 and which are not yet ready for use. Without this flag,
+% the drawing functions wait until creation of such textures is finished.
+% See Screen('TextureReady') for checking if textures are ready.
+%
+
+rc = 4;
+return;
@@ -20,6 +20,7 @@
 %   FlipTimingWithRTBoxPhotoDiodeTest - Benchmark of visual stimulus onset timing and timestamping. See ECVP 2010 poster in PsychDocumentation/
 %   CopyWindowTest                  - Test CopyWindow functionality.
 %   DaqTest                         - Test PsychHID and routines to control the  USB-1208FS digital acquistion device.
+%   DrawDotsBenchmark               - Benchmark maximum number of dots per frame in DrawDots at a given refresh rate.
 %   DrawingStuffTest                - FrameRect, DrawLine, FillPoly, FramePoly.
 %   EventAvailTest                  - Test EventAvail
 %   FillPolyTest                    - Test drawing concave polygons.
@@ -29,6 +30,7 @@
 %   FloatTexturePrecisionTest       - Test effective precision of floating point 16bpc textures.
 %   FrameSequentialStereoTest       - Test routine for timing and stimulus onset on quad-buffered frame-sequential stereo hardware.
 %   GetCharTest                     - Tests of GetChar.
+%   GetImageBenchmark               - Benchmark throughput of window readback in GetImage for scalar, SIMD and multi-threaded code.
 %   GetSecsTest                     - Timing test of clock used by Psychtoolbox, e.g., GetSecs, WaitSecs, Screen...
 %   GraphicsDisplaySyncAcrossDualHeadsTest - Test synchronization of refresh cycles of different display heads.
 %   HIDIntervalTest                 - Sample HID keyboard and mouse, plot distribution of detected event times.
@@ -38,6 +40,7 @@
 %   KeyboardLatencyTest             - Get a feeling for keyboard and mouse latency via some sound-based measurement procedure.
 %   LabLuvTest                      - Test routines that convert to CIELAB and CIELUV.
 %   LoadGenerator                   - Create cpu load by spinning in an infinite loop. Used in conjunction with FlipTimingWithRTBoxPhotoDiodeTest.
+%   MakeTextureBenchmark            - Benchmark throughput of image matrix conversion in MakeTexture for scalar, SIMD and multi-threaded code.
 %   MakeTextureTimingTest           - Time memory allocation by MakeTexture
 %   MakeTextureTimingTest2          - Time texture creation -> upload -> destruction for given texture by MakeTexture et al.
 %   MatlabTimingTest                - Test for MATLAB timing glitch caused by sigsetjmp().
@@ -48,6 +51,7 @@
 %   PosterBatchAnalyzeTimestamps    - Batch analysis of timestamp logs generated by FlipTimingWithRTBoxPhotoDiodeTest for ECVP 2010 poster.
 %   PsychHIDTest                    - PsychHID MEX file for HID-compliant USB devices.
 %   PupilDiameterTest               - Test functions that compute pupil diameter from luminance.
+%   PsychPortAudioBenchmark         - Benchmark PsychPortAudio's mixing engine on a virtual null device, without sound hardware.
 %   PsychPortAudioDataPixxTimingTest - Test PsychPortAudio's timing with a DataPixx device and a audio line cable.
 %   PsychPortAudioTimingTest        - Testsignal generator for test of PsychPortAudios timing with external measurement equipment.
 %   QuestTest                       - Some Quest simulations, more elaborate than QuestDemo.
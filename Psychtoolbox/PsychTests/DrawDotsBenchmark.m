@@ -0,0 +1,147 @@
+function DrawDotsBenchmark(targetHz, nrReps)
+% DrawDotsBenchmark([targetHz=120][, nrReps=20])
+%
+% Benchmark Screen('DrawDots'): Find the maximum number of dots per frame
+% which can be drawn in a sustained way at a refresh rate of 'targetHz',
+% i.e., with a total drawing time per frame of less than 1/targetHz seconds.
+%
+% The test is done for all combinations of dots with one common size vs.
+% dots with an individual random size per dot, with random colors per dot,
+% and for 'xy' positions and sizes passed as double vs. single precision
+% matrices.
+%
+% Dots with individual sizes are drawn with one single draw call on GLSL
+% capable hardware, so their throughput should be close to the one of dots
+% with a common size. Without GLSL support, each dot is drawn separately,
+% which is much slower.
+%
+% Drawing time is measured via Screen('DrawingFinished', win, 0, 1), which
+% waits for the graphics card to finish drawing. Flips are not synchronized
+% to the display, so the results do not depend on the actual refresh rate
+% of your display.
+%
+% Optional parameters:
+%
+% 'targetHz'  Refresh rate to sustain. Defaults to 120 Hz.
+% 'nrReps'    Number of timed frames per tested dot count. Defaults to 20.
+%
+% see also: PsychTests, DotDemo
+
+if nargin < 1 || isempty(targetHz)
+    targetHz = 120;
+end
+
+if nargin < 2 || isempty(nrReps)
+    nrReps = 20;
+end
+
+% Maximum number of dots to test:
+maxDots = 2^22;
+
+try
+    screenid = max(Screen('Screens'));
+    w = Screen('OpenWindow', screenid, 0);
+    [width, height] = Screen('WindowSize', w);
+    Screen('BlendFunction', w, 'GL_SRC_ALPHA', 'GL_ONE_MINUS_SRC_ALPHA');
+
+    fprintf('\nScreen(''DrawDots'') benchmark: Maximum dots per frame at %i Hz, %i frames per test.\n\n', targetHz, nrReps);
+    fprintf('Sizes       Type       Dots/frame   msecs/frame\n');
+
+    for varSize = 0:1
+        for isSingle = 0:1
+            % Find largest power of two dot count which is fast enough:
+            n = 1024;
+            [ok, t] = timeDots(w, n, width, height, varSize, isSingle, targetHz, nrReps);
+            if ~ok
+                bestN = 0;
+                bestT = t;
+            else
+                while ok && n < maxDots
+                    bestN = n;
+                    bestT = t;
+                    n = n * 2;
+                    [ok, t] = timeDots(w, n, width, height, varSize, isSingle, targetHz, nrReps);
+                end
+
+                if ok
+                    bestN = n;
+                    bestT = t;
+                end
+
+                % Refine by bisection between last good and first bad count:
+                lo = bestN;
+                hi = n;
+                while ~ok && (hi - lo) > lo / 32
+                    n = round((lo + hi) / 2);
+                    [okMid, t] = timeDots(w, n, width, height, varSize, isSingle, targetHz, nrReps);
+                    if okMid
+                        lo = n;
+                        bestN = n;
+                        bestT = t;
+                    else
+                        hi = n;
+                    end
+                end
+            end
+
+            if varSize
+                sizeName = 'per-dot';
+            else
+                sizeName = 'common';
+            end
+
+            if isSingle
+                typeName = 'single';
+            else
+                typeName = 'double';
+            end
+
+            fprintf('%-10s  %-6s  %13i  %12.3f\n', sizeName, typeName, bestN, bestT * 1000);
+        end
+    end
+
+    fprintf('\n');
+    sca;
+catch %#ok<CTCH>
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+return;
+
+function [ok, t] = timeDots(w, n, width, height, varSize, isSingle, targetHz, nrReps)
+% Draw nrReps frames with n random dots each, return mean drawing time per frame
+% and if that time is below the frame duration at targetHz:
+
+xy = [rand(1, n) * width; rand(1, n) * height];
+colors = uint8(rand(4, n) * 255);
+
+if varSize
+    sizes = 1 + rand(1, n) * 9;
+else
+    sizes = 4;
+end
+
+if isSingle
+    xy = single(xy);
+    sizes = single(sizes);
+end
+
+% Warmup:
+Screen('DrawDots', w, xy, sizes, colors, [], 1);
+Screen('DrawingFinished', w, 0, 1);
+Screen('Flip', w, 0, 0, 2);
+
+t = 0;
+for i = 1:nrReps
+    tStart = GetSecs;
+    Screen('DrawDots', w, xy, sizes, colors, [], 1);
+    Screen('DrawingFinished', w, 0, 1);
+    t = t + GetSecs - tStart;
+    Screen('Flip', w, 0, 0, 2);
+end
+
+t = t / nrReps;
+ok = (t < 1 / targetHz);
+
+return;
@@ -0,0 +1,101 @@
+function GetImageBenchmark(numThreads, nrReps)
+% GetImageBenchmark([numThreads=4][, nrReps=10])
+%
+% Benchmark the readback of window content into Matlab/Octave image
+% matrices by Screen('GetImage') for different readback sizes, numbers of
+% channels (L, LA, RGB, RGBA) and return types (uint8, double, single).
+%
+% Readback sizes are 640 x 480, 1280 x 720, 1920 x 1080 and 3840 x 2160
+% pixels, as far as they fit into the onscreen window.
+%
+% Each combination is timed with the three conversion modes selectable via
+% Screen('Preference', 'MakeTextureThreads', mode):
+%
+% 0 = Scalar reference code, ie., the old implementation.
+% 1 = Tiled SIMD conversion, the default.
+% 'numThreads' = Tiled SIMD conversion, striped across 'numThreads' threads
+% for big images.
+%
+% The reported throughput in MB/s is the size of the returned image matrix,
+% divided by the mean duration of a GetImage call. The duration includes
+% the glReadPixels readback from the graphics card, which is the same for
+% all modes, so the differences between modes are due to the conversion
+% alone.
+%
+% Optional parameters:
+%
+% 'numThreads'      Number of threads for the multi-threaded mode. Defaults to 4.
+% 'nrReps'          Number of timed GetImage calls per test. Defaults to 10.
+%
+% see also: PsychTests, MakeTextureBenchmark
+
+if nargin < 1 || isempty(numThreads)
+    numThreads = 4;
+end
+
+if nargin < 2 || isempty(nrReps)
+    nrReps = 10;
+end
+
+sizes = [640 480; 1280 720; 1920 1080; 3840 2160];
+modes = [0, 1, numThreads];
+typeNames = {'uint8', 'double', 'single'};
+oldThreads = Screen('Preference', 'MakeTextureThreads');
+
+try
+    screenid = max(Screen('Screens'));
+    w = Screen('OpenWindow', screenid, 0);
+    [winWidth, winHeight] = Screen('WindowSize', w);
+
+    % Some random content to read back:
+    tex = Screen('MakeTexture', w, uint8(rand(winHeight, winWidth, 3) * 255));
+    Screen('DrawTexture', w, tex);
+    Screen('Flip', w, 0, 1);
+    Screen('Close', tex);
+
+    fprintf('\nScreen(''GetImage'') readback benchmark: %i repetitions.\n\n', nrReps);
+    fprintf('  Width  Height  Channels  Type     Scalar MB/s     SIMD MB/s   %2i Thr. MB/s\n', numThreads);
+
+    for s = 1:size(sizes, 1)
+        if sizes(s, 1) > winWidth || sizes(s, 2) > winHeight
+            continue;
+        end
+
+        rect = [0, 0, sizes(s, 1), sizes(s, 2)];
+
+        for nrchannels = 1:4
+            for floatprecision = 0:2
+                rate = zeros(1, length(modes));
+                for m = 1:length(modes)
+                    Screen('Preference', 'MakeTextureThreads', modes(m));
+
+                    % Warmup:
+                    img = Screen('GetImage', w, rect, 'backBuffer', floatprecision, nrchannels);
+                    info = whos('img');
+                    mbytes = info.bytes / 1024 / 1024;
+
+                    t = 0;
+                    for i = 1:nrReps
+                        tStart = GetSecs;
+                        img = Screen('GetImage', w, rect, 'backBuffer', floatprecision, nrchannels); %#ok<NASGU>
+                        t = t + GetSecs - tStart;
+                    end
+
+                    rate(m) = mbytes / (t / nrReps);
+                end
+
+                fprintf('%7i  %6i  %8i  %-6s  %12.1f  %12.1f  %12.1f\n', sizes(s, 1), sizes(s, 2), nrchannels, typeNames{floatprecision + 1}, rate(1), rate(2), rate(3));
+            end
+        end
+    end
+
+    fprintf('\n');
+    Screen('Preference', 'MakeTextureThreads', oldThreads);
+    sca;
+catch %#ok<CTCH>
+    Screen('Preference', 'MakeTextureThreads', oldThreads);
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+return;
@@ -0,0 +1,111 @@
+function MakeTextureBenchmark(width, height, numThreads, nrReps)
+% MakeTextureBenchmark([width=3840][, height=2160][, numThreads=4][, nrReps=10])
+%
+% Benchmark the conversion of Matlab/Octave image matrices into textures by
+% Screen('MakeTexture') for all combinations of image planes (L, LA, RGB,
+% RGBA), input types (uint8, double) and texture precision (8 bpc, 16 bpc
+% float, 32 bpc float).
+%
+% Each combination is timed with the three conversion modes selectable via
+% Screen('Preference', 'MakeTextureThreads', mode):
+%
+% 0 = Scalar reference code, ie., the old implementation.
+% 1 = Vectorized SIMD conversion, the default.
+% 'numThreads' = Vectorized conversion, striped across 'numThreads' threads
+% for big images.
+%
+% The reported throughput in MB/s is the size of the input image matrix,
+% divided by the mean duration of a MakeTexture call. The duration includes
+% texture upload to the graphics card, which is the same for all modes, so
+% the differences between modes are due to the conversion alone.
+%
+% Optional parameters:
+%
+% 'width', 'height' Size of the test images. Defaults to 3840 x 2160 pixels.
+% 'numThreads'      Number of threads for the multi-threaded mode. Defaults to 4.
+% 'nrReps'          Number of timed MakeTexture calls per test. Defaults to 10.
+%
+% see also: PsychTests, MakeTextureTimingTest2
+
+if nargin < 1 || isempty(width)
+    width = 3840;
+end
+
+if nargin < 2 || isempty(height)
+    height = 2160;
+end
+
+if nargin < 3 || isempty(numThreads)
+    numThreads = 4;
+end
+
+if nargin < 4 || isempty(nrReps)
+    nrReps = 10;
+end
+
+modes = [0, 1, numThreads];
+oldThreads = Screen('Preference', 'MakeTextureThreads');
+
+try
+    screenid = max(Screen('Screens'));
+    w = Screen('OpenWindow', screenid, 0);
+
+    fprintf('\nScreen(''MakeTexture'') conversion benchmark: %i x %i pixels, %i repetitions.\n\n', width, height, nrReps);
+    fprintf('Planes  Type    Precision   Scalar MB/s     SIMD MB/s   %2i Thr. MB/s\n', numThreads);
+
+    for planes = 1:4
+        for precision = 0:2
+            for isDouble = 0:1
+                % Float textures are only supported for double input:
+                if precision > 0 && ~isDouble
+                    continue;
+                end
+
+                img = rand(height, width, planes) * 255;
+                if ~isDouble
+                    img = uint8(img);
+                end
+
+                info = whos('img');
+                mbytes = info.bytes / 1024 / 1024;
+
+                rate = zeros(1, length(modes));
+                for m = 1:length(modes)
+                    Screen('Preference', 'MakeTextureThreads', modes(m));
+
+                    % Warmup:
+                    tex = Screen('MakeTexture', w, img, [], [], precision);
+                    Screen('Close', tex);
+
+                    t = 0;
+                    for i = 1:nrReps
+                        tStart = GetSecs;
+                        tex = Screen('MakeTexture', w, img, [], [], precision);
+                        t = t + GetSecs - tStart;
+                        Screen('Close', tex);
+                    end
+
+                    rate(m) = mbytes / (t / nrReps);
+                end
+
+                if isDouble
+                    typeName = 'double';
+                else
+                    typeName = 'uint8';
+                end
+
+                fprintf('%6i  %-6s  %9i  %12.1f  %12.1f  %12.1f\n', planes, typeName, precision, rate(1), rate(2), rate(3));
+            end
+        end
+    end
+
+    fprintf('\n');
+    Screen('Preference', 'MakeTextureThreads', oldThreads);
+    sca;
+catch %#ok<CTCH>
+    Screen('Preference', 'MakeTextureThreads', oldThreads);
+    sca;
+    psychrethrow(psychlasterror);
+end
+
+return;
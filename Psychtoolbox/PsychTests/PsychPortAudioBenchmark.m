@@ -0,0 +1,124 @@
+function PsychPortAudioBenchmark(nSlaves, duration, useSchedule, buffersize, channels, wavfile)
+% PsychPortAudioBenchmark([nSlaves=32][, duration=5][, useSchedule=0][, buffersize=256][, channels=2][, wavfile])
+%
+% Benchmark the PsychPortAudio audio engine without any sound hardware.
+%
+% Opens a virtual null device (deviceid -2) as master device with a
+% free-running virtual sample clock, so the engine processes audio buffers
+% as fast as it can. Attaches 'nSlaves' playback slave devices to it, each
+% playing a looped noise buffer, then runs the engine for 'duration'
+% seconds of wall clock time and reports:
+%
+% * Callbacks per second and the realtime factor, ie., how many seconds of
+%   sound are computed per second of wall clock time.
+% * Mean and maximum duration of one master callback.
+% * Mean mixing cost per slave, as measured by the master.
+% * Mean cost of one schedule processing step, if 'useSchedule' is 1.
+%
+% Because no sound hardware is involved, results are deterministic enough
+% to compare engine optimizations against each other on the same machine,
+% e.g., with PsychPortAudio('EngineTunables', [], [], [], [], useSIMD)
+% set to 0 or 1.
+%
+% Optional parameters:
+%
+% 'nSlaves'     Number of playback slaves to mix. Defaults to 32.
+% 'duration'    Wall clock duration of the benchmark in seconds. Defaults to 5.
+% 'useSchedule' 1 = Play each slave via a schedule of buffer slots instead of
+%               a single looped buffer. Defaults to 0.
+% 'buffersize'  Size of one callback buffer in sample frames. Defaults to 256.
+% 'channels'    Number of output channels of master and slaves. Defaults to 2.
+% 'wavfile'     Optional name of a WAV file to write the mixed output into.
+%
+% see also: PsychTests
+
+if nargin < 1 || isempty(nSlaves)
+    nSlaves = 32;
+end
+
+if nargin < 2 || isempty(duration)
+    duration = 5;
+end
+
+if nargin < 3 || isempty(useSchedule)
+    useSchedule = 0;
+end
+
+if nargin < 4 || isempty(buffersize)
+    buffersize = 256;
+end
+
+if nargin < 5 || isempty(channels)
+    channels = 2;
+end
+
+if nargin < 6
+    wavfile = [];
+end
+
+freq = 48000;
+
+InitializePsychSound;
+oldverbosity = PsychPortAudio('Verbosity', 2);
+
+% Open virtual master device for playback, free-running virtual clock:
+pamaster = PsychPortAudio('Open', -2, 1+8, 0, freq, channels, buffersize, [], [], 32, wavfile);
+
+% Create one shared noise buffer, attach slaves which all play it:
+noise = 0.01 * (rand(channels, freq) * 2 - 1);
+buffer = PsychPortAudio('CreateBuffer', [], noise);
+slaves = zeros(1, nSlaves);
+for i = 1:nSlaves
+    slaves(i) = PsychPortAudio('OpenSlave', pamaster, 1, channels);
+    if useSchedule
+        PsychPortAudio('UseSchedule', slaves(i), 1, 16);
+        for j = 1:16
+            PsychPortAudio('AddToSchedule', slaves(i), buffer, 1000);
+        end
+    else
+        PsychPortAudio('FillBuffer', slaves(i), buffer);
+    end
+    PsychPortAudio('Start', slaves(i), 0, 0, 0);
+end
+
+% Run the engine:
+PsychPortAudio('Start', pamaster, 0, 0, 1);
+tStart = GetSecs;
+WaitSecs(duration);
+mstatus = PsychPortAudio('GetStatus', pamaster);
+tElapsed = GetSecs - tStart;
+
+slaveCost = zeros(1, nSlaves);
+schedCost = zeros(1, nSlaves);
+for i = 1:nSlaves
+    status = PsychPortAudio('GetStatus', slaves(i));
+    slaveCost(i) = status.MeanCallbackDuration;
+    schedCost(i) = status.MeanScheduleDuration;
+end
+
+PsychPortAudio('Stop', pamaster);
+PsychPortAudio('Close');
+PsychPortAudio('Verbosity', oldverbosity);
+
+callbacksPerSec = mstatus.VirtualCallbacks / tElapsed;
+fprintf('\nPsychPortAudio engine benchmark: %i slaves, %i channels, %i frames per buffer, %s.\n', nSlaves, channels, buffersize, ...
+        ifelse(useSchedule, 'schedules', 'looped buffers'));
+fprintf('Callbacks per second:          %f\n', callbacksPerSec);
+fprintf('Realtime factor:               %f x\n', callbacksPerSec * buffersize / freq);
+fprintf('Mean master callback duration: %f usecs.\n', mstatus.MeanCallbackDuration * 1e6);
+fprintf('Max master callback duration:  %f usecs.\n', mstatus.MaxCallbackDuration * 1e6);
+fprintf('Mean mix cost per slave:       %f usecs.\n', mean(slaveCost) * 1e6);
+if useSchedule
+    fprintf('Mean schedule processing cost: %f usecs.\n', mean(schedCost) * 1e6);
+end
+fprintf('\n');
+
+return;
+
+function r = ifelse(cond, a, b)
+if cond
+    r = a;
+else
+    r = b;
+end
+return;